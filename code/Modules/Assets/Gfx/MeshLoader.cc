@@ -7,6 +7,7 @@
 #include "Gfx/Gfx.h"
 #include "Gfx/private/gfxResourceContainer.h"
 #include "IO/IO.h"
+#include "Core/Trace.h"
 
 namespace Oryol {
 
@@ -31,16 +32,25 @@ MeshLoader::~MeshLoader() {
 void
 MeshLoader::Cancel() {
     if (this->ioRequest) {
-        this->ioRequest->Cancelled = true;
+        this->ioRequest->Cancel();
+        this->ioRequest->OnCompleted = nullptr;
         this->ioRequest = nullptr;
     }
 }
 
+//------------------------------------------------------------------------------
+bool
+MeshLoader::IsEventDriven() const {
+    return true;
+}
+
 //------------------------------------------------------------------------------
 Id
 MeshLoader::Start() {
     this->resId = Gfx::resource()->prepareAsync(this->setup);
-    this->ioRequest = IO::LoadFile(setup.Locator.Location());
+    this->ioRequest = IO::LoadFile(setup.Locator.Location(), [this](const Ptr<IORequest>&) {
+        this->signalReady();
+    });
     return this->resId;
 }
 
@@ -53,6 +63,7 @@ MeshLoader::Continue() {
     ResourceState::Code result = ResourceState::Pending;
     
     if (this->ioRequest->Handled) {
+        o_trace_scoped(Assets_MeshLoader_Finish);
         if (IOStatus::OK == this->ioRequest->Status) {
             // async loading has finished, use OmshParser to
             // create a MeshSetup object from the loaded data
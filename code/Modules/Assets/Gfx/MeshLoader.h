@@ -28,6 +28,8 @@ public:
     virtual ResourceState::Code Continue() override;
     /// cancel the load process
     virtual void Cancel() override;
+    /// the loader signals when its IO request has completed
+    virtual bool IsEventDriven() const override;
 private:
     Id resId;
     Ptr<IORead> ioRequest;
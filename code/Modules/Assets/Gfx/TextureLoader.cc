@@ -4,6 +4,7 @@
 #include "Pre.h"
 #include "TextureLoader.h"
 #include "IO/IO.h"
+#include "Core/Trace.h"
 #include "Gfx/Gfx.h"
 #include "Gfx/private/gfxResourceContainer.h"
 #define GLIML_ASSERT(x) o_assert(x)
@@ -32,16 +33,25 @@ TextureLoader::~TextureLoader() {
 void
 TextureLoader::Cancel() {
     if (this->ioRequest) {
-        this->ioRequest->Cancelled = true;
+        this->ioRequest->Cancel();
+        this->ioRequest->OnCompleted = nullptr;
         this->ioRequest = nullptr;
     }
 }
 
+//------------------------------------------------------------------------------
+bool
+TextureLoader::IsEventDriven() const {
+    return true;
+}
+
 //------------------------------------------------------------------------------
 Id
 TextureLoader::Start() {
     this->resId = Gfx::resource()->prepareAsync(this->setup);
-    this->ioRequest = IO::LoadFile(setup.Locator.Location());
+    this->ioRequest = IO::LoadFile(setup.Locator.Location(), [this](const Ptr<IORequest>&) {
+        this->signalReady();
+    });
     return this->resId;
 }
 
@@ -54,6 +64,7 @@ TextureLoader::Continue() {
     ResourceState::Code result = ResourceState::Pending;
     
     if (this->ioRequest->Handled) {
+        o_trace_scoped(Assets_TextureLoader_Finish);
         if (IOStatus::OK == this->ioRequest->Status) {
             // yeah, IO is done, let gliml parse the texture data
             // and create the texture resource
@@ -29,6 +29,8 @@ public:
     virtual ResourceState::Code Continue() override;
     /// cancel the load process
     virtual void Cancel() override;
+    /// the loader signals when its IO request has completed
+    virtual bool IsEventDriven() const override;
 
 private:
     /// convert gliml context attrs into a TextureSetup object
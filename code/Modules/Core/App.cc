@@ -7,6 +7,10 @@
 #include "Core/Core.h"
 #include "Core/RunLoop.h"
 #include "Core/Trace.h"
+#include "Core/Time/FrameStats.h"
+#include "Core/Time/Clock.h"
+#include "Core/Memory/AllocationTracker.h"
+#include "Core/Replay.h"
 #if ORYOL_EMSCRIPTEN
 #include <emscripten/emscripten.h>
 #elif ORYOL_IOS
@@ -16,7 +20,9 @@
 #elif ORYOL_ANDROID
 #include "Core/private/android/androidBridge.h"
 #endif
+#include <algorithm>
 #include <chrono>
+#include <cstdio>
 #include <thread>
 
 namespace Oryol {
@@ -25,14 +31,25 @@ using namespace _priv;
 
 App* App::self = nullptr;
 
+namespace {
+    FrameStats::PhaseId preRunLoopPhase = FrameStats::InvalidPhaseId;
+    FrameStats::PhaseId onFramePhase = FrameStats::InvalidPhaseId;
+    FrameStats::PhaseId postRunLoopPhase = FrameStats::InvalidPhaseId;
+}
+
 //------------------------------------------------------------------------------
 App::App() :
 curState(AppState::Init),
 nextState(AppState::InvalidAppState),
 quitRequested(false),
-suspendRequested(false)
+suspendRequested(false),
+benchmarkAllocs(0),
+benchmarkAllocBytes(0)
 {
     self = this;
+    preRunLoopPhase = FrameStats::RegisterPhase("PreRunLoop");
+    onFramePhase = FrameStats::RegisterPhase("OnFrame");
+    postRunLoopPhase = FrameStats::RegisterPhase("PostRunLoop");
     #if ORYOL_ANDROID
     this->androidBridge = Memory::New<_priv::androidBridge>();
     this->androidBridge->setup(this);
@@ -67,7 +84,8 @@ App::~App() {
 void
 App::StartMainLoop() {
     o_assert(nullptr != self);
-    Core::Setup();
+    Core::Setup(this->coreSetup);
+    this->beginBenchmark();
     Log::Info("=> App::StartMainLoop()\n");
     #if ORYOL_EMSCRIPTEN
         emscripten_set_main_loop(staticOnFrame, 0, 1);
@@ -88,6 +106,7 @@ App::StartMainLoop() {
         }
     #endif
     Log::Info("<= App::StartMainLoop()\n");
+    this->endBenchmark();
     Core::Discard();
 }
 
@@ -145,13 +164,24 @@ App::onFrame() {
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
     else {
+        // advance simulated time and dispatch replayed events
+        // before anything else happens in the frame
+        if (Clock::IsSimulated()) {
+            Clock::AdvanceSimulatedTime();
+        }
+        Replay::BeginFrame();
+        FrameStats::BeginFrame();
+
         // trigger the 'before-frame' runloop
         o_trace_begin(App_PreRunLoop);
+        FrameStats::BeginPhase(preRunLoopPhase);
         Core::PreRunLoop()->Run();
+        FrameStats::EndPhase(preRunLoopPhase);
         o_trace_end();
     
         // call current state handler function
         o_trace_begin(App_InnerFrame);
+        FrameStats::BeginPhase(onFramePhase);
         switch (this->curState) {
             case AppState::Init:
                 this->nextState = this->OnInit();
@@ -170,12 +200,21 @@ App::onFrame() {
                 o_warn("App::onFrame(): UNHANDLED APP STATE '%s'!\n", AppState::ToString(this->curState));
                 break;
         }
+        FrameStats::EndPhase(onFramePhase);
         o_trace_end();
 
         // trigger the 'after-frame' runloop
         o_trace_begin(App_PostRunLoop);
+        FrameStats::BeginPhase(postRunLoopPhase);
         Core::PostRunLoop()->Run();
+        FrameStats::EndPhase(postRunLoopPhase);
         o_trace_end();
+
+        // this runs the frame pacer if enabled
+        FrameStats::EndFrame();
+        if (this->coreSetup.BenchmarkFrames > 0) {
+            this->updateBenchmark();
+        }
     }
     o_trace_end_frame();
 }
@@ -251,4 +290,128 @@ App::requestSuspend() {
     this->suspendRequested = true;
 }
 
+//------------------------------------------------------------------------------
+void
+App::parseBenchmarkArgs(const Args& args) {
+    if (args.HasArg("-benchmark")) {
+        this->coreSetup.BenchmarkFrames = args.GetInt("-benchmark", 0);
+    }
+    if (args.HasArg("-timestep")) {
+        this->coreSetup.BenchmarkTimeStep = Duration::FromMilliSeconds(double(args.GetFloat("-timestep", 16.667f)));
+    }
+    if (args.HasArg("-benchmark-out")) {
+        this->coreSetup.BenchmarkOutputPath = args.GetString("-benchmark-out");
+    }
+    if (args.HasArg("-replay")) {
+        this->coreSetup.ReplayPath = args.GetString("-replay");
+    }
+    if (args.HasArg("-record")) {
+        this->coreSetup.RecordPath = args.GetString("-record");
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+App::beginBenchmark() {
+    const CoreSetup& setup = this->coreSetup;
+    if (!setup.RecordPath.Empty()) {
+        if (Replay::StartRecording(setup.RecordPath.AsCStr())) {
+            Log::Info("App: recording replay into '%s'\n", setup.RecordPath.AsCStr());
+        }
+    }
+    else if (!setup.ReplayPath.Empty()) {
+        if (Replay::StartPlayback(setup.ReplayPath.AsCStr())) {
+            Log::Info("App: playing back replay '%s'\n", setup.ReplayPath.AsCStr());
+        }
+    }
+    if (setup.BenchmarkFrames > 0) {
+        Log::Info("App: benchmark mode, %d frames, %.3fms time step\n",
+            setup.BenchmarkFrames, setup.BenchmarkTimeStep.AsMilliSeconds());
+        Clock::SetSimulatedTimeStep(setup.BenchmarkTimeStep);
+        FrameStats::SetTargetFrameRate(0);
+        FrameStats::SetSpikeFactor(0.0f);
+        this->benchmarkFrames.Reserve(setup.BenchmarkFrames);
+        this->benchmarkAllocs = AllocationTracker::ThreadNumAllocs();
+        this->benchmarkAllocBytes = AllocationTracker::ThreadAllocBytes();
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Only frames in the Running state are benchmarked, the allocation
+    counters are sampled on each frame to exclude the Init frames.
+*/
+void
+App::updateBenchmark() {
+    const int64_t numAllocs = AllocationTracker::ThreadNumAllocs();
+    const int64_t allocBytes = AllocationTracker::ThreadAllocBytes();
+    if ((AppState::Running == this->curState) && (this->benchmarkFrames.Size() < this->coreSetup.BenchmarkFrames)) {
+        benchmarkFrame& f = this->benchmarkFrames.Add();
+        f.frame = Replay::FrameIndex();
+        f.frameMs = FrameStats::PhaseTime(FrameStats::FramePhase).AsMilliSeconds();
+        f.preRunLoopMs = FrameStats::PhaseTime(preRunLoopPhase).AsMilliSeconds();
+        f.onFrameMs = FrameStats::PhaseTime(onFramePhase).AsMilliSeconds();
+        f.postRunLoopMs = FrameStats::PhaseTime(postRunLoopPhase).AsMilliSeconds();
+        f.numAllocs = numAllocs - this->benchmarkAllocs;
+        f.allocBytes = allocBytes - this->benchmarkAllocBytes;
+        if (this->benchmarkFrames.Size() == this->coreSetup.BenchmarkFrames) {
+            this->requestQuit();
+        }
+    }
+    this->benchmarkAllocs = numAllocs;
+    this->benchmarkAllocBytes = allocBytes;
+}
+
+//------------------------------------------------------------------------------
+void
+App::endBenchmark() {
+    if (Replay::IsRecording() || Replay::IsPlaying()) {
+        Replay::Stop();
+    }
+    if (0 == this->coreSetup.BenchmarkFrames) {
+        return;
+    }
+    Clock::SetSimulatedTimeStep(Duration());
+    const int num = this->benchmarkFrames.Size();
+    if (0 == num) {
+        o_warn("App: benchmark finished without Running frames!\n");
+        return;
+    }
+
+    // per-frame CSV output
+    const char* path = this->coreSetup.BenchmarkOutputPath.AsCStr();
+    FILE* fp = std::fopen(path, "w");
+    if (fp) {
+        std::fputs("frame,frame_ms,prerunloop_ms,onframe_ms,postrunloop_ms,allocs,alloc_bytes\n", fp);
+        for (const benchmarkFrame& f : this->benchmarkFrames) {
+            std::fprintf(fp, "%lld,%.4f,%.4f,%.4f,%.4f,%lld,%lld\n",
+                (long long)f.frame, f.frameMs, f.preRunLoopMs, f.onFrameMs, f.postRunLoopMs,
+                (long long)f.numAllocs, (long long)f.allocBytes);
+        }
+        std::fclose(fp);
+    }
+    else {
+        o_warn("App: failed to write benchmark results to '%s'\n", path);
+    }
+
+    // summary as a single key=value line which is easy to grep from CI logs
+    Array<double> times;
+    times.Reserve(num);
+    double sum = 0.0;
+    int64_t allocs = 0;
+    for (const benchmarkFrame& f : this->benchmarkFrames) {
+        times.Add(f.frameMs);
+        sum += f.frameMs;
+        allocs += f.numAllocs;
+    }
+    std::sort(times.begin(), times.end());
+    auto percentile = [&times, num](int p) -> double {
+        const int rank = (p * num + 99) / 100;
+        return times[std::max(rank, 1) - 1];
+    };
+    Log::Info("App: benchmark: frames=%d avg_ms=%.4f p50_ms=%.4f p95_ms=%.4f p99_ms=%.4f max_ms=%.4f allocs_per_frame=%.2f%s output=%s\n",
+        num, sum / num, percentile(50), percentile(95), percentile(99), times[num - 1],
+        double(allocs) / num, AllocationTracker::IsEnabled() ? "" : " (no allocation tracking)", path);
+}
+
 } // namespace Oryol
@@ -31,10 +31,32 @@
     };
     OryolMain(MyAppClass);    
     ```
+
+    Benchmark mode: App can run headless benchmarks of an application
+    which are reproducible across runs. In benchmark mode, Clock::Now()
+    returns a simulated time which advances by a fixed time step per
+    frame, the frame pacer is disabled, input events and IO responses
+    are played back from a replay file which was recorded in an earlier
+    run, and the App quits after a fixed number of frames in the Running
+    state. The CPU time of each of these frames (overall and split into
+    the PreRunLoop, OnFrame and PostRunLoop phases) and the number of
+    allocations on the main thread (if compiled with allocation tracking)
+    are written to a CSV file. The modes are configured through CoreSetup,
+    or with these command line arguments:
+
+    ```
+    -record <file>          record input events and IO responses
+    -replay <file>          play back a recorded file
+    -benchmark <frames>     run the benchmark for a number of frames
+    -timestep <ms>          simulated frame duration (default: 16.667)
+    -benchmark-out <file>   CSV output path (default: benchmark.csv)
+    ```
 */
 #include "Core/Args.h"
 #include "Core/AppState.h"
+#include "Core/CoreSetup.h"
 #include "Core/Containers/Set.h"
+#include "Core/Containers/Array.h"
 
 namespace Oryol {
 namespace _priv {
@@ -81,14 +103,36 @@ public:
     void requestQuit();
     /// low-level request app to suspend notifier
     void requestSuspend();
+    /// low-level: configure benchmark and replay mode from command line args
+    void parseBenchmarkArgs(const Args& args);
 
 protected:    
+    /// start recording, playback and benchmark mode
+    void beginBenchmark();
+    /// record the timings of the last frame, quit when done
+    void updateBenchmark();
+    /// write benchmark results, stop recording and playback
+    void endBenchmark();
+
     static App* self;
+    CoreSetup coreSetup;
     AppState::Code curState;
     AppState::Code nextState;
     Set<AppState::Code> blockers;
     bool quitRequested;
     bool suspendRequested;
+    struct benchmarkFrame {
+        int64_t frame = 0;
+        double frameMs = 0.0;
+        double preRunLoopMs = 0.0;
+        double onFrameMs = 0.0;
+        double postRunLoopMs = 0.0;
+        int64_t numAllocs = 0;
+        int64_t allocBytes = 0;
+    };
+    Array<benchmarkFrame> benchmarkFrames;
+    int64_t benchmarkAllocs;
+    int64_t benchmarkAllocBytes;
     #if ORYOL_IOS
     _priv::iosBridge* iosBridge;
     #elif ORYOL_MACOS && ORYOL_METAL
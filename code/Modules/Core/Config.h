@@ -18,6 +18,11 @@
 #define ORYOL_HAS_THREADS (0)
 #define ORYOL_COMPILER_HAS_THREADLOCAL (0)
 #define ORYOL_THREADLOCAL_PTHREAD (0)
+#elif ORYOL_FORCE_THREADLOCAL_PTHREAD
+// use the pthread-key code path on a POSIX platform with native thread-locals (for testing)
+#define ORYOL_HAS_THREADS (1)
+#define ORYOL_COMPILER_HAS_THREADLOCAL (0)
+#define ORYOL_THREADLOCAL_PTHREAD (1)
 #elif ORYOL_IOS
 #define ORYOL_HAS_THREADS (1)
 #define ORYOL_COMPILER_HAS_THREADLOCAL (0)
@@ -39,6 +44,9 @@
 #define ORYOL_MAX_PLATFORM_ALIGN (16)
 #endif
 
+/// cache line size, used to keep data written by different threads apart
+#define ORYOL_CACHE_LINE_SIZE (64)
+
 /// memory debug fill pattern (byte)
 #define ORYOL_MEMORY_DEBUG_BYTE (0xBB)
 /// memory debug fill pattern (short)
@@ -58,6 +66,13 @@
 /// silence unused variable warning
 #define ORYOL_UNUSED __attribute__((unused))
 
+/// prevent a function from being inlined
+#if defined(_MSC_VER)
+#define ORYOL_NOINLINE __declspec(noinline)
+#else
+#define ORYOL_NOINLINE __attribute__((noinline))
+#endif
+
 /// stringify helper
 #define __oryol_stringify(x) #x
 #define ORYOL_STRINGIFY(x) __oryol_stringify(x)
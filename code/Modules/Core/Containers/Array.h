@@ -25,7 +25,19 @@
     
     NOTE: An array growth operation will truncate any spare room
     at the front.
+
+    By default the array memory is allocated with the current thread's
+    memory tag, use SetMemoryTag() to allocate from a specific 
+    allocator, for instance SetMemoryTag(MemoryTag::Frame) puts 
+    the array into frame memory which is reset at the end of the
+    frame (see FrameAllocator). The memory tag is not copied, but
+    moves with the array content.
     
+    The array storage honors alignof(TYPE), an explicit alignment
+    can be provided with the ALIGN template parameter (e.g. 
+    Array<glm::mat4, 32> for AVX kernels, or 64 for cache-line
+    separation).
+
     For sorting, iterating and sorted insertion, use the standard 
     algorithm stuff!
     
@@ -38,7 +50,7 @@
 
 namespace Oryol {
 
-template<class TYPE> class Array {
+template<class TYPE, int ALIGN=0> class Array {
 public:
     /// default constructor
     Array();
@@ -64,6 +76,10 @@ public:
     int GetMinGrow() const;
     /// get max grow value
     int GetMaxGrow() const;
+    /// set memory tag for allocations (call before the array allocates memory)
+    void SetMemoryTag(MemoryTag::Code tag);
+    /// get memory tag (InvalidMemoryTag if current thread's tag is used)
+    MemoryTag::Code GetMemoryTag() const;
     /// get number of elements in array
     int Size() const;
     /// return true if empty
@@ -145,34 +161,34 @@ private:
     /// grow to make room
     void grow();
     
-    _priv::elementBuffer<TYPE> buffer;
+    _priv::elementBuffer<TYPE,ALIGN> buffer;
     int minGrow;
     int maxGrow;
 };
 
 //------------------------------------------------------------------------------
-template<class TYPE>
-Array<TYPE>::Array() :
+template<class TYPE, int ALIGN>
+Array<TYPE,ALIGN>::Array() :
 minGrow(ORYOL_CONTAINER_DEFAULT_MIN_GROW),
 maxGrow(ORYOL_CONTAINER_DEFAULT_MAX_GROW) {
     // empty
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE>
-Array<TYPE>::Array(const Array& rhs) {
+template<class TYPE, int ALIGN>
+Array<TYPE,ALIGN>::Array(const Array& rhs) {
     this->copy(rhs);
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE>
-Array<TYPE>::Array(Array&& rhs) {
+template<class TYPE, int ALIGN>
+Array<TYPE,ALIGN>::Array(Array&& rhs) {
     this->move(std::move(rhs));
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE>
-Array<TYPE>::Array(std::initializer_list<TYPE> l) :
+template<class TYPE, int ALIGN>
+Array<TYPE,ALIGN>::Array(std::initializer_list<TYPE> l) :
 minGrow(ORYOL_CONTAINER_DEFAULT_MIN_GROW),
 maxGrow(ORYOL_CONTAINER_DEFAULT_MAX_GROW) {
     this->Reserve(int(l.size()));
@@ -182,14 +198,14 @@ maxGrow(ORYOL_CONTAINER_DEFAULT_MAX_GROW) {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE>
-Array<TYPE>::~Array() {
+template<class TYPE, int ALIGN>
+Array<TYPE,ALIGN>::~Array() {
     this->destroy();
 };
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-Array<TYPE>::operator=(const Array<TYPE>& rhs) {
+template<class TYPE, int ALIGN> void
+Array<TYPE,ALIGN>::operator=(const Array<TYPE,ALIGN>& rhs) {
     /// @todo: this should be optimized when rhs.size() < this->capacity()!
     if (&rhs != this) {
         this->destroy();
@@ -198,8 +214,8 @@ Array<TYPE>::operator=(const Array<TYPE>& rhs) {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-Array<TYPE>::operator=(Array<TYPE>&& rhs) {
+template<class TYPE, int ALIGN> void
+Array<TYPE,ALIGN>::operator=(Array<TYPE,ALIGN>&& rhs) {
     /// @todo: this should be optimized when rhs.size() < this->capacity()!
     if (&rhs != this) {
         this->destroy();
@@ -208,15 +224,15 @@ Array<TYPE>::operator=(Array<TYPE>&& rhs) {
 }
     
 //------------------------------------------------------------------------------
-template<class TYPE> void
-Array<TYPE>::SetAllocStrategy(int minGrow_, int maxGrow_) {
+template<class TYPE, int ALIGN> void
+Array<TYPE,ALIGN>::SetAllocStrategy(int minGrow_, int maxGrow_) {
     this->minGrow = minGrow_;
     this->maxGrow = maxGrow_;
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-Array<TYPE>::SetFixedCapacity(int fixedCapacity) {
+template<class TYPE, int ALIGN> void
+Array<TYPE,ALIGN>::SetFixedCapacity(int fixedCapacity) {
     this->minGrow = 0;
     this->maxGrow = 0;
     if (fixedCapacity > this->buffer.capacity()) {
@@ -225,80 +241,93 @@ Array<TYPE>::SetFixedCapacity(int fixedCapacity) {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> int
-Array<TYPE>::GetMinGrow() const {
+template<class TYPE, int ALIGN> int
+Array<TYPE,ALIGN>::GetMinGrow() const {
         return this->minGrow;
     }
     
 //------------------------------------------------------------------------------
-template<class TYPE> int
-Array<TYPE>::GetMaxGrow() const {
+template<class TYPE, int ALIGN> int
+Array<TYPE,ALIGN>::GetMaxGrow() const {
     return this->maxGrow;
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> int
-Array<TYPE>::Size() const {
+template<class TYPE, int ALIGN> void
+Array<TYPE,ALIGN>::SetMemoryTag(MemoryTag::Code tag_) {
+    o_assert_dbg(nullptr == this->buffer.buf);
+    this->buffer.tag = tag_;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int ALIGN> MemoryTag::Code
+Array<TYPE,ALIGN>::GetMemoryTag() const {
+    return this->buffer.tag;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int ALIGN> int
+Array<TYPE,ALIGN>::Size() const {
     return this->buffer.size();
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> bool
-Array<TYPE>::Empty() const {
+template<class TYPE, int ALIGN> bool
+Array<TYPE,ALIGN>::Empty() const {
     return this->buffer.size() == 0;
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> int
-Array<TYPE>::Capacity() const {
+template<class TYPE, int ALIGN> int
+Array<TYPE,ALIGN>::Capacity() const {
     return this->buffer.capacity();
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> int
-Array<TYPE>::Spare() const {
+template<class TYPE, int ALIGN> int
+Array<TYPE,ALIGN>::Spare() const {
     return this->buffer.backSpare();
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> TYPE&
-Array<TYPE>::operator[](int index) {
+template<class TYPE, int ALIGN> TYPE&
+Array<TYPE,ALIGN>::operator[](int index) {
     return this->buffer[index];
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> const TYPE&
-Array<TYPE>::operator[](int index) const {
+template<class TYPE, int ALIGN> const TYPE&
+Array<TYPE,ALIGN>::operator[](int index) const {
     return this->buffer[index];
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> TYPE&
-Array<TYPE>::Front() {
+template<class TYPE, int ALIGN> TYPE&
+Array<TYPE,ALIGN>::Front() {
     return this->buffer.front();
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> const TYPE&
-Array<TYPE>::Front() const {
+template<class TYPE, int ALIGN> const TYPE&
+Array<TYPE,ALIGN>::Front() const {
     return this->buffer.front();
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> TYPE&
-Array<TYPE>::Back() {
+template<class TYPE, int ALIGN> TYPE&
+Array<TYPE,ALIGN>::Back() {
     return this->buffer.back();
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> const TYPE&
-Array<TYPE>::Back() const {
+template<class TYPE, int ALIGN> const TYPE&
+Array<TYPE,ALIGN>::Back() const {
     return this->buffer.back();
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> Slice<TYPE>
-Array<TYPE>::MakeSlice(int offset, int numItems) {
+template<class TYPE, int ALIGN> Slice<TYPE>
+Array<TYPE,ALIGN>::MakeSlice(int offset, int numItems) {
     if (numItems == EndOfRange) {
         numItems = this->buffer.size() - offset;
     }
@@ -306,8 +335,8 @@ Array<TYPE>::MakeSlice(int offset, int numItems) {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-Array<TYPE>::Reserve(int numElements) {
+template<class TYPE, int ALIGN> void
+Array<TYPE,ALIGN>::Reserve(int numElements) {
     int newCapacity = this->buffer.size() + numElements;
     if (newCapacity > this->buffer.capacity()) {
         this->adjustCapacity(newCapacity);
@@ -315,8 +344,8 @@ Array<TYPE>::Reserve(int numElements) {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-Array<TYPE>::Trim() {
+template<class TYPE, int ALIGN> void
+Array<TYPE,ALIGN>::Trim() {
     const int curSize = this->buffer.size();
     if (curSize < this->buffer.capacity()) {
         this->adjustCapacity(curSize);
@@ -324,14 +353,14 @@ Array<TYPE>::Trim() {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-Array<TYPE>::Clear() {
+template<class TYPE, int ALIGN> void
+Array<TYPE,ALIGN>::Clear() {
     this->buffer.clear();
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> TYPE&
-Array<TYPE>::Add(const TYPE& elm) {
+template<class TYPE, int ALIGN> TYPE&
+Array<TYPE,ALIGN>::Add(const TYPE& elm) {
     if (this->buffer.backSpare() == 0) {
         this->grow();
     }
@@ -340,8 +369,8 @@ Array<TYPE>::Add(const TYPE& elm) {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> TYPE&
-Array<TYPE>::Add(TYPE&& elm) {
+template<class TYPE, int ALIGN> TYPE&
+Array<TYPE,ALIGN>::Add(TYPE&& elm) {
     if (this->buffer.backSpare() == 0) {
         this->grow();
     }
@@ -350,8 +379,8 @@ Array<TYPE>::Add(TYPE&& elm) {
 }
     
 //------------------------------------------------------------------------------
-template<class TYPE> void
-Array<TYPE>::Insert(int index, const TYPE& elm) {
+template<class TYPE, int ALIGN> void
+Array<TYPE,ALIGN>::Insert(int index, const TYPE& elm) {
     if (this->buffer.spare() == 0) {
         this->grow();
     }
@@ -359,8 +388,8 @@ Array<TYPE>::Insert(int index, const TYPE& elm) {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-Array<TYPE>::Insert(int index, TYPE&& elm) {
+template<class TYPE, int ALIGN> void
+Array<TYPE,ALIGN>::Insert(int index, TYPE&& elm) {
     if (this->buffer.spare() == 0) {
         this->grow();
     }
@@ -369,8 +398,8 @@ Array<TYPE>::Insert(int index, TYPE&& elm) {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> template<class... ARGS> TYPE&
-Array<TYPE>::Add(ARGS&&... args) {
+template<class TYPE, int ALIGN> template<class... ARGS> TYPE&
+Array<TYPE,ALIGN>::Add(ARGS&&... args) {
     if (this->buffer.backSpare() == 0) {
         this->grow();
     }
@@ -379,50 +408,50 @@ Array<TYPE>::Add(ARGS&&... args) {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> TYPE
-Array<TYPE>::PopBack() {
+template<class TYPE, int ALIGN> TYPE
+Array<TYPE,ALIGN>::PopBack() {
     return this->buffer.popBack();
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> TYPE
-Array<TYPE>::PopFront() {
+template<class TYPE, int ALIGN> TYPE
+Array<TYPE,ALIGN>::PopFront() {
     return this->buffer.popFront();
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-Array<TYPE>::Erase(int index) {
+template<class TYPE, int ALIGN> void
+Array<TYPE,ALIGN>::Erase(int index) {
     this->buffer.erase(index);
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-Array<TYPE>::EraseSwap(int index) {
+template<class TYPE, int ALIGN> void
+Array<TYPE,ALIGN>::EraseSwap(int index) {
     this->buffer.eraseSwap(index);
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-Array<TYPE>::EraseSwapBack(int index) {
+template<class TYPE, int ALIGN> void
+Array<TYPE,ALIGN>::EraseSwapBack(int index) {
     this->buffer.eraseSwapBack(index);
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-Array<TYPE>::EraseSwapFront(int index) {
+template<class TYPE, int ALIGN> void
+Array<TYPE,ALIGN>::EraseSwapFront(int index) {
     this->buffer.eraseSwapFront(index);
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-Array<TYPE>::EraseRange(int index, int num) {
+template<class TYPE, int ALIGN> void
+Array<TYPE,ALIGN>::EraseRange(int index, int num) {
     this->buffer.eraseRange(index, num);
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> int
-Array<TYPE>::FindIndexLinear(const TYPE& elm, int startIndex, int endIndex) const {
+template<class TYPE, int ALIGN> int
+Array<TYPE,ALIGN>::FindIndexLinear(const TYPE& elm, int startIndex, int endIndex) const {
     const int size = this->buffer.size();
     if (size > 0) {
         o_assert_dbg(startIndex < size);
@@ -446,48 +475,48 @@ Array<TYPE>::FindIndexLinear(const TYPE& elm, int startIndex, int endIndex) cons
 }
     
 //------------------------------------------------------------------------------
-template<class TYPE> TYPE*
-Array<TYPE>::begin() {
+template<class TYPE, int ALIGN> TYPE*
+Array<TYPE,ALIGN>::begin() {
     return this->buffer._begin();
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> const TYPE*
-Array<TYPE>::begin() const {
+template<class TYPE, int ALIGN> const TYPE*
+Array<TYPE,ALIGN>::begin() const {
     return this->buffer._begin();
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> TYPE*
-Array<TYPE>::end() {
+template<class TYPE, int ALIGN> TYPE*
+Array<TYPE,ALIGN>::end() {
     return this->buffer._end();
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> const TYPE*
-Array<TYPE>::end() const {
+template<class TYPE, int ALIGN> const TYPE*
+Array<TYPE,ALIGN>::end() const {
     return this->buffer._end();
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-Array<TYPE>::destroy() {
+template<class TYPE, int ALIGN> void
+Array<TYPE,ALIGN>::destroy() {
     this->minGrow = 0;
     this->maxGrow = 0;
     this->buffer.destroy();
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-Array<TYPE>::copy(const Array& rhs) {
+template<class TYPE, int ALIGN> void
+Array<TYPE,ALIGN>::copy(const Array& rhs) {
     this->minGrow = rhs.minGrow;
     this->maxGrow = rhs.maxGrow;
     this->buffer = rhs.buffer;
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-Array<TYPE>::move(Array&& rhs) {
+template<class TYPE, int ALIGN> void
+Array<TYPE,ALIGN>::move(Array&& rhs) {
     this->minGrow = rhs.minGrow;
     this->maxGrow = rhs.maxGrow;
     this->buffer  = std::move(rhs.buffer);
@@ -495,14 +524,14 @@ Array<TYPE>::move(Array&& rhs) {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-Array<TYPE>::adjustCapacity(int newCapacity) {
+template<class TYPE, int ALIGN> void
+Array<TYPE,ALIGN>::adjustCapacity(int newCapacity) {
     this->buffer.alloc(newCapacity, 0);
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-Array<TYPE>::grow() {
+template<class TYPE, int ALIGN> void
+Array<TYPE,ALIGN>::grow() {
     const int curCapacity = this->buffer.capacity();
     int growBy = curCapacity >> 1;
     if (growBy < minGrow) {
@@ -4,10 +4,23 @@
     @class Oryol::Buffer
     @ingroup Core
     @brief growable memory buffer for raw data
+
+    By default the buffer memory is allocated with the current thread's
+    memory tag, use SetMemoryTag() to allocate from a specific allocator
+    (e.g. MemoryTag::Frame for per-frame scratch data). The buffer memory
+    is aligned to ORYOL_MAX_PLATFORM_ALIGN, use SetAlignment() for 
+    bigger alignments.
+
+    A buffer can also wrap external memory (for instance a memory-mapped
+    file) with Wrap(), the owner object of the memory is kept alive until
+    the buffer releases the memory. The wrapped memory must be writable.
+    A wrapped buffer can't grow, before new data is added the content
+    is copied into memory allocated by the buffer.
 */
 #include "Core/Types.h"
 #include "Core/Assertion.h"
 #include "Core/Memory/Memory.h"
+#include "Core/RefCounted.h"
 
 namespace Oryol {
 
@@ -36,6 +49,14 @@ public:
     int Capacity() const;
     /// get number of free bytes at back
     int Spare() const;
+    /// set memory tag for allocations (call before the buffer allocates memory)
+    void SetMemoryTag(MemoryTag::Code tag);
+    /// get memory tag (InvalidMemoryTag if current thread's tag is used)
+    MemoryTag::Code GetMemoryTag() const;
+    /// set power-of-two alignment (call before the buffer allocates memory)
+    void SetAlignment(int alignment);
+    /// get alignment
+    int GetAlignment() const;
 
     /// make room for N more bytes
     void Reserve(int numBytes);
@@ -45,8 +66,12 @@ public:
     uint8_t* Add(int numBytes);
     /// remove a chunk of data from the buffer, return number of bytes removed
     int Remove(int offset, int numBytes);
-    /// clear the buffer (deletes content, keeps capacity)
+    /// clear the buffer (deletes content, keeps capacity, releases wrapped memory)
     void Clear();
+    /// wrap external memory, the owner is released together with the memory
+    void Wrap(const Ptr<RefCounted>& owner, uint8_t* data, int numBytes);
+    /// return true if the buffer wraps external memory
+    bool IsWrapped() const;
     /// get read-only pointer to content (throws assert if would return nullptr)
     const uint8_t* Data() const;
     /// get read/write pointer to content (throws assert if would return nullptr)
@@ -63,6 +88,9 @@ private:
     int size;
     int capacity;
     uint8_t* data;
+    MemoryTag::Code tag;
+    int alignment;
+    Ptr<RefCounted> owner;      // only set for wrapped memory
 };
 
 //------------------------------------------------------------------------------
@@ -70,7 +98,9 @@ inline
 Buffer::Buffer() :
 size(0),
 capacity(0),
-data(nullptr) {
+data(nullptr),
+tag(MemoryTag::InvalidMemoryTag),
+alignment(ORYOL_MAX_PLATFORM_ALIGN) {
     // empty
 }
 
@@ -79,7 +109,10 @@ inline
 Buffer::Buffer(Buffer&& rhs) :
 size(rhs.size),
 capacity(rhs.capacity),
-data(rhs.data) {
+data(rhs.data),
+tag(rhs.tag),
+alignment(rhs.alignment),
+owner(std::move(rhs.owner)) {
     rhs.size = 0;
     rhs.capacity = 0;
     rhs.data = nullptr;
@@ -97,13 +130,27 @@ Buffer::alloc(int newCapacity) {
     o_assert_dbg(newCapacity > this->capacity);
     o_assert_dbg(newCapacity > this->size);
 
-    uint8_t* newBuf = (uint8_t*) Memory::Alloc(newCapacity);
-    if (this->size > 0) {
-        o_assert_dbg(this->data);
+    // NOTE: re-alloc keeps the original allocator and alignment, and may grow in place
+    uint8_t* newBuf;
+    if (this->owner) {
+        // wrapped memory can't grow, copy the content into own memory
+        if (MemoryTag::InvalidMemoryTag == this->tag) {
+            newBuf = (uint8_t*) Memory::AllocAligned(newCapacity, this->alignment);
+        }
+        else {
+            newBuf = (uint8_t*) Memory::AllocAligned(newCapacity, this->alignment, this->tag);
+        }
         Memory::Copy(this->data, newBuf, this->size);
+        this->owner = nullptr;
     }
-    if (this->data) {
-        Memory::Free(this->data);
+    else if (this->data) {
+        newBuf = (uint8_t*) Memory::ReAlloc(this->data, newCapacity);
+    }
+    else if (MemoryTag::InvalidMemoryTag == this->tag) {
+        newBuf = (uint8_t*) Memory::AllocAligned(newCapacity, this->alignment);
+    }
+    else {
+        newBuf = (uint8_t*) Memory::AllocAligned(newCapacity, this->alignment, this->tag);
     }
     this->data = newBuf;
     this->capacity = newCapacity;
@@ -112,7 +159,10 @@ Buffer::alloc(int newCapacity) {
 //------------------------------------------------------------------------------
 inline void
 Buffer::destroy() {
-    if (this->data) {
+    if (this->owner) {
+        this->owner = nullptr;
+    }
+    else if (this->data) {
         Memory::Free(this->data);
     }
     this->data = nullptr;
@@ -137,6 +187,9 @@ Buffer::operator=(Buffer&& rhs) {
     this->size = rhs.size;
     this->capacity = rhs.capacity;
     this->data = rhs.data;
+    this->tag = rhs.tag;
+    this->alignment = rhs.alignment;
+    this->owner = std::move(rhs.owner);
     rhs.size = 0;
     rhs.capacity = 0;
     rhs.data = nullptr;
@@ -166,6 +219,33 @@ Buffer::Spare() const {
     return this->capacity - this->size;
 }
 
+//------------------------------------------------------------------------------
+inline void
+Buffer::SetMemoryTag(MemoryTag::Code tag_) {
+    o_assert_dbg(nullptr == this->data);
+    this->tag = tag_;
+}
+
+//------------------------------------------------------------------------------
+inline MemoryTag::Code
+Buffer::GetMemoryTag() const {
+    return this->tag;
+}
+
+//------------------------------------------------------------------------------
+inline void
+Buffer::SetAlignment(int alignment_) {
+    o_assert_dbg(nullptr == this->data);
+    o_assert_dbg((alignment_ > 0) && (0 == (alignment_ & (alignment_ - 1))));
+    this->alignment = alignment_;
+}
+
+//------------------------------------------------------------------------------
+inline int
+Buffer::GetAlignment() const {
+    return this->alignment;
+}
+
 //------------------------------------------------------------------------------
 inline void
 Buffer::Reserve(int numBytes) {
@@ -195,7 +275,29 @@ Buffer::Add(int numBytes) {
 //------------------------------------------------------------------------------
 inline void
 Buffer::Clear() {
-    this->size = 0;
+    if (this->owner) {
+        this->destroy();
+    }
+    else {
+        this->size = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+inline void
+Buffer::Wrap(const Ptr<RefCounted>& owner_, uint8_t* data_, int numBytes) {
+    o_assert_dbg(owner_ && data_ && (numBytes > 0));
+    this->destroy();
+    this->data = data_;
+    this->size = numBytes;
+    this->capacity = numBytes;
+    this->owner = owner_;
+}
+
+//------------------------------------------------------------------------------
+inline bool
+Buffer::IsWrapped() const {
+    return this->owner.isValid();
 }
 
 //------------------------------------------------------------------------------
@@ -0,0 +1,444 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::ChunkedArray
+    @ingroup Core
+    @brief growable array with stable element addresses
+
+    A ChunkedArray stores its elements in fixed-size chunks of CHUNKSIZE
+    elements (must be a power of 2). Adding an element never moves
+    existing elements, so pointers and references into the array stay
+    valid until the element is removed or the array is destroyed.
+    Growing only allocates a new chunk and appends a pointer to the
+    chunk table, there is no copy of the existing elements.
+
+    Indexed access is a shift, a mask and one indirection. Within a chunk
+    the elements are contiguous, use NumChunks() and Chunk() to process
+    the array chunk by chunk, or ParallelForEachChunk() to process the
+    chunks on the JobSystem worker threads.
+
+    Elements can only be removed from the back (PopBack()), there is
+    no insert or erase in the middle since this would break the
+    address stability. Clear() destroys all elements but keeps the
+    chunks allocated.
+
+    @see Array, Slice
+*/
+#include "Core/Config.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Containers/Array.h"
+#include "Core/Containers/Slice.h"
+#include "Core/Threading/JobSystem.h"
+#include <initializer_list>
+#include <utility>
+
+namespace Oryol {
+
+template<class TYPE, int CHUNKSIZE=64> class ChunkedArray {
+    static_assert((CHUNKSIZE > 0) && ((CHUNKSIZE & (CHUNKSIZE - 1)) == 0), "CHUNKSIZE must be a power of 2");
+public:
+    /// default constructor
+    ChunkedArray();
+    /// copy constructor
+    ChunkedArray(const ChunkedArray& rhs);
+    /// move constructor
+    ChunkedArray(ChunkedArray&& rhs);
+    /// initialize from initializer list
+    ChunkedArray(std::initializer_list<TYPE> l);
+    /// destructor
+    ~ChunkedArray();
+
+    /// copy-assignment operator
+    void operator=(const ChunkedArray& rhs);
+    /// move-assignment operator
+    void operator=(ChunkedArray&& rhs);
+
+    /// number of elements per chunk
+    static const int ChunkSize = CHUNKSIZE;
+
+    /// get number of elements in array
+    int Size() const;
+    /// return true if empty
+    bool Empty() const;
+    /// get capacity (number of allocated chunks * CHUNKSIZE)
+    int Capacity() const;
+    /// get number of chunks which contain elements
+    int NumChunks() const;
+
+    /// read/write access an existing element
+    TYPE& operator[](int index);
+    /// read-only access to existing element
+    const TYPE& operator[](int index) const;
+    /// read/write access to first element (must exist)
+    TYPE& Front();
+    /// read-only access to first element (must exist)
+    const TYPE& Front() const;
+    /// read/write access to last element (must exist)
+    TYPE& Back();
+    /// read-only access to last element (must exist)
+    const TYPE& Back() const;
+    /// get the elements of a chunk as slice
+    Slice<TYPE> Chunk(int chunkIndex);
+    /// get the elements of a chunk as read-only slice
+    Slice<const TYPE> Chunk(int chunkIndex) const;
+
+    /// make sure that there's room for at least numElements more elements
+    void Reserve(int numElements);
+    /// destroy all elements (keeps the chunks)
+    void Clear();
+
+    /// copy-add element to back of array, return reference to new element
+    TYPE& Add(const TYPE& elm);
+    /// move-add element to back of array, return reference to new element
+    TYPE& Add(TYPE&& elm);
+    /// construct-add new element at back of array, return reference to new element
+    template<class... ARGS> TYPE& Add(ARGS&&... args);
+    /// remove and return the last element
+    TYPE PopBack();
+
+    /// call func(Slice<TYPE>, chunkIndex) for each chunk
+    template<class FUNC> void ForEachChunk(FUNC func);
+    /// call func(Slice<TYPE>, chunkIndex) for each chunk on the JobSystem worker threads
+    template<class FUNC> void ParallelForEachChunk(FUNC func);
+
+    /// forward iterator
+    template<class ELM, class OWNER> class iter {
+    public:
+        iter(OWNER* o, int i) : owner(o), index(i) { };
+        ELM& operator*() const { return (*this->owner)[this->index]; };
+        ELM* operator->() const { return &(*this->owner)[this->index]; };
+        iter& operator++() { this->index++; return *this; };
+        bool operator==(const iter& rhs) const { return this->index == rhs.index; };
+        bool operator!=(const iter& rhs) const { return this->index != rhs.index; };
+    private:
+        OWNER* owner;
+        int index;
+    };
+    typedef iter<TYPE, ChunkedArray> iterator;
+    typedef iter<const TYPE, const ChunkedArray> const_iterator;
+
+    /// C++ conform begin
+    iterator begin();
+    /// C++ conform begin
+    const_iterator begin() const;
+    /// C++ conform end
+    iterator end();
+    /// C++ conform end
+    const_iterator end() const;
+
+private:
+    /// allocate a new chunk
+    void allocChunk();
+    /// destroy elements and free chunks
+    void destroy();
+    /// copy from other array
+    void copy(const ChunkedArray& rhs);
+    /// move from other array
+    void move(ChunkedArray&& rhs);
+    /// get pointer to element slot (may be unconstructed)
+    TYPE* slotPtr(int index) const;
+    /// number of elements in a chunk
+    int chunkNumElements(int chunkIndex) const;
+
+    static const int chunkShift = (CHUNKSIZE>1) + (CHUNKSIZE>2) + (CHUNKSIZE>4) + (CHUNKSIZE>8) +
+        (CHUNKSIZE>16) + (CHUNKSIZE>32) + (CHUNKSIZE>64) + (CHUNKSIZE>128) + (CHUNKSIZE>256) +
+        (CHUNKSIZE>512) + (CHUNKSIZE>1024) + (CHUNKSIZE>2048) + (CHUNKSIZE>4096) + (CHUNKSIZE>8192) +
+        (CHUNKSIZE>16384) + (CHUNKSIZE>32768);
+    static const int chunkMask = CHUNKSIZE - 1;
+    static_assert((1<<chunkShift) == CHUNKSIZE, "CHUNKSIZE too big");
+
+    Array<TYPE*> chunks;
+    int size;
+};
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CHUNKSIZE>
+ChunkedArray<TYPE,CHUNKSIZE>::ChunkedArray() :
+size(0) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CHUNKSIZE>
+ChunkedArray<TYPE,CHUNKSIZE>::ChunkedArray(const ChunkedArray& rhs) :
+size(0) {
+    this->copy(rhs);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CHUNKSIZE>
+ChunkedArray<TYPE,CHUNKSIZE>::ChunkedArray(ChunkedArray&& rhs) :
+size(0) {
+    this->move(std::move(rhs));
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CHUNKSIZE>
+ChunkedArray<TYPE,CHUNKSIZE>::ChunkedArray(std::initializer_list<TYPE> l) :
+size(0) {
+    this->Reserve(int(l.size()));
+    for (const auto& elm : l) {
+        this->Add(elm);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CHUNKSIZE>
+ChunkedArray<TYPE,CHUNKSIZE>::~ChunkedArray() {
+    this->destroy();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CHUNKSIZE> void
+ChunkedArray<TYPE,CHUNKSIZE>::operator=(const ChunkedArray& rhs) {
+    if (&rhs != this) {
+        this->destroy();
+        this->copy(rhs);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CHUNKSIZE> void
+ChunkedArray<TYPE,CHUNKSIZE>::operator=(ChunkedArray&& rhs) {
+    if (&rhs != this) {
+        this->destroy();
+        this->move(std::move(rhs));
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CHUNKSIZE> void
+ChunkedArray<TYPE,CHUNKSIZE>::destroy() {
+    this->Clear();
+    for (TYPE* chunk : this->chunks) {
+        Memory::Free(chunk);
+    }
+    this->chunks.Clear();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CHUNKSIZE> void
+ChunkedArray<TYPE,CHUNKSIZE>::copy(const ChunkedArray& rhs) {
+    o_assert_dbg(0 == this->size);
+    this->Reserve(rhs.size);
+    for (int i = 0; i < rhs.size; i++) {
+        this->Add(rhs[i]);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CHUNKSIZE> void
+ChunkedArray<TYPE,CHUNKSIZE>::move(ChunkedArray&& rhs) {
+    this->chunks = std::move(rhs.chunks);
+    this->size = rhs.size;
+    rhs.size = 0;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CHUNKSIZE> void
+ChunkedArray<TYPE,CHUNKSIZE>::allocChunk() {
+    const int align = alignof(TYPE) > ORYOL_MAX_PLATFORM_ALIGN ? int(alignof(TYPE)) : ORYOL_MAX_PLATFORM_ALIGN;
+    this->chunks.Add((TYPE*) Memory::AllocAligned(CHUNKSIZE * sizeof(TYPE), align));
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CHUNKSIZE> TYPE*
+ChunkedArray<TYPE,CHUNKSIZE>::slotPtr(int index) const {
+    return this->chunks[index >> chunkShift] + (index & chunkMask);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CHUNKSIZE> int
+ChunkedArray<TYPE,CHUNKSIZE>::chunkNumElements(int chunkIndex) const {
+    const int num = this->size - (chunkIndex << chunkShift);
+    return num < CHUNKSIZE ? num : CHUNKSIZE;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CHUNKSIZE> int
+ChunkedArray<TYPE,CHUNKSIZE>::Size() const {
+    return this->size;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CHUNKSIZE> bool
+ChunkedArray<TYPE,CHUNKSIZE>::Empty() const {
+    return 0 == this->size;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CHUNKSIZE> int
+ChunkedArray<TYPE,CHUNKSIZE>::Capacity() const {
+    return this->chunks.Size() << chunkShift;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CHUNKSIZE> int
+ChunkedArray<TYPE,CHUNKSIZE>::NumChunks() const {
+    return (this->size + chunkMask) >> chunkShift;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CHUNKSIZE> TYPE&
+ChunkedArray<TYPE,CHUNKSIZE>::operator[](int index) {
+    o_assert_range_dbg(index, this->size);
+    return *this->slotPtr(index);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CHUNKSIZE> const TYPE&
+ChunkedArray<TYPE,CHUNKSIZE>::operator[](int index) const {
+    o_assert_range_dbg(index, this->size);
+    return *this->slotPtr(index);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CHUNKSIZE> TYPE&
+ChunkedArray<TYPE,CHUNKSIZE>::Front() {
+    o_assert_dbg(this->size > 0);
+    return *this->slotPtr(0);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CHUNKSIZE> const TYPE&
+ChunkedArray<TYPE,CHUNKSIZE>::Front() const {
+    o_assert_dbg(this->size > 0);
+    return *this->slotPtr(0);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CHUNKSIZE> TYPE&
+ChunkedArray<TYPE,CHUNKSIZE>::Back() {
+    o_assert_dbg(this->size > 0);
+    return *this->slotPtr(this->size - 1);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CHUNKSIZE> const TYPE&
+ChunkedArray<TYPE,CHUNKSIZE>::Back() const {
+    o_assert_dbg(this->size > 0);
+    return *this->slotPtr(this->size - 1);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CHUNKSIZE> Slice<TYPE>
+ChunkedArray<TYPE,CHUNKSIZE>::Chunk(int chunkIndex) {
+    o_assert_range_dbg(chunkIndex, this->NumChunks());
+    return Slice<TYPE>(this->chunks[chunkIndex], this->chunkNumElements(chunkIndex));
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CHUNKSIZE> Slice<const TYPE>
+ChunkedArray<TYPE,CHUNKSIZE>::Chunk(int chunkIndex) const {
+    o_assert_range_dbg(chunkIndex, this->NumChunks());
+    return Slice<const TYPE>(this->chunks[chunkIndex], this->chunkNumElements(chunkIndex));
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CHUNKSIZE> void
+ChunkedArray<TYPE,CHUNKSIZE>::Reserve(int numElements) {
+    o_assert_dbg(numElements >= 0);
+    const int numChunks = (this->size + numElements + chunkMask) >> chunkShift;
+    if (numChunks > this->chunks.Size()) {
+        this->chunks.Reserve(numChunks - this->chunks.Size());
+        while (this->chunks.Size() < numChunks) {
+            this->allocChunk();
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CHUNKSIZE> void
+ChunkedArray<TYPE,CHUNKSIZE>::Clear() {
+    for (int i = 0; i < this->size; i++) {
+        this->slotPtr(i)->~TYPE();
+    }
+    this->size = 0;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CHUNKSIZE> TYPE&
+ChunkedArray<TYPE,CHUNKSIZE>::Add(const TYPE& elm) {
+    return this->Add<const TYPE&>(elm);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CHUNKSIZE> TYPE&
+ChunkedArray<TYPE,CHUNKSIZE>::Add(TYPE&& elm) {
+    return this->Add<TYPE>(std::move(elm));
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CHUNKSIZE> template<class... ARGS> TYPE&
+ChunkedArray<TYPE,CHUNKSIZE>::Add(ARGS&&... args) {
+    if (this->size == this->Capacity()) {
+        this->allocChunk();
+    }
+    TYPE* ptr = this->slotPtr(this->size);
+    new(ptr) TYPE(std::forward<ARGS>(args)...);
+    this->size++;
+    return *ptr;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CHUNKSIZE> TYPE
+ChunkedArray<TYPE,CHUNKSIZE>::PopBack() {
+    o_assert_dbg(this->size > 0);
+    TYPE* ptr = this->slotPtr(--this->size);
+    TYPE elm(std::move(*ptr));
+    ptr->~TYPE();
+    return elm;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CHUNKSIZE> template<class FUNC> void
+ChunkedArray<TYPE,CHUNKSIZE>::ForEachChunk(FUNC func) {
+    const int numChunks = this->NumChunks();
+    for (int i = 0; i < numChunks; i++) {
+        func(this->Chunk(i), i);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    The chunks are handed to the JobSystem (one job per chunk), the
+    calling thread takes part in the work, and work-stealing balances
+    uneven per-chunk cost. The function must not add or remove elements.
+    If the JobSystem has no worker threads, the chunks are processed
+    on the calling thread.
+*/
+template<class TYPE, int CHUNKSIZE> template<class FUNC> void
+ChunkedArray<TYPE,CHUNKSIZE>::ParallelForEachChunk(FUNC func) {
+    JobSystem::ParallelFor(0, this->NumChunks(), 1, [this, &func](int first, int last) {
+        for (int i = first; i < last; i++) {
+            func(this->Chunk(i), i);
+        }
+    });
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CHUNKSIZE> typename ChunkedArray<TYPE,CHUNKSIZE>::iterator
+ChunkedArray<TYPE,CHUNKSIZE>::begin() {
+    return iterator(this, 0);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CHUNKSIZE> typename ChunkedArray<TYPE,CHUNKSIZE>::const_iterator
+ChunkedArray<TYPE,CHUNKSIZE>::begin() const {
+    return const_iterator(this, 0);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CHUNKSIZE> typename ChunkedArray<TYPE,CHUNKSIZE>::iterator
+ChunkedArray<TYPE,CHUNKSIZE>::end() {
+    return iterator(this, this->size);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int CHUNKSIZE> typename ChunkedArray<TYPE,CHUNKSIZE>::const_iterator
+ChunkedArray<TYPE,CHUNKSIZE>::end() const {
+    return const_iterator(this, this->size);
+}
+
+} // namespace Oryol
@@ -0,0 +1,368 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::FlatHashSet
+    @ingroup Core
+    @brief growable hash set with contiguous element storage
+
+    A hash set which, unlike HashSet, doesn't have a fixed number of
+    buckets. The values live in a single dense array (in the order
+    they were added, erasing a value moves the last value into the gap),
+    and a separate open-addressing index table maps hash values to array
+    indices. The index table is rehashed (doubled) when the number of
+    values would exceed the max load factor, which is 0.875 by default
+    and can be changed with SetMaxLoadFactor(). Lookup cost thus stays
+    constant no matter how many values are in the set.
+
+    Many values can be added in bulk mode, this appends the values
+    to the array and builds the index only once in EndBulk(), which
+    also drops values that are already in the set:
+
+    @code
+    set.BeginBulk();
+    for (...) {
+        set.AddBulk(val);
+    }
+    set.EndBulk();
+    @endcode
+
+    The HASHER must provide an operator() which returns an int32_t hash
+    value, lookup functions are templated on the lookup-value type to allow
+    heterogeneous lookup (see HashMap).
+
+    @see HashSet, HashMap, Set
+*/
+#include <initializer_list>
+#include "Core/Config.h"
+#include "Core/Containers/Array.h"
+#include "Core/Containers/hashIndex.h"
+
+namespace Oryol {
+
+template<class VALUETYPE, class HASHER> class FlatHashSet {
+public:
+    /// default constructor
+    FlatHashSet();
+    /// copy constructor
+    FlatHashSet(const FlatHashSet& rhs);
+    /// move constructor
+    FlatHashSet(FlatHashSet&& rhs);
+    /// construct from initializer list
+    FlatHashSet(std::initializer_list<VALUETYPE> rhs);
+
+    /// copy-assignment operator
+    void operator=(const FlatHashSet& rhs);
+    /// move-assignment operator
+    void operator=(FlatHashSet&& rhs);
+
+    /// set max load factor (between 0.25 and 0.95), rehashes if needed
+    void SetMaxLoadFactor(float f);
+    /// get max load factor
+    float GetMaxLoadFactor() const;
+    /// get number of values in the set
+    int Size() const;
+    /// return true if empty
+    bool Empty() const;
+    /// get number of values which fit into the set without rehashing
+    int Capacity() const;
+
+    /// increase capacity to hold at least numValues more values without rehashing
+    void Reserve(int numValues);
+    /// clear the set (keeps capacity)
+    void Clear();
+
+    /// test if a value exists
+    template<class K> bool Contains(const K& val) const;
+    /// find a value, returns index or InvalidIndex
+    template<class K> int FindIndex(const K& val) const;
+    /// find a value, returns nullptr if not found
+    template<class K> const VALUETYPE* Find(const K& val) const;
+    /// add a value (must not exist)
+    void Add(const VALUETYPE& val);
+    /// add a value with move semantics (must not exist)
+    void Add(VALUETYPE&& val);
+    /// add a value, return false if the value already existed
+    bool AddUnique(const VALUETYPE& val);
+    /// erase a value, does nothing if the value doesn't exist
+    template<class K> void Erase(const K& val);
+    /// erase value at index (moves last value to index)
+    void EraseIndex(int index);
+
+    /// begin bulk-adding values
+    void BeginBulk();
+    /// add a value in bulk mode
+    void AddBulk(const VALUETYPE& val);
+    /// add a value in bulk mode with move semantics
+    void AddBulk(VALUETYPE&& val);
+    /// end bulk mode, builds the index for the bulk-added values and drops duplicates
+    void EndBulk();
+
+    /// get value at index
+    const VALUETYPE& ValueAtIndex(int index) const;
+
+    /// C++ conform begin, MAY RETURN nullptr!
+    const VALUETYPE* begin() const;
+    /// C++ conform end, MAY RETURN nullptr!
+    const VALUETYPE* end() const;
+
+private:
+    /// compute hash value for a value
+    template<class K> static uint32_t hashOf(const K& val);
+    /// find index of a value, with precomputed hash
+    template<class K> int findIndex(uint32_t hash, const K& val) const;
+
+    Array<VALUETYPE> values;
+    _priv::hashIndex index;
+    int bulkStart;      // InvalidIndex if not in bulk mode
+};
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER>
+FlatHashSet<VALUETYPE, HASHER>::FlatHashSet() :
+bulkStart(InvalidIndex) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER>
+FlatHashSet<VALUETYPE, HASHER>::FlatHashSet(const FlatHashSet& rhs) :
+values(rhs.values),
+index(rhs.index),
+bulkStart(InvalidIndex) {
+    o_assert_dbg(InvalidIndex == rhs.bulkStart);
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER>
+FlatHashSet<VALUETYPE, HASHER>::FlatHashSet(FlatHashSet&& rhs) :
+values(std::move(rhs.values)),
+index(std::move(rhs.index)),
+bulkStart(InvalidIndex) {
+    o_assert_dbg(InvalidIndex == rhs.bulkStart);
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER>
+FlatHashSet<VALUETYPE, HASHER>::FlatHashSet(std::initializer_list<VALUETYPE> rhs) :
+bulkStart(InvalidIndex) {
+    this->Reserve(int(rhs.size()));
+    for (const auto& val : rhs) {
+        this->Add(val);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> void
+FlatHashSet<VALUETYPE, HASHER>::operator=(const FlatHashSet& rhs) {
+    o_assert_dbg((InvalidIndex == this->bulkStart) && (InvalidIndex == rhs.bulkStart));
+    if (&rhs != this) {
+        this->values = rhs.values;
+        this->index = rhs.index;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> void
+FlatHashSet<VALUETYPE, HASHER>::operator=(FlatHashSet&& rhs) {
+    o_assert_dbg((InvalidIndex == this->bulkStart) && (InvalidIndex == rhs.bulkStart));
+    if (&rhs != this) {
+        this->values = std::move(rhs.values);
+        this->index = std::move(rhs.index);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> void
+FlatHashSet<VALUETYPE, HASHER>::SetMaxLoadFactor(float f) {
+    this->index.setMaxLoadFactor(f);
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> float
+FlatHashSet<VALUETYPE, HASHER>::GetMaxLoadFactor() const {
+    return this->index.maxLoadFactor();
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> int
+FlatHashSet<VALUETYPE, HASHER>::Size() const {
+    return this->values.Size();
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> bool
+FlatHashSet<VALUETYPE, HASHER>::Empty() const {
+    return this->values.Empty();
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> int
+FlatHashSet<VALUETYPE, HASHER>::Capacity() const {
+    return this->index.capacity();
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> template<class K> uint32_t
+FlatHashSet<VALUETYPE, HASHER>::hashOf(const K& val) {
+    return _priv::hashIndex::mix(uint32_t(HASHER()(val)));
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> template<class K> int
+FlatHashSet<VALUETYPE, HASHER>::findIndex(uint32_t hash, const K& val) const {
+    o_assert_dbg(InvalidIndex == this->bulkStart);
+    return this->index.find(hash, [this, &val](int i) {
+        return this->values[i] == val;
+    });
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> void
+FlatHashSet<VALUETYPE, HASHER>::Reserve(int numValues) {
+    this->index.reserve(this->values.Size() + numValues);
+    if (numValues > this->values.Spare()) {
+        this->values.Reserve(numValues - this->values.Spare());
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> void
+FlatHashSet<VALUETYPE, HASHER>::Clear() {
+    o_assert_dbg(InvalidIndex == this->bulkStart);
+    this->values.Clear();
+    this->index.clear();
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> template<class K> int
+FlatHashSet<VALUETYPE, HASHER>::FindIndex(const K& val) const {
+    return this->findIndex(hashOf(val), val);
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> template<class K> bool
+FlatHashSet<VALUETYPE, HASHER>::Contains(const K& val) const {
+    return InvalidIndex != this->findIndex(hashOf(val), val);
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> template<class K> const VALUETYPE*
+FlatHashSet<VALUETYPE, HASHER>::Find(const K& val) const {
+    const int i = this->findIndex(hashOf(val), val);
+    return (InvalidIndex == i) ? nullptr : &this->values[i];
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> void
+FlatHashSet<VALUETYPE, HASHER>::Add(const VALUETYPE& val) {
+    o_assert_dbg(!this->Contains(val));
+    this->index.insert(hashOf(val), this->values.Size());
+    this->values.Add(val);
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> void
+FlatHashSet<VALUETYPE, HASHER>::Add(VALUETYPE&& val) {
+    o_assert_dbg(!this->Contains(val));
+    this->index.insert(hashOf(val), this->values.Size());
+    this->values.Add(std::move(val));
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> bool
+FlatHashSet<VALUETYPE, HASHER>::AddUnique(const VALUETYPE& val) {
+    const uint32_t hash = hashOf(val);
+    if (InvalidIndex != this->findIndex(hash, val)) {
+        return false;
+    }
+    this->index.insert(hash, this->values.Size());
+    this->values.Add(val);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> template<class K> void
+FlatHashSet<VALUETYPE, HASHER>::Erase(const K& val) {
+    const int i = this->FindIndex(val);
+    if (InvalidIndex != i) {
+        this->EraseIndex(i);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> void
+FlatHashSet<VALUETYPE, HASHER>::EraseIndex(int i) {
+    o_assert_dbg(InvalidIndex == this->bulkStart);
+    this->index.erase(hashOf(this->values[i]), i);
+    const int lastIndex = this->values.Size() - 1;
+    if (i != lastIndex) {
+        // the last value will be moved into the gap
+        this->index.reindex(hashOf(this->values[lastIndex]), lastIndex, i);
+    }
+    this->values.EraseSwapBack(i);
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> void
+FlatHashSet<VALUETYPE, HASHER>::BeginBulk() {
+    o_assert(InvalidIndex == this->bulkStart);
+    this->bulkStart = this->values.Size();
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> void
+FlatHashSet<VALUETYPE, HASHER>::AddBulk(const VALUETYPE& val) {
+    o_assert_dbg(InvalidIndex != this->bulkStart);
+    this->values.Add(val);
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> void
+FlatHashSet<VALUETYPE, HASHER>::AddBulk(VALUETYPE&& val) {
+    o_assert_dbg(InvalidIndex != this->bulkStart);
+    this->values.Add(std::move(val));
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> void
+FlatHashSet<VALUETYPE, HASHER>::EndBulk() {
+    o_assert(InvalidIndex != this->bulkStart);
+    const int start = this->bulkStart;
+    this->bulkStart = InvalidIndex;
+
+    // grow the index only once for all new values, values which are
+    // already in the set are dropped (the last value moves into the gap,
+    // the values after i aren't indexed yet)
+    int num = this->values.Size();
+    this->index.reserve(num);
+    for (int i = start; i < num; ) {
+        const uint32_t hash = hashOf(this->values[i]);
+        if (InvalidIndex == this->findIndex(hash, this->values[i])) {
+            this->index.insert(hash, i++);
+        }
+        else {
+            this->values.EraseSwapBack(i);
+            num--;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> const VALUETYPE&
+FlatHashSet<VALUETYPE, HASHER>::ValueAtIndex(int i) const {
+    return this->values[i];
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> const VALUETYPE*
+FlatHashSet<VALUETYPE, HASHER>::begin() const {
+    return this->values.begin();
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER> const VALUETYPE*
+FlatHashSet<VALUETYPE, HASHER>::end() const {
+    return this->values.end();
+}
+
+} // namespace Oryol
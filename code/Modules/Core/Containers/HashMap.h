@@ -0,0 +1,403 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::HashMap
+    @ingroup Core
+    @brief open-addressing hash map with dense element storage
+
+    A key-value map with O(1) lookup, insertion and erase. Elements
+    live in a dense, contiguous array of KeyValuePairs, a separate
+    open-addressing index table (Robin Hood probing) maps hash values
+    to element indices. Each index slot is only 8 bytes and stores
+    the full hash value, so that most failed probes don't need to
+    touch the elements at all.
+
+    Iteration goes over the dense element array, the iteration order
+    is the insertion order, and it is not affected by rehashing. Erasing
+    an element moves the last element into the gap (like
+    Array::EraseSwapBack()).
+
+    The HASHER must provide an operator() which returns an int32_t hash
+    value for a key. Lookup functions are templated on the lookup-key type,
+    this allows heterogeneous lookup (e.g. looking up a String key with a
+    const char*) if the HASHER provides an operator() for the lookup-key
+    type (which must produce the same hash value as for the equivalent
+    KEY), and the KEY type has an operator== for the lookup-key type.
+
+    Unlike Map, a HashMap can't contain multiple elements with the
+    same key.
+
+    @see Map, ArrayMap, FlatHashSet, KeyValuePair
+*/
+#include <initializer_list>
+#include "Core/Config.h"
+#include "Core/Containers/Array.h"
+#include "Core/Containers/KeyValuePair.h"
+#include "Core/Containers/hashIndex.h"
+
+namespace Oryol {
+
+template<class KEY, class VALUE, class HASHER> class HashMap {
+public:
+    /// default constructor
+    HashMap();
+    /// copy constructor
+    HashMap(const HashMap& rhs);
+    /// move constructor
+    HashMap(HashMap&& rhs);
+    /// construct from initializer list
+    HashMap(std::initializer_list<KeyValuePair<KEY,VALUE>> rhs);
+    /// destructor
+    ~HashMap();
+
+    /// copy-assignment operator
+    void operator=(const HashMap& rhs);
+    /// move-assignment operator
+    void operator=(HashMap&& rhs);
+
+    /// set max load factor (between 0.25 and 0.95), rehashes if needed
+    void SetMaxLoadFactor(float f);
+    /// get max load factor
+    float GetMaxLoadFactor() const;
+    /// get number of elements
+    int Size() const;
+    /// return true if empty
+    bool Empty() const;
+    /// get number of elements which fit into the map without rehashing
+    int Capacity() const;
+
+    /// read/write access single element (element must exist)
+    template<class K> VALUE& operator[](const K& key);
+    /// read-only access single element (element must exist)
+    template<class K> const VALUE& operator[](const K& key) const;
+
+    /// increase capacity to hold at least numElements more elements without rehashing
+    void Reserve(int numElements);
+    /// clear the map (deletes elements, keeps capacity)
+    void Clear();
+
+    /// test if an element exists
+    template<class K> bool Contains(const K& key) const;
+    /// find an element, returns index, or InvalidIndex
+    template<class K> int FindIndex(const K& key) const;
+    /// find an element, returns pointer to value, or nullptr
+    template<class K> VALUE* Find(const K& key);
+    /// find an element, returns pointer to value, or nullptr
+    template<class K> const VALUE* Find(const K& key) const;
+
+    /// add new element (key must not exist)
+    void Add(const KeyValuePair<KEY, VALUE>& kvp);
+    /// add new element (key must not exist)
+    void Add(KeyValuePair<KEY, VALUE>&& kvp);
+    /// add new element (key must not exist)
+    void Add(const KEY& key, const VALUE& value);
+    /// add new element, return false if element with key already existed
+    bool AddUnique(const KeyValuePair<KEY, VALUE>& kvp);
+    /// add new element with move-semantics, return false if element with key already existed
+    bool AddUnique(KeyValuePair<KEY, VALUE>&& kvp);
+    /// add new element, return false if element with key already existed
+    bool AddUnique(const KEY& key, const VALUE& value);
+    /// erase element matching key, does nothing if key not contained
+    template<class K> void Erase(const K& key);
+    /// erase element at index (moves last element to index)
+    void EraseIndex(int index);
+
+    /// get key at index
+    const KEY& KeyAtIndex(int index) const;
+    /// get value at index (read-only)
+    const VALUE& ValueAtIndex(int index) const;
+    /// get value at index (read/write)
+    VALUE& ValueAtIndex(int index);
+
+    /// C++ conform begin, MAY RETURN nullptr!
+    KeyValuePair<KEY, VALUE>* begin();
+    /// C++ conform begin, MAY RETURN nullptr!
+    const KeyValuePair<KEY, VALUE>* begin() const;
+    /// C++ conform end, MAY RETURN nullptr!
+    KeyValuePair<KEY, VALUE>* end();
+    /// C++ conform end, MAY RETURN nullptr!
+    const KeyValuePair<KEY, VALUE>* end() const;
+
+private:
+    /// compute hash value for a key
+    template<class K> static uint32_t hashOf(const K& key);
+    /// find index of key, with precomputed hash
+    template<class K> int findIndex(uint32_t hash, const K& key) const;
+
+    Array<KeyValuePair<KEY, VALUE>> elements;
+    _priv::hashIndex index;
+};
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER>
+HashMap<KEY, VALUE, HASHER>::HashMap() {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER>
+HashMap<KEY, VALUE, HASHER>::HashMap(const HashMap& rhs) :
+elements(rhs.elements),
+index(rhs.index) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER>
+HashMap<KEY, VALUE, HASHER>::HashMap(HashMap&& rhs) :
+elements(std::move(rhs.elements)),
+index(std::move(rhs.index)) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER>
+HashMap<KEY, VALUE, HASHER>::HashMap(std::initializer_list<KeyValuePair<KEY,VALUE>> rhs) {
+    this->Reserve(int(rhs.size()));
+    for (const auto& kvp : rhs) {
+        this->Add(kvp);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER>
+HashMap<KEY, VALUE, HASHER>::~HashMap() {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::operator=(const HashMap& rhs) {
+    if (&rhs != this) {
+        this->elements = rhs.elements;
+        this->index = rhs.index;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::operator=(HashMap&& rhs) {
+    if (&rhs != this) {
+        this->elements = std::move(rhs.elements);
+        this->index = std::move(rhs.index);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::SetMaxLoadFactor(float f) {
+    this->index.setMaxLoadFactor(f);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> float
+HashMap<KEY, VALUE, HASHER>::GetMaxLoadFactor() const {
+    return this->index.maxLoadFactor();
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> int
+HashMap<KEY, VALUE, HASHER>::Size() const {
+    return this->elements.Size();
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> bool
+HashMap<KEY, VALUE, HASHER>::Empty() const {
+    return this->elements.Empty();
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> int
+HashMap<KEY, VALUE, HASHER>::Capacity() const {
+    return this->index.capacity();
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> template<class K> uint32_t
+HashMap<KEY, VALUE, HASHER>::hashOf(const K& key) {
+    return _priv::hashIndex::mix(uint32_t(HASHER()(key)));
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> template<class K> int
+HashMap<KEY, VALUE, HASHER>::findIndex(uint32_t hash, const K& key) const {
+    return this->index.find(hash, [this, &key](int i) {
+        return this->elements[i].key == key;
+    });
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Reserve(int numElements) {
+    this->index.reserve(this->elements.Size() + numElements);
+    if (numElements > this->elements.Spare()) {
+        this->elements.Reserve(numElements - this->elements.Spare());
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Clear() {
+    this->elements.Clear();
+    this->index.clear();
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> template<class K> int
+HashMap<KEY, VALUE, HASHER>::FindIndex(const K& key) const {
+    return this->findIndex(hashOf(key), key);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> template<class K> bool
+HashMap<KEY, VALUE, HASHER>::Contains(const K& key) const {
+    return InvalidIndex != this->findIndex(hashOf(key), key);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> template<class K> VALUE*
+HashMap<KEY, VALUE, HASHER>::Find(const K& key) {
+    const int i = this->FindIndex(key);
+    return (InvalidIndex == i) ? nullptr : &this->elements[i].value;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> template<class K> const VALUE*
+HashMap<KEY, VALUE, HASHER>::Find(const K& key) const {
+    const int i = this->FindIndex(key);
+    return (InvalidIndex == i) ? nullptr : &this->elements[i].value;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> template<class K> VALUE&
+HashMap<KEY, VALUE, HASHER>::operator[](const K& key) {
+    const int i = this->FindIndex(key);
+    o_assert(InvalidIndex != i);
+    return this->elements[i].value;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> template<class K> const VALUE&
+HashMap<KEY, VALUE, HASHER>::operator[](const K& key) const {
+    const int i = this->FindIndex(key);
+    o_assert(InvalidIndex != i);
+    return this->elements[i].value;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Add(const KeyValuePair<KEY, VALUE>& kvp) {
+    o_assert_dbg(!this->Contains(kvp.key));
+    this->index.insert(hashOf(kvp.key), this->elements.Size());
+    this->elements.Add(kvp);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Add(KeyValuePair<KEY, VALUE>&& kvp) {
+    o_assert_dbg(!this->Contains(kvp.key));
+    this->index.insert(hashOf(kvp.key), this->elements.Size());
+    this->elements.Add(std::move(kvp));
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Add(const KEY& key, const VALUE& value) {
+    this->Add(KeyValuePair<KEY, VALUE>(key, value));
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> bool
+HashMap<KEY, VALUE, HASHER>::AddUnique(const KeyValuePair<KEY, VALUE>& kvp) {
+    const uint32_t hash = hashOf(kvp.key);
+    if (InvalidIndex != this->findIndex(hash, kvp.key)) {
+        return false;
+    }
+    this->index.insert(hash, this->elements.Size());
+    this->elements.Add(kvp);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> bool
+HashMap<KEY, VALUE, HASHER>::AddUnique(KeyValuePair<KEY, VALUE>&& kvp) {
+    const uint32_t hash = hashOf(kvp.key);
+    if (InvalidIndex != this->findIndex(hash, kvp.key)) {
+        return false;
+    }
+    this->index.insert(hash, this->elements.Size());
+    this->elements.Add(std::move(kvp));
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> bool
+HashMap<KEY, VALUE, HASHER>::AddUnique(const KEY& key, const VALUE& value) {
+    return this->AddUnique(KeyValuePair<KEY, VALUE>(key, value));
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> template<class K> void
+HashMap<KEY, VALUE, HASHER>::Erase(const K& key) {
+    const int i = this->FindIndex(key);
+    if (InvalidIndex != i) {
+        this->EraseIndex(i);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::EraseIndex(int i) {
+    this->index.erase(hashOf(this->elements[i].key), i);
+    const int lastIndex = this->elements.Size() - 1;
+    if (i != lastIndex) {
+        // the last element will be moved into the gap
+        this->index.reindex(hashOf(this->elements[lastIndex].key), lastIndex, i);
+    }
+    this->elements.EraseSwapBack(i);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> const KEY&
+HashMap<KEY, VALUE, HASHER>::KeyAtIndex(int index) const {
+    return this->elements[index].key;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> const VALUE&
+HashMap<KEY, VALUE, HASHER>::ValueAtIndex(int index) const {
+    return this->elements[index].value;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> VALUE&
+HashMap<KEY, VALUE, HASHER>::ValueAtIndex(int index) {
+    return this->elements[index].value;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> KeyValuePair<KEY, VALUE>*
+HashMap<KEY, VALUE, HASHER>::begin() {
+    return this->elements.begin();
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> const KeyValuePair<KEY, VALUE>*
+HashMap<KEY, VALUE, HASHER>::begin() const {
+    return this->elements.begin();
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> KeyValuePair<KEY, VALUE>*
+HashMap<KEY, VALUE, HASHER>::end() {
+    return this->elements.end();
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> const KeyValuePair<KEY, VALUE>*
+HashMap<KEY, VALUE, HASHER>::end() const {
+    return this->elements.end();
+}
+
+} // namespace Oryol
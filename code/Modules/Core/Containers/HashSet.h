@@ -8,7 +8,7 @@
     Implements a hash set with a fixed number of buckets, each
     bucket is a binary-sorted set.
     
-    @see Array, ArrayMap, Map, Set
+    @see Array, ArrayMap, Map, Set, FlatHashSet
 */
 #include "Core/Config.h"
 #include "Core/Containers/Set.h"
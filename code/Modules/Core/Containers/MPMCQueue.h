@@ -0,0 +1,208 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::MPMCQueue
+    @ingroup Core
+    @brief bounded lock-free multi-producer/multi-consumer queue
+
+    A fixed-capacity queue which can be used from any number of
+    producer and consumer threads concurrently without locking
+    (this is Dmitry Vyukov's bounded MPMC queue). Each cell has a
+    sequence number which tells producers and consumers whether
+    the cell is ready to be written or read, producers and consumers
+    claim cells with a compare-and-swap on their shared position.
+
+    Like SPSCQueue, Enqueue() returns false when the queue is full,
+    and Dequeue() returns false when the queue is empty. The capacity
+    is rounded up to the next power of 2 (and is at least 2). Elements
+    only need to be movable.
+
+    @see Queue, SPSCQueue
+*/
+#include "Core/Config.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#include <atomic>
+#include <type_traits>
+
+namespace Oryol {
+
+template<class TYPE> class MPMCQueue {
+public:
+    /// constructor with capacity (rounded up to power of 2)
+    explicit MPMCQueue(int capacity);
+    /// destructor
+    ~MPMCQueue();
+
+    /// get capacity
+    int Capacity() const;
+    /// get number of elements (only a snapshot if called while other threads are active)
+    int Size() const;
+    /// return true if empty (only a snapshot if called while other threads are active)
+    bool Empty() const;
+
+    /// enqueue element by copying, return false if full
+    bool Enqueue(const TYPE& elm);
+    /// enqueue element by moving, return false if full
+    bool Enqueue(TYPE&& elm);
+    /// construct element in place, return false if full
+    template<class... ARGS> bool Enqueue(ARGS&&... args);
+    /// dequeue element by moving, return false if empty
+    bool Dequeue(TYPE& outElm);
+
+private:
+    /// not copyable
+    MPMCQueue(const MPMCQueue& rhs) = delete;
+    /// not copy-assignable
+    void operator=(const MPMCQueue& rhs) = delete;
+
+    struct cell {
+        std::atomic<size_t> sequence;
+        typename std::aligned_storage<sizeof(TYPE), alignof(TYPE)>::type storage;
+    };
+    /// get pointer to the element in a cell
+    static TYPE* elementPtr(cell* c);
+
+    // read-only after construction
+    cell* cells;
+    size_t mask;
+    uint8_t pad0[ORYOL_CACHE_LINE_SIZE - sizeof(cell*) - sizeof(size_t)];
+    // shared by producers
+    std::atomic<size_t> enqueuePos;
+    uint8_t pad1[ORYOL_CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+    // shared by consumers
+    std::atomic<size_t> dequeuePos;
+    uint8_t pad2[ORYOL_CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+};
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+MPMCQueue<TYPE>::MPMCQueue(int capacity) :
+cells(nullptr),
+mask(0),
+enqueuePos(0),
+dequeuePos(0) {
+    o_assert((capacity > 0) && (capacity <= (1<<30)));
+    size_t num = 2;
+    while (num < size_t(capacity)) {
+        num <<= 1;
+    }
+    this->mask = num - 1;
+    const int align = alignof(cell) > ORYOL_CACHE_LINE_SIZE ? int(alignof(cell)) : ORYOL_CACHE_LINE_SIZE;
+    this->cells = (cell*) Memory::AllocAligned(int(num * sizeof(cell)), align);
+    for (size_t i = 0; i < num; i++) {
+        new(&this->cells[i].sequence) std::atomic<size_t>(i);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+MPMCQueue<TYPE>::~MPMCQueue() {
+    // destroy remaining elements
+    const size_t end = this->enqueuePos.load(std::memory_order_relaxed);
+    for (size_t pos = this->dequeuePos.load(std::memory_order_relaxed); pos != end; pos++) {
+        elementPtr(&this->cells[pos & this->mask])->~TYPE();
+    }
+    Memory::FreeAligned(this->cells);
+    this->cells = nullptr;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> TYPE*
+MPMCQueue<TYPE>::elementPtr(cell* c) {
+    return reinterpret_cast<TYPE*>(&c->storage);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int
+MPMCQueue<TYPE>::Capacity() const {
+    return int(this->mask + 1);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int
+MPMCQueue<TYPE>::Size() const {
+    const size_t deq = this->dequeuePos.load(std::memory_order_acquire);
+    const size_t enq = this->enqueuePos.load(std::memory_order_acquire);
+    return enq > deq ? int(enq - deq) : 0;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+MPMCQueue<TYPE>::Empty() const {
+    return 0 == this->Size();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+MPMCQueue<TYPE>::Enqueue(const TYPE& elm) {
+    return this->Enqueue<const TYPE&>(elm);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+MPMCQueue<TYPE>::Enqueue(TYPE&& elm) {
+    return this->Enqueue<TYPE>(std::move(elm));
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> template<class... ARGS> bool
+MPMCQueue<TYPE>::Enqueue(ARGS&&... args) {
+    cell* c;
+    size_t pos = this->enqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        c = &this->cells[pos & this->mask];
+        const size_t seq = c->sequence.load(std::memory_order_acquire);
+        const intptr_t diff = intptr_t(seq) - intptr_t(pos);
+        if (0 == diff) {
+            // cell is free, try to claim it
+            if (this->enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (diff < 0) {
+            // queue is full
+            return false;
+        }
+        else {
+            // another producer was faster
+            pos = this->enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+    new(elementPtr(c)) TYPE(std::forward<ARGS>(args)...);
+    c->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+MPMCQueue<TYPE>::Dequeue(TYPE& outElm) {
+    cell* c;
+    size_t pos = this->dequeuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        c = &this->cells[pos & this->mask];
+        const size_t seq = c->sequence.load(std::memory_order_acquire);
+        const intptr_t diff = intptr_t(seq) - intptr_t(pos + 1);
+        if (0 == diff) {
+            // cell contains an element, try to claim it
+            if (this->dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (diff < 0) {
+            // queue is empty
+            return false;
+        }
+        else {
+            // another consumer was faster
+            pos = this->dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+    TYPE* elm = elementPtr(c);
+    outElm = std::move(*elm);
+    elm->~TYPE();
+    c->sequence.store(pos + this->mask + 1, std::memory_order_release);
+    return true;
+}
+
+} // namespace Oryol
@@ -4,13 +4,16 @@
     @class Oryol::Queue
     @ingroup Core
     @brief a FIFO queue
+
+    The queue storage honors alignof(TYPE), or the explicit alignment
+    in the optional ALIGN template parameter.
 */
 #include "Core/Config.h"
 #include "Core/Containers/elementBuffer.h"
 
 namespace Oryol {
 
-template<class TYPE> class Queue {
+template<class TYPE, int ALIGN=0> class Queue {
 public:
     /// default constructor
     Queue();
@@ -87,30 +90,30 @@ private:
     /// common checks before enqueuing
     void checkEnqueue();
     
-    _priv::elementBuffer<TYPE> buffer;
+    _priv::elementBuffer<TYPE,ALIGN> buffer;
     int minGrow;
     int maxGrow;
 };
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-Queue<TYPE>::destroy() {
+template<class TYPE, int ALIGN> void
+Queue<TYPE,ALIGN>::destroy() {
     this->minGrow = 0;
     this->maxGrow = 0;
     this->buffer.destroy();
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-Queue<TYPE>::copy(const Queue<TYPE>& rhs) {
+template<class TYPE, int ALIGN> void
+Queue<TYPE,ALIGN>::copy(const Queue<TYPE,ALIGN>& rhs) {
     this->minGrow = rhs.minGrow;
     this->maxGrow = rhs.maxGrow;
     this->buffer = rhs.buffer;
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-Queue<TYPE>::move(Queue&& rhs) {
+template<class TYPE, int ALIGN> void
+Queue<TYPE,ALIGN>::move(Queue&& rhs) {
     this->minGrow = rhs.minGrow;
     this->maxGrow = rhs.maxGrow;
     this->buffer  = std::move(rhs.buffer);
@@ -118,14 +121,14 @@ Queue<TYPE>::move(Queue&& rhs) {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-Queue<TYPE>::adjustCapacity(int newCapacity) {
+template<class TYPE, int ALIGN> void
+Queue<TYPE,ALIGN>::adjustCapacity(int newCapacity) {
     this->buffer.alloc(newCapacity, 0);
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-Queue<TYPE>::grow() {
+template<class TYPE, int ALIGN> void
+Queue<TYPE,ALIGN>::grow() {
     const int curCapacity = this->buffer.capacity();
     int growBy = curCapacity >> 1;
     if (growBy < minGrow) {
@@ -140,8 +143,8 @@ Queue<TYPE>::grow() {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-Queue<TYPE>::moveToFront() {
+template<class TYPE, int ALIGN> void
+Queue<TYPE,ALIGN>::moveToFront() {
     const int num = this->buffer.size();
     if (num > 0) {
         o_assert_dbg(this->buffer.buf);
@@ -159,34 +162,34 @@ Queue<TYPE>::moveToFront() {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE>
-Queue<TYPE>::Queue() :
+template<class TYPE, int ALIGN>
+Queue<TYPE,ALIGN>::Queue() :
 minGrow(ORYOL_CONTAINER_DEFAULT_MIN_GROW),
 maxGrow(ORYOL_CONTAINER_DEFAULT_MAX_GROW) {
     // empty
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE>
-Queue<TYPE>::Queue(const Queue& rhs) {
+template<class TYPE, int ALIGN>
+Queue<TYPE,ALIGN>::Queue(const Queue& rhs) {
     this->copy(rhs);
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE>
-Queue<TYPE>::Queue(Queue&& rhs) {
+template<class TYPE, int ALIGN>
+Queue<TYPE,ALIGN>::Queue(Queue&& rhs) {
     this->move(std::move(rhs));
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE>
-Queue<TYPE>::~Queue() {
+template<class TYPE, int ALIGN>
+Queue<TYPE,ALIGN>::~Queue() {
     this->destroy();
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-Queue<TYPE>::operator=(const Queue& rhs) {
+template<class TYPE, int ALIGN> void
+Queue<TYPE,ALIGN>::operator=(const Queue& rhs) {
     /// @todo: this should be optimized when rhs.size() < this->capacity()!
     if (&rhs != this) {
         this->destroy();
@@ -195,8 +198,8 @@ Queue<TYPE>::operator=(const Queue& rhs) {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-Queue<TYPE>::operator=(Queue&& rhs) {
+template<class TYPE, int ALIGN> void
+Queue<TYPE,ALIGN>::operator=(Queue&& rhs) {
     /// @todo: this should be optimized when rhs.size() < this->capacity()!
     if (&rhs != this) {
         this->destroy();
@@ -205,15 +208,15 @@ Queue<TYPE>::operator=(Queue&& rhs) {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-Queue<TYPE>::SetAllocStrategy(int minGrow_, int maxGrow_) {
+template<class TYPE, int ALIGN> void
+Queue<TYPE,ALIGN>::SetAllocStrategy(int minGrow_, int maxGrow_) {
     this->minGrow = minGrow_;
     this->maxGrow = maxGrow_;
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-Queue<TYPE>::SetFixedCapacity(int fixedCapacity) {
+template<class TYPE, int ALIGN> void
+Queue<TYPE,ALIGN>::SetFixedCapacity(int fixedCapacity) {
     this->minGrow = 0;
     this->maxGrow = 0;
     if (fixedCapacity > this->buffer.capacity()) {
@@ -222,50 +225,50 @@ Queue<TYPE>::SetFixedCapacity(int fixedCapacity) {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> int
-Queue<TYPE>::GetMinGrow() const {
+template<class TYPE, int ALIGN> int
+Queue<TYPE,ALIGN>::GetMinGrow() const {
     return this->minGrow;
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> int
-Queue<TYPE>::GetMaxGrow() const {
+template<class TYPE, int ALIGN> int
+Queue<TYPE,ALIGN>::GetMaxGrow() const {
     return this->maxGrow;
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> int
-Queue<TYPE>::Size() const {
+template<class TYPE, int ALIGN> int
+Queue<TYPE,ALIGN>::Size() const {
     return this->buffer.size();
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> int
-Queue<TYPE>::Capacity() const {
+template<class TYPE, int ALIGN> int
+Queue<TYPE,ALIGN>::Capacity() const {
     return this->buffer.capacity();
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> bool
-Queue<TYPE>::Empty() const {
+template<class TYPE, int ALIGN> bool
+Queue<TYPE,ALIGN>::Empty() const {
     return this->buffer.size() == 0;
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> int
-Queue<TYPE>::SpareDequeue() const {
+template<class TYPE, int ALIGN> int
+Queue<TYPE,ALIGN>::SpareDequeue() const {
     return this->buffer.frontSpare();
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> int
-Queue<TYPE>::SpareEnqueue() const {
+template<class TYPE, int ALIGN> int
+Queue<TYPE,ALIGN>::SpareEnqueue() const {
     return this->buffer.backSpare();
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-Queue<TYPE>::Reserve(int numElements) {
+template<class TYPE, int ALIGN> void
+Queue<TYPE,ALIGN>::Reserve(int numElements) {
     int newCapacity = this->buffer.size() + numElements;
     if (newCapacity > this->buffer.capacity()) {
         this->adjustCapacity(newCapacity);
@@ -273,14 +276,14 @@ Queue<TYPE>::Reserve(int numElements) {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-Queue<TYPE>::Clear() {
+template<class TYPE, int ALIGN> void
+Queue<TYPE,ALIGN>::Clear() {
     this->buffer.clear();
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-Queue<TYPE>::checkEnqueue() {
+template<class TYPE, int ALIGN> void
+Queue<TYPE,ALIGN>::checkEnqueue() {
     // if there are currently no elements in the queue,
     // then this is a good time to move the start
     // to the front
@@ -300,61 +303,61 @@ Queue<TYPE>::checkEnqueue() {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-Queue<TYPE>::Enqueue(const TYPE& elm) {
+template<class TYPE, int ALIGN> void
+Queue<TYPE,ALIGN>::Enqueue(const TYPE& elm) {
     this->checkEnqueue();
     this->buffer.pushBack(elm);
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-Queue<TYPE>::Enqueue(TYPE&& elm) {
+template<class TYPE, int ALIGN> void
+Queue<TYPE,ALIGN>::Enqueue(TYPE&& elm) {
     this->checkEnqueue();
     this->buffer.pushBack(std::move(elm));
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> template<class... ARGS> void
-Queue<TYPE>::Enqueue(ARGS&&... args) {
+template<class TYPE, int ALIGN> template<class... ARGS> void
+Queue<TYPE,ALIGN>::Enqueue(ARGS&&... args) {
     this->checkEnqueue();
     this->buffer.emplaceBack(std::forward<ARGS>(args)...);
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> TYPE
-Queue<TYPE>::Dequeue() {
+template<class TYPE, int ALIGN> TYPE
+Queue<TYPE,ALIGN>::Dequeue() {
     o_assert_dbg(this->buffer.size() > 0);
     return std::move(this->buffer.popFront());
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-Queue<TYPE>::Dequeue(TYPE& outElm) {
+template<class TYPE, int ALIGN> void
+Queue<TYPE,ALIGN>::Dequeue(TYPE& outElm) {
     o_assert_dbg(this->buffer.size() > 0);
     outElm = std::move(this->buffer.popFront());
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> TYPE&
-Queue<TYPE>::Front() {
+template<class TYPE, int ALIGN> TYPE&
+Queue<TYPE,ALIGN>::Front() {
     return this->buffer.front();
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> const TYPE&
-Queue<TYPE>::Front() const {
+template<class TYPE, int ALIGN> const TYPE&
+Queue<TYPE,ALIGN>::Front() const {
     return this->buffer.front();
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> TYPE&
-Queue<TYPE>::Back() {
+template<class TYPE, int ALIGN> TYPE&
+Queue<TYPE,ALIGN>::Back() {
     return this->buffer.back();
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> const TYPE&
-Queue<TYPE>::Back() const {
+template<class TYPE, int ALIGN> const TYPE&
+Queue<TYPE,ALIGN>::Back() const {
     return this->buffer.back();
 }
 
@@ -0,0 +1,169 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::SPSCQueue
+    @ingroup Core
+    @brief bounded lock-free single-producer/single-consumer queue
+
+    A fixed-capacity ring buffer for handing elements from exactly one
+    producer thread to exactly one consumer thread without locking.
+    Enqueue() must only be called from the producer thread, Dequeue()
+    only from the consumer thread. Unlike Queue, Enqueue() doesn't
+    grow the queue but returns false if the queue is full, and Dequeue()
+    returns false if the queue is empty.
+
+    The capacity is rounded up to the next power of 2. Elements only need
+    to be movable, and are destroyed when they are dequeued (or when the
+    queue is destroyed).
+
+    The producer- and consumer-owned indices live on separate
+    cache lines, and each side keeps a cached copy of the other side's
+    index, so that the shared indices are only read when the cached
+    copy says the queue is full (or empty).
+
+    @see Queue, MPMCQueue
+*/
+#include "Core/Config.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#include <atomic>
+
+namespace Oryol {
+
+template<class TYPE> class SPSCQueue {
+public:
+    /// constructor with capacity (rounded up to power of 2)
+    explicit SPSCQueue(int capacity);
+    /// destructor
+    ~SPSCQueue();
+
+    /// get capacity
+    int Capacity() const;
+    /// get number of elements (only a snapshot if called while other threads are active)
+    int Size() const;
+    /// return true if empty (only a snapshot if called while other threads are active)
+    bool Empty() const;
+
+    /// enqueue element by copying (producer thread only), return false if full
+    bool Enqueue(const TYPE& elm);
+    /// enqueue element by moving (producer thread only), return false if full
+    bool Enqueue(TYPE&& elm);
+    /// construct element in place (producer thread only), return false if full
+    template<class... ARGS> bool Enqueue(ARGS&&... args);
+    /// dequeue element by moving (consumer thread only), return false if empty
+    bool Dequeue(TYPE& outElm);
+
+private:
+    /// not copyable
+    SPSCQueue(const SPSCQueue& rhs) = delete;
+    /// not copy-assignable
+    void operator=(const SPSCQueue& rhs) = delete;
+
+    // written by consumer
+    std::atomic<uint32_t> head;
+    uint32_t cachedTail;
+    uint8_t pad0[ORYOL_CACHE_LINE_SIZE - sizeof(std::atomic<uint32_t>) - sizeof(uint32_t)];
+    // written by producer
+    std::atomic<uint32_t> tail;
+    uint32_t cachedHead;
+    uint8_t pad1[ORYOL_CACHE_LINE_SIZE - sizeof(std::atomic<uint32_t>) - sizeof(uint32_t)];
+    // read-only after construction
+    TYPE* buffer;
+    uint32_t mask;
+};
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+SPSCQueue<TYPE>::SPSCQueue(int capacity) :
+head(0),
+cachedTail(0),
+tail(0),
+cachedHead(0),
+buffer(nullptr),
+mask(0) {
+    o_assert((capacity > 0) && (capacity <= (1<<30)));
+    uint32_t num = 1;
+    while (num < uint32_t(capacity)) {
+        num <<= 1;
+    }
+    this->mask = num - 1;
+    const int align = alignof(TYPE) > ORYOL_CACHE_LINE_SIZE ? int(alignof(TYPE)) : ORYOL_CACHE_LINE_SIZE;
+    this->buffer = (TYPE*) Memory::AllocAligned(int(num * sizeof(TYPE)), align);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+SPSCQueue<TYPE>::~SPSCQueue() {
+    const uint32_t t = this->tail.load(std::memory_order_relaxed);
+    for (uint32_t h = this->head.load(std::memory_order_relaxed); h != t; h++) {
+        this->buffer[h & this->mask].~TYPE();
+    }
+    Memory::FreeAligned(this->buffer);
+    this->buffer = nullptr;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int
+SPSCQueue<TYPE>::Capacity() const {
+    return int(this->mask + 1);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int
+SPSCQueue<TYPE>::Size() const {
+    return int(this->tail.load(std::memory_order_acquire) - this->head.load(std::memory_order_acquire));
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+SPSCQueue<TYPE>::Empty() const {
+    return 0 == this->Size();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+SPSCQueue<TYPE>::Enqueue(const TYPE& elm) {
+    return this->Enqueue<const TYPE&>(elm);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+SPSCQueue<TYPE>::Enqueue(TYPE&& elm) {
+    return this->Enqueue<TYPE>(std::move(elm));
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> template<class... ARGS> bool
+SPSCQueue<TYPE>::Enqueue(ARGS&&... args) {
+    const uint32_t t = this->tail.load(std::memory_order_relaxed);
+    if ((t - this->cachedHead) > this->mask) {
+        // looks full, refresh the consumer's index
+        this->cachedHead = this->head.load(std::memory_order_acquire);
+        if ((t - this->cachedHead) > this->mask) {
+            return false;
+        }
+    }
+    new(&this->buffer[t & this->mask]) TYPE(std::forward<ARGS>(args)...);
+    this->tail.store(t + 1, std::memory_order_release);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+SPSCQueue<TYPE>::Dequeue(TYPE& outElm) {
+    const uint32_t h = this->head.load(std::memory_order_relaxed);
+    if (h == this->cachedTail) {
+        // looks empty, refresh the producer's index
+        this->cachedTail = this->tail.load(std::memory_order_acquire);
+        if (h == this->cachedTail) {
+            return false;
+        }
+    }
+    TYPE& elm = this->buffer[h & this->mask];
+    outElm = std::move(elm);
+    elm.~TYPE();
+    this->head.store(h + 1, std::memory_order_release);
+    return true;
+}
+
+} // namespace Oryol
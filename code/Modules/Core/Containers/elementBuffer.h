@@ -12,6 +12,13 @@
     bufEnd   - pointer to one-past-end of allocated memory
     elmStart - pointer to first valid element
     elmEnd   - pointer to one-past-end of valid elements
+
+    The optional memory tag selects where the buffer memory is allocated
+    from (InvalidMemoryTag means the current thread's memory tag). The
+    memory tag follows the buffer on move, but is not copied.
+
+    The buffer memory is aligned to ALIGN bytes, or to alignof(TYPE)
+    if ALIGN is 0 (but at least ORYOL_MAX_PLATFORM_ALIGN).
  
     |----|----|----|----|XXXX|XXXX|XXXX|XXXX|----|----|----|
     bufStart            elmStart             elmEnd         bufEnd
@@ -27,7 +34,8 @@
 namespace Oryol {
 namespace _priv {
 
-template<class TYPE> class elementBuffer {
+template<class TYPE, int ALIGN=0> class elementBuffer {
+    static_assert((ALIGN & (ALIGN - 1)) == 0, "ALIGN must be 0 or a power of 2!");
 public:
     /// default constructor
     elementBuffer();
@@ -67,6 +75,8 @@ public:
     /// get back element (r/o)
     const TYPE& back() const;
     
+    /// get alignment of the buffer memory
+    static constexpr int alignment();
     /// allocate, grow or shrink the elementBuffer
     void alloc(int capacity, int frontSpare);
     /// destroy all
@@ -141,26 +151,29 @@ public:
     int cap;            // buffer capacity (num elements)
     int start;          // index of first valid element in buffer
     int end;            // index of one-past-last valid element in buffer
+    MemoryTag::Code tag;    // memory tag for allocation, or InvalidMemoryTag
 };
 
 //------------------------------------------------------------------------------
-template<class TYPE>
-elementBuffer<TYPE>::elementBuffer() :
+template<class TYPE, int ALIGN>
+elementBuffer<TYPE,ALIGN>::elementBuffer() :
 buf(nullptr),
 cap(0),
 start(0),
-end(0)
+end(0),
+tag(MemoryTag::InvalidMemoryTag)
 {
     // empty
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE>
-elementBuffer<TYPE>::elementBuffer(const elementBuffer& rhs) :
+template<class TYPE, int ALIGN>
+elementBuffer<TYPE,ALIGN>::elementBuffer(const elementBuffer& rhs) :
 buf(nullptr),
 cap(0),
 start(0),
-end(0)
+end(0),
+tag(MemoryTag::InvalidMemoryTag)
 {
     if (rhs.buf) {
         this->alloc(rhs.size(), 0);
@@ -175,12 +188,13 @@ end(0)
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE>
-elementBuffer<TYPE>::elementBuffer(elementBuffer&& rhs) :
+template<class TYPE, int ALIGN>
+elementBuffer<TYPE,ALIGN>::elementBuffer(elementBuffer&& rhs) :
 buf(rhs.buf),
 cap(rhs.cap),
 start(rhs.start),
-end(rhs.end)
+end(rhs.end),
+tag(rhs.tag)
 {
     // reset rhs to default-constructed state
     rhs.buf = nullptr;
@@ -190,14 +204,14 @@ end(rhs.end)
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE>
-elementBuffer<TYPE>::~elementBuffer() {
+template<class TYPE, int ALIGN>
+elementBuffer<TYPE,ALIGN>::~elementBuffer() {
     this->destroy();
 }
     
 //------------------------------------------------------------------------------
-template<class TYPE> void
-elementBuffer<TYPE>::operator=(const elementBuffer<TYPE>& rhs) {
+template<class TYPE, int ALIGN> void
+elementBuffer<TYPE,ALIGN>::operator=(const elementBuffer<TYPE,ALIGN>& rhs) {
     if (&rhs != this) {
         this->destroy();
         const int newSize = rhs.size();
@@ -216,14 +230,15 @@ elementBuffer<TYPE>::operator=(const elementBuffer<TYPE>& rhs) {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-elementBuffer<TYPE>::operator=(elementBuffer<TYPE>&& rhs) {
+template<class TYPE, int ALIGN> void
+elementBuffer<TYPE,ALIGN>::operator=(elementBuffer<TYPE,ALIGN>&& rhs) {
     if (&rhs != this) {
         this->destroy();
         this->buf   = rhs.buf;
         this->cap   = rhs.cap;
         this->start = rhs.start;
         this->end   = rhs.end;
+        this->tag   = rhs.tag;
         rhs.buf   = nullptr;
         rhs.cap   = 0;
         rhs.start = 0;
@@ -232,38 +247,38 @@ elementBuffer<TYPE>::operator=(elementBuffer<TYPE>&& rhs) {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> int
-elementBuffer<TYPE>::frontSpare() const {
+template<class TYPE, int ALIGN> int
+elementBuffer<TYPE,ALIGN>::frontSpare() const {
     return this->start;
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> int
-elementBuffer<TYPE>::backSpare() const {
+template<class TYPE, int ALIGN> int
+elementBuffer<TYPE,ALIGN>::backSpare() const {
     return this->cap - this->end;
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> int
-elementBuffer<TYPE>::spare() const {
+template<class TYPE, int ALIGN> int
+elementBuffer<TYPE,ALIGN>::spare() const {
     return this->cap - this->size();
 }
     
 //------------------------------------------------------------------------------
-template<class TYPE> int
-elementBuffer<TYPE>::size() const {
+template<class TYPE, int ALIGN> int
+elementBuffer<TYPE,ALIGN>::size() const {
     return this->end-this->start;
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> int
-elementBuffer<TYPE>::capacity() const {
+template<class TYPE, int ALIGN> int
+elementBuffer<TYPE,ALIGN>::capacity() const {
     return this->cap;
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> TYPE&
-elementBuffer<TYPE>::operator[](int index) {
+template<class TYPE, int ALIGN> TYPE&
+elementBuffer<TYPE,ALIGN>::operator[](int index) {
     o_assert_dbg((index >= 0) && (index < this->size()));
     o_assert_dbg(this->buf);
     o_assert_range_dbg(this->start+index, this->cap);
@@ -271,8 +286,8 @@ elementBuffer<TYPE>::operator[](int index) {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> const TYPE&
-elementBuffer<TYPE>::operator[](int index) const {
+template<class TYPE, int ALIGN> const TYPE&
+elementBuffer<TYPE,ALIGN>::operator[](int index) const {
     o_assert_dbg((index >= 0) && (index < this->size()));
     o_assert_dbg(this->buf);
     o_assert_range_dbg(this->start+index, this->cap);
@@ -280,40 +295,46 @@ elementBuffer<TYPE>::operator[](int index) const {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> TYPE&
-elementBuffer<TYPE>::front() {
+template<class TYPE, int ALIGN> TYPE&
+elementBuffer<TYPE,ALIGN>::front() {
     o_assert((this->start != this->end) && this->buf);
     o_assert_range_dbg(this->start, this->cap);
     return this->buf[this->start];
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> const TYPE&
-elementBuffer<TYPE>::front() const {
+template<class TYPE, int ALIGN> const TYPE&
+elementBuffer<TYPE,ALIGN>::front() const {
     o_assert((this->start != this->end) && this->buf);
     o_assert_range_dbg(this->start, this->cap);
     return this->buf[this->start];
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> TYPE&
-elementBuffer<TYPE>::back() {
+template<class TYPE, int ALIGN> TYPE&
+elementBuffer<TYPE,ALIGN>::back() {
     o_assert((this->start != this->end) && this->buf);
     o_assert_range_dbg(this->end-1, this->cap);
     return this->buf[this->end - 1];
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> const TYPE&
-elementBuffer<TYPE>::back() const {
+template<class TYPE, int ALIGN> const TYPE&
+elementBuffer<TYPE,ALIGN>::back() const {
     o_assert((this->start != this->end) && this->buf);
     o_assert_range_dbg(this->end-1, this->cap);
     return this->buf[this->end - 1];
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-elementBuffer<TYPE>::alloc(int newCapacity, int newStart) {
+template<class TYPE, int ALIGN> constexpr int
+elementBuffer<TYPE,ALIGN>::alignment() {
+    return ALIGN ? ALIGN : int(alignof(TYPE));
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, int ALIGN> void
+elementBuffer<TYPE,ALIGN>::alloc(int newCapacity, int newStart) {
     o_assert_dbg(newCapacity > 0);
     if (this->cap == newCapacity) {
         return;
@@ -323,7 +344,9 @@ elementBuffer<TYPE>::alloc(int newCapacity, int newStart) {
 
     // allocate new buffer
     const int newBufSize = newCapacity * sizeof(TYPE);
-    TYPE* newBuffer = (TYPE*) Memory::Alloc(newBufSize);
+    TYPE* newBuffer = (TYPE*) ((MemoryTag::InvalidMemoryTag == this->tag) ?
+        Memory::AllocAligned(newBufSize, alignment()) :
+        Memory::AllocAligned(newBufSize, alignment(), this->tag));
     TYPE* newElmStart = newBuffer + newStart;
     
     // need to move any elements?
@@ -353,8 +376,8 @@ elementBuffer<TYPE>::alloc(int newCapacity, int newStart) {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-elementBuffer<TYPE>::destroy() {
+template<class TYPE, int ALIGN> void
+elementBuffer<TYPE,ALIGN>::destroy() {
     // destroy elements and free buffer
     if (this->buf) {
         for (int i = this->start; i < this->end; i++) {
@@ -370,14 +393,14 @@ elementBuffer<TYPE>::destroy() {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-elementBuffer<TYPE>::destroyElement(TYPE* elm) {
+template<class TYPE, int ALIGN> void
+elementBuffer<TYPE,ALIGN>::destroyElement(TYPE* elm) {
     elm->~TYPE();
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-elementBuffer<TYPE>::clear() {
+template<class TYPE, int ALIGN> void
+elementBuffer<TYPE,ALIGN>::clear() {
     if (this->buf) {
         for (int i = this->start; i < this->end; i++) {
             o_assert_range_dbg(i, this->cap);
@@ -388,14 +411,14 @@ elementBuffer<TYPE>::clear() {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> bool
-elementBuffer<TYPE>::overlaps(const TYPE* from, const TYPE* to, int num) {
+template<class TYPE, int ALIGN> bool
+elementBuffer<TYPE,ALIGN>::overlaps(const TYPE* from, const TYPE* to, int num) {
     return (to >= from) && (to < (from + num));
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-elementBuffer<TYPE>::copyConstruct(const TYPE* from, TYPE* to, int num) {
+template<class TYPE, int ALIGN> void
+elementBuffer<TYPE,ALIGN>::copyConstruct(const TYPE* from, TYPE* to, int num) {
     o_assert_dbg(!overlaps(from, to, num));
     for (int i = 0; i < num; i++) {
         new(to++) TYPE(*from++);
@@ -403,8 +426,8 @@ elementBuffer<TYPE>::copyConstruct(const TYPE* from, TYPE* to, int num) {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-elementBuffer<TYPE>::copyAssign(const TYPE* from, TYPE* to, int num) {
+template<class TYPE, int ALIGN> void
+elementBuffer<TYPE,ALIGN>::copyAssign(const TYPE* from, TYPE* to, int num) {
     o_assert_dbg(!overlaps(from, to, num));
     for (int i = 0; i < num; i++) {
         *to++ = *from++;
@@ -412,8 +435,8 @@ elementBuffer<TYPE>::copyAssign(const TYPE* from, TYPE* to, int num) {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-elementBuffer<TYPE>::pushBack(const TYPE& elm) {
+template<class TYPE, int ALIGN> void
+elementBuffer<TYPE,ALIGN>::pushBack(const TYPE& elm) {
     // NOTE: this will fail if there is no spare space at the back,
     // use insert(size(), elm) which will move towards front if possible
     o_assert_dbg(this->buf);
@@ -422,8 +445,8 @@ elementBuffer<TYPE>::pushBack(const TYPE& elm) {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-elementBuffer<TYPE>::pushBack(TYPE&& elm) {
+template<class TYPE, int ALIGN> void
+elementBuffer<TYPE,ALIGN>::pushBack(TYPE&& elm) {
     // NOTE: this will fail if there is no spare space at the back,
     // use insert(size(), elm) which will move towards front if possible
     o_assert_dbg(this->buf);
@@ -432,8 +455,8 @@ elementBuffer<TYPE>::pushBack(TYPE&& elm) {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> template<class... ARGS> void
-elementBuffer<TYPE>::emplaceBack(ARGS&&... args) {
+template<class TYPE, int ALIGN> template<class... ARGS> void
+elementBuffer<TYPE,ALIGN>::emplaceBack(ARGS&&... args) {
     // NOTE: this will fail if there is no spare space at the back,
     // use insert(size(), elm) which will move towards front if possible
     o_assert_dbg(this->buf);
@@ -442,8 +465,8 @@ elementBuffer<TYPE>::emplaceBack(ARGS&&... args) {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-elementBuffer<TYPE>::pushFront(const TYPE& elm) {
+template<class TYPE, int ALIGN> void
+elementBuffer<TYPE,ALIGN>::pushFront(const TYPE& elm) {
     // NOTE: this will fail if there is no spare space at the front,
     // use insert(0, elm) which will move towards back if possible
     o_assert_dbg(this->buf && (this->start > 0) && (this->start <= this->cap));
@@ -451,8 +474,8 @@ elementBuffer<TYPE>::pushFront(const TYPE& elm) {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-elementBuffer<TYPE>::pushFront(TYPE&& elm) {
+template<class TYPE, int ALIGN> void
+elementBuffer<TYPE,ALIGN>::pushFront(TYPE&& elm) {
     // NOTE: this will fail if there is no spare space at the front,
     // use insert(0, elm) which will move towards back if possible
     o_assert_dbg(this->buf && (this->start > 0) && (this->start <= this->cap));
@@ -460,8 +483,8 @@ elementBuffer<TYPE>::pushFront(TYPE&& elm) {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> template<class... ARGS> void
-elementBuffer<TYPE>::emplaceFront(ARGS&&... args) {
+template<class TYPE, int ALIGN> template<class... ARGS> void
+elementBuffer<TYPE,ALIGN>::emplaceFront(ARGS&&... args) {
     // NOTE: this will fail if there is no spare space at the front,
     // use insert(0, elm) which will move towards back if possible
     o_assert_dbg(this->buf && (this->start > 0) && (this->start <= this->cap));
@@ -469,8 +492,8 @@ elementBuffer<TYPE>::emplaceFront(ARGS&&... args) {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> TYPE*
-elementBuffer<TYPE>::moveInsertFront(int index) {
+template<class TYPE, int ALIGN> TYPE*
+elementBuffer<TYPE,ALIGN>::moveInsertFront(int index) {
     // free a slot for insertion by moving the elements
     // at and before it towards the front
     // the freed slot will NOT be deconstructed!
@@ -489,8 +512,8 @@ elementBuffer<TYPE>::moveInsertFront(int index) {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> TYPE*
-elementBuffer<TYPE>::moveInsertBack(int index) {
+template<class TYPE, int ALIGN> TYPE*
+elementBuffer<TYPE,ALIGN>::moveInsertBack(int index) {
     // free a slot for insertion by moving the elements
     // after it towards the back
     // the freed slot will NOT be deconstructed!
@@ -509,8 +532,8 @@ elementBuffer<TYPE>::moveInsertBack(int index) {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-elementBuffer<TYPE>::moveEraseFront(int index) {
+template<class TYPE, int ALIGN> void
+elementBuffer<TYPE,ALIGN>::moveEraseFront(int index) {
     // erase a slot by moving elements from the front
     o_assert_dbg(this->buf && (index >= 0) && (index < this->size()));
     for (int i = this->start + index; i > this->start; i--) {
@@ -523,8 +546,8 @@ elementBuffer<TYPE>::moveEraseFront(int index) {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-elementBuffer<TYPE>::moveEraseBack(int index) {
+template<class TYPE, int ALIGN> void
+elementBuffer<TYPE,ALIGN>::moveEraseBack(int index) {
     // erase a slot by moving elements from the back
     o_assert_dbg(this->buf && (index >= 0) && (index < this->size()));
     for (int i = this->start + index; i < (this->end - 1); i++) {
@@ -537,8 +560,8 @@ elementBuffer<TYPE>::moveEraseBack(int index) {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> TYPE*
-elementBuffer<TYPE>::prepareInsert(int index, bool& outSlotConstructed) {
+template<class TYPE, int ALIGN> TYPE*
+elementBuffer<TYPE,ALIGN>::prepareInsert(int index, bool& outSlotConstructed) {
 
     // this method will return a pointer to an empty, destructed slot!
 
@@ -615,8 +638,8 @@ elementBuffer<TYPE>::prepareInsert(int index, bool& outSlotConstructed) {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-elementBuffer<TYPE>::insert(int index, const TYPE& elm) {
+template<class TYPE, int ALIGN> void
+elementBuffer<TYPE,ALIGN>::insert(int index, const TYPE& elm) {
     bool slotConstructed = true;
     TYPE* ptr = this->prepareInsert(index, slotConstructed);
     if (slotConstructed) {
@@ -628,8 +651,8 @@ elementBuffer<TYPE>::insert(int index, const TYPE& elm) {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-elementBuffer<TYPE>::insert(int index, TYPE&& elm) {
+template<class TYPE, int ALIGN> void
+elementBuffer<TYPE,ALIGN>::insert(int index, TYPE&& elm) {
     bool slotConstructed = true;
     TYPE* ptr = this->prepareInsert(index, slotConstructed);
     if (slotConstructed) {
@@ -641,8 +664,8 @@ elementBuffer<TYPE>::insert(int index, TYPE&& elm) {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-elementBuffer<TYPE>::erase(int index) {
+template<class TYPE, int ALIGN> void
+elementBuffer<TYPE,ALIGN>::erase(int index) {
     const int size = this->size();
     o_assert_dbg(this->buf && (index >= 0) && (index < size));
     
@@ -670,8 +693,8 @@ elementBuffer<TYPE>::erase(int index) {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-elementBuffer<TYPE>::eraseSwap(int index) {
+template<class TYPE, int ALIGN> void
+elementBuffer<TYPE,ALIGN>::eraseSwap(int index) {
     const int size = this->size();
     o_assert_dbg(this->buf && (index >= 0) && (index < size));
     
@@ -705,8 +728,8 @@ elementBuffer<TYPE>::eraseSwap(int index) {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-elementBuffer<TYPE>::eraseSwapBack(int index) {
+template<class TYPE, int ALIGN> void
+elementBuffer<TYPE,ALIGN>::eraseSwapBack(int index) {
     const int size = this->size();
     o_assert_dbg(this->buf && (index >= 0) && (index < size));
     if (index == (size - 1)) {
@@ -724,8 +747,8 @@ elementBuffer<TYPE>::eraseSwapBack(int index) {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-elementBuffer<TYPE>::eraseSwapFront(int index) {
+template<class TYPE, int ALIGN> void
+elementBuffer<TYPE,ALIGN>::eraseSwapFront(int index) {
     o_assert_dbg(this->buf && (index >= 0) && (index < this->size()));
     if (0 == index) {
         // special case: first element
@@ -742,8 +765,8 @@ elementBuffer<TYPE>::eraseSwapFront(int index) {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> void
-elementBuffer<TYPE>::eraseRange(int index, int num) {
+template<class TYPE, int ALIGN> void
+elementBuffer<TYPE,ALIGN>::eraseRange(int index, int num) {
     o_assert_dbg(this->buf && (index>=0) && ((index+num) <= this->size()) && (num >= 0));
     if (0 == num) {
         return;
@@ -763,8 +786,8 @@ elementBuffer<TYPE>::eraseRange(int index, int num) {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> TYPE
-elementBuffer<TYPE>::popBack() {
+template<class TYPE, int ALIGN> TYPE
+elementBuffer<TYPE,ALIGN>::popBack() {
     o_assert_dbg(this->buf && (this->end > this->start));
     o_assert_dbg((this->end > 0) && (this->end <= this->cap));
     TYPE val(std::move(this->buf[--this->end]));
@@ -773,8 +796,8 @@ elementBuffer<TYPE>::popBack() {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> TYPE
-elementBuffer<TYPE>::popFront() {
+template<class TYPE, int ALIGN> TYPE
+elementBuffer<TYPE,ALIGN>::popFront() {
     o_assert_dbg(this->buf && (this->start < this->end));
     o_assert_range_dbg(this->start, this->cap);
     TYPE val(std::move(this->buf[this->start]));
@@ -783,8 +806,8 @@ elementBuffer<TYPE>::popFront() {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> TYPE*
-elementBuffer<TYPE>::_begin() {
+template<class TYPE, int ALIGN> TYPE*
+elementBuffer<TYPE,ALIGN>::_begin() {
     if (this->buf) {
         // NOTE: the returned pointer may point to invalid memory!
         return &this->buf[this->start];
@@ -795,8 +818,8 @@ elementBuffer<TYPE>::_begin() {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> const TYPE*
-elementBuffer<TYPE>::_begin() const {
+template<class TYPE, int ALIGN> const TYPE*
+elementBuffer<TYPE,ALIGN>::_begin() const {
     if (this->buf) {
         // NOTE: the returned pointer may point to invalid memory!
         return &this->buf[this->start];
@@ -807,8 +830,8 @@ elementBuffer<TYPE>::_begin() const {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> TYPE*
-elementBuffer<TYPE>::_end() {
+template<class TYPE, int ALIGN> TYPE*
+elementBuffer<TYPE,ALIGN>::_end() {
     if (this->buf) {
         // NOTE: the returned pointer may point to invalid memory!
         return &this->buf[this->end];
@@ -819,8 +842,8 @@ elementBuffer<TYPE>::_end() {
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE> const TYPE*
-elementBuffer<TYPE>::_end() const {
+template<class TYPE, int ALIGN> const TYPE*
+elementBuffer<TYPE,ALIGN>::_end() const {
     if (this->buf) {
         // NOTE: the returned pointer may point to invalid memory!
         return &this->buf[this->end];
@@ -0,0 +1,366 @@
+#pragma once
+//------------------------------------------------------------------------------
+/*
+    @class Oryol::_priv::hashIndex
+    @ingroup _priv
+
+    Open-addressing index table used by the HashMap and FlatHashSet
+    containers. The table maps hash values to indices into a dense
+    element array owned by the container. Each slot stores the full
+    32-bit hash and the element index (8 bytes per slot), so that
+    rehashing never needs to touch the elements, and most failed
+    probes are rejected without comparing keys.
+
+    Collisions are resolved with Robin Hood linear probing, erase
+    uses backward-shift deletion (no tombstones). The number of slots
+    is always a power of 2, and the table grows by doubling once
+    the number of used slots would exceed the max load factor.
+*/
+#include "Core/Types.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+
+namespace Oryol {
+namespace _priv {
+
+class hashIndex {
+public:
+    /// minimum number of slots
+    static const int MinNumSlots = 16;
+    /// default max load factor
+    static constexpr float DefaultMaxLoadFactor = 0.875f;
+
+    /// default constructor
+    hashIndex();
+    /// copy constructor
+    hashIndex(const hashIndex& rhs);
+    /// move constructor
+    hashIndex(hashIndex&& rhs);
+    /// destructor
+    ~hashIndex();
+
+    /// copy-assignment
+    void operator=(const hashIndex& rhs);
+    /// move-assignment
+    void operator=(hashIndex&& rhs);
+
+    /// finalize a user-provided hash value (MurmurHash3's fmix32)
+    static uint32_t mix(uint32_t h);
+
+    /// set the max load factor (between 0.25 and 0.95), may rehash
+    void setMaxLoadFactor(float f);
+    /// get the max load factor
+    float maxLoadFactor() const;
+    /// number of entries which fit into the index without growing
+    int capacity() const;
+    /// number of entries in the index
+    int size() const;
+
+    /// make room for numEntries entries in total
+    void reserve(int numEntries);
+    /// remove all entries (keeps slots)
+    void clear();
+    /// find an element index by hash, isMatch(int index) must compare the actual key
+    template<class MATCH> int find(uint32_t hash, const MATCH& isMatch) const;
+    /// insert an entry, grows the table if needed
+    void insert(uint32_t hash, int index);
+    /// erase an entry
+    void erase(uint32_t hash, int index);
+    /// change the element index of an entry (e.g. after a swap-back erase)
+    void reindex(uint32_t hash, int oldIndex, int newIndex);
+
+private:
+    /// an index slot
+    struct slot {
+        uint32_t hash;
+        int32_t index;      // InvalidIndex if slot is empty
+    };
+    /// compute capacity for a number of slots
+    int capacityFor(int slotCount) const;
+    /// get the probe distance of a slot at position
+    int probeDistance(const slot& s, int pos) const;
+    /// find slot position of an element index
+    int findSlotOfIndex(uint32_t hash, int index) const;
+    /// insert without growing
+    void insertSlot(uint32_t hash, int index);
+    /// rebuild the table with a new number of slots
+    void rehash(int newNumSlots);
+    /// free slots
+    void destroy();
+
+    slot* slots;
+    int numSlots;       // always 0 or 2^N
+    int numUsed;
+    float maxLoad;
+};
+
+//------------------------------------------------------------------------------
+inline
+hashIndex::hashIndex() :
+slots(nullptr),
+numSlots(0),
+numUsed(0),
+maxLoad(DefaultMaxLoadFactor) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+inline
+hashIndex::hashIndex(const hashIndex& rhs) :
+slots(nullptr),
+numSlots(0),
+numUsed(0),
+maxLoad(DefaultMaxLoadFactor) {
+    *this = rhs;
+}
+
+//------------------------------------------------------------------------------
+inline
+hashIndex::hashIndex(hashIndex&& rhs) :
+slots(nullptr),
+numSlots(0),
+numUsed(0),
+maxLoad(DefaultMaxLoadFactor) {
+    *this = std::move(rhs);
+}
+
+//------------------------------------------------------------------------------
+inline
+hashIndex::~hashIndex() {
+    this->destroy();
+}
+
+//------------------------------------------------------------------------------
+inline void
+hashIndex::operator=(const hashIndex& rhs) {
+    if (&rhs != this) {
+        this->destroy();
+        this->maxLoad = rhs.maxLoad;
+        if (rhs.slots) {
+            this->numSlots = rhs.numSlots;
+            this->numUsed = rhs.numUsed;
+            this->slots = (slot*) Memory::Alloc(this->numSlots * sizeof(slot));
+            Memory::Copy(rhs.slots, this->slots, this->numSlots * sizeof(slot));
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+inline void
+hashIndex::operator=(hashIndex&& rhs) {
+    if (&rhs != this) {
+        this->destroy();
+        this->slots = rhs.slots;
+        this->numSlots = rhs.numSlots;
+        this->numUsed = rhs.numUsed;
+        this->maxLoad = rhs.maxLoad;
+        rhs.slots = nullptr;
+        rhs.numSlots = 0;
+        rhs.numUsed = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+inline void
+hashIndex::destroy() {
+    if (this->slots) {
+        Memory::Free(this->slots);
+        this->slots = nullptr;
+    }
+    this->numSlots = 0;
+    this->numUsed = 0;
+}
+
+//------------------------------------------------------------------------------
+inline uint32_t
+hashIndex::mix(uint32_t h) {
+    // make sure that simple user hash functions (e.g. identity)
+    // still spread well over the slots
+    h ^= h >> 16;
+    h *= 0x85ebca6b;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35;
+    h ^= h >> 16;
+    return h;
+}
+
+//------------------------------------------------------------------------------
+inline void
+hashIndex::setMaxLoadFactor(float f) {
+    o_assert((f >= 0.25f) && (f <= 0.95f));
+    this->maxLoad = f;
+    if (this->numUsed > this->capacity()) {
+        this->reserve(this->numUsed);
+    }
+}
+
+//------------------------------------------------------------------------------
+inline float
+hashIndex::maxLoadFactor() const {
+    return this->maxLoad;
+}
+
+//------------------------------------------------------------------------------
+inline int
+hashIndex::capacityFor(int slotCount) const {
+    // always keep at least one slot empty, so that probing terminates
+    int cap = int(slotCount * this->maxLoad);
+    return cap < slotCount ? cap : slotCount - 1;
+}
+
+//------------------------------------------------------------------------------
+inline int
+hashIndex::capacity() const {
+    return this->numSlots > 0 ? this->capacityFor(this->numSlots) : 0;
+}
+
+//------------------------------------------------------------------------------
+inline int
+hashIndex::size() const {
+    return this->numUsed;
+}
+
+//------------------------------------------------------------------------------
+inline int
+hashIndex::probeDistance(const slot& s, int pos) const {
+    return (pos - int(s.hash & (this->numSlots - 1))) & (this->numSlots - 1);
+}
+
+//------------------------------------------------------------------------------
+inline void
+hashIndex::reserve(int numEntries) {
+    int newNumSlots = this->numSlots > 0 ? this->numSlots : MinNumSlots;
+    while (this->capacityFor(newNumSlots) < numEntries) {
+        newNumSlots *= 2;
+    }
+    if (newNumSlots != this->numSlots) {
+        this->rehash(newNumSlots);
+    }
+}
+
+//------------------------------------------------------------------------------
+inline void
+hashIndex::clear() {
+    for (int i = 0; i < this->numSlots; i++) {
+        this->slots[i].index = InvalidIndex;
+    }
+    this->numUsed = 0;
+}
+
+//------------------------------------------------------------------------------
+template<class MATCH> int
+hashIndex::find(uint32_t hash, const MATCH& isMatch) const {
+    if (0 == this->numSlots) {
+        return InvalidIndex;
+    }
+    const int mask = this->numSlots - 1;
+    int pos = hash & mask;
+    for (int dist = 0; ; dist++) {
+        const slot& s = this->slots[pos];
+        if ((InvalidIndex == s.index) || (dist > this->probeDistance(s, pos))) {
+            // Robin Hood invariant: the entry would have been placed before this slot
+            return InvalidIndex;
+        }
+        if ((s.hash == hash) && isMatch(int(s.index))) {
+            return s.index;
+        }
+        pos = (pos + 1) & mask;
+    }
+}
+
+//------------------------------------------------------------------------------
+inline int
+hashIndex::findSlotOfIndex(uint32_t hash, int index) const {
+    const int mask = this->numSlots - 1;
+    int pos = hash & mask;
+    while (this->slots[pos].index != index) {
+        o_assert_dbg(InvalidIndex != this->slots[pos].index);
+        pos = (pos + 1) & mask;
+    }
+    return pos;
+}
+
+//------------------------------------------------------------------------------
+inline void
+hashIndex::insertSlot(uint32_t hash, int index) {
+    const int mask = this->numSlots - 1;
+    slot cur = { hash, index };
+    int pos = hash & mask;
+    int dist = 0;
+    for (;;) {
+        slot& s = this->slots[pos];
+        if (InvalidIndex == s.index) {
+            s = cur;
+            return;
+        }
+        // steal the slot from a 'richer' entry
+        const int sDist = this->probeDistance(s, pos);
+        if (sDist < dist) {
+            slot tmp = s;
+            s = cur;
+            cur = tmp;
+            dist = sDist;
+        }
+        pos = (pos + 1) & mask;
+        dist++;
+    }
+}
+
+//------------------------------------------------------------------------------
+inline void
+hashIndex::insert(uint32_t hash, int index) {
+    if ((this->numUsed + 1) > this->capacity()) {
+        this->rehash(this->numSlots > 0 ? this->numSlots * 2 : MinNumSlots);
+    }
+    this->insertSlot(hash, index);
+    this->numUsed++;
+}
+
+//------------------------------------------------------------------------------
+inline void
+hashIndex::erase(uint32_t hash, int index) {
+    const int mask = this->numSlots - 1;
+    int pos = this->findSlotOfIndex(hash, index);
+    for (;;) {
+        const int next = (pos + 1) & mask;
+        const slot& s = this->slots[next];
+        if ((InvalidIndex == s.index) || (0 == this->probeDistance(s, next))) {
+            this->slots[pos].index = InvalidIndex;
+            break;
+        }
+        this->slots[pos] = s;
+        pos = next;
+    }
+    this->numUsed--;
+}
+
+//------------------------------------------------------------------------------
+inline void
+hashIndex::reindex(uint32_t hash, int oldIndex, int newIndex) {
+    this->slots[this->findSlotOfIndex(hash, oldIndex)].index = newIndex;
+}
+
+//------------------------------------------------------------------------------
+inline void
+hashIndex::rehash(int newNumSlots) {
+    o_assert_dbg((newNumSlots & (newNumSlots - 1)) == 0);
+    slot* oldSlots = this->slots;
+    const int oldNumSlots = this->numSlots;
+    this->numSlots = newNumSlots;
+    this->slots = (slot*) Memory::Alloc(newNumSlots * sizeof(slot));
+    for (int i = 0; i < newNumSlots; i++) {
+        this->slots[i].index = InvalidIndex;
+    }
+    if (oldSlots) {
+        // the slots store the full hash, so elements don't need to be re-hashed
+        for (int i = 0; i < oldNumSlots; i++) {
+            if (InvalidIndex != oldSlots[i].index) {
+                this->insertSlot(oldSlots[i].hash, oldSlots[i].index);
+            }
+        }
+        Memory::Free(oldSlots);
+    }
+}
+
+} // namespace _priv
+} // namespace Oryol
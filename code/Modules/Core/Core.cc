@@ -4,8 +4,13 @@
 #include "Pre.h"
 #include "Core.h"
 #include "Core/RunLoop.h"
+#include "Core/Memory/FrameAllocator.h"
 #include "Core/Threading/ThreadLocalPtr.h"
+#include "Core/Threading/JobSystem.h"
+#include "Core/Time/FrameStats.h"
+#include "Core/Time/Clock.h"
 #include "Core/Trace.h"
+#include "Core/Log.h"
 #include <thread>
 
 namespace Oryol {
@@ -15,6 +20,7 @@ namespace {
     ORYOL_THREADLOCAL_PTR(RunLoop) threadPostRunLoop = nullptr;
     struct _state {
         std::thread::id mainThreadId;
+        int frameAllocatorCapacity = FrameAllocator::DefaultCapacity;
         #if ORYOL_PROFILING
         Trace trace;
         #endif
@@ -24,14 +30,33 @@ namespace {
 
 //------------------------------------------------------------------------------
 void
-Core::Setup() {
+Core::Setup(const CoreSetup& setup) {
     o_assert_dbg(!IsValid());
     o_assert_dbg(nullptr == threadPreRunLoop);
     o_assert_dbg(nullptr == threadPostRunLoop);
+
+    // install allocators first, memory allocated before will 
+    // still be freed through the old allocator
+    for (int i = 0; i < MemoryTag::NumMemoryTags; i++) {
+        Memory::SetAllocator((MemoryTag::Code)i, setup.Allocators[i]);
+    }
+    Memory::ScopedTag memTag(MemoryTag::Core);
     state = Memory::New<_state>();
     state->mainThreadId = std::this_thread::get_id();
+    state->frameAllocatorCapacity = setup.FrameAllocatorCapacity;
     threadPreRunLoop = Memory::New<RunLoop>();
     threadPostRunLoop = Memory::New<RunLoop>();
+    setupFrameAllocator();
+    FrameStats::Reset();
+    FrameStats::SetTargetFrameRate(setup.TargetFrameRate);
+    // calibrate the Clock tick rate up front instead of on first use
+    Clock::TicksPerSecond();
+
+    // start the job system last, the worker threads enter the Core module
+    JobSystem::Setup(setup.NumJobWorkers);
+    if (setup.AsyncLogging) {
+        Log::SetAsync(true);
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -40,6 +65,11 @@ Core::Discard() {
     o_assert(IsValid());
     o_assert(threadPreRunLoop);
     o_assert(threadPostRunLoop);
+    if (Log::IsAsync()) {
+        Log::SetAsync(false);
+    }
+    JobSystem::Discard();
+    discardFrameAllocator();
     Memory::Delete<RunLoop>(threadPreRunLoop);
     Memory::Delete<RunLoop>(threadPostRunLoop);
     Memory::Delete(state);
@@ -47,6 +77,12 @@ Core::Discard() {
     threadPostRunLoop = nullptr;
     state = nullptr;
 
+    // reset allocators to malloc, memory which is still alive will
+    // be freed through the allocator it has been allocated with!
+    for (int i = 0; i < MemoryTag::NumMemoryTags; i++) {
+        Memory::SetAllocator((MemoryTag::Code)i, nullptr);
+    }
+
     // do NOT destroy the thread-local string atom table to
     // ensure that string atom data pointers still point to valid data!!!    
 }
@@ -86,10 +122,16 @@ Core::IsMainThread() {
 void
 Core::EnterThread() {
     #if ORYOL_HAS_THREADS
+    #if ORYOL_THREADLOCAL_PTHREAD
+    // create the thread's pointer table first, the thread-locals below live in it
+    ThreadLocalData::EnterThread();
+    #endif
     o_assert(nullptr == threadPreRunLoop);
     o_assert(nullptr == threadPostRunLoop);
+    Memory::ScopedTag memTag(MemoryTag::Core);
     threadPreRunLoop = Memory::New<RunLoop>();
     threadPostRunLoop = Memory::New<RunLoop>();
+    setupFrameAllocator();
     #endif
 }
 
@@ -99,6 +141,7 @@ Core::LeaveThread() {
     #if ORYOL_HAS_THREADS
     o_assert(threadPreRunLoop);
     o_assert(threadPostRunLoop);
+    discardFrameAllocator();
     Memory::Delete<RunLoop>(threadPreRunLoop);
     Memory::Delete<RunLoop>(threadPostRunLoop);
     threadPreRunLoop = nullptr;
@@ -106,7 +149,36 @@ Core::LeaveThread() {
 
     // do NOT destroy the thread-local string atom table to
     // ensure that string atom data pointers still point to valid data
+    // (only the thread's pointer table is freed)
+    #if ORYOL_THREADLOCAL_PTHREAD
+    ThreadLocalData::LeaveThread();
     #endif
+    #endif
+}
+
+//------------------------------------------------------------------------------
+/**
+    Create the current thread's frame allocator and hook its reset 
+    into the thread's PostRunLoop, the memory region itself is only 
+    allocated when the frame allocator is used for the first time.
+*/
+void
+Core::setupFrameAllocator() {
+    o_assert(nullptr == FrameAllocator::ThreadLocal());
+    const int capacity = state ? state->frameAllocatorCapacity : FrameAllocator::DefaultCapacity;
+    FrameAllocator::SetThreadLocal(Memory::New<FrameAllocator>("FrameAllocator", capacity));
+    threadPostRunLoop->Add([]() {
+        FrameAllocator::ThreadLocal()->Reset();
+    });
+}
+
+//------------------------------------------------------------------------------
+void
+Core::discardFrameAllocator() {
+    FrameAllocator* frameAllocator = FrameAllocator::ThreadLocal();
+    o_assert(frameAllocator);
+    FrameAllocator::SetThreadLocal(nullptr);
+    Memory::Delete(frameAllocator);
 }
 
 } // namespace Oryol
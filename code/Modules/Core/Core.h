@@ -10,13 +10,14 @@
 */
 #include "Core/Types.h"
 #include "Core/RunLoop.h"
+#include "Core/CoreSetup.h"
 
 namespace Oryol {
 
 class Core {
 public:
     /// setup the Core module
-    static void Setup();
+    static void Setup(const CoreSetup& setup=CoreSetup());
     /// discard the Core module
     static void Discard();
     /// check if Core module has been setup
@@ -33,6 +34,12 @@ public:
     static void LeaveThread();
     /// test if we are on the main thread
     static bool IsMainThread();
+
+private:
+    /// create the current thread's frame allocator
+    static void setupFrameAllocator();
+    /// destroy the current thread's frame allocator
+    static void discardFrameAllocator();
 };
 
 } // namespace Oryol
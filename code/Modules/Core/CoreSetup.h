@@ -0,0 +1,63 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::CoreSetup
+    @ingroup Core
+    @brief configure the Core module
+
+    The CoreSetup object is handed to Core::Setup(). For Oryol applications,
+    Core::Setup() is called from App::StartMainLoop(), an App subclass can
+    configure the Core module by writing the App::coreSetup member in its
+    constructor.
+
+    The benchmark and replay members are usually set from the command
+    line (see App::parseBenchmarkArgs()).
+*/
+#include "Core/Memory/MemoryTag.h"
+#include "Core/Memory/FrameAllocator.h"
+#include "Core/Threading/JobSystem.h"
+#include "Core/String/String.h"
+#include "Core/Time/Duration.h"
+
+namespace Oryol {
+
+class Allocator;
+
+class CoreSetup {
+public:
+    /// default constructor
+    CoreSetup() :
+    FrameAllocatorCapacity(FrameAllocator::DefaultCapacity),
+    NumJobWorkers(JobSystem::AutoNumWorkers),
+    AsyncLogging(false),
+    TargetFrameRate(0),
+    BenchmarkFrames(0),
+    BenchmarkTimeStep(Duration::FromMicroSeconds(16667.0)),
+    BenchmarkOutputPath("benchmark.csv") {
+        for (int i = 0; i < MemoryTag::NumMemoryTags; i++) {
+            this->Allocators[i] = nullptr;
+        }
+    };
+    /// optional allocator backends by memory tag (nullptr: use malloc)
+    Allocator* Allocators[MemoryTag::NumMemoryTags];
+    /// initial capacity of per-thread frame allocators (grows on demand)
+    int FrameAllocatorCapacity;
+    /// number of JobSystem worker threads (AutoNumWorkers: one per core minus the main thread)
+    int NumJobWorkers;
+    /// write log messages on a background thread (see Log::SetAsync())
+    bool AsyncLogging;
+    /// frame pacer target frame rate, 0 for no pacing (see FrameStats)
+    int TargetFrameRate;
+    /// benchmark mode: number of Running frames until the App quits, 0 for normal mode
+    int BenchmarkFrames;
+    /// benchmark mode: the fixed simulated frame duration of Clock::Now()
+    Duration BenchmarkTimeStep;
+    /// benchmark mode: CSV file for the per-frame timings and allocation counts
+    String BenchmarkOutputPath;
+    /// play back a replay file (see Replay)
+    String ReplayPath;
+    /// record a replay file (see Replay)
+    String RecordPath;
+};
+
+} // namespace Oryol
@@ -0,0 +1,111 @@
+//------------------------------------------------------------------------------
+//  Counters.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "Counters.h"
+#include "Core/Assertion.h"
+#include "Core/TraceRecorder.h"
+#include <atomic>
+#include <cstring>
+#if ORYOL_HAS_THREADS
+#include <mutex>
+#endif
+
+namespace Oryol {
+
+namespace {
+    const char* names[Counters::MaxCounters];
+    std::atomic<int64_t> values[Counters::MaxCounters];
+    std::atomic<int> numCounters{0};
+    #if ORYOL_HAS_THREADS
+    std::mutex registerMutex;
+    #endif
+
+    //--------------------------------------------------------------------------
+    Counters::Id
+    findCounter(const char* name, int num) {
+        for (int i = 0; i < num; i++) {
+            if ((names[i] == name) || (0 == std::strcmp(names[i], name))) {
+                return i;
+            }
+        }
+        return Counters::InvalidId;
+    }
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+Counters::Id
+Counters::Register(const char* name) {
+    o_assert(nullptr != name);
+    #if ORYOL_HAS_THREADS
+    std::lock_guard<std::mutex> guard(registerMutex);
+    #endif
+    const int num = numCounters.load(std::memory_order_relaxed);
+    Id id = findCounter(name, num);
+    if (InvalidId == id) {
+        o_assert2(num < MaxCounters, "Too many counters registered!\n");
+        id = num;
+        names[id] = name;
+        values[id].store(0, std::memory_order_relaxed);
+        numCounters.store(num + 1, std::memory_order_release);
+    }
+    return id;
+}
+
+//------------------------------------------------------------------------------
+Counters::Id
+Counters::Find(const char* name) {
+    o_assert(nullptr != name);
+    return findCounter(name, numCounters.load(std::memory_order_acquire));
+}
+
+//------------------------------------------------------------------------------
+int
+Counters::NumCounters() {
+    return numCounters.load(std::memory_order_acquire);
+}
+
+//------------------------------------------------------------------------------
+const char*
+Counters::Name(Id id) {
+    o_assert_range_dbg(id, NumCounters());
+    return names[id];
+}
+
+//------------------------------------------------------------------------------
+int64_t
+Counters::Get(Id id) {
+    o_assert_range_dbg(id, NumCounters());
+    return values[id].load(std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+void
+Counters::Set(Id id, int64_t value) {
+    o_assert_range_dbg(id, NumCounters());
+    values[id].store(value, std::memory_order_relaxed);
+    if (TraceRecorder::IsRecording()) {
+        TraceRecorder::Counter(names[id], value);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+Counters::Add(Id id, int64_t delta) {
+    o_assert_range_dbg(id, NumCounters());
+    const int64_t value = values[id].fetch_add(delta, std::memory_order_relaxed) + delta;
+    if (TraceRecorder::IsRecording()) {
+        TraceRecorder::Counter(names[id], value);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+Counters::ResetAll() {
+    const int num = numCounters.load(std::memory_order_acquire);
+    for (int i = 0; i < num; i++) {
+        values[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+} // namespace Oryol
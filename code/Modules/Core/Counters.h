@@ -0,0 +1,63 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::Counters
+    @ingroup Core
+    @brief process-wide registry of named numeric counters
+
+    Counters are named 64-bit integer values which subsystems update
+    in their hot paths (e.g. bytes read by the IO workers, pending
+    resource loaders, render states applied or skipped by the Gfx state
+    cache). The current values can be queried at runtime by name or by
+    iterating over all registered counters, so that the numbers of a
+    single capture can be attributed to a subsystem. While the
+    TraceRecorder is recording, each update is also recorded as a trace
+    counter event.
+
+    Counters are usually updated through the o_trace_counter(name, value)
+    and o_trace_counter_add(name, delta) macros in Core/Trace.h, which
+    register the counter once and are compiled out without ORYOL_PROFILING.
+
+    @code
+    Counters::Id id = Counters::Find("IO_BytesRead");
+    if (Counters::InvalidId != id) {
+        Log::Info("%s: %lld\n", Counters::Name(id), (long long)Counters::Get(id));
+    }
+    @endcode
+
+    Updating a counter is a relaxed atomic operation, registering a
+    counter takes a lock. Counter names must be static strings, since only
+    the pointer is stored. Counters are never unregistered.
+*/
+#include "Core/Types.h"
+
+namespace Oryol {
+
+class Counters {
+public:
+    /// a counter id
+    typedef int Id;
+    /// an invalid counter id
+    static const Id InvalidId = -1;
+    /// max number of registered counters
+    static const int MaxCounters = 256;
+
+    /// register a counter (returns the existing id if a counter with this name exists)
+    static Id Register(const char* name);
+    /// find a counter by name, return InvalidId if not registered
+    static Id Find(const char* name);
+    /// get number of registered counters (ids are 0..NumCounters()-1)
+    static int NumCounters();
+    /// get the name of a counter
+    static const char* Name(Id id);
+    /// get the current value of a counter
+    static int64_t Get(Id id);
+    /// set a counter value
+    static void Set(Id id, int64_t value);
+    /// add to a counter value
+    static void Add(Id id, int64_t delta);
+    /// reset all counter values to zero
+    static void ResetAll();
+};
+
+} // namespace Oryol
@@ -3,11 +3,13 @@
 //------------------------------------------------------------------------------
 #include "Pre.h"
 #include <cstdio>
+#include <cstring>
 #include "Core/Log.h"
 #include "Core/Assertion.h"
 #include "Core/Logger.h"
 #include "Core/StackTrace.h"
 #include "Core/Containers/Array.h"
+#include "Core/Time/Clock.h"
 #if ORYOL_WINDOWS
 #include <Windows.h>
 #endif
@@ -17,6 +19,11 @@
 
 #if ORYOL_HAS_THREADS
 #include <mutex>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include "Core/Containers/SPSCQueue.h"
+#include "Core/Threading/ThreadLocalPtr.h"
 static std::mutex lockMutex;
 #define SCOPED_LOCK std::lock_guard<std::mutex> lock(lockMutex)
 #else
@@ -35,6 +42,73 @@ using namespace std;
 static Log::Level curLogLevel = Log::Level::Dbg;
 static Array<Ptr<Logger>> loggers;
 
+#if ORYOL_HAS_THREADS
+namespace {
+    // a formatted message in a thread's async queue
+    struct asyncMessage {
+        asyncMessage() { };
+        asyncMessage(uint64_t seq_, int64_t time_, Log::Level level_, const char* msg_) :
+        seq(seq_), time(time_), level(level_) {
+            std::strncpy(this->msg, msg_, sizeof(this->msg));
+            this->msg[Log::MaxAsyncMessageLength] = 0;
+        };
+        uint64_t seq = 0;
+        int64_t time = 0;
+        Log::Level level = Log::Level::InvalidLevel;
+        char msg[Log::MaxAsyncMessageLength + 1];
+    };
+    // a thread's async queue, the thread is the only producer,
+    // the async log thread the only consumer
+    struct asyncQueue {
+        asyncQueue(int index_) : index(index_), queue(Log::AsyncQueueSize) { };
+        int index;
+        SPSCQueue<asyncMessage> queue;
+        std::atomic<int64_t> numDropped{0};
+        // only accessed by the consumer
+        int64_t numDroppedReported = 0;
+        bool hasHead = false;
+        asyncMessage head;
+    };
+    // NOTE: queues are never destroyed, since threads keep a pointer
+    // to their queue (same as the thread-local string atom tables)
+    asyncQueue* queues[Log::MaxAsyncThreads];
+    std::atomic<int> numQueues{0};
+    std::mutex queuesMutex;
+    ORYOL_THREADLOCAL_PTR(asyncQueue) threadQueue = nullptr;
+
+    std::atomic<bool> asyncEnabled{false};
+    std::atomic<bool> asyncStop{false};
+    std::atomic<uint64_t> nextSeq{0};
+    std::atomic<uint64_t> numDone{0};       // written messages, also the next seq to write
+    std::atomic<int64_t> numDropped{0};
+    std::thread asyncThread;
+    ORYOL_THREADLOCAL_PTR(std::thread) isAsyncThread = nullptr;
+    std::mutex wakeMutex;
+    std::condition_variable wakeCond;
+
+    //--------------------------------------------------------------------------
+    asyncQueue*
+    getThreadQueue() {
+        if (nullptr == threadQueue) {
+            if (numQueues.load(std::memory_order_relaxed) >= Log::MaxAsyncThreads) {
+                return nullptr;
+            }
+            std::lock_guard<std::mutex> guard(queuesMutex);
+            const int index = numQueues.load(std::memory_order_relaxed);
+            if (index >= Log::MaxAsyncThreads) {
+                return nullptr;
+            }
+            asyncQueue* q = Memory::New<asyncQueue>(index);
+            queues[index] = q;
+            numQueues.store(index + 1, std::memory_order_release);
+            threadQueue = q;
+        }
+        return threadQueue;
+    }
+} // anonymous namespace
+#endif
+
+
 //------------------------------------------------------------------------------
 void
 Log::AddLogger(const Ptr<Logger>& l) {
@@ -44,6 +118,16 @@ Log::AddLogger(const Ptr<Logger>& l) {
     }
 }
 
+//------------------------------------------------------------------------------
+void
+Log::RemoveLogger(const Ptr<Logger>& l) {
+    SCOPED_LOCK;
+    const int index = loggers.FindIndexLinear(l);
+    if (InvalidIndex != index) {
+        loggers.Erase(index);
+    }
+}
+
 //------------------------------------------------------------------------------
 int
 Log::GetNumLoggers() {
@@ -144,10 +228,223 @@ Log::VError(const char* msg, va_list args) {
     }
 }
 
+//------------------------------------------------------------------------------
+void
+Log::SetAsync(bool async) {
+    #if ORYOL_HAS_THREADS
+    if (async == asyncEnabled.load()) {
+        return;
+    }
+    if (async) {
+        asyncStop.store(false);
+        asyncThread = std::thread(asyncThreadFunc);
+        asyncEnabled.store(true);
+    }
+    else {
+        // new messages are written synchronously from now on, the
+        // log thread writes the queued messages before it exits
+        asyncEnabled.store(false);
+        {
+            std::lock_guard<std::mutex> guard(wakeMutex);
+            asyncStop.store(true);
+        }
+        wakeCond.notify_one();
+        asyncThread.join();
+        drainAsync();
+    }
+    #endif
+}
+
+//------------------------------------------------------------------------------
+bool
+Log::IsAsync() {
+    #if ORYOL_HAS_THREADS
+    return asyncEnabled.load(std::memory_order_relaxed);
+    #else
+    return false;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+Log::Flush() {
+    #if ORYOL_HAS_THREADS
+    if (!asyncEnabled.load() || (nullptr != isAsyncThread)) {
+        return;
+    }
+    const uint64_t target = nextSeq.load();
+    while (numDone.load(std::memory_order_acquire) < target) {
+        wakeCond.notify_one();
+        std::this_thread::yield();
+    }
+    #endif
+}
+
+//------------------------------------------------------------------------------
+int64_t
+Log::NumDropped() {
+    #if ORYOL_HAS_THREADS
+    return numDropped.load(std::memory_order_relaxed);
+    #else
+    return 0;
+    #endif
+}
+
 //------------------------------------------------------------------------------
 void
 Log::vprint(Level lvl, const char* msg, va_list args) {
+    #if ORYOL_HAS_THREADS
+    if (asyncEnabled.load(std::memory_order_relaxed)) {
+        asyncQueue* q = (Level::Error != lvl) ? getThreadQueue() : nullptr;
+        if (q) {
+            // format on this thread, but leave the actual output
+            // to the log thread, this doesn't take any locks
+            if (q->queue.Size() < q->queue.Capacity()) {
+                char buf[MaxAsyncMessageLength + 1];
+                std::vsnprintf(buf, sizeof(buf), msg, args);
+                const int64_t time = Clock::Now().getRaw();
+                const uint64_t seq = nextSeq.fetch_add(1);
+                // this can't fail since this thread is the only producer
+                // of its queue, and there was a free slot, so the log
+                // thread will never wait for a sequence number which
+                // doesn't arrive
+                const bool enqueued = q->queue.Enqueue(seq, time, lvl, buf);
+                o_assert_dbg(enqueued);
+                (void)enqueued;
+                return;
+            }
+            q->numDropped.fetch_add(1, std::memory_order_relaxed);
+            numDropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        // errors, and threads without a queue are written synchronously,
+        // but only after the queued messages to keep the order
+        Flush();
+    }
+    #endif
     SCOPED_LOCK;
+    write(lvl, msg, args);
+}
+
+//------------------------------------------------------------------------------
+void
+Log::writef(Level lvl, const char* msg, ...) {
+    va_list args;
+    va_start(args, msg);
+    write(lvl, msg, args);
+    va_end(args);
+}
+
+//------------------------------------------------------------------------------
+void
+Log::writeRecord(const Record& rec) {
+    if (loggers.Empty()) {
+        writef(rec.LogLevel, "%s", rec.Message);
+    }
+    else {
+        for (const auto& l : loggers) {
+            l->PrintRecord(rec);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    Writes the messages of all thread queues in strict sequence number
+    order. Only the message with the next expected sequence number is
+    written, if a producer thread has already taken that sequence number
+    but hasn't enqueued its message yet, this waits for the message to
+    show up instead of writing a later message first. This must only be
+    called from one thread at a time (the async log thread, or the
+    thread which switches async mode off).
+*/
+int
+Log::drainAsync() {
+    int numWritten = 0;
+    #if ORYOL_HAS_THREADS
+    SCOPED_LOCK;
+    for (;;) {
+        const uint64_t expected = numDone.load(std::memory_order_relaxed);
+        if (expected == nextSeq.load(std::memory_order_acquire)) {
+            break;
+        }
+        // producer threads may have been added since the last round
+        const int num = numQueues.load(std::memory_order_acquire);
+        asyncQueue* next = nullptr;
+        for (int i = 0; i < num; i++) {
+            asyncQueue* q = queues[i];
+            if (!q->hasHead) {
+                q->hasHead = q->queue.Dequeue(q->head);
+            }
+            if (q->hasHead && (expected == q->head.seq)) {
+                next = q;
+                break;
+            }
+        }
+        if (nullptr == next) {
+            // the sequence number has been taken, but the message is
+            // not enqueued yet (the producer is only a few instructions
+            // away from this, unless it has been preempted)
+            std::this_thread::yield();
+            continue;
+        }
+        Record rec;
+        rec.LogLevel = next->head.level;
+        rec.SequenceNumber = next->head.seq;
+        rec.Time = TimePoint(next->head.time);
+        rec.ThreadIndex = next->index;
+        rec.Message = next->head.msg;
+        writeRecord(rec);
+        next->hasHead = false;
+        numWritten++;
+        numDone.fetch_add(1, std::memory_order_release);
+    }
+
+    // report dropped messages
+    const int num = numQueues.load(std::memory_order_acquire);
+    for (int i = 0; i < num; i++) {
+        asyncQueue* q = queues[i];
+        const int64_t dropped = q->numDropped.load(std::memory_order_relaxed);
+        if (dropped != q->numDroppedReported) {
+            char buf[128];
+            std::snprintf(buf, sizeof(buf), "Log: %d messages of thread %d dropped (queue full)\n",
+                int(dropped - q->numDroppedReported), q->index);
+            q->numDroppedReported = dropped;
+            Record rec;
+            rec.LogLevel = Level::Warn;
+            rec.SequenceNumber = nextSeq.load(std::memory_order_relaxed);
+            rec.Time = Clock::Now();
+            rec.ThreadIndex = q->index;
+            rec.Message = buf;
+            writeRecord(rec);
+        }
+    }
+    #endif
+    return numWritten;
+}
+
+//------------------------------------------------------------------------------
+void
+Log::asyncThreadFunc() {
+    #if ORYOL_HAS_THREADS
+    isAsyncThread = &asyncThread;
+    while (!asyncStop.load()) {
+        if (0 == drainAsync()) {
+            // producers don't wake the log thread (this would need a lock),
+            // instead poll with a short timeout
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            if (!asyncStop.load()) {
+                wakeCond.wait_for(lock, std::chrono::milliseconds(2));
+            }
+        }
+    }
+    drainAsync();
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+Log::write(Level lvl, const char* msg, va_list args) {
     if (loggers.Empty()) {
         #if ORYOL_ANDROID
             android_LogPriority pri = ANDROID_LOG_DEFAULT;
@@ -189,6 +486,7 @@ Log::vprint(Level lvl, const char* msg, va_list args) {
 //------------------------------------------------------------------------------
 void
 Log::AssertMsg(const char* cond, const char* msg, const char* file, int line, const char* func) {
+    Flush();
     SCOPED_LOCK;
     if (loggers.Empty()) {
         char callstack[4096];
@@ -9,11 +9,24 @@
     output is logged to stdout and stderr, but custom Logger objects
     can be attached to handle log output differently.
 
+    By default, log messages are written synchronously on the calling
+    thread under a global lock. In async mode (SetAsync(true)), messages
+    are formatted on the calling thread into a per-thread lock-free
+    queue, and a background thread writes them to the loggers in the
+    order they were logged. The background thread hands timestamped
+    Log::Record objects to Logger::PrintRecord(). If a thread's queue is
+    full, the message is dropped, the number of dropped messages is
+    reported in the log output and by NumDropped(). Errors and
+    assert messages are always written synchronously (after the
+    queued messages have been flushed), so they are never lost
+    before a program abort.
+
     @see Logger
 */
 #include <cstdarg>
 #include "Core/Types.h"
 #include "Core/Config.h"
+#include "Core/Time/TimePoint.h"
 
 namespace Oryol {
 
@@ -33,9 +46,31 @@ public:
         NumLevels,
         InvalidLevel
     };
+    /// max message length in async mode (longer messages are truncated)
+    static const int MaxAsyncMessageLength = 480;
+    /// number of queued messages per thread in async mode
+    static const int AsyncQueueSize = 128;
+    /// max number of threads with their own queue in async mode (others log synchronously)
+    static const int MaxAsyncThreads = 32;
+
+    /// a timestamped log record, written by the async log thread
+    struct Record {
+        /// the log level
+        Log::Level LogLevel = Level::InvalidLevel;
+        /// the global sequence number (increases in logging order)
+        uint64_t SequenceNumber = 0;
+        /// time when the message was logged
+        TimePoint Time;
+        /// index of the logging thread (in order of the thread's first log message)
+        int ThreadIndex = 0;
+        /// the formatted message
+        const char* Message = nullptr;
+    };
 
     /// add a logger object
     static void AddLogger(const Ptr<Logger>& p);
+    /// remove a logger object
+    static void RemoveLogger(const Ptr<Logger>& p);
     /// get number of loggers
     static int GetNumLoggers();
     /// get logger at index
@@ -45,6 +80,16 @@ public:
     static void SetLogLevel(Level l);
     /// get current log level
     static Level GetLogLevel();
+
+    /// switch async logging on or off (don't call while other threads are logging)
+    static void SetAsync(bool async);
+    /// return true if async logging is on
+    static bool IsAsync();
+    /// block until all queued async messages have been written
+    static void Flush();
+    /// get number of messages dropped because an async queue was full
+    static int64_t NumDropped();
+
     /// print a debug message
     static void Dbg(const char* msg, ...) __attribute__((format(printf, 1, 2)));
     /// print a debug message (with va_list)
@@ -67,6 +112,16 @@ public:
 private:
     /// generic vprint-style method
     static void vprint(Level l, const char* msg, va_list args) __attribute__((format(printf, 2, 0)));
+    /// write a message to the loggers or stdout (caller must hold the lock)
+    static void write(Level l, const char* msg, va_list args) __attribute__((format(printf, 2, 0)));
+    /// printf-style version of write()
+    static void writef(Level l, const char* msg, ...) __attribute__((format(printf, 2, 3)));
+    /// write a record to the loggers or stdout (caller must hold the lock)
+    static void writeRecord(const Record& rec);
+    /// write all queued async messages, return number of written messages
+    static int drainAsync();
+    /// async log thread function
+    static void asyncThreadFunc();
 };
 
 /// shortcut for Log::Dbg()
@@ -22,6 +22,22 @@ Logger::VPrint(Log::Level /*l*/, const char* /*msg*/, va_list /*args*/) {
     // we can't do an o_error() here since it would recurse
 }
 
+//------------------------------------------------------------------------------
+namespace {
+    void printf_helper(Logger* logger, Log::Level l, const char* msg, ...) {
+        va_list args;
+        va_start(args, msg);
+        logger->VPrint(l, msg, args);
+        va_end(args);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+Logger::PrintRecord(const Log::Record& rec) {
+    printf_helper(this, rec.LogLevel, "%s", rec.Message);
+}
+
 //------------------------------------------------------------------------------
 /**
  */
@@ -30,4 +46,4 @@ Logger::AssertMsg(const char* /*cond*/, const char* /*msg*/, const char* /*file*
     // we can't do an o_error() here since it would recurse
 }
 
-} // namespace Oryol
\ No newline at end of file
+} // namespace Oryol
\ No newline at end of file
@@ -24,6 +24,8 @@ public:
     ~Logger();
     /// generic vprint-style method
     virtual void VPrint(Log::Level l, const char* msg, va_list args);
+    /// print a timestamped record in async mode (default calls VPrint())
+    virtual void PrintRecord(const Log::Record& rec);
     /// print an assert message
     virtual void AssertMsg(const char* cond, const char* msg, const char* file, int line, const char* func);
 };
@@ -29,6 +29,7 @@ Oryol::Args OryolArgs; \
 int main(int argc, const char** argv) { \
     OryolArgs = Oryol::Args(argc, argv); \
     clazz* app = Oryol::Memory::New<clazz>(); \
+    app->parseBenchmarkArgs(OryolArgs); \
     app->StartMainLoop(); \
     Oryol::Memory::Delete(app); \
     return 0; \
@@ -40,6 +41,7 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE prevInstance, LPSTR lpCmdLine,
     Oryol::WideString cmdLine = ::GetCommandLineW(); \
     OryolArgs = Oryol::Args(cmdLine); \
     clazz* app = Oryol::Memory::New<clazz>(); \
+    app->parseBenchmarkArgs(OryolArgs); \
     app->StartMainLoop(); \
     Oryol::Memory::Delete<clazz>(app); \
     return 0; \
@@ -62,6 +64,7 @@ Oryol::Args OryolArgs; \
 int main(int argc, const char** argv) { \
     OryolArgs = Oryol::Args(argc, argv); \
     clazz* app = Oryol::Memory::New<clazz>(); \
+    app->parseBenchmarkArgs(OryolArgs); \
     app->StartMainLoop(); \
     Oryol::Memory::Delete(app); \
     return 0; \
@@ -0,0 +1,371 @@
+//------------------------------------------------------------------------------
+//  AllocationTracker.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "AllocationTracker.h"
+#include "Core/Log.h"
+#include <algorithm>
+#if ORYOL_ALLOCATION_TRACKING
+#include "Core/StackTrace.h"
+#include "Core/Threading/ThreadLocalPtr.h"
+#include <cstdlib>
+#include <cstring>
+#if ORYOL_HAS_THREADS
+#include <mutex>
+#endif
+#endif
+
+namespace Oryol {
+
+#if ORYOL_ALLOCATION_TRACKING
+namespace {
+    // NOTE: all tracker state lives in malloc'ed memory to not 
+    // recurse into Memory::Alloc(), call-sites which don't fit 
+    // into the table are only counted in the totals
+    const int MaxCallSites = 8192;      // must be 2^N
+    const int StackTraceSize = 2048;
+    AllocationTracker::CallSite* callSites = nullptr;
+    int numCallSites = 0;
+    AllocationTracker::Counters total;
+    int sampleRate = 0;
+    #if ORYOL_HAS_THREADS
+    std::mutex lockMutex;
+    #define SCOPED_LOCK std::lock_guard<std::mutex> lock(lockMutex)
+    #else
+    #define SCOPED_LOCK
+    #endif
+
+    // per-thread allocation counters, these are never freed
+    struct threadCounters {
+        int64_t numAllocs;
+        int64_t allocBytes;
+        int ignore;             // >0 inside the tracker, guards against reentrancy
+    };
+    #if ORYOL_THREADLOCAL_PTHREAD
+    ThreadLocalPtr<threadCounters, ThreadLocalData::AllocationTrackerSlot>& threadPtr() {
+        static ThreadLocalPtr<threadCounters, ThreadLocalData::AllocationTrackerSlot> ptr;
+        return ptr;
+    }
+    #else
+    ORYOL_THREADLOCAL_PTR(threadCounters) threadCountersPtr = nullptr;
+    threadCounters*& threadPtr() {
+        return threadCountersPtr;
+    }
+    #endif
+    threadCounters* thisThread() {
+        threadCounters* counters = threadPtr();
+        if (nullptr == counters) {
+            counters = (threadCounters*) std::calloc(1, sizeof(threadCounters));
+            threadPtr() = counters;
+        }
+        return counters;
+    }
+
+    // the return addresses which identify a call-site
+    struct callStack {
+        const void* frames[AllocationTracker::CallSiteDepth] = { };
+    };
+
+    // capture the call-stack starting at the Memory function caller, the
+    // frames of the tracker and Memory functions are skipped by searching
+    // for the caller's return address (their number depends on inlining)
+    void captureCallStack(const void* callSite, callStack& outStack) {
+        outStack.frames[0] = callSite;
+        const int maxFrames = AllocationTracker::CallSiteDepth + 8;
+        void* frames[maxFrames];
+        const int numFrames = StackTrace::Capture(frames, maxFrames);
+        for (int i = 0; i < numFrames; i++) {
+            if (frames[i] == callSite) {
+                for (int j = 1; (j < AllocationTracker::CallSiteDepth) && ((i + j) < numFrames); j++) {
+                    outStack.frames[j] = frames[i + j];
+                }
+                break;
+            }
+        }
+    }
+
+    bool sameCallStack(const AllocationTracker::CallSite& site, const callStack& stack) {
+        if (site.Address != stack.frames[0]) {
+            return false;
+        }
+        for (int i = 1; i < AllocationTracker::CallSiteDepth; i++) {
+            if (site.Callers[i - 1] != stack.frames[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // lookup or add a call-site, must be called with lock held
+    int lookupCallSite(const callStack& stack) {
+        if (nullptr == callSites) {
+            callSites = (AllocationTracker::CallSite*) std::calloc(MaxCallSites, sizeof(AllocationTracker::CallSite));
+        }
+        uint32_t hash = 0;
+        for (const void* frame : stack.frames) {
+            hash = (hash ^ uint32_t(uintptr_t(frame) >> 2)) * 2654435761u;
+        }
+        for (int i = 0; i < MaxCallSites; i++) {
+            const int index = (hash + i) & (MaxCallSites - 1);
+            AllocationTracker::CallSite& site = callSites[index];
+            if (nullptr == site.Address) {
+                if (numCallSites >= (MaxCallSites / 2)) {
+                    // table too full, only count in totals
+                    return InvalidIndex;
+                }
+                numCallSites++;
+                site.Index = index;
+                site.Address = stack.frames[0];
+                for (int j = 1; j < AllocationTracker::CallSiteDepth; j++) {
+                    site.Callers[j - 1] = stack.frames[j];
+                }
+                return index;
+            }
+            else if (sameCallStack(site, stack)) {
+                return index;
+            }
+        }
+        return InvalidIndex;
+    }
+
+    void addAlloc(AllocationTracker::Counters& c, int numBytes) {
+        c.NumAllocs++;
+        c.AllocBytes += numBytes;
+        c.LiveBytes += numBytes;
+        if (c.LiveBytes > c.PeakBytes) {
+            c.PeakBytes = c.LiveBytes;
+        }
+    }
+
+    void addFree(AllocationTracker::Counters& c, int numBytes) {
+        c.NumFrees++;
+        c.LiveBytes -= numBytes;
+    }
+}
+
+//------------------------------------------------------------------------------
+int
+AllocationTracker::onAlloc(const void* callSite, int numBytes) {
+    threadCounters* counters = thisThread();
+    if (counters->ignore > 0) {
+        return Untracked;
+    }
+    counters->numAllocs++;
+    counters->allocBytes += numBytes;
+
+    // the stack capture functions may allocate, those allocations
+    // (and any Memory::Alloc() they might do) are not tracked
+    counters->ignore++;
+    callStack stack;
+    captureCallStack(callSite, stack);
+    int index;
+    bool captureStack = false;
+    {
+        SCOPED_LOCK;
+        addAlloc(total, numBytes);
+        index = lookupCallSite(stack);
+        if (InvalidIndex != index) {
+            addAlloc(callSites[index].Stats, numBytes);
+            captureStack = (sampleRate > 0) &&
+                           (0 == (total.NumAllocs % sampleRate)) &&
+                           (nullptr == callSites[index].Trace);
+        }
+    }
+    if (captureStack) {
+        // NOTE: call-stacks are captured once per call-site and never change
+        char buf[StackTraceSize];
+        StackTrace::Dump(buf, sizeof(buf));
+        const int len = int(std::strlen(buf)) + 1;
+        char* trace = (char*) std::malloc(len);
+        std::memcpy(trace, buf, len);
+        SCOPED_LOCK;
+        if (nullptr == callSites[index].Trace) {
+            callSites[index].Trace = trace;
+        }
+        else {
+            std::free(trace);
+        }
+    }
+    counters->ignore--;
+    return index;
+}
+
+//------------------------------------------------------------------------------
+void
+AllocationTracker::onFree(int callSiteIndex, int numBytes) {
+    if (Untracked == callSiteIndex) {
+        return;
+    }
+    SCOPED_LOCK;
+    addFree(total, numBytes);
+    if (InvalidIndex != callSiteIndex) {
+        addFree(callSites[callSiteIndex].Stats, numBytes);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+AllocationTracker::SetSampleRate(int everyNth) {
+    o_assert(everyNth >= 0);
+    SCOPED_LOCK;
+    sampleRate = everyNth;
+}
+
+//------------------------------------------------------------------------------
+int
+AllocationTracker::SampleRate() {
+    SCOPED_LOCK;
+    return sampleRate;
+}
+
+//------------------------------------------------------------------------------
+AllocationTracker::Snapshot
+AllocationTracker::TakeSnapshot() {
+    // allocations made by the snapshot itself are not tracked
+    threadCounters* counters = thisThread();
+    counters->ignore++;
+    Snapshot snapshot;
+    snapshot.CallSites.Reserve(MaxCallSites / 2);
+    {
+        SCOPED_LOCK;
+        snapshot.Total = total;
+        if (callSites) {
+            for (int i = 0; i < MaxCallSites; i++) {
+                if (callSites[i].Address) {
+                    snapshot.CallSites.Add(callSites[i]);
+                }
+            }
+        }
+    }
+    snapshot.CallSites.Trim();
+    counters->ignore--;
+    return snapshot;
+}
+
+//------------------------------------------------------------------------------
+int64_t
+AllocationTracker::ThreadNumAllocs() {
+    return thisThread()->numAllocs;
+}
+
+//------------------------------------------------------------------------------
+int64_t
+AllocationTracker::ThreadAllocBytes() {
+    return thisThread()->allocBytes;
+}
+
+#else // ORYOL_ALLOCATION_TRACKING
+
+//------------------------------------------------------------------------------
+int
+AllocationTracker::onAlloc(const void* /*callSite*/, int /*numBytes*/) {
+    return InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+void
+AllocationTracker::onFree(int /*callSiteIndex*/, int /*numBytes*/) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+void
+AllocationTracker::SetSampleRate(int /*everyNth*/) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+int
+AllocationTracker::SampleRate() {
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+AllocationTracker::Snapshot
+AllocationTracker::TakeSnapshot() {
+    return Snapshot();
+}
+
+//------------------------------------------------------------------------------
+int64_t
+AllocationTracker::ThreadNumAllocs() {
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+int64_t
+AllocationTracker::ThreadAllocBytes() {
+    return 0;
+}
+#endif // ORYOL_ALLOCATION_TRACKING
+
+//------------------------------------------------------------------------------
+AllocationTracker::Snapshot
+AllocationTracker::Diff(const Snapshot& before, const Snapshot& after) {
+    Snapshot diff;
+    diff.Total.NumAllocs  = after.Total.NumAllocs - before.Total.NumAllocs;
+    diff.Total.NumFrees   = after.Total.NumFrees - before.Total.NumFrees;
+    diff.Total.AllocBytes = after.Total.AllocBytes - before.Total.AllocBytes;
+    diff.Total.LiveBytes  = after.Total.LiveBytes - before.Total.LiveBytes;
+    diff.Total.PeakBytes  = after.Total.PeakBytes;
+
+    // both call-site arrays are sorted by call-site index, and 
+    // call-sites are never removed
+    int beforeIndex = 0;
+    for (const CallSite& site : after.CallSites) {
+        while ((beforeIndex < before.CallSites.Size()) && (before.CallSites[beforeIndex].Index < site.Index)) {
+            beforeIndex++;
+        }
+        CallSite d = site;
+        if ((beforeIndex < before.CallSites.Size()) && (before.CallSites[beforeIndex].Index == site.Index)) {
+            const Counters& prev = before.CallSites[beforeIndex].Stats;
+            d.Stats.NumAllocs  -= prev.NumAllocs;
+            d.Stats.NumFrees   -= prev.NumFrees;
+            d.Stats.AllocBytes -= prev.AllocBytes;
+            d.Stats.LiveBytes  -= prev.LiveBytes;
+        }
+        if ((d.Stats.NumAllocs != 0) || (d.Stats.NumFrees != 0)) {
+            diff.CallSites.Add(d);
+        }
+    }
+    return diff;
+}
+
+//------------------------------------------------------------------------------
+void
+AllocationTracker::Dump(const Snapshot& snapshot, int maxCallSites) {
+    Log::Info("AllocationTracker: %lld allocs, %lld frees, %lld bytes allocated, %lld bytes live, %lld bytes peak\n",
+        (long long) snapshot.Total.NumAllocs,
+        (long long) snapshot.Total.NumFrees,
+        (long long) snapshot.Total.AllocBytes,
+        (long long) snapshot.Total.LiveBytes,
+        (long long) snapshot.Total.PeakBytes);
+    Array<const CallSite*> sorted;
+    sorted.Reserve(snapshot.CallSites.Size());
+    for (const CallSite& site : snapshot.CallSites) {
+        sorted.Add(&site);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const CallSite* a, const CallSite* b) {
+        if (a->Stats.LiveBytes != b->Stats.LiveBytes) {
+            return a->Stats.LiveBytes > b->Stats.LiveBytes;
+        }
+        return a->Stats.AllocBytes > b->Stats.AllocBytes;
+    });
+    for (int i = 0; (i < sorted.Size()) && (i < maxCallSites); i++) {
+        const CallSite* site = sorted[i];
+        Log::Info("  %p <- %p <- %p: %lld allocs, %lld frees, %lld bytes allocated, %lld bytes live, %lld bytes peak\n",
+            site->Address,
+            site->Callers[0],
+            site->Callers[1],
+            (long long) site->Stats.NumAllocs,
+            (long long) site->Stats.NumFrees,
+            (long long) site->Stats.AllocBytes,
+            (long long) site->Stats.LiveBytes,
+            (long long) site->Stats.PeakBytes);
+        if (site->Trace) {
+            Log::Info("%s", site->Trace);
+        }
+    }
+}
+
+} // namespace Oryol
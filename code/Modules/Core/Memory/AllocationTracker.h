@@ -0,0 +1,154 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::AllocationTracker
+    @ingroup Core
+    @brief opt-in allocation tracking for Memory::Alloc/ReAlloc/Free
+
+    When compiled with ORYOL_ALLOCATION_TRACKING (cmake option 
+    FIPS_ALLOCATION_TRACKING), every allocation made through Oryol::Memory 
+    is recorded in a call-site table. A call-site is identified by the
+    return address of the Memory::Alloc() caller and the next return
+    addresses up the stack (up to CallSiteDepth), so that allocations
+    made by container code are told apart by the code using the
+    container. Where StackTrace::Capture() isn't supported, only the
+    first return address is used. For each call-site the number of
+    allocations and frees, allocated bytes, live bytes and peak live
+    bytes are recorded. The call stack of sampled allocations is
+    captured with StackTrace (see SetSampleRate()).
+
+    Without ORYOL_ALLOCATION_TRACKING the Memory functions have no
+    tracking overhead, and the AllocationTracker functions return 
+    empty results.
+
+    Allocations with MemoryTag::Frame are not tracked, use 
+    FrameAllocator::Stats() for those.
+
+    To check that a piece of code doesn't allocate:
+
+        AllocationTracker::Checkpoint checkpoint;
+        Gfx::ApplyDrawState(drawState);
+        Gfx::Draw();
+        CHECK(checkpoint.NumAllocs() == 0);
+
+    @see Memory, StackTrace
+*/
+#include "Core/Types.h"
+#include "Core/Containers/Array.h"
+
+namespace Oryol {
+
+class AllocationTracker {
+public:
+    /// return true if allocation tracking has been compiled in
+    static bool IsEnabled();
+    /// number of return addresses which identify a call-site
+    static const int CallSiteDepth = 5;
+
+    /// allocation counters
+    struct Counters {
+        /// number of Alloc() calls (ReAlloc counts as Free+Alloc)
+        int64_t NumAllocs = 0;
+        /// number of Free() calls
+        int64_t NumFrees = 0;
+        /// overall number of allocated bytes
+        int64_t AllocBytes = 0;
+        /// number of currently allocated bytes
+        int64_t LiveBytes = 0;
+        /// peak number of live bytes
+        int64_t PeakBytes = 0;
+    };
+    /// per-callsite allocation info
+    struct CallSite {
+        /// stable call-site index
+        int Index = InvalidIndex;
+        /// return address of the Memory function caller
+        const void* Address = nullptr;
+        /// the return addresses further up the stack (nullptr-padded)
+        const void* Callers[CallSiteDepth - 1] = { };
+        /// allocation counters of this call-site
+        Counters Stats;
+        /// call-stack of a sampled allocation, or nullptr
+        const char* Trace = nullptr;
+    };
+    /// a snapshot of the allocation counters
+    class Snapshot {
+    public:
+        /// counters over all call-sites
+        Counters Total;
+        /// call-sites, sorted by call-site index
+        Array<CallSite> CallSites;
+    };
+
+    /// capture the call stack for every Nth allocation (0 to disable)
+    static void SetSampleRate(int everyNth);
+    /// get the sample rate
+    static int SampleRate();
+
+    /// take a snapshot of all call-sites
+    static Snapshot TakeSnapshot();
+    /// get the difference between 2 snapshots (PeakBytes is taken from 'after')
+    static Snapshot Diff(const Snapshot& before, const Snapshot& after);
+    /// log the top call-sites of a snapshot sorted by live bytes
+    static void Dump(const Snapshot& snapshot, int maxCallSites=16);
+
+    /// get number of allocations of the current thread
+    static int64_t ThreadNumAllocs();
+    /// get number of bytes allocated by the current thread
+    static int64_t ThreadAllocBytes();
+
+    /// count allocations on the current thread since construction
+    class Checkpoint {
+    public:
+        /// constructor, records the current thread's allocation count
+        Checkpoint();
+        /// number of allocations on this thread since construction
+        int64_t NumAllocs() const;
+        /// number of allocated bytes on this thread since construction
+        int64_t AllocBytes() const;
+    private:
+        int64_t startAllocs;
+        int64_t startBytes;
+    };
+
+private:
+    friend class Memory;
+    /// call-site index of allocations which are not tracked at all
+    static const int Untracked = -2;
+    /// record an allocation, return call-site index (called by Memory)
+    static int onAlloc(const void* callSite, int numBytes);
+    /// record a free (called by Memory)
+    static void onFree(int callSiteIndex, int numBytes);
+};
+
+//------------------------------------------------------------------------------
+inline bool
+AllocationTracker::IsEnabled() {
+    #if ORYOL_ALLOCATION_TRACKING
+    return true;
+    #else
+    return false;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+inline
+AllocationTracker::Checkpoint::Checkpoint() :
+startAllocs(AllocationTracker::ThreadNumAllocs()),
+startBytes(AllocationTracker::ThreadAllocBytes()) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+inline int64_t
+AllocationTracker::Checkpoint::NumAllocs() const {
+    return AllocationTracker::ThreadNumAllocs() - this->startAllocs;
+}
+
+//------------------------------------------------------------------------------
+inline int64_t
+AllocationTracker::Checkpoint::AllocBytes() const {
+    return AllocationTracker::ThreadAllocBytes() - this->startBytes;
+}
+
+} // namespace Oryol
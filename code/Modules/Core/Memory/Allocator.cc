@@ -0,0 +1,26 @@
+//------------------------------------------------------------------------------
+//  Allocator.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "Allocator.h"
+#include "Core/Memory/Memory.h"
+
+namespace Oryol {
+
+//------------------------------------------------------------------------------
+Allocator::~Allocator() {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+void*
+Allocator::ReAlloc(void* ptr, int oldNumBytes, int newNumBytes) {
+    void* newPtr = this->Alloc(newNumBytes);
+    if (ptr) {
+        Memory::Copy(ptr, newPtr, oldNumBytes < newNumBytes ? oldNumBytes : newNumBytes);
+        this->Free(ptr, oldNumBytes);
+    }
+    return newPtr;
+}
+
+} // namespace Oryol
@@ -0,0 +1,61 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::Allocator
+    @ingroup Core
+    @brief base class for pluggable memory allocator backends
+
+    Allocator objects can be installed per MemoryTag through the CoreSetup
+    object, all memory allocations through Oryol::Memory with that tag will
+    then be routed to the allocator. Memory returned by Alloc() must be
+    aligned to ORYOL_MAX_PLATFORM_ALIGN.
+
+    Allocators can be called from any thread and must do their own
+    locking. An allocator object must stay alive until all memory
+    allocated through it has been freed (in practice this means that
+    allocator objects should be static objects).
+
+    @see PoolAllocator, ArenaAllocator, Memory
+*/
+#include "Core/Types.h"
+
+namespace Oryol {
+
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::AllocatorStats
+    @ingroup Core
+    @brief allocation statistics of an Allocator
+*/
+struct AllocatorStats {
+    /// number of bytes currently allocated
+    int64_t LiveBytes = 0;
+    /// highest value of LiveBytes so far
+    int64_t HighWaterMark = 0;
+    /// number of bytes currently reserved from the system
+    int64_t ReservedBytes = 0;
+    /// number of currently live allocations
+    int NumLiveAllocs = 0;
+    /// overall number of allocations so far
+    int NumAllocs = 0;
+};
+
+//------------------------------------------------------------------------------
+class Allocator {
+public:
+    /// destructor
+    virtual ~Allocator();
+
+    /// get a human-readable name of the allocator
+    virtual const char* Name() const = 0;
+    /// allocate a chunk of memory
+    virtual void* Alloc(int numBytes) = 0;
+    /// free a chunk of memory, numBytes is the size of the allocation
+    virtual void Free(void* ptr, int numBytes) = 0;
+    /// re-allocate a chunk of memory (default does Alloc+Copy+Free)
+    virtual void* ReAlloc(void* ptr, int oldNumBytes, int newNumBytes);
+    /// get current allocation statistics
+    virtual AllocatorStats Stats() const = 0;
+};
+
+} // namespace Oryol
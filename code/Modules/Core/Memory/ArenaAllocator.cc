@@ -0,0 +1,178 @@
+//------------------------------------------------------------------------------
+//  ArenaAllocator.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "ArenaAllocator.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Assertion.h"
+#include <cstdlib>
+
+#if ORYOL_HAS_THREADS
+#define SCOPED_LOCK std::lock_guard<std::mutex> lock(this->lockMutex)
+#else
+#define SCOPED_LOCK
+#endif
+
+namespace Oryol {
+
+//------------------------------------------------------------------------------
+ArenaAllocator::ArenaAllocator(const char* name_, int chunkSize_) :
+name(name_),
+chunkSize(chunkSize_),
+first(nullptr),
+cur(nullptr) {
+    static_assert(sizeof(chunk) <= ChunkHeaderSize, "chunk header too big!");
+    o_assert(this->chunkSize > 0);
+}
+
+//------------------------------------------------------------------------------
+ArenaAllocator::~ArenaAllocator() {
+    while (this->first) {
+        chunk* next = this->first->next;
+        std::free(this->first);
+        this->first = next;
+    }
+    this->cur = nullptr;
+}
+
+//------------------------------------------------------------------------------
+const char*
+ArenaAllocator::Name() const {
+    return this->name;
+}
+
+//------------------------------------------------------------------------------
+uint8_t*
+ArenaAllocator::chunkData(chunk* c) {
+    return ((uint8_t*)c) + ChunkHeaderSize;
+}
+
+//------------------------------------------------------------------------------
+void*
+ArenaAllocator::Alloc(int numBytes) {
+    const int roundedNumBytes = Memory::RoundUp(numBytes, ORYOL_MAX_PLATFORM_ALIGN);
+    SCOPED_LOCK;
+
+    // find a chunk with enough room, starting at the current chunk
+    while (this->cur && ((this->cur->top + roundedNumBytes) > this->cur->size)) {
+        if (this->cur->next) {
+            this->cur = this->cur->next;
+            this->cur->top = 0;
+        }
+        else {
+            break;
+        }
+    }
+    if ((nullptr == this->cur) || ((this->cur->top + roundedNumBytes) > this->cur->size)) {
+        // need a new chunk, append to the end of the chunk list
+        const int size = roundedNumBytes > this->chunkSize ? roundedNumBytes : this->chunkSize;
+        chunk* c = (chunk*) std::malloc(ChunkHeaderSize + size);
+        o_assert(c);
+        c->next = nullptr;
+        c->size = size;
+        c->top = 0;
+        if (this->cur) {
+            this->cur->next = c;
+        }
+        else {
+            this->first = c;
+        }
+        this->cur = c;
+        this->stats.ReservedBytes += ChunkHeaderSize + size;
+    }
+    void* ptr = chunkData(this->cur) + this->cur->top;
+    this->cur->top += roundedNumBytes;
+
+    this->stats.LiveBytes += numBytes;
+    this->stats.NumLiveAllocs++;
+    this->stats.NumAllocs++;
+    if (this->stats.LiveBytes > this->stats.HighWaterMark) {
+        this->stats.HighWaterMark = this->stats.LiveBytes;
+    }
+    return ptr;
+}
+
+//------------------------------------------------------------------------------
+bool
+ArenaAllocator::isTop(void* ptr, int roundedNumBytes) const {
+    return this->cur && ((chunkData(this->cur) + this->cur->top) == (((uint8_t*)ptr) + roundedNumBytes));
+}
+
+//------------------------------------------------------------------------------
+void
+ArenaAllocator::Free(void* ptr, int numBytes) {
+    o_assert_dbg(ptr);
+    const int roundedNumBytes = Memory::RoundUp(numBytes, ORYOL_MAX_PLATFORM_ALIGN);
+    SCOPED_LOCK;
+    this->stats.LiveBytes -= numBytes;
+    this->stats.NumLiveAllocs--;
+    o_assert_dbg(this->stats.NumLiveAllocs >= 0);
+    if (0 == this->stats.NumLiveAllocs) {
+        // everything has been freed, rewind the arena
+        this->rewind();
+    }
+    else if (this->isTop(ptr, roundedNumBytes)) {
+        // free'd the most recent allocation, can reclaim
+        this->cur->top -= roundedNumBytes;
+    }
+}
+
+//------------------------------------------------------------------------------
+void*
+ArenaAllocator::ReAlloc(void* ptr, int oldNumBytes, int newNumBytes) {
+    {
+        const int oldRounded = Memory::RoundUp(oldNumBytes, ORYOL_MAX_PLATFORM_ALIGN);
+        const int newRounded = Memory::RoundUp(newNumBytes, ORYOL_MAX_PLATFORM_ALIGN);
+        SCOPED_LOCK;
+        if (this->isTop(ptr, oldRounded) && ((this->cur->top - oldRounded + newRounded) <= this->cur->size)) {
+            // most recent allocation, can grow or shrink in place
+            this->cur->top += newRounded - oldRounded;
+            this->stats.LiveBytes += newNumBytes - oldNumBytes;
+            if (this->stats.LiveBytes > this->stats.HighWaterMark) {
+                this->stats.HighWaterMark = this->stats.LiveBytes;
+            }
+            return ptr;
+        }
+    }
+    return Allocator::ReAlloc(ptr, oldNumBytes, newNumBytes);
+}
+
+//------------------------------------------------------------------------------
+void
+ArenaAllocator::rewind() {
+    this->cur = this->first;
+    if (this->cur) {
+        this->cur->top = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+ArenaAllocator::Reset() {
+    SCOPED_LOCK;
+    this->rewind();
+    this->stats.LiveBytes = 0;
+    this->stats.NumLiveAllocs = 0;
+}
+
+//------------------------------------------------------------------------------
+bool
+ArenaAllocator::Owns(const void* ptr) const {
+    SCOPED_LOCK;
+    for (chunk* c = this->first; c; c = c->next) {
+        const uint8_t* start = chunkData(c);
+        if ((ptr >= start) && (ptr < (start + c->size))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+AllocatorStats
+ArenaAllocator::Stats() const {
+    SCOPED_LOCK;
+    return this->stats;
+}
+
+} // namespace Oryol
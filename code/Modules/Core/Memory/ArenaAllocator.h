@@ -0,0 +1,80 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::ArenaAllocator
+    @ingroup Core
+    @brief linear (bump-pointer) arena allocator backend
+
+    The ArenaAllocator hands out memory by bumping a pointer through
+    big memory chunks, new chunks are added when the current chunk is
+    exhausted. Individual Free() calls only reclaim memory if the freed
+    block is the most recent allocation (LIFO order), otherwise memory
+    is reclaimed when the number of live allocations drops to zero,
+    or when Reset() is called explicitly. Chunks are kept around
+    and recycled until the allocator is destroyed.
+
+    Use an arena for allocations with a clearly defined life time 
+    (e.g. everything allocated during a loading phase or a frame).
+
+    @see Allocator, PoolAllocator
+*/
+#include "Core/Memory/Allocator.h"
+#include "Core/Config.h"
+#if ORYOL_HAS_THREADS
+#include <mutex>
+#endif
+
+namespace Oryol {
+
+class ArenaAllocator : public Allocator {
+public:
+    /// default size of memory chunks
+    static const int DefaultChunkSize = 1024 * 1024;
+
+    /// constructor
+    ArenaAllocator(const char* name="ArenaAllocator", int chunkSize=DefaultChunkSize);
+    /// destructor
+    virtual ~ArenaAllocator();
+
+    /// get human-readable name
+    virtual const char* Name() const override;
+    /// allocate a chunk of memory
+    virtual void* Alloc(int numBytes) override;
+    /// free a chunk of memory
+    virtual void Free(void* ptr, int numBytes) override;
+    /// re-allocate a chunk of memory (grows in place if last allocation)
+    virtual void* ReAlloc(void* ptr, int oldNumBytes, int newNumBytes) override;
+    /// get allocation statistics
+    virtual AllocatorStats Stats() const override;
+
+    /// rewind the arena, all memory allocated from the arena becomes invalid!
+    void Reset();
+    /// test if a pointer is inside of one of the arena's chunks
+    bool Owns(const void* ptr) const;
+
+private:
+    struct chunk {
+        chunk* next;
+        int size;       // usable size in bytes
+        int top;        // current bump offset
+    };
+    static const int ChunkHeaderSize = 16;
+
+    /// get start of chunk data
+    static uint8_t* chunkData(chunk* c);
+    /// rewind all chunks (must be called with lock held)
+    void rewind();
+    /// test if ptr is last allocation in current chunk (must be called with lock held)
+    bool isTop(void* ptr, int roundedNumBytes) const;
+
+    const char* name;
+    int chunkSize;
+    chunk* first;
+    chunk* cur;
+    AllocatorStats stats;
+    #if ORYOL_HAS_THREADS
+    mutable std::mutex lockMutex;
+    #endif
+};
+
+} // namespace Oryol
@@ -0,0 +1,250 @@
+//------------------------------------------------------------------------------
+//  FrameAllocator.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "FrameAllocator.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Assertion.h"
+#include <cstdlib>
+
+// in debug mode, protect the previous frame's memory region
+#if ORYOL_ALLOCATOR_DEBUG && ORYOL_POSIX && !ORYOL_EMSCRIPTEN
+#define ORYOL_FRAMEALLOCATOR_PROTECT (1)
+#include <sys/mman.h>
+#else
+#define ORYOL_FRAMEALLOCATOR_PROTECT (0)
+#endif
+
+namespace Oryol {
+
+ORYOL_THREADLOCAL_FIXED_PTR(FrameAllocator, FrameAllocatorSlot) FrameAllocator::threadPtr = nullptr;
+
+namespace {
+    uint8_t* mapRegion(int size) {
+        #if ORYOL_FRAMEALLOCATOR_PROTECT
+        void* ptr = mmap(nullptr, size, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+        o_assert(MAP_FAILED != ptr);
+        return (uint8_t*) ptr;
+        #else
+        uint8_t* ptr = (uint8_t*) std::malloc(size);
+        o_assert(ptr);
+        return ptr;
+        #endif
+    }
+    void unmapRegion(uint8_t* ptr, ORYOL_UNUSED int size) {
+        #if ORYOL_FRAMEALLOCATOR_PROTECT
+        munmap(ptr, size);
+        #else
+        std::free(ptr);
+        #endif
+    }
+}
+
+//------------------------------------------------------------------------------
+FrameAllocator::FrameAllocator(const char* name_, int capacity_) :
+name(name_),
+capacity(Memory::RoundUp(capacity_, ORYOL_MAX_PLATFORM_ALIGN)),
+top(0),
+region(nullptr),
+#if ORYOL_ALLOCATOR_DEBUG
+retiredRegion(nullptr),
+#endif
+overflow(nullptr),
+overflowBytes(0),
+numOverflowAllocs(0),
+frameCount(0) {
+    static_assert(sizeof(overflowNode) <= OverflowHeaderSize, "overflow header too big!");
+    o_assert(this->capacity > 0);
+}
+
+//------------------------------------------------------------------------------
+FrameAllocator::~FrameAllocator() {
+    this->freeOverflow();
+    this->freeRegion();
+}
+
+//------------------------------------------------------------------------------
+FrameAllocator*
+FrameAllocator::ThreadLocal() {
+    return threadPtr;
+}
+
+//------------------------------------------------------------------------------
+void
+FrameAllocator::SetThreadLocal(FrameAllocator* frameAllocator) {
+    threadPtr = frameAllocator;
+}
+
+//------------------------------------------------------------------------------
+const char*
+FrameAllocator::Name() const {
+    return this->name;
+}
+
+//------------------------------------------------------------------------------
+void
+FrameAllocator::allocRegion() {
+    o_assert_dbg(nullptr == this->region);
+    this->region = mapRegion(this->capacity);
+    this->stats.ReservedBytes += this->capacity;
+}
+
+//------------------------------------------------------------------------------
+void
+FrameAllocator::freeRegion() {
+    if (this->region) {
+        unmapRegion(this->region, this->capacity);
+        this->region = nullptr;
+    }
+    #if ORYOL_ALLOCATOR_DEBUG
+    if (this->retiredRegion) {
+        unmapRegion(this->retiredRegion, this->capacity);
+        this->retiredRegion = nullptr;
+    }
+    #endif
+    this->stats.ReservedBytes = 0;
+}
+
+//------------------------------------------------------------------------------
+void
+FrameAllocator::freeOverflow() {
+    while (this->overflow) {
+        overflowNode* next = this->overflow->next;
+        std::free(this->overflow);
+        this->overflow = next;
+    }
+}
+
+//------------------------------------------------------------------------------
+void*
+FrameAllocator::Alloc(int numBytes) {
+    const int roundedNumBytes = Memory::RoundUp(numBytes, ORYOL_MAX_PLATFORM_ALIGN);
+    if (nullptr == this->region) {
+        this->allocRegion();
+    }
+    void* ptr;
+    if ((this->top + roundedNumBytes) <= this->capacity) {
+        ptr = this->region + this->top;
+        this->top += roundedNumBytes;
+    }
+    else {
+        // region exhausted, fall back to malloc until next Reset()
+        overflowNode* node = (overflowNode*) std::malloc(OverflowHeaderSize + roundedNumBytes);
+        o_assert(node);
+        node->next = this->overflow;
+        this->overflow = node;
+        this->overflowBytes += roundedNumBytes;
+        this->numOverflowAllocs++;
+        ptr = ((uint8_t*)node) + OverflowHeaderSize;
+    }
+    this->stats.LiveBytes += numBytes;
+    this->stats.NumLiveAllocs++;
+    this->stats.NumAllocs++;
+    if (this->stats.LiveBytes > this->stats.HighWaterMark) {
+        this->stats.HighWaterMark = this->stats.LiveBytes;
+    }
+    return ptr;
+}
+
+//------------------------------------------------------------------------------
+bool
+FrameAllocator::isTop(void* ptr, int roundedNumBytes) const {
+    return this->region && ((this->region + this->top) == (((uint8_t*)ptr) + roundedNumBytes));
+}
+
+//------------------------------------------------------------------------------
+void
+FrameAllocator::Free(void* ptr, int numBytes) {
+    o_assert_dbg(ptr);
+    o_assert_dbg(this->Owns(ptr));
+    const int roundedNumBytes = Memory::RoundUp(numBytes, ORYOL_MAX_PLATFORM_ALIGN);
+    if (this->isTop(ptr, roundedNumBytes)) {
+        // free'd the most recent allocation, can reclaim
+        this->top -= roundedNumBytes;
+    }
+    // NOTE: overflow allocations are freed in Reset()
+    this->stats.LiveBytes -= numBytes;
+    this->stats.NumLiveAllocs--;
+}
+
+//------------------------------------------------------------------------------
+void*
+FrameAllocator::ReAlloc(void* ptr, int oldNumBytes, int newNumBytes) {
+    const int oldRounded = Memory::RoundUp(oldNumBytes, ORYOL_MAX_PLATFORM_ALIGN);
+    const int newRounded = Memory::RoundUp(newNumBytes, ORYOL_MAX_PLATFORM_ALIGN);
+    if (this->isTop(ptr, oldRounded) && ((this->top - oldRounded + newRounded) <= this->capacity)) {
+        // most recent allocation, can grow or shrink in place
+        this->top += newRounded - oldRounded;
+        this->stats.LiveBytes += newNumBytes - oldNumBytes;
+        if (this->stats.LiveBytes > this->stats.HighWaterMark) {
+            this->stats.HighWaterMark = this->stats.LiveBytes;
+        }
+        return ptr;
+    }
+    return Allocator::ReAlloc(ptr, oldNumBytes, newNumBytes);
+}
+
+//------------------------------------------------------------------------------
+void
+FrameAllocator::Reset() {
+    this->frameCount++;
+    if (this->overflow) {
+        // the region was too small for this frame, grow it so 
+        // that the next frame fits without malloc calls
+        const int frameBytes = this->top + this->overflowBytes;
+        this->freeOverflow();
+        this->overflowBytes = 0;
+        // old region content is dead, new region is allocated on demand,
+        // NOTE: the regions must be freed before the capacity changes
+        this->freeRegion();
+        while (this->capacity < frameBytes) {
+            this->capacity *= 2;
+        }
+    }
+    else if (this->region && (this->top > 0)) {
+        // NOTE: if nothing was allocated, the current region is kept
+        #if ORYOL_FRAMEALLOCATOR_PROTECT
+        // protect this frame's memory, and swap in the previous frame's region
+        int res ORYOL_UNUSED = mprotect(this->region, this->capacity, PROT_NONE);
+        o_assert(0 == res);
+        uint8_t* prevRegion = this->retiredRegion;
+        this->retiredRegion = this->region;
+        if (prevRegion) {
+            res = mprotect(prevRegion, this->capacity, PROT_READ|PROT_WRITE);
+            o_assert(0 == res);
+            this->region = prevRegion;
+        }
+        else {
+            this->region = nullptr;
+            this->allocRegion();
+        }
+        #elif ORYOL_ALLOCATOR_DEBUG
+        Memory::Fill(this->region, this->top, DebugFillByte);
+        #endif
+    }
+    this->top = 0;
+    this->stats.LiveBytes = 0;
+    this->stats.NumLiveAllocs = 0;
+}
+
+//------------------------------------------------------------------------------
+bool
+FrameAllocator::Owns(const void* ptr) const {
+    if (this->region && (ptr >= this->region) && (ptr < (this->region + this->top))) {
+        return true;
+    }
+    for (const overflowNode* node = this->overflow; node; node = node->next) {
+        if ((((const uint8_t*)node) + OverflowHeaderSize) == ptr) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+AllocatorStats
+FrameAllocator::Stats() const {
+    return this->stats;
+}
+
+} // namespace Oryol
@@ -0,0 +1,134 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::FrameAllocator
+    @ingroup Core
+    @brief thread-local linear allocator which is reset once per frame
+
+    The FrameAllocator is a bump-pointer allocator for memory which
+    doesn't survive the current frame. Core creates one FrameAllocator
+    per thread (see Core::Setup() and Core::EnterThread()) and resets
+    it from the thread's PostRunLoop, threads which don't run a
+    PostRunLoop must reset it themselves (JobSystem workers reset it
+    after each job). Allocations are routed to the
+    current thread's FrameAllocator through MemoryTag::Frame, for 
+    instance with Memory::Alloc(n, MemoryTag::Frame), or by putting
+    an Array or Buffer on frame memory with SetMemoryTag(MemoryTag::Frame).
+
+    The memory region is allocated on first use. If a frame needs more
+    memory than the region can hold, the overflow is served by malloc() 
+    and the region grows to the frame's high-water mark on the next 
+    Reset(), so that steady-state frames don't call malloc() or free().
+
+    Frame memory must not be handed to other threads, and all objects
+    living in frame memory must be destroyed before the end of the frame!
+    When compiled with ORYOL_ALLOCATOR_DEBUG on POSIX platforms, the 
+    previous frame's memory is read/write-protected after Reset(), so 
+    that any access through a stale pointer traps immediately. Since the
+    allocator alternates between two regions, this only catches pointers
+    which are exactly one frame old, older pointers point into the
+    current frame's memory again. On other platforms the stale memory is
+    overwritten with a fill pattern.
+
+    Per-frame scratch memory in the engine itself (for instance the
+    Dbg text string) comes from the FrameAllocator. Memory which crosses
+    threads can't live in frame memory, per-frame arrays of this kind
+    (for instance the IO completion lists) are reused instead.
+
+    @see Allocator, ArenaAllocator, MemoryTag
+*/
+#include "Core/Memory/Allocator.h"
+#include "Core/Threading/ThreadLocalPtr.h"
+
+namespace Oryol {
+
+class FrameAllocator : public Allocator {
+public:
+    /// default capacity of the frame memory region
+    static const int DefaultCapacity = 4 * 1024 * 1024;
+    /// fill pattern for stale frame memory in debug mode
+    static const uint8_t DebugFillByte = 0xDD;
+
+    /// constructor
+    FrameAllocator(const char* name="FrameAllocator", int capacity=DefaultCapacity);
+    /// destructor
+    virtual ~FrameAllocator();
+
+    /// get the current thread's frame allocator (may be nullptr)
+    static FrameAllocator* ThreadLocal();
+    /// set the current thread's frame allocator (called by Core)
+    static void SetThreadLocal(FrameAllocator* frameAllocator);
+
+    /// get human-readable name
+    virtual const char* Name() const override;
+    /// allocate a chunk of memory
+    virtual void* Alloc(int numBytes) override;
+    /// free a chunk of memory (only reclaims the most recent allocation)
+    virtual void Free(void* ptr, int numBytes) override;
+    /// re-allocate a chunk of memory (grows in place if last allocation)
+    virtual void* ReAlloc(void* ptr, int oldNumBytes, int newNumBytes) override;
+    /// get allocation statistics
+    virtual AllocatorStats Stats() const override;
+
+    /// reset at frame boundary, all frame memory becomes invalid! (cheap if nothing was allocated)
+    void Reset();
+    /// test if a pointer has been allocated in the current frame
+    bool Owns(const void* ptr) const;
+    /// get current capacity of the memory region
+    int Capacity() const;
+    /// get number of Reset() calls
+    int FrameCount() const;
+    /// get overall number of allocations which didn't fit into the region
+    int NumOverflowAllocs() const;
+
+private:
+    /// allocate the memory region(s)
+    void allocRegion();
+    /// free the memory region(s)
+    void freeRegion();
+    /// free overflow allocations
+    void freeOverflow();
+    /// test if ptr is the last allocation in the region
+    bool isTop(void* ptr, int roundedNumBytes) const;
+
+    static ORYOL_THREADLOCAL_FIXED_PTR(FrameAllocator, FrameAllocatorSlot) threadPtr;
+
+    struct overflowNode {
+        overflowNode* next;
+    };
+    static const int OverflowHeaderSize = 16;
+
+    const char* name;
+    int capacity;
+    int top;
+    uint8_t* region;
+    #if ORYOL_ALLOCATOR_DEBUG
+    /// debug mode: the retired region of the previous frame
+    uint8_t* retiredRegion;
+    #endif
+    overflowNode* overflow;
+    int overflowBytes;
+    int numOverflowAllocs;
+    int frameCount;
+    AllocatorStats stats;
+};
+
+//------------------------------------------------------------------------------
+inline int
+FrameAllocator::Capacity() const {
+    return this->capacity;
+}
+
+//------------------------------------------------------------------------------
+inline int
+FrameAllocator::FrameCount() const {
+    return this->frameCount;
+}
+
+//------------------------------------------------------------------------------
+inline int
+FrameAllocator::NumOverflowAllocs() const {
+    return this->numOverflowAllocs;
+}
+
+} // namespace Oryol
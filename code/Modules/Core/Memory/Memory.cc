@@ -5,16 +5,176 @@
 #include <cstdlib>
 #include <cstring>
 #include "Memory.h"
+#include "Core/Memory/Allocator.h"
+#include "Core/Memory/FrameAllocator.h"
+#include "Core/Memory/AllocationTracker.h"
+#include "Core/Threading/ThreadLocalPtr.h"
+#include "Core/Assertion.h"
 #if ORYOL_USE_VLD
 #include "vld.h"
 #endif
+#if ORYOL_ALLOCATION_TRACKING && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// the call-site of a Memory function for allocation tracking
+#if !ORYOL_ALLOCATION_TRACKING
+#define ORYOL_CALLSITE (nullptr)
+#elif defined(_MSC_VER)
+#define ORYOL_CALLSITE (_ReturnAddress())
+#else
+#define ORYOL_CALLSITE (__builtin_return_address(0))
+#endif
 
 namespace Oryol {
-    
+
+namespace {
+    // each allocation is prefixed with a header which remembers the 
+    // allocator and tag it was allocated with, this allows to free
+    // memory correctly even if allocators have been changed after 
+    // the allocation (e.g. for static objects allocated before Core::Setup()),
+    // for over-aligned allocations the header sits right in front
+    // of the aligned pointer, and 'padding' is the distance to the
+    // start of the raw allocation
+    struct allocHeader {
+        Allocator* allocator;
+        int32_t size;
+        uint8_t tag;
+        uint8_t alignShift;     // log2(alignment), or 0 if default alignment
+        uint16_t padding;       // in units of ORYOL_MAX_PLATFORM_ALIGN
+        #if ORYOL_ALLOCATION_TRACKING
+        int32_t callSite;
+        #endif
+    };
+    #if ORYOL_ALLOCATION_TRACKING
+    const int HeaderSize = 32;
+    #else
+    const int HeaderSize = 16;
+    #endif
+    static_assert(sizeof(allocHeader) <= HeaderSize, "allocHeader too big!");
+    static_assert((HeaderSize % ORYOL_MAX_PLATFORM_ALIGN) == 0, "HeaderSize must be multiple of ORYOL_MAX_PLATFORM_ALIGN");
+
+    Allocator* allocators[MemoryTag::NumMemoryTags] = { };
+
+    // thread-locals can only be pointers, so the current tag
+    // is stored as pointer into this table
+    const MemoryTag::Code tagTable[MemoryTag::NumMemoryTags] = {
+        MemoryTag::Default,
+        MemoryTag::Core,
+        MemoryTag::IO,
+        MemoryTag::Resource,
+        MemoryTag::Gfx,
+        MemoryTag::Frame,
+    };
+    #if ORYOL_THREADLOCAL_PTHREAD
+    // NOTE: memory may be allocated during static initialization, so 
+    // the thread-local must be a function-local static
+    ThreadLocalPtr<const MemoryTag::Code, ThreadLocalData::MemoryTagSlot>& threadTag() {
+        static ThreadLocalPtr<const MemoryTag::Code, ThreadLocalData::MemoryTagSlot> ptr;
+        return ptr;
+    }
+    #else
+    ORYOL_THREADLOCAL_PTR(const MemoryTag::Code) threadTagPtr = nullptr;
+    const MemoryTag::Code*& threadTag() {
+        return threadTagPtr;
+    }
+    #endif
+
+    inline allocHeader* headerOf(const void* ptr) {
+        return (allocHeader*) (((uint8_t*)ptr) - HeaderSize);
+    }
+    inline void* dataOf(allocHeader* hdr) {
+        return ((uint8_t*)hdr) + HeaderSize;
+    }
+    // extra bytes needed for over-aligned allocations
+    inline int alignExtra(int alignShift) {
+        return alignShift ? ((1 << alignShift) - ORYOL_MAX_PLATFORM_ALIGN) : 0;
+    }
+    // size of the raw allocation
+    inline int rawSize(const allocHeader* hdr) {
+        return hdr->size + HeaderSize + alignExtra(hdr->alignShift);
+    }
+    // start of the raw allocation
+    inline void* rawOf(allocHeader* hdr) {
+        return ((uint8_t*)hdr) - hdr->padding * ORYOL_MAX_PLATFORM_ALIGN;
+    }
+    // log2 of alignment
+    inline int alignShiftOf(int alignment) {
+        int shift = 0;
+        while ((1 << shift) < alignment) {
+            shift++;
+        }
+        return shift;
+    }
+}
+
 //------------------------------------------------------------------------------
 void*
 Memory::Alloc(int numBytes) {
-    void* ptr = std::malloc(numBytes);
+    return Memory::alloc(numBytes, ORYOL_MAX_PLATFORM_ALIGN, CurrentTag(), ORYOL_CALLSITE);
+}
+
+//------------------------------------------------------------------------------
+void*
+Memory::Alloc(int numBytes, MemoryTag::Code tag) {
+    return Memory::alloc(numBytes, ORYOL_MAX_PLATFORM_ALIGN, tag, ORYOL_CALLSITE);
+}
+
+//------------------------------------------------------------------------------
+void*
+Memory::AllocAligned(int numBytes, int alignment) {
+    return Memory::alloc(numBytes, alignment, CurrentTag(), ORYOL_CALLSITE);
+}
+
+//------------------------------------------------------------------------------
+void*
+Memory::AllocAligned(int numBytes, int alignment, MemoryTag::Code tag) {
+    return Memory::alloc(numBytes, alignment, tag, ORYOL_CALLSITE);
+}
+
+//------------------------------------------------------------------------------
+void
+Memory::FreeAligned(void* ptr) {
+    Memory::Free(ptr);
+}
+
+//------------------------------------------------------------------------------
+void*
+Memory::alloc(int numBytes, int alignment, MemoryTag::Code tag, ORYOL_UNUSED const void* callSite) {
+    o_assert_range_dbg(tag, MemoryTag::NumMemoryTags);
+    o_assert_dbg((alignment > 0) && (0 == (alignment & (alignment - 1))));
+    o_assert_dbg(alignment <= MaxAlignment);
+    const int alignShift = (alignment > ORYOL_MAX_PLATFORM_ALIGN) ? alignShiftOf(alignment) : 0;
+    const int allocSize = numBytes + HeaderSize + alignExtra(alignShift);
+
+    // NOTE: if the thread has no frame allocator, frame memory comes from malloc
+    Allocator* allocator = (MemoryTag::Frame == tag) ? FrameAllocator::ThreadLocal() : allocators[tag];
+    uint8_t* raw;
+    if (allocator) {
+        raw = (uint8_t*) allocator->Alloc(allocSize);
+    }
+    else {
+        raw = (uint8_t*) std::malloc(allocSize);
+    }
+    allocHeader* hdr;
+    if (alignShift) {
+        uint8_t* ptr = (uint8_t*) ((intptr_t(raw) + HeaderSize + (alignment - 1)) & ~intptr_t(alignment - 1));
+        hdr = headerOf(ptr);
+        hdr->padding = uint16_t((((uint8_t*)hdr) - raw) / ORYOL_MAX_PLATFORM_ALIGN);
+    }
+    else {
+        hdr = (allocHeader*) raw;
+        hdr->padding = 0;
+    }
+    hdr->allocator = allocator;
+    hdr->size = numBytes;
+    hdr->tag = uint8_t(tag);
+    hdr->alignShift = uint8_t(alignShift);
+    #if ORYOL_ALLOCATION_TRACKING
+    // NOTE: frame memory isn't tracked since it is not freed individually
+    hdr->callSite = (MemoryTag::Frame != tag) ? AllocationTracker::onAlloc(callSite, numBytes) : AllocationTracker::Untracked;
+    #endif
+    void* ptr = dataOf(hdr);
 #if ORYOL_ALLOCATOR_DEBUG || ORYOL_UNITTESTS
     Memory::Fill(ptr, numBytes, ORYOL_MEMORY_DEBUG_BYTE);
 #endif
@@ -31,13 +191,52 @@ Memory::Fill(void* ptr, int numBytes, uint8_t value) {
 void*
 Memory::ReAlloc(void* ptr, int s) {
     /// @todo: HMM need to fix fill with debug pattern...
-    return std::realloc(ptr, s);
+    if (nullptr == ptr) {
+        return Memory::alloc(s, ORYOL_MAX_PLATFORM_ALIGN, CurrentTag(), ORYOL_CALLSITE);
+    }
+    allocHeader* hdr = headerOf(ptr);
+    if (hdr->alignShift) {
+        // over-aligned memory can't be re-allocated in place
+        void* newPtr = Memory::alloc(s, 1 << hdr->alignShift, (MemoryTag::Code)hdr->tag, ORYOL_CALLSITE);
+        Memory::Copy(ptr, newPtr, s < hdr->size ? s : hdr->size);
+        Memory::Free(ptr);
+        return newPtr;
+    }
+    #if ORYOL_ALLOCATION_TRACKING
+    AllocationTracker::onFree(hdr->callSite, hdr->size);
+    #endif
+    Allocator* allocator = hdr->allocator;
+    if (allocator) {
+        hdr = (allocHeader*) allocator->ReAlloc(hdr, rawSize(hdr), s + HeaderSize);
+    }
+    else {
+        hdr = (allocHeader*) std::realloc(hdr, s + HeaderSize);
+    }
+    hdr->size = s;
+    #if ORYOL_ALLOCATION_TRACKING
+    if (MemoryTag::Frame != hdr->tag) {
+        hdr->callSite = AllocationTracker::onAlloc(ORYOL_CALLSITE, s);
+    }
+    #endif
+    return dataOf(hdr);
 }
 
 //------------------------------------------------------------------------------
 void
 Memory::Free(void* p) {
-    std::free(p);
+    if (nullptr == p) {
+        return;
+    }
+    allocHeader* hdr = headerOf(p);
+    #if ORYOL_ALLOCATION_TRACKING
+    AllocationTracker::onFree(hdr->callSite, hdr->size);
+    #endif
+    if (hdr->allocator) {
+        hdr->allocator->Free(rawOf(hdr), rawSize(hdr));
+    }
+    else {
+        std::free(rawOf(hdr));
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -58,7 +257,45 @@ Memory::Clear(void* ptr, int numBytes) {
     std::memset(ptr, 0, numBytes);
 }
 
-} // namespace Oryol
+//------------------------------------------------------------------------------
+/**
+    NOTE: allocators should only be installed during setup before 
+    other threads are running, memory which has been allocated 
+    before will still be freed through its original allocator.
+*/
+void
+Memory::SetAllocator(MemoryTag::Code tag, Allocator* allocator) {
+    o_assert_range(tag, MemoryTag::NumMemoryTags);
+    o_assert((MemoryTag::Frame != tag) || (nullptr == allocator));
+    allocators[tag] = allocator;
+}
 
+//------------------------------------------------------------------------------
+Allocator*
+Memory::GetAllocator(MemoryTag::Code tag) {
+    o_assert_range_dbg(tag, MemoryTag::NumMemoryTags);
+    return allocators[tag];
+}
 
+//------------------------------------------------------------------------------
+MemoryTag::Code
+Memory::CurrentTag() {
+    const MemoryTag::Code* tagPtr = threadTag();
+    return tagPtr ? *tagPtr : MemoryTag::Default;
+}
 
+//------------------------------------------------------------------------------
+void
+Memory::setCurrentTag(MemoryTag::Code tag) {
+    o_assert_range_dbg(tag, MemoryTag::NumMemoryTags);
+    threadTag() = &tagTable[tag];
+}
+
+//------------------------------------------------------------------------------
+MemoryTag::Code
+Memory::TagOf(const void* ptr) {
+    o_assert_dbg(ptr);
+    return (MemoryTag::Code) headerOf(ptr)->tag;
+}
+
+} // namespace Oryol
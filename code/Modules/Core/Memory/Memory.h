@@ -8,25 +8,52 @@
     Lowlevel memory allocation wrapper for Oryol. Standard memory alignment
     differs by platforms (e.g. platforms with SSE support return 16-byte
     aligned memory.
-    
-    @todo for now this simply calls malloc()/free(), may be more
-    advanced in the future.
+
+    Each allocation is associated with a MemoryTag, and each tag can be
+    routed to its own Allocator (installed through CoreSetup), by 
+    default memory is allocated with malloc(). The allocation tag 
+    is taken from the current thread's active tag (see ScopedTag), or
+    can be provided explicitly.
+
+    Memory::Alloc() returns memory aligned to ORYOL_MAX_PLATFORM_ALIGN,
+    use Memory::AllocAligned() for bigger power-of-two alignments
+    (e.g. for AVX or cache-line separation). Aligned memory can be 
+    freed with either Memory::FreeAligned() or Memory::Free().
+
+    Allocations can be tracked per call-site by compiling with 
+    ORYOL_ALLOCATION_TRACKING, see AllocationTracker.
+
+    @see Allocator, MemoryTag, CoreSetup, AllocationTracker
 */
 #include "Core/Types.h"
 #include "Core/Config.h"
+#include "Core/Memory/MemoryTag.h"
 #include <new>
 #include <utility>
 
 namespace Oryol {
+
+class Allocator;
     
 class Memory {
 public:
+    /// max alignment for AllocAligned()
+    static const int MaxAlignment = (1<<16) * ORYOL_MAX_PLATFORM_ALIGN;
+
     /// allocate a raw chunk of memory
     static void* Alloc(int numBytes);
-    /// re-allocate a raw chunk of memory
+    /// allocate a raw chunk of memory with explicit memory tag
+    static void* Alloc(int numBytes, MemoryTag::Code tag);
+    /// allocate a raw chunk of memory with power-of-two alignment
+    static void* AllocAligned(int numBytes, int alignment);
+    /// allocate a raw chunk of memory with power-of-two alignment and explicit memory tag
+    static void* AllocAligned(int numBytes, int alignment, MemoryTag::Code tag);
+    /// re-allocate a raw chunk of memory (keeps alignment)
     static void* ReAlloc(void* ptr, int numBytes);
     /// free a raw chunk of memory
     static void Free(void* ptr);
+    /// free aligned memory (same as Free())
+    static void FreeAligned(void* ptr);
     /// fill range of memory with a byte value
     static void Fill(void* ptr, int numBytes, uint8_t value);
     /// copy a raw chunk of non-overlapping memory
@@ -49,6 +76,32 @@ public:
         ptr->~TYPE();
         Memory::Free(ptr);
     };
+
+    /// install an allocator for a memory tag (nullptr for malloc)
+    static void SetAllocator(MemoryTag::Code tag, Allocator* allocator);
+    /// get the allocator for a memory tag (nullptr if malloc)
+    static Allocator* GetAllocator(MemoryTag::Code tag);
+    /// get the current thread's active memory tag
+    static MemoryTag::Code CurrentTag();
+    /// get the memory tag a chunk of memory has been allocated with
+    static MemoryTag::Code TagOf(const void* ptr);
+
+    /// set the current thread's memory tag for the life time of the object
+    class ScopedTag {
+    public:
+        /// constructor, sets new memory tag
+        ScopedTag(MemoryTag::Code tag);
+        /// destructor, restores previous memory tag
+        ~ScopedTag();
+    private:
+        MemoryTag::Code prevTag;
+    };
+
+private:
+    /// allocate memory with alignment and tag, call-site is used for allocation tracking
+    static void* alloc(int numBytes, int alignment, MemoryTag::Code tag, const void* callSite);
+    /// set the current thread's active memory tag
+    static void setCurrentTag(MemoryTag::Code tag);
 };
 
 //------------------------------------------------------------------------------
@@ -65,5 +118,18 @@ inline int
 Memory::RoundUp(int val, int roundTo) {
     return (val + (roundTo - 1)) & ~(roundTo - 1);
 }
+
+//------------------------------------------------------------------------------
+inline
+Memory::ScopedTag::ScopedTag(MemoryTag::Code tag) :
+prevTag(Memory::CurrentTag()) {
+    Memory::setCurrentTag(tag);
+}
+
+//------------------------------------------------------------------------------
+inline
+Memory::ScopedTag::~ScopedTag() {
+    Memory::setCurrentTag(this->prevTag);
+}
     
-} // namespace oryol
\ No newline at end of file
+} // namespace oryol
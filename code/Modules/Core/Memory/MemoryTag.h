@@ -0,0 +1,47 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::MemoryTag
+    @ingroup Core
+    @brief allocation tags to route memory allocations to different allocators
+
+    Each memory allocation made through Oryol::Memory carries a tag,
+    by default this is the current thread's active tag (see
+    Memory::ScopedTag). A separate Allocator can be installed per
+    tag through the CoreSetup object. The special Frame tag routes
+    allocations to the current thread's FrameAllocator.
+
+    @see Memory, Allocator, CoreSetup
+*/
+namespace Oryol {
+
+class MemoryTag {
+public:
+    /// memory tag enum
+    enum Code {
+        Default,
+        Core,
+        IO,
+        Resource,
+        Gfx,
+        Frame,      ///< per-thread frame memory, see FrameAllocator
+
+        NumMemoryTags,
+        InvalidMemoryTag,
+    };
+
+    /// convert to string
+    static const char* ToString(Code c) {
+        switch (c) {
+            case Default:   return "Default";
+            case Core:      return "Core";
+            case IO:        return "IO";
+            case Resource:  return "Resource";
+            case Gfx:       return "Gfx";
+            case Frame:     return "Frame";
+            default: return "InvalidMemoryTag";
+        }
+    };
+};
+
+} // namespace Oryol
@@ -0,0 +1,163 @@
+//------------------------------------------------------------------------------
+//  PoolAllocator.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "PoolAllocator.h"
+#include "Core/Assertion.h"
+#include <cstdlib>
+
+#if ORYOL_HAS_THREADS
+#define SCOPED_LOCK std::lock_guard<std::mutex> lock(this->lockMutex)
+#else
+#define SCOPED_LOCK
+#endif
+
+namespace Oryol {
+
+//------------------------------------------------------------------------------
+PoolAllocator::PoolAllocator(const char* name_, int pageSize_) :
+name(name_),
+pageSize(pageSize_),
+pages(nullptr) {
+    o_assert(this->pageSize >= (MaxBlockSize + PageHeaderSize));
+    for (int i = 0; i < NumSizeClasses; i++) {
+        this->freeLists[i] = nullptr;
+    }
+}
+
+//------------------------------------------------------------------------------
+PoolAllocator::~PoolAllocator() {
+    while (this->pages) {
+        page* next = this->pages->next;
+        std::free(this->pages);
+        this->pages = next;
+    }
+}
+
+//------------------------------------------------------------------------------
+const char*
+PoolAllocator::Name() const {
+    return this->name;
+}
+
+//------------------------------------------------------------------------------
+int
+PoolAllocator::SizeClass(int numBytes) {
+    int blockSize = MinBlockSize;
+    for (int i = 0; i < NumSizeClasses; i++, blockSize <<= 1) {
+        if (numBytes <= blockSize) {
+            return i;
+        }
+    }
+    return InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+int
+PoolAllocator::BlockSize(int sizeClass) {
+    o_assert_range_dbg(sizeClass, NumSizeClasses);
+    return MinBlockSize << sizeClass;
+}
+
+//------------------------------------------------------------------------------
+void
+PoolAllocator::allocPage(int sizeClass) {
+    // NOTE: must be called with lock held
+    uint8_t* ptr = (uint8_t*) std::malloc(this->pageSize);
+    o_assert(ptr);
+    page* p = (page*) ptr;
+    p->next = this->pages;
+    this->pages = p;
+    this->stats.ReservedBytes += this->pageSize;
+
+    // carve the page into blocks and put them on the free list
+    const int blockSize = BlockSize(sizeClass);
+    const int numBlocks = (this->pageSize - PageHeaderSize) / blockSize;
+    uint8_t* blockPtr = ptr + PageHeaderSize;
+    for (int i = 0; i < numBlocks; i++, blockPtr += blockSize) {
+        freeBlock* block = (freeBlock*) blockPtr;
+        block->next = this->freeLists[sizeClass];
+        this->freeLists[sizeClass] = block;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+PoolAllocator::statsAlloc(int numBytes) {
+    this->stats.LiveBytes += numBytes;
+    this->stats.NumLiveAllocs++;
+    this->stats.NumAllocs++;
+    if (this->stats.LiveBytes > this->stats.HighWaterMark) {
+        this->stats.HighWaterMark = this->stats.LiveBytes;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+PoolAllocator::statsFree(int numBytes) {
+    this->stats.LiveBytes -= numBytes;
+    this->stats.NumLiveAllocs--;
+    o_assert_dbg(this->stats.NumLiveAllocs >= 0);
+}
+
+//------------------------------------------------------------------------------
+void*
+PoolAllocator::Alloc(int numBytes) {
+    const int sizeClass = SizeClass(numBytes);
+    SCOPED_LOCK;
+    this->statsAlloc(numBytes);
+    if (InvalidIndex == sizeClass) {
+        // too big for the pools
+        this->stats.ReservedBytes += numBytes;
+        return std::malloc(numBytes);
+    }
+    if (nullptr == this->freeLists[sizeClass]) {
+        this->allocPage(sizeClass);
+    }
+    freeBlock* block = this->freeLists[sizeClass];
+    this->freeLists[sizeClass] = block->next;
+    return block;
+}
+
+//------------------------------------------------------------------------------
+void
+PoolAllocator::Free(void* ptr, int numBytes) {
+    o_assert_dbg(ptr);
+    const int sizeClass = SizeClass(numBytes);
+    SCOPED_LOCK;
+    this->statsFree(numBytes);
+    if (InvalidIndex == sizeClass) {
+        this->stats.ReservedBytes -= numBytes;
+        std::free(ptr);
+    }
+    else {
+        freeBlock* block = (freeBlock*) ptr;
+        block->next = this->freeLists[sizeClass];
+        this->freeLists[sizeClass] = block;
+    }
+}
+
+//------------------------------------------------------------------------------
+void*
+PoolAllocator::ReAlloc(void* ptr, int oldNumBytes, int newNumBytes) {
+    // if the new size fits into the same size class, nothing needs to be done
+    const int oldSizeClass = SizeClass(oldNumBytes);
+    if ((InvalidIndex != oldSizeClass) && (oldSizeClass == SizeClass(newNumBytes))) {
+        SCOPED_LOCK;
+        this->stats.LiveBytes += newNumBytes - oldNumBytes;
+        if (this->stats.LiveBytes > this->stats.HighWaterMark) {
+            this->stats.HighWaterMark = this->stats.LiveBytes;
+        }
+        return ptr;
+    }
+    return Allocator::ReAlloc(ptr, oldNumBytes, newNumBytes);
+}
+
+//------------------------------------------------------------------------------
+AllocatorStats
+PoolAllocator::Stats() const {
+    SCOPED_LOCK;
+    return this->stats;
+}
+
+} // namespace Oryol
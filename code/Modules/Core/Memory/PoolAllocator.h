@@ -0,0 +1,87 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::PoolAllocator
+    @ingroup Core
+    @brief size-class pool allocator backend
+
+    The PoolAllocator serves small allocations from a fixed number of
+    power-of-2 size classes (from MinBlockSize to MaxBlockSize bytes), each
+    size class has its own free-list of blocks carved from big memory pages.
+    Freed blocks go back into their free-list and are recycled, pages are
+    only returned to the system when the allocator is destroyed.
+    Allocations bigger than MaxBlockSize are passed through to malloc().
+
+    This drastically reduces heap fragmentation for typical Oryol
+    allocation patterns (many small, short-lived container buffers,
+    strings and ref-counted objects).
+
+    @see Allocator, ArenaAllocator
+*/
+#include "Core/Memory/Allocator.h"
+#include "Core/Config.h"
+#if ORYOL_HAS_THREADS
+#include <mutex>
+#endif
+
+namespace Oryol {
+
+class PoolAllocator : public Allocator {
+public:
+    /// number of size classes
+    static const int NumSizeClasses = 8;
+    /// smallest block size
+    static const int MinBlockSize = 32;
+    /// biggest block size, bigger allocations go to malloc()
+    static const int MaxBlockSize = MinBlockSize << (NumSizeClasses - 1);
+    /// default size of memory pages
+    static const int DefaultPageSize = 64 * 1024;
+
+    /// constructor
+    PoolAllocator(const char* name="PoolAllocator", int pageSize=DefaultPageSize);
+    /// destructor
+    virtual ~PoolAllocator();
+
+    /// get human-readable name
+    virtual const char* Name() const override;
+    /// allocate a chunk of memory
+    virtual void* Alloc(int numBytes) override;
+    /// free a chunk of memory
+    virtual void Free(void* ptr, int numBytes) override;
+    /// re-allocate a chunk of memory
+    virtual void* ReAlloc(void* ptr, int oldNumBytes, int newNumBytes) override;
+    /// get allocation statistics
+    virtual AllocatorStats Stats() const override;
+
+    /// get the size class index for a number of bytes (InvalidIndex if too big)
+    static int SizeClass(int numBytes);
+    /// get the block size of a size class
+    static int BlockSize(int sizeClass);
+
+private:
+    /// carve a new page into blocks for a size class
+    void allocPage(int sizeClass);
+    /// update stats after allocation
+    void statsAlloc(int numBytes);
+    /// update stats after free
+    void statsFree(int numBytes);
+
+    struct freeBlock {
+        freeBlock* next;
+    };
+    struct page {
+        page* next;
+    };
+    static const int PageHeaderSize = 16;
+
+    const char* name;
+    int pageSize;
+    freeBlock* freeLists[NumSizeClasses];
+    page* pages;
+    AllocatorStats stats;
+    #if ORYOL_HAS_THREADS
+    mutable std::mutex lockMutex;
+    #endif
+};
+
+} // namespace Oryol
@@ -8,7 +8,12 @@
     The Oryol smart pointer class is used together with the RefCounted
     base class to implement automatic object life-time management.
 
-    @see RefCounted
+    Each copy of a Ptr adds a reference, which is an atomic operation
+    on an object shared between threads. To hand an object to code
+    which doesn't keep it, either move the Ptr, or pass a Borrowed
+    pointer which doesn't touch the reference count (see borrow()).
+
+    @see RefCounted, WeakPtr, Borrowed
 */
 #include <type_traits>
 #include "Core/Types.h"
@@ -16,6 +21,8 @@
 
 namespace Oryol {
 
+template<class T> class Borrowed;
+
 template<class T> class Ptr {
     struct __nat {int __for_bool_;};
 public:
@@ -174,6 +181,16 @@ public:
         o_assert_dbg(nullptr != p);
         return p;
     };
+    /// borrow the object without adding a reference
+    Borrowed<T> borrow() const {
+        return Borrowed<T>(p);
+    };
+    /// low-level: take over an already added reference of a raw pointer
+    static Ptr<T> adopt(T* rhs) {
+        Ptr<T> ptr;
+        ptr.p = rhs;
+        return ptr;
+    };
 
     T* p;
 
@@ -194,4 +211,109 @@ private:
     };
 };
 
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::Borrowed
+    @ingroup Core
+    @brief a non-owning pointer to a ref-counted object
+
+    A Borrowed pointer is a raw pointer which is only valid as long as
+    some Ptr keeps the object alive, creating and copying it never
+    touches the reference count. In debug mode, the object counts the
+    Borrowed pointers pointing to it and asserts if it is destroyed
+    while still borrowed. Borrowed pointers are meant for function
+    arguments and locals, don't store them.
+*/
+template<class T> class Borrowed {
+public:
+    /// default constructor
+    Borrowed() : p(nullptr) { };
+    /// nullptr constructor
+    Borrowed(std::nullptr_t) : p(nullptr) { };
+    /// construct from raw pointer
+    explicit Borrowed(T* rhs) : p(rhs) {
+        this->add();
+    };
+    /// borrow from a Ptr
+    template<class U> Borrowed(const Ptr<U>& rhs) : p(rhs.getUnsafe()) {
+        this->add();
+    };
+    /// copy constructor
+    Borrowed(const Borrowed<T>& rhs) : p(rhs.p) {
+        this->add();
+    };
+    /// move constructor
+    Borrowed(Borrowed<T>&& rhs) : p(rhs.p) {
+        rhs.p = nullptr;
+    };
+    /// destructor
+    ~Borrowed() {
+        this->rel();
+    };
+    /// copy-assign
+    void operator=(const Borrowed<T>& rhs) {
+        if (rhs.p != this->p) {
+            this->rel();
+            this->p = rhs.p;
+            this->add();
+        }
+    };
+    /// move-assign
+    void operator=(Borrowed<T>&& rhs) {
+        if (rhs.p != this->p) {
+            this->rel();
+            this->p = rhs.p;
+        }
+        else {
+            rhs.rel();
+        }
+        rhs.p = nullptr;
+    };
+
+    /// cast to bool
+    explicit operator bool() const {
+        return nullptr != p;
+    };
+    /// operator*
+    T& operator*() const {
+        o_assert_dbg(nullptr != p);
+        return *p;
+    };
+    /// operator->
+    T* operator->() const {
+        o_assert_dbg(nullptr != p);
+        return p;
+    };
+    /// get (assert that returned pointer is not nullptr)
+    T* get() const {
+        o_assert_dbg(nullptr != p);
+        return p;
+    };
+    /// unsafe get, may return nullptr
+    T* getUnsafe() const {
+        return p;
+    };
+    /// get an owning Ptr (adds a reference)
+    Ptr<T> lock() const {
+        return Ptr<T>(p);
+    };
+
+private:
+    void add() {
+        #if ORYOL_DEBUG
+        if (p) {
+            p->addBorrow();
+        }
+        #endif
+    };
+    void rel() {
+        #if ORYOL_DEBUG
+        if (p) {
+            p->releaseBorrow();
+        }
+        #endif
+    };
+    T* p;
+};
+
 } // namespace oryol
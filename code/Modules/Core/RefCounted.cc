@@ -0,0 +1,175 @@
+//------------------------------------------------------------------------------
+//  RefCounted.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "RefCounted.h"
+#include "Core/Assertion.h"
+#if ORYOL_DEBUG && ORYOL_HAS_THREADS
+#include <functional>
+#include <thread>
+#endif
+
+namespace Oryol {
+
+#if ORYOL_DEBUG
+namespace {
+    uintptr_t currentThread() {
+        #if ORYOL_HAS_THREADS
+        return uintptr_t(std::hash<std::thread::id>()(std::this_thread::get_id())) | 1;
+        #else
+        return 1;
+        #endif
+    }
+}
+#endif
+
+//------------------------------------------------------------------------------
+void
+_priv::weakRefBlock::release() {
+    #if ORYOL_HAS_ATOMIC
+    if (1 == this->refCount.fetch_sub(1, std::memory_order_acq_rel)) {
+    #else
+    if (1 == this->refCount--) {
+    #endif
+        Memory::Delete(this);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+    NOTE: this must be called while the object is only referenced by
+    the calling thread, usually right after creation.
+*/
+void
+RefCounted::SetSingleThreaded() {
+    o_assert(this->refCount <= 1);
+    #if ORYOL_DEBUG
+    this->ownerThread = currentThread();
+    #endif
+    this->singleThreaded = true;
+}
+
+//------------------------------------------------------------------------------
+#if ORYOL_DEBUG
+void
+RefCounted::checkOwnerThread() const {
+    o_assert2(currentThread() == this->ownerThread, "Single-threaded RefCounted object accessed from other thread!\n");
+}
+#endif
+
+//------------------------------------------------------------------------------
+/**
+    The reference count is only incremented if it isn't zero, so that
+    a WeakPtr can't resurrect an object which is already being destroyed.
+*/
+bool
+RefCounted::tryAddRef() {
+    #if ORYOL_HAS_ATOMIC
+    if (this->singleThreaded) {
+        #if ORYOL_DEBUG
+        this->checkOwnerThread();
+        #endif
+        const int cur = this->refCount.load(std::memory_order_relaxed);
+        if (0 == cur) {
+            return false;
+        }
+        this->refCount.store(cur + 1, std::memory_order_relaxed);
+        return true;
+    }
+    int cur = this->refCount.load(std::memory_order_relaxed);
+    while (cur > 0) {
+        if (this->refCount.compare_exchange_weak(cur, cur + 1, std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+    return false;
+    #else
+    if (0 == this->refCount) {
+        return false;
+    }
+    this->refCount++;
+    return true;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+_priv::weakRefBlock*
+RefCounted::weakBlock() {
+    #if ORYOL_HAS_ATOMIC
+    _priv::weakRefBlock* block = this->weakRefs.load(std::memory_order_acquire);
+    if (nullptr == block) {
+        // the new block holds one reference for the object itself
+        _priv::weakRefBlock* newBlock = Memory::New<_priv::weakRefBlock>();
+        newBlock->obj = this;
+        if (this->weakRefs.compare_exchange_strong(block, newBlock, std::memory_order_acq_rel)) {
+            block = newBlock;
+        }
+        else {
+            // another thread was faster
+            Memory::Delete(newBlock);
+        }
+    }
+    return block;
+    #else
+    if (nullptr == this->weakRefs) {
+        this->weakRefs = Memory::New<_priv::weakRefBlock>();
+        this->weakRefs->obj = this;
+    }
+    return this->weakRefs;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+/**
+    A WeakPtr::lock() which runs concurrently either sees the object
+    before the block is detached (and then fails to add a reference
+    because the count is already zero), or sees a nullptr object.
+*/
+void
+RefCounted::detachWeakBlock() {
+    #if ORYOL_HAS_ATOMIC
+    _priv::weakRefBlock* block = this->weakRefs.exchange(nullptr, std::memory_order_acq_rel);
+    #else
+    _priv::weakRefBlock* block = this->weakRefs;
+    this->weakRefs = nullptr;
+    #endif
+    if (block) {
+        block->lock();
+        block->obj = nullptr;
+        block->unlock();
+        block->release();
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+RefCounted::onLastRelease() {
+    #if ORYOL_HAS_ATOMIC
+    std::atomic_thread_fence(std::memory_order_acquire);
+    #endif
+    if (this->weakRefs) {
+        this->detachWeakBlock();
+    }
+    #if ORYOL_DEBUG
+    o_assert2(0 == this->borrowCount, "RefCounted object destroyed while still borrowed!\n");
+    #endif
+    // destroy() is virtual and provided by the OryolClassDecl macro
+    this->destroy();
+}
+
+#if ORYOL_DEBUG
+//------------------------------------------------------------------------------
+void
+RefCounted::addBorrow() {
+    this->borrowCount++;
+}
+
+//------------------------------------------------------------------------------
+void
+RefCounted::releaseBorrow() {
+    o_assert(this->borrowCount > 0);
+    this->borrowCount--;
+}
+#endif
+
+} // namespace Oryol
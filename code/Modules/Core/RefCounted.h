@@ -6,10 +6,24 @@
     @brief Oryol's reference-counted base class
 
     The RefCounted class is used together with the Ptr smart-pointer class
-    to automatically manage the life-time of objects through 
+    to automatically manage the life-time of objects through
     reference-counting.
- 
-    @see Ptr
+
+    The reference count is atomic by default, since Ptr's are handed
+    between threads (for instance IO requests). Objects which are
+    only ever referenced from one thread can switch to non-atomic
+    counting with SetSingleThreaded(), in debug mode this checks that
+    all reference count changes happen on the owner thread.
+
+    Weak references (see WeakPtr) don't keep the object alive, they are
+    tracked through a small separately allocated block which is only
+    created when the first WeakPtr to an object is created.
+
+    Borrowed references (see Ptr::borrow()) don't touch the reference
+    count at all, in debug mode the object counts its borrows and
+    asserts if it is destroyed while still borrowed.
+
+    @see Ptr, WeakPtr, Borrowed
 */
 #include "Core/Types.h"
 #include "Core/Ptr.h"
@@ -20,7 +34,34 @@
 #endif
 
 namespace Oryol {
-    
+
+class RefCounted;
+
+namespace _priv {
+/// the shared block between an object and its weak pointers
+class weakRefBlock {
+public:
+    /// lock the block (the object can't be destroyed while locked)
+    void lock();
+    /// unlock the block
+    void unlock();
+    /// add a reference to the block
+    void addRef();
+    /// release a reference, deletes the block when the last reference is gone
+    void release();
+
+    /// the object, or nullptr if the object has been destroyed
+    RefCounted* obj = nullptr;
+private:
+    #if ORYOL_HAS_ATOMIC
+    std::atomic<int> refCount{1};
+    std::atomic_flag spinLock = ATOMIC_FLAG_INIT;
+    #else
+    int32_t refCount{1};
+    #endif
+};
+} // namespace _priv
+
 class RefCounted {
     OryolBaseClassDecl(RefCounted);
 public:
@@ -28,16 +69,50 @@ public:
     virtual ~RefCounted() { };
     /// get reference count
     int GetRefCount() const;
+    /// switch to non-atomic reference counting (only valid for single-thread owned objects)
+    void SetSingleThreaded();
+    /// return true if reference counting is non-atomic
+    bool IsSingleThreaded() const;
     /// add reference
     void addRef();
     /// release reference (calls destructor when ref_count reaches zero)
     void release();
+    /// add a reference unless the object is already being destroyed
+    bool tryAddRef();
+    /// get the weak reference block, create if not exists
+    _priv::weakRefBlock* weakBlock();
+    #if ORYOL_DEBUG
+    /// debug: add a borrowed reference
+    void addBorrow();
+    /// debug: release a borrowed reference
+    void releaseBorrow();
+    #endif
 
 private:
+    /// detach the weak reference block before the object is destroyed
+    void detachWeakBlock();
+    /// called when the reference count drops to zero
+    void onLastRelease();
+    #if ORYOL_DEBUG
+    /// debug: check that a single-threaded object is accessed from its owner thread
+    void checkOwnerThread() const;
+    #endif
+
     #if ORYOL_HAS_ATOMIC
     std::atomic<int> refCount{0};
+    std::atomic<_priv::weakRefBlock*> weakRefs{nullptr};
     #else
     int32_t refCount{0};
+    _priv::weakRefBlock* weakRefs{nullptr};
+    #endif
+    bool singleThreaded = false;
+    #if ORYOL_DEBUG
+    #if ORYOL_HAS_ATOMIC
+    std::atomic<int> borrowCount{0};
+    #else
+    int32_t borrowCount{0};
+    #endif
+    uintptr_t ownerThread = 0;
     #endif
 };
 
@@ -45,7 +120,16 @@ private:
 inline void
 RefCounted::addRef() {
     #if ORYOL_HAS_ATOMIC
-    this->refCount.fetch_add(1, std::memory_order_relaxed);
+    if (this->singleThreaded) {
+        #if ORYOL_DEBUG
+        this->checkOwnerThread();
+        #endif
+        // no other thread touches the counter, a plain load and store will do
+        this->refCount.store(this->refCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    else {
+        this->refCount.fetch_add(1, std::memory_order_relaxed);
+    }
     #else
     this->refCount++;
     #endif
@@ -55,12 +139,23 @@ RefCounted::addRef() {
 inline void
 RefCounted::release() {
     #if ORYOL_HAS_ATOMIC
-    if (1 == this->refCount.fetch_sub(1, std::memory_order_relaxed)) {
+    int prev;
+    if (this->singleThreaded) {
+        #if ORYOL_DEBUG
+        this->checkOwnerThread();
+        #endif
+        prev = this->refCount.load(std::memory_order_relaxed);
+        this->refCount.store(prev - 1, std::memory_order_relaxed);
+    }
+    else {
+        // release-order pairs with the acquire-fence in onLastRelease()
+        prev = this->refCount.fetch_sub(1, std::memory_order_release);
+    }
+    if (1 == prev) {
     #else
     if (1 == this->refCount--) {
     #endif
-        // destroy() is virtual and provided by the OryolClassDecl macro
-        this->destroy();
+        this->onLastRelease();
     }
 }
 
@@ -71,4 +166,38 @@ RefCounted::GetRefCount() const
     return this->refCount;
 }
 
+//------------------------------------------------------------------------------
+inline bool
+RefCounted::IsSingleThreaded() const {
+    return this->singleThreaded;
+}
+
+//------------------------------------------------------------------------------
+inline void
+_priv::weakRefBlock::lock() {
+    #if ORYOL_HAS_ATOMIC
+    while (this->spinLock.test_and_set(std::memory_order_acquire)) {
+        // spin, the lock is only held for a few instructions
+    }
+    #endif
+}
+
+//------------------------------------------------------------------------------
+inline void
+_priv::weakRefBlock::unlock() {
+    #if ORYOL_HAS_ATOMIC
+    this->spinLock.clear(std::memory_order_release);
+    #endif
+}
+
+//------------------------------------------------------------------------------
+inline void
+_priv::weakRefBlock::addRef() {
+    #if ORYOL_HAS_ATOMIC
+    this->refCount.fetch_add(1, std::memory_order_relaxed);
+    #else
+    this->refCount++;
+    #endif
+}
+
 } // namespace Oryol
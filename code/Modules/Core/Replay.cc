@@ -0,0 +1,333 @@
+//------------------------------------------------------------------------------
+//  Replay.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "Replay.h"
+#include "Core/Assertion.h"
+#include "Core/Log.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Containers/Buffer.h"
+#include <cstdio>
+#include <cstring>
+
+namespace Oryol {
+
+namespace {
+    const uint32_t replayMagic = 0x4C50524F;    // 'ORPL'
+    const uint32_t replayVersion = 1;
+    // a record with this channel index defines the name of a file channel
+    const int32_t channelDefinition = -1;
+
+    struct recordHeader {
+        uint32_t frame;
+        int32_t channel;
+        int32_t size;
+    };
+
+    struct _state {
+        const char* names[Replay::MaxChannels] = { };
+        Replay::PlaybackFunc handlers[Replay::MaxChannels];
+        int numChannels = 0;
+        int64_t frameIndex = -1;
+
+        // recording: channels are defined in the file on first use,
+        // file channel indices are assigned in definition order
+        FILE* recordFile = nullptr;
+        int32_t recordChannelIndex[Replay::MaxChannels] = { };
+        int numRecordChannels = 0;
+
+        // playback: the whole file is loaded, file channels are
+        // mapped to registered channels by name on first use
+        bool playing = false;
+        Buffer playbackData;
+        int playbackPos = 0;
+        const char* fileChannelNames[Replay::MaxChannels] = { };
+        Replay::ChannelId fileChannelMap[Replay::MaxChannels] = { };
+        int numFileChannels = 0;
+    };
+    _state* state = nullptr;
+
+    //--------------------------------------------------------------------------
+    _state*
+    getState() {
+        // NOTE: never released, same as the Counters registry
+        if (nullptr == state) {
+            state = Memory::New<_state>();
+        }
+        return state;
+    }
+
+    //--------------------------------------------------------------------------
+    void
+    writeRecord(uint32_t frame, int32_t channel, const void* data, int size) {
+        recordHeader hdr;
+        hdr.frame = frame;
+        hdr.channel = channel;
+        hdr.size = size;
+        std::fwrite(&hdr, sizeof(hdr), 1, state->recordFile);
+        if (size > 0) {
+            std::fwrite(data, size, 1, state->recordFile);
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    Replay::ChannelId
+    mapFileChannel(int32_t fileChannel) {
+        o_assert_range_dbg(fileChannel, state->numFileChannels);
+        Replay::ChannelId id = state->fileChannelMap[fileChannel];
+        if (Replay::InvalidChannelId == id) {
+            // the channel may have been registered since the last lookup
+            id = Replay::FindChannel(state->fileChannelNames[fileChannel]);
+            state->fileChannelMap[fileChannel] = id;
+        }
+        return id;
+    }
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+Replay::ChannelId
+Replay::RegisterChannel(const char* name) {
+    o_assert(nullptr != name);
+    ChannelId id = FindChannel(name);
+    if (InvalidChannelId == id) {
+        _state* s = getState();
+        o_assert2(s->numChannels < MaxChannels, "Too many Replay channels registered!\n");
+        id = s->numChannels++;
+        s->names[id] = name;
+    }
+    return id;
+}
+
+//------------------------------------------------------------------------------
+Replay::ChannelId
+Replay::FindChannel(const char* name) {
+    o_assert(nullptr != name);
+    _state* s = getState();
+    for (int i = 0; i < s->numChannels; i++) {
+        if (0 == std::strcmp(s->names[i], name)) {
+            return i;
+        }
+    }
+    return InvalidChannelId;
+}
+
+//------------------------------------------------------------------------------
+void
+Replay::SetPlaybackHandler(ChannelId id, PlaybackFunc func) {
+    o_assert_range(id, getState()->numChannels);
+    state->handlers[id] = func;
+}
+
+//------------------------------------------------------------------------------
+void
+Replay::ClearPlaybackHandler(ChannelId id) {
+    o_assert_range(id, getState()->numChannels);
+    state->handlers[id] = nullptr;
+}
+
+//------------------------------------------------------------------------------
+bool
+Replay::StartRecording(const char* path) {
+    o_assert(nullptr != path);
+    o_assert(!IsRecording() && !IsPlaying());
+    _state* s = getState();
+    s->recordFile = std::fopen(path, "wb");
+    if (nullptr == s->recordFile) {
+        o_warn("Replay::StartRecording(): failed to open '%s'\n", path);
+        return false;
+    }
+    std::fwrite(&replayMagic, sizeof(replayMagic), 1, s->recordFile);
+    std::fwrite(&replayVersion, sizeof(replayVersion), 1, s->recordFile);
+    for (int i = 0; i < MaxChannels; i++) {
+        s->recordChannelIndex[i] = channelDefinition;
+    }
+    s->numRecordChannels = 0;
+    s->frameIndex = -1;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+bool
+Replay::StartPlayback(const char* path) {
+    o_assert(nullptr != path);
+    o_assert(!IsRecording() && !IsPlaying());
+    _state* s = getState();
+    FILE* fp = std::fopen(path, "rb");
+    if (nullptr == fp) {
+        o_warn("Replay::StartPlayback(): failed to open '%s'\n", path);
+        return false;
+    }
+    std::fseek(fp, 0, SEEK_END);
+    const int fileSize = int(std::ftell(fp));
+    std::fseek(fp, 0, SEEK_SET);
+    s->playbackData.Clear();
+    if (fileSize > 0) {
+        const bool ok = (1 == std::fread(s->playbackData.Add(fileSize), fileSize, 1, fp));
+        if (!ok) {
+            s->playbackData.Clear();
+        }
+    }
+    std::fclose(fp);
+
+    // check the file header, and the integrity of all records
+    const uint8_t* data = s->playbackData.Data();
+    const int size = s->playbackData.Size();
+    uint32_t magic = 0, version = 0;
+    if (size >= int(2 * sizeof(uint32_t))) {
+        std::memcpy(&magic, data, sizeof(magic));
+        std::memcpy(&version, data + sizeof(magic), sizeof(version));
+    }
+    if ((replayMagic != magic) || (replayVersion != version)) {
+        o_warn("Replay::StartPlayback(): '%s' is not a valid replay file\n", path);
+        s->playbackData.Clear();
+        return false;
+    }
+    const int start = 2 * sizeof(uint32_t);
+    for (int pos = start; pos < size; ) {
+        recordHeader hdr = { };
+        if ((pos + int(sizeof(hdr))) > size) {
+            pos = -1;
+        }
+        else {
+            std::memcpy(&hdr, data + pos, sizeof(hdr));
+            pos += int(sizeof(hdr)) + hdr.size;
+        }
+        if ((pos < 0) || (pos > size) || (hdr.size < 0) || (hdr.channel < channelDefinition)) {
+            o_warn("Replay::StartPlayback(): '%s' is truncated\n", path);
+            s->playbackData.Clear();
+            return false;
+        }
+    }
+    s->playbackPos = start;
+    s->numFileChannels = 0;
+    s->frameIndex = -1;
+    s->playing = true;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+void
+Replay::Stop() {
+    _state* s = getState();
+    if (s->recordFile) {
+        std::fclose(s->recordFile);
+        s->recordFile = nullptr;
+    }
+    if (s->playing) {
+        s->playing = false;
+        s->playbackData.Clear();
+        s->playbackPos = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+Replay::IsRecording() {
+    return state && (nullptr != state->recordFile);
+}
+
+//------------------------------------------------------------------------------
+bool
+Replay::IsPlaying() {
+    return state && state->playing;
+}
+
+//------------------------------------------------------------------------------
+bool
+Replay::PlaybackFinished() {
+    return IsPlaying() && (state->playbackPos >= state->playbackData.Size());
+}
+
+//------------------------------------------------------------------------------
+void
+Replay::PeekRecords(ChannelId id, PlaybackFunc func) {
+    o_assert_range(id, getState()->numChannels);
+    if (!state->playing) {
+        return;
+    }
+    // the channel definitions may come before the current position,
+    // so the file is scanned from the start
+    const char* fileChannelNames[MaxChannels] = { };
+    int numFileChannels = 0;
+    const uint8_t* data = state->playbackData.Data();
+    const int size = state->playbackData.Size();
+    for (int pos = 2 * sizeof(uint32_t); pos < size; ) {
+        recordHeader hdr;
+        std::memcpy(&hdr, data + pos, sizeof(hdr));
+        const uint8_t* payload = data + pos + sizeof(hdr);
+        const bool dispatched = pos < state->playbackPos;
+        pos += int(sizeof(hdr)) + hdr.size;
+        if (channelDefinition == hdr.channel) {
+            if (numFileChannels < MaxChannels) {
+                fileChannelNames[numFileChannels++] = (const char*) payload;
+            }
+        }
+        else if (!dispatched && (hdr.channel < numFileChannels) &&
+                 (0 == std::strcmp(fileChannelNames[hdr.channel], state->names[id]))) {
+            func(payload, hdr.size);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+Replay::Record(ChannelId id, const void* data, int size) {
+    o_assert_dbg(IsRecording());
+    o_assert_range_dbg(id, state->numChannels);
+    o_assert_dbg((nullptr != data) || (0 == size));
+    // NOTE: records written before the first frame belong to frame 0
+    const uint32_t frame = uint32_t(state->frameIndex < 0 ? 0 : state->frameIndex);
+    if (channelDefinition == state->recordChannelIndex[id]) {
+        const char* name = state->names[id];
+        writeRecord(frame, channelDefinition, name, int(std::strlen(name)) + 1);
+        state->recordChannelIndex[id] = state->numRecordChannels++;
+    }
+    writeRecord(frame, state->recordChannelIndex[id], data, size);
+}
+
+//------------------------------------------------------------------------------
+void
+Replay::BeginFrame() {
+    _state* s = getState();
+    s->frameIndex++;
+    if (!s->playing) {
+        return;
+    }
+    // dispatch all records up to and including the new frame
+    const uint8_t* data = s->playbackData.Data();
+    const int size = s->playbackData.Size();
+    while (s->playbackPos < size) {
+        recordHeader hdr;
+        std::memcpy(&hdr, data + s->playbackPos, sizeof(hdr));
+        if (int64_t(hdr.frame) > s->frameIndex) {
+            break;
+        }
+        const uint8_t* payload = data + s->playbackPos + sizeof(hdr);
+        s->playbackPos += int(sizeof(hdr)) + hdr.size;
+        if (channelDefinition == hdr.channel) {
+            if (s->numFileChannels < MaxChannels) {
+                s->fileChannelNames[s->numFileChannels] = (const char*) payload;
+                s->fileChannelMap[s->numFileChannels] = InvalidChannelId;
+                s->numFileChannels++;
+            }
+        }
+        else if (hdr.channel < s->numFileChannels) {
+            const ChannelId id = mapFileChannel(hdr.channel);
+            if ((InvalidChannelId != id) && s->handlers[id]) {
+                s->handlers[id](payload, hdr.size);
+                if (!s->playing) {
+                    // the handler has stopped the playback
+                    return;
+                }
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+int64_t
+Replay::FrameIndex() {
+    return state ? state->frameIndex : -1;
+}
+
+} // namespace Oryol
@@ -0,0 +1,90 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::Replay
+    @ingroup Core
+    @brief record and play back per-frame events for deterministic runs
+
+    Replay records the nondeterministic inputs of an application (like
+    input events or IO responses) into a file, tagged with the frame
+    they happened in, and feeds them back in the same frames when the
+    file is played back. Together with the simulated time of the Clock
+    this makes a run reproducible, which is what App's benchmark mode
+    is built on.
+
+    Replay doesn't know the content of the recorded events. Modules
+    register a named channel, call Record() with a binary blob while
+    recording, and install a playback handler which is called with
+    the same blob in the same frame during playback:
+
+    @code
+    static Replay::ChannelId channel = Replay::RegisterChannel("Input");
+    Replay::SetPlaybackHandler(channel, [](const uint8_t* data, int size) {
+        // apply the recorded event
+    });
+    ...
+    if (Replay::IsRecording()) {
+        Replay::Record(channel, &event, sizeof(event));
+    }
+    @endcode
+
+    App calls BeginFrame() at the start of each frame, this advances
+    the frame counter and dispatches the recorded events of the new
+    frame to the playback handlers. Records of channels without a
+    playback handler are dropped. PeekRecords() looks ahead at the
+    records of a channel which haven't been dispatched yet, for
+    instance to check whether a response has been recorded at all.
+
+    The file is written with native endianness and can only be
+    played back on the same platform. Replay must only be used
+    from the main thread.
+*/
+#include "Core/Types.h"
+#include <functional>
+
+namespace Oryol {
+
+class Replay {
+public:
+    /// a channel id
+    typedef int ChannelId;
+    /// an invalid channel id
+    static const ChannelId InvalidChannelId = -1;
+    /// max number of channels
+    static const int MaxChannels = 32;
+    /// a playback handler, called with a recorded blob
+    typedef std::function<void(const uint8_t* data, int size)> PlaybackFunc;
+
+    /// register a channel (returns the existing id if already registered)
+    static ChannelId RegisterChannel(const char* name);
+    /// find a channel by name, return InvalidChannelId if not registered
+    static ChannelId FindChannel(const char* name);
+    /// set the playback handler of a channel
+    static void SetPlaybackHandler(ChannelId id, PlaybackFunc func);
+    /// remove the playback handler of a channel
+    static void ClearPlaybackHandler(ChannelId id);
+
+    /// start recording into a file, return false if the file can't be opened
+    static bool StartRecording(const char* path);
+    /// start playback of a recorded file, return false if the file is missing or invalid
+    static bool StartPlayback(const char* path);
+    /// stop recording or playback
+    static void Stop();
+    /// return true if recording
+    static bool IsRecording();
+    /// return true if playing back
+    static bool IsPlaying();
+    /// return true if all records of the played back file have been dispatched
+    static bool PlaybackFinished();
+    /// call func with the records of a channel which haven't been dispatched yet (during playback)
+    static void PeekRecords(ChannelId id, PlaybackFunc func);
+
+    /// record a blob into the current frame (only valid while recording)
+    static void Record(ChannelId id, const void* data, int size);
+    /// advance to the next frame, and dispatch its records during playback
+    static void BeginFrame();
+    /// get the current frame index (0 is the first frame)
+    static int64_t FrameIndex();
+};
+
+} // namespace Oryol
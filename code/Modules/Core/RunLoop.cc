@@ -3,12 +3,17 @@
 //------------------------------------------------------------------------------
 #include "Pre.h"
 #include "RunLoop.h"
+#include "Core/Assertion.h"
 
 namespace Oryol {
 
 //------------------------------------------------------------------------------
 RunLoop::RunLoop() :
 curId(InvalidId)
+#if ORYOL_HAS_THREADS
+, threadId(std::this_thread::get_id())
+, remoteDirty(false)
+#endif
 {
     // empty
 }
@@ -18,24 +23,43 @@ RunLoop::~RunLoop() {
     // empty
 }
 
+//------------------------------------------------------------------------------
+bool
+RunLoop::isRunLoopThread() const {
+    #if ORYOL_HAS_THREADS
+    return std::this_thread::get_id() == this->threadId;
+    #else
+    return true;
+    #endif
+}
+
 //------------------------------------------------------------------------------
 void
 RunLoop::Run() {
-    this->remCallbacks();
-    this->addCallbacks();
-    for (const auto& entry : this->callbacks) {
-        if (entry.Value().valid) {
-            entry.Value().func();
+    o_assert_dbg(this->isRunLoopThread());
+    #if ORYOL_HAS_THREADS
+    if (this->dirty || this->remoteDirty.load(std::memory_order_acquire)) {
+    #else
+    if (this->dirty) {
+    #endif
+        this->applyPending();
+    }
+    // NOTE: the callbacks array isn't modified while iterating, adds
+    // and removes from inside a callback are deferred
+    const int num = this->callbacks.Size();
+    for (int i = 0; i < num; i++) {
+        const item& cur = this->callbacks[i];
+        if (InvalidId != cur.id) {
+            cur.func();
         }
     }
-    this->remCallbacks();
-    this->addCallbacks();
-}
-
-//------------------------------------------------------------------------------
-bool
-RunLoop::HasCallback(Id id) const {
-    return this->callbacks.Contains(id) || this->toAdd.Contains(id);
+    #if ORYOL_HAS_THREADS
+    if (this->dirty || this->remoteDirty.load(std::memory_order_acquire)) {
+    #else
+    if (this->dirty) {
+    #endif
+        this->applyPending();
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -44,47 +68,167 @@ RunLoop::HasCallback(Id id) const {
  start or end of the Run function.
 */
 RunLoop::Id
-RunLoop::Add(Func func) {
-    Id newId = ++this->curId;
-    this->toAdd.Add(newId, item{func, false});
+RunLoop::Add(Func func, int priority) {
+    o_assert_dbg(func);
+    const Id newId = this->curId.fetch_add(1, std::memory_order_relaxed) + 1;
+    item newItem;
+    newItem.id = newId;
+    newItem.priority = priority;
+    newItem.func = std::move(func);
+    #if ORYOL_HAS_THREADS
+    if (!this->isRunLoopThread()) {
+        std::lock_guard<std::mutex> lock(this->remoteMutex);
+        this->remoteAdd.Add(std::move(newItem));
+        this->remoteDirty.store(true, std::memory_order_release);
+        return newId;
+    }
+    #endif
+    this->toAdd.Add(std::move(newItem));
+    this->dirty = true;
     return newId;
 }
 
 //------------------------------------------------------------------------------
 /**
- NOTE: the callback function not be removed immediately, but at the 
- start or end of the Run function.
+ NOTE: a callback removed on the runloop's thread won't be called anymore
+ (even if Remove() is called from inside Run()), but the array entry is
+ only cleaned up at the start or end of the Run function. A callback
+ removed from another thread is removed at the start or end of the
+ next Run().
 */
 void
 RunLoop::Remove(Id id) {
-    o_assert_dbg(!this->toRemove.Contains(id));
-    o_assert_dbg(this->callbacks.Contains(id) || this->toAdd.Contains(id));
-    this->toRemove.Add(id);
+    o_assert_dbg(InvalidId != id);
+    #if ORYOL_HAS_THREADS
+    if (!this->isRunLoopThread()) {
+        std::lock_guard<std::mutex> lock(this->remoteMutex);
+        this->remoteRemove.Add(id);
+        this->remoteDirty.store(true, std::memory_order_release);
+        return;
+    }
+    #endif
+    if (!this->remove(id)) {
+        #if ORYOL_HAS_THREADS
+        // might have been added from another thread and not been applied yet
+        std::lock_guard<std::mutex> lock(this->remoteMutex);
+        this->remoteRemove.Add(id);
+        this->remoteDirty.store(true, std::memory_order_release);
+        #else
+        o_assert2_dbg(false, "RunLoop::Remove(): invalid id!\n");
+        #endif
+    }
 }
 
 //------------------------------------------------------------------------------
-void
-RunLoop::addCallbacks() {
-    for (auto& entry : this->toAdd) {
-        item& item = entry.Value();
-        item.valid = true;
-        this->callbacks.Add(entry.Key(), item);
+bool
+RunLoop::remove(Id id) {
+    for (item& cur : this->callbacks) {
+        if (id == cur.id) {
+            cur.id = InvalidId;
+            this->dirty = true;
+            return true;
+        }
     }
-    this->toAdd.Clear();
+    for (int i = 0; i < this->toAdd.Size(); i++) {
+        if (id == this->toAdd[i].id) {
+            this->toAdd.Erase(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+bool
+RunLoop::HasCallback(Id id) const {
+    o_assert_dbg(this->isRunLoopThread());
+    if (InvalidId == id) {
+        return false;
+    }
+    for (const item& cur : this->callbacks) {
+        if (id == cur.id) {
+            return true;
+        }
+    }
+    for (const item& cur : this->toAdd) {
+        if (id == cur.id) {
+            return true;
+        }
+    }
+    #if ORYOL_HAS_THREADS
+    std::lock_guard<std::mutex> lock(this->remoteMutex);
+    for (const item& cur : this->remoteAdd) {
+        if (id == cur.id) {
+            return this->remoteRemove.FindIndexLinear(id) == InvalidIndex;
+        }
+    }
+    #endif
+    return false;
+}
+
+//------------------------------------------------------------------------------
+int
+RunLoop::NumCallbacks() const {
+    o_assert_dbg(this->isRunLoopThread());
+    int num = this->toAdd.Size();
+    for (const item& cur : this->callbacks) {
+        if (InvalidId != cur.id) {
+            num++;
+        }
+    }
+    #if ORYOL_HAS_THREADS
+    std::lock_guard<std::mutex> lock(this->remoteMutex);
+    num += this->remoteAdd.Size();
+    #endif
+    return num;
 }
 
 //------------------------------------------------------------------------------
 void
-RunLoop::remCallbacks() {
-    for (Id id : this->toRemove) {
-        if (this->callbacks.Contains(id)) {
-            this->callbacks.Erase(id);
+RunLoop::applyPending() {
+    o_assert_dbg(this->isRunLoopThread());
+
+    // move adds and removes from other threads over
+    #if ORYOL_HAS_THREADS
+    if (this->remoteDirty.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(this->remoteMutex);
+        for (item& cur : this->remoteAdd) {
+            this->toAdd.Add(std::move(cur));
         }
-        else if (this->toAdd.Contains(id)) {
-            this->toAdd.Erase(id);
+        this->remoteAdd.Clear();
+        for (Id id : this->remoteRemove) {
+            this->remove(id);
+        }
+        this->remoteRemove.Clear();
+        this->remoteDirty.store(false, std::memory_order_relaxed);
+    }
+    #endif
+
+    // compact removed callbacks, keeping the order
+    int dst = 0;
+    const int num = this->callbacks.Size();
+    for (int src = 0; src < num; src++) {
+        if (InvalidId != this->callbacks[src].id) {
+            if (dst != src) {
+                this->callbacks[dst] = std::move(this->callbacks[src]);
+            }
+            dst++;
         }
     }
-    this->toRemove.Clear();
+    if (dst < num) {
+        this->callbacks.EraseRange(dst, num - dst);
+    }
+
+    // insert new callbacks behind callbacks with the same priority
+    for (item& newItem : this->toAdd) {
+        int index = this->callbacks.Size();
+        while ((index > 0) && (this->callbacks[index - 1].priority > newItem.priority)) {
+            index--;
+        }
+        this->callbacks.Insert(index, std::move(newItem));
+    }
+    this->toAdd.Clear();
+    this->dirty = false;
 }
 
 } // namespace Oryol
@@ -4,28 +4,48 @@
     @class Oryol::RunLoop
     @ingroup Core
     @brief universal run-loop object for on-frame callbacks
-    
-    A runloop object manages a priority-sorted array of callback 
+
+    A runloop object manages a priority-sorted array of callback
     functions which are called per-frame. By default, each thread
     has a RunLoop object which can be configured through the Core facade
     singleton. Runloops can be nested by adding the Run() function
     of one runloop to another runloop. NOTE that priority values are
-    inverted, lower values are called first).
-    
+    inverted, lower values are called first, callbacks with the same
+    priority are called in the order they were added.
+
     Examples for constructing callbacks:
-    
+
     1. from C function myFunc():
 
-        Callback("name", pri, std::function<void()>(&myFunc);
+        runLoop->Add(std::function<void()>(&myFunc));
     2. from an object's method (careful, object must not go out-of-scope
        as long as the callback is added to the RunLoop!
 
         MyClass myObj;<br>
-        Callback("name", pri, std::function<void()>(&MyClass::MyMethod, &myObj));
+        runLoop->Add([&myObj]() { myObj.MyMethod(); }, pri);
+
+    The callbacks live in a flat array which is sorted by priority,
+    Run() only walks this array. Add() and Remove() are deferred,
+    they are applied at the start or end of Run(), so that callbacks
+    may add or remove callbacks (including themselves) while the
+    runloop is running. A removed callback is never called again, even
+    if it is removed in the middle of a Run(). Once the internal arrays
+    have grown to their working size, neither Run() nor Add() / Remove()
+    allocate memory (the std::function objects themselves might allocate
+    for big captures).
+
+    Add() and Remove() may also be called from other threads than the
+    thread which created the runloop, these calls go through a
+    mutex-protected queue which Run() checks with a single atomic load.
+    All other methods must be called on the runloop's thread.
 */
 #include <functional>
-#include "Core/Containers/Map.h"
-#include "Core/Containers/Set.h"
+#include <atomic>
+#include "Core/Containers/Array.h"
+#if ORYOL_HAS_THREADS
+#include <mutex>
+#include <thread>
+#endif
 
 namespace Oryol {
 
@@ -42,32 +62,44 @@ public:
     RunLoop();
     /// destructor
     ~RunLoop();
-    
+
     /// run one frame
     void Run();
-    
-    /// add a callback to the run loop, higher priorities run earlier, slow!
-    Id Add(Func func);
-    /// remove a callback, slow!
-    void Remove(Id);
-    /// test if a callback has been attached, slow!
-    bool HasCallback(Id) const;
-    
+
+    /// add a callback to the run loop, lower priority values run earlier
+    Id Add(Func func, int priority=0);
+    /// remove a callback
+    void Remove(Id id);
+    /// test if a callback has been added and not removed
+    bool HasCallback(Id id) const;
+    /// get number of callbacks (including pending adds)
+    int NumCallbacks() const;
+
 private:
-    /// add new callbacks that have been added (called at beginning of Run())
-    void addCallbacks();
-    /// remove callbacks that have been removed (called at end of Run())
-    void remCallbacks();
-    
+    /// apply pending adds and removes (called at beginning and end of Run())
+    void applyPending();
+    /// remove a callback on the runloop's thread, return false if not found
+    bool remove(Id id);
+    /// return true if called on the runloop's thread
+    bool isRunLoopThread() const;
+
     struct item {
+        Id id = InvalidId;      // InvalidId if removed
+        int priority = 0;
         Func func;
-        bool valid;
     };
-    
-    Id curId;
-    Map<Id, item> callbacks;
-    Map<Id, item> toAdd;
-    Set<Id> toRemove;
+
+    std::atomic<Id> curId;
+    Array<item> callbacks;      // sorted by priority
+    Array<item> toAdd;
+    bool dirty = false;         // pending adds, or removed items in callbacks
+    #if ORYOL_HAS_THREADS
+    std::thread::id threadId;
+    std::atomic<bool> remoteDirty;
+    mutable std::mutex remoteMutex;
+    Array<item> remoteAdd;
+    Array<Id> remoteRemove;
+    #endif
 };
-    
+
 } // namespace Oryol
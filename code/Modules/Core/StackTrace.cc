@@ -76,6 +76,12 @@ StackTrace::Dump(char* buf, int bufSize) {
     std::free(symbols);
 }
 
+//------------------------------------------------------------------------------
+int
+StackTrace::Capture(void** frames, int maxFrames) {
+    return backtrace(frames, maxFrames);
+}
+
 //------------------------------------------------------------------------------
 #elif HAVE_STACKWALKER
 class OryolStackWalker : public StackWalker {
@@ -100,6 +106,12 @@ StackTrace::Dump(char* buf, int bufSize) {
     stackWalker.ShowCallstack();
 }
 
+//------------------------------------------------------------------------------
+int
+StackTrace::Capture(void** frames, int maxFrames) {
+    return CaptureStackBackTrace(0, maxFrames, frames, NULL);
+}
+
 //------------------------------------------------------------------------------
 #else
 void
@@ -107,6 +119,12 @@ StackTrace::Dump(char* buf, int bufSize) {
     std::strncpy(buf, "STACK TRACE NOT IMPLEMENTED\n", bufSize);
     buf[bufSize-1] = 0;
 }
+
+//------------------------------------------------------------------------------
+int
+StackTrace::Capture(void** /*frames*/, int /*maxFrames*/) {
+    return 0;
+}
 #endif
 
 } // namespace Oryol
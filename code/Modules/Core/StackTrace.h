@@ -12,6 +12,8 @@ class StackTrace {
 public:
     /// write stack trace into buf as human-readable string 
     static void Dump(char* buf, int bufSize);
+    /// capture up to maxFrames return addresses, return number of frames (0 if not supported)
+    static int Capture(void** frames, int maxFrames);
 };
 
 } // namespace Oryol
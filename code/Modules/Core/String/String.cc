@@ -8,8 +8,6 @@
 
 namespace Oryol {
 
-const char* String::emptyString = "";
-
 //------------------------------------------------------------------------------
 String::String(const StringAtom& str) {
     const char* cstr = str.AsCStr();
@@ -22,16 +20,15 @@ String::String(const char* str) {
         this->create(str, int(std::strlen(str)));
     }
     else {
-        this->data = nullptr;
-        this->strPtr = nullptr;
+        this->length = 0;
+        this->localBuf[0] = 0;
     }
 }
 
 //------------------------------------------------------------------------------
 String::String() :
-data(nullptr),
-strPtr(nullptr) {
-    // empty
+length(0) {
+    this->localBuf[0] = 0;
 }
 
 //------------------------------------------------------------------------------
@@ -89,26 +86,36 @@ String::AsStringAtom() const {
     return StringAtom(this->AsCStr());;
 }
 
+//------------------------------------------------------------------------------
+bool
+String::isLocal() const {
+    return this->length <= MaxLocalLength;
+}
+
+//------------------------------------------------------------------------------
+bool
+String::isShared(const String& rhs) const {
+    return !this->isLocal() && !rhs.isLocal() && (this->data == rhs.data);
+}
+
 //------------------------------------------------------------------------------
 void
 String::destroy() {
-    o_assert(0 != this->data);
+    o_assert(!this->isLocal());
     o_assert(0 == this->data->refCount);
     this->data->~StringData();
     Memory::Free(this->data);
     this->data = nullptr;
-    this->strPtr = nullptr;
 }
 
 //------------------------------------------------------------------------------
 void
 String::alloc(int len) {
-    o_assert(len > 0);
+    o_assert(len > MaxLocalLength);
     this->data = (StringData*) Memory::Alloc(sizeof(StringData) + len + 1);
     new(this->data) StringData();
+    this->length = len;
     this->addRef();
-    this->data->length = len;
-    this->strPtr = (const char*) &(this->data[1]);
 }
 
 //------------------------------------------------------------------------------
@@ -116,21 +123,30 @@ void
 String::create(const char* ptr, int len) {
     o_assert(0 != ptr);
     if ((ptr[0] != 0) && (len > 0)) {
-        this->alloc(len);
-        Memory::Copy(ptr, (void*)this->strPtr, len);
-        ((char*)this->strPtr)[len] = 0;
+        char* dst;
+        if (len > MaxLocalLength) {
+            this->alloc(len);
+            dst = (char*) &(this->data[1]);
+        }
+        else {
+            // short string, store in local buffer
+            this->length = len;
+            dst = this->localBuf;
+        }
+        Memory::Copy(ptr, dst, len);
+        dst[len] = 0;
     }
     else {
-        // empty string, don't bother to allocate storage for this
-        this->data = nullptr;
-        this->strPtr = nullptr;
+        // empty string
+        this->length = 0;
+        this->localBuf[0] = 0;
     }
 }
 
 //------------------------------------------------------------------------------
 void
 String::addRef() {
-    o_assert(nullptr != this->data);
+    o_assert(!this->isLocal());
     #if ORYOL_HAS_ATOMIC
     this->data->refCount.fetch_add(1, std::memory_order_relaxed);
     #else
@@ -141,7 +157,7 @@ String::addRef() {
 //------------------------------------------------------------------------------
 void
 String::release() {
-    if (nullptr != this->data) {
+    if (!this->isLocal()) {
         #if ORYOL_HAS_ATOMIC
         if (1 == this->data->refCount.fetch_sub(1, std::memory_order_relaxed)) {
         #else
@@ -150,9 +166,37 @@ String::release() {
             // no more owners, destroy the shared string data
             this->destroy();
         }
-        this->data = nullptr;
-        this->strPtr = nullptr;
     }
+    this->length = 0;
+    this->localBuf[0] = 0;
+}
+
+//------------------------------------------------------------------------------
+void
+String::copy(const String& rhs) {
+    this->length = rhs.length;
+    if (rhs.isLocal()) {
+        // copy the terminating 0 too (the string may contain 0-bytes)
+        Memory::Copy(rhs.localBuf, this->localBuf, rhs.length + 1);
+    }
+    else {
+        this->data = rhs.data;
+        this->addRef();
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+String::move(String&& rhs) {
+    this->length = rhs.length;
+    if (rhs.isLocal()) {
+        Memory::Copy(rhs.localBuf, this->localBuf, rhs.length + 1);
+    }
+    else {
+        this->data = rhs.data;
+    }
+    rhs.length = 0;
+    rhs.localBuf[0] = 0;
 }
 
 //------------------------------------------------------------------------------
@@ -173,19 +217,12 @@ String::Assign(const String& rhs, int startIndex, int endIndex) {
     
 //------------------------------------------------------------------------------
 String::String(const String& rhs) {
-    this->data = rhs.data;
-    this->strPtr = rhs.strPtr;
-    if (nullptr != this->data) {
-        this->addRef();
-    }
+    this->copy(rhs);
 }
 
 //------------------------------------------------------------------------------
 String::String(String&& rhs) {
-    this->data = rhs.data;
-    this->strPtr = rhs.strPtr;
-    rhs.data = 0;
-    rhs.strPtr = 0;
+    this->move(std::move(rhs));
 }
 
 //------------------------------------------------------------------------------
@@ -207,11 +244,7 @@ void
 String::operator=(const String& rhs) {
     if (this != &rhs) {
         this->release();
-        this->data = rhs.data;
-        this->strPtr = rhs.strPtr;
-        if (nullptr != this->data) {
-            this->addRef();
-        }
+        this->copy(rhs);
     }
 }
 
@@ -220,22 +253,16 @@ void
 String::operator=(String&& rhs) {
     if (this != &rhs) {
         this->release();
-        this->data = rhs.data;
-        this->strPtr = rhs.strPtr;
-        rhs.data = 0;
-        rhs.strPtr = 0;
+        this->move(std::move(rhs));
     }
 }
 
 //------------------------------------------------------------------------------
 bool
 String::operator==(const String& rhs) const {
-    if (this->data == rhs.data) {
+    if (this->isShared(rhs)) {
         return true;
     }
-    else if ((nullptr == this->data) || (nullptr == rhs.data)) {
-        return false;
-    }
     else {
         return std::strcmp(this->AsCStr(), rhs.AsCStr()) == 0;
     }
@@ -250,7 +277,7 @@ String::operator!=(const String& rhs) const {
 //------------------------------------------------------------------------------
 bool
 String::operator<(const String& rhs) const {
-    if (this->data == rhs.data) {
+    if (this->isShared(rhs)) {
         return false;
     }
     else {
@@ -261,7 +288,7 @@ String::operator<(const String& rhs) const {
 //------------------------------------------------------------------------------
 bool
 String::operator>(const String& rhs) const {
-    if (this->data == rhs.data) {
+    if (this->isShared(rhs)) {
         return false;
     }
     else {
@@ -272,7 +299,7 @@ String::operator>(const String& rhs) const {
 //------------------------------------------------------------------------------
 bool
 String::operator<=(const String& rhs) const {
-    if (this->data == rhs.data) {
+    if (this->isShared(rhs)) {
         return true;
     }
     else {
@@ -283,7 +310,7 @@ String::operator<=(const String& rhs) const {
 //------------------------------------------------------------------------------
 bool
 String::operator>=(const String& rhs) const {
-    if (this->data == rhs.data) {
+    if (this->isShared(rhs)) {
         return true;
     }
     else {
@@ -294,22 +321,17 @@ String::operator>=(const String& rhs) const {
 //------------------------------------------------------------------------------
 int
 String::Length() const {
-    if (nullptr == this->data) {
-        return 0;
-    }
-    else {
-        return this->data->length;
-    }
+    return this->length;
 }
 
 //------------------------------------------------------------------------------
 const char*
 String::AsCStr() const {
-    if (nullptr == this->strPtr) {
-        return emptyString;
+    if (this->isLocal()) {
+        return this->localBuf;
     }
     else {
-        return this->strPtr;
+        return (const char*) &(this->data[1]);
     }
 }
 
@@ -334,9 +356,12 @@ String::Clear() {
 //------------------------------------------------------------------------------
 int
 String::RefCount() const {
-    if (nullptr == this->data) {
+    if (0 == this->length) {
         return 0;
     }
+    else if (this->isLocal()) {
+        return 1;
+    }
     else {
         return this->data->refCount;
     }
@@ -345,8 +370,8 @@ String::RefCount() const {
 //------------------------------------------------------------------------------
 char
 String::Back() const {
-    if (this->strPtr) {
-        return this->strPtr[this->data->length - 1];
+    if (this->length > 0) {
+        return this->AsCStr()[this->length - 1];
     }
     else {
         return 0;
@@ -356,12 +381,7 @@ String::Back() const {
 //------------------------------------------------------------------------------
 char
 String::Front() const {
-    if (this->strPtr) {
-        return this->strPtr[0];
-    }
-    else {
-        return 0;
-    }
+    return this->AsCStr()[0];
 }
 
 //------------------------------------------------------------------------------
@@ -5,12 +5,14 @@
     @ingroup Core
     @brief immutable, reference counted, shared strings
     
-    An immutable, shared UTF-8 String class. Memory is only allocated
-    when creating or assigning from non-String objects (const char*,
-    StringAtoms). When assigning from another string,
-    only a pointer to the original string data is copied, and a 
-    refcount is maintained. The last String pointing to the string
-    data frees the string data.
+    An immutable, shared UTF-8 String class. Strings of up to
+    MaxLocalLength bytes are stored inside the String object
+    itself and never allocate. Longer strings live in a refcounted
+    heap block, memory is only allocated when creating or assigning
+    from non-String objects (const char*, StringAtoms). When assigning
+    from another string, only a pointer to the original string data is
+    copied, and a refcount is maintained. The last String pointing to
+    the string data frees the string data.
     
     To manipulate string data, use the StringUtil class.
     
@@ -37,15 +39,18 @@ class StringAtom;
 
 class String {
 public:
+    /// max length of strings which are stored without heap allocation
+    static const int MaxLocalLength = 23;
+
     /// default constructor
     String();
-    /// construct from C string (allocates!)
+    /// construct from C string (allocates if longer than MaxLocalLength)
     String(const char* cstr);
     /// construct from raw byte sequence, endIndex can be EndOfString
     String(const char* ptr, int startIndex, int endIndex);
     /// construct from substring of other string, endIndex can be EndOfString
     String(const String& rhs, int startIndex, int endIndex);
-    /// construct from StringAtom (allocates!)
+    /// construct from StringAtom (allocates if longer than MaxLocalLength)
     String(const StringAtom& str);
     
     /// copy constructor (does not allocate)
@@ -56,9 +61,9 @@ public:
     /// destructor
     ~String();
     
-    /// assign from C string (allocates!)
+    /// assign from C string (allocates if longer than MaxLocalLength)
     void operator=(const char* cstr);
-    /// assign from StringAtom (allocates!)
+    /// assign from StringAtom (allocates if longer than MaxLocalLength)
     void operator=(const StringAtom& str);
     /// copy-assign from other String (does not allocate)
     void operator=(const String& rhs);
@@ -99,7 +104,7 @@ public:
     bool Empty() const;
     /// clear content
     void Clear();
-    /// get the refcount of this string
+    /// get the refcount of this string (always 1 for short, non-empty strings)
     int RefCount() const;
     
 private:
@@ -110,10 +115,9 @@ private:
         #else
         int refCount{0};
         #endif
-        int length;
     };
     
-    /// create new string data block, numBytes does not include the terminating 0
+    /// create new string data, numBytes does not include the terminating 0
     void create(const char* ptr, int len);
     /// private alloc function for len
     void alloc(int len);
@@ -123,10 +127,20 @@ private:
     void addRef();
     /// decrement refcount, call destroy if 0
     void release();
+    /// copy from other string (shares heap data)
+    void copy(const String& rhs);
+    /// move from other string
+    void move(String&& rhs);
+    /// return true if the string is stored in the local buffer
+    bool isLocal() const;
+    /// return true if this and other string share the same heap data
+    bool isShared(const String& rhs) const;
     
-    StringData* data;
-    const char* strPtr;     // direct pointer to string data, necessary to see something in the debugger
-    static const char* emptyString;
+    union {
+        StringData* data;                   // if length > MaxLocalLength
+        char localBuf[MaxLocalLength + 1];  // if length <= MaxLocalLength
+    };
+    int length;
 };
 
 //------------------------------------------------------------------------------
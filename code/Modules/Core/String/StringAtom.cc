@@ -5,6 +5,9 @@
 #include <cstring>
 #include "StringAtom.h"
 #include "String.h"
+#if ORYOL_GLOBAL_STRINGATOMS
+#include "globalStringAtomTable.h"
+#endif
 
 namespace Oryol {
 const char* StringAtom::emptyString = "";
@@ -32,13 +35,43 @@ StringAtom::AsString() const {
     }
 }
 
+//------------------------------------------------------------------------------
+const void*
+StringAtom::currentTable() {
+    #if ORYOL_GLOBAL_STRINGATOMS
+    return globalStringAtomTable::Ptr();
+    #else
+    return stringAtomTable::threadLocalPtr();
+    #endif
+}
+
+//------------------------------------------------------------------------------
+StringAtom::TableStats
+StringAtom::GetTableStats() {
+    TableStats stats;
+    #if ORYOL_GLOBAL_STRINGATOMS
+    const globalStringAtomTable* table = globalStringAtomTable::Ptr();
+    stats.Global = true;
+    stats.NumAtoms = table->NumAtoms();
+    stats.NumBytes = table->NumBytes();
+    stats.NumAllocatedBytes = table->NumAllocatedBytes();
+    stats.NumDuplicateBytesSaved = table->NumDuplicateBytesSaved();
+    #else
+    const stringAtomTable* table = stringAtomTable::threadLocalPtr();
+    stats.NumAtoms = table->table.Size();
+    stats.NumBytes = table->buffer.numBytes;
+    stats.NumAllocatedBytes = table->buffer.chunks.Size() * stringAtomBuffer::chunkSize;
+    #endif
+    return stats;
+}
+
 //------------------------------------------------------------------------------
 void
 StringAtom::copy(const StringAtom& rhs) {
-    // check if rhs is from our thread, if yes the copy is quick,
+    // check if rhs is from our table, if yes the copy is quick,
     // if no we need to transfer it into this thread's string atom table
     if (rhs.data) {
-        if (rhs.data->table == stringAtomTable::threadLocalPtr()) {
+        if (rhs.data->table == currentTable()) {
             this->data = rhs.data;
         }
         else {
@@ -57,11 +90,15 @@ void
 StringAtom::setupFromCString(const char* str) {
 
     if ((0 != str) && (str[0] != 0)) {
-        // get my thread-local string atom table
-        stringAtomTable* table = stringAtomTable::threadLocalPtr();
-        
         // get hash of string
         int32_t hash = stringAtomTable::HashForString(str);
+
+        #if ORYOL_GLOBAL_STRINGATOMS
+        // lock-free lookup in the process-wide table, adds the string if needed
+        this->data = globalStringAtomTable::Ptr()->FindOrAdd(hash, str);
+        #else
+        // get my thread-local string atom table
+        stringAtomTable* table = stringAtomTable::threadLocalPtr();
         
         // check if string already exists in table
         this->data = table->Find(hash, str);
@@ -69,6 +106,7 @@ StringAtom::setupFromCString(const char* str) {
             // string doesn't exist yet in table, add it
             this->data = table->Add(hash, str);
         }
+        #endif
     }
     else {
         // source was a null-ptr or empty string
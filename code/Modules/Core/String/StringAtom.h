@@ -8,6 +8,14 @@
     A unique string, relatively slow on creation, but fast for comparison.
     String atoms are stored in thread-local stringAtomTables and comparison
     is fastest in the creator thread.
+
+    When compiled with ORYOL_GLOBAL_STRINGATOMS (cmake option), all
+    threads share a single process-wide table instead. Lookups in the
+    global table don't lock (only adding a new string does), atoms
+    always compare by pointer, can be copied between threads without
+    a table lookup, and each string is only stored once per process.
+    Use GetTableStats() to inspect the table size and, in global mode,
+    how much duplicate string memory was saved.
     
     @see String
 */
@@ -20,6 +28,22 @@ class String;
 
 class StringAtom {
 public:
+    /// string atom table statistics, see GetTableStats()
+    struct TableStats {
+        /// true if this is the process-wide table
+        bool Global = false;
+        /// number of unique strings
+        int NumAtoms = 0;
+        /// number of used bytes (string data and headers)
+        int NumBytes = 0;
+        /// number of bytes allocated by the table
+        int NumAllocatedBytes = 0;
+        /// bytes that thread-local tables would have duplicated (global table only)
+        int64_t NumDuplicateBytesSaved = 0;
+    };
+    /// get statistics of the string atom table used by the calling thread
+    static TableStats GetTableStats();
+
     /// default constructor
     StringAtom();
     /// construct from String
@@ -28,7 +52,7 @@ public:
     StringAtom(const char* str);
     /// construct from raw string (slow)
     StringAtom(const unsigned char* str);
-    /// copy-constructor (fast if rhs was created in same thread)
+    /// copy-constructor (fast if rhs was created in same thread, or with global table)
     StringAtom(const StringAtom& rhs);
     /// move-constructor
     StringAtom(StringAtom&& rhs);
@@ -76,10 +100,14 @@ public:
     int Length() const;
     /// get contained C-string (static lifetime)
     const char* AsCStr() const;
+    /// get the precomputed string hash (0 if empty)
+    int32_t Hash() const;
     /// get String (slow because string object must be constructed)
     String AsString() const;
 
 private:
+    /// get the table new string atoms are added to
+    static const void* currentTable();
     /// copy content
     void copy(const StringAtom& rhs);
     /// setup from C string
@@ -228,4 +256,15 @@ StringAtom::AsCStr() const {
     }
 }
 
+//------------------------------------------------------------------------------
+inline int32_t
+StringAtom::Hash() const {
+    if (nullptr != this->data) {
+        return this->data->hash;
+    }
+    else {
+        return 0;
+    }
+}
+
 } // namespace Oryol
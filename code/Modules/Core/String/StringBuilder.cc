@@ -17,10 +17,10 @@ namespace Oryol {
     
 //------------------------------------------------------------------------------
 StringBuilder::StringBuilder() :
-buffer(0),
-capacity(0),
+buffer(localBuffer),
+capacity(LocalBufferSize),
 size(0) {
-    // empty
+    this->localBuffer[0] = 0;
 }
 
 //------------------------------------------------------------------------------
@@ -61,7 +61,7 @@ StringBuilder() {
 
 //------------------------------------------------------------------------------
 StringBuilder::~StringBuilder() {
-    if (0 != this->buffer) {
+    if (this->buffer != this->localBuffer) {
         Memory::Free(this->buffer);
     }
     this->buffer = 0;
@@ -82,19 +82,10 @@ StringBuilder::ensureRoom(int numBytes) {
         int growBy = (numBytes < minGrowSize) ? minGrowSize : numBytes;
         const int newCapacity = this->capacity + growBy;
         char* newBuffer = (char*) Memory::Alloc(newCapacity);
-        if (this->buffer) {
-            // copy over old content and free old buffer
-            #if ORYOL_WINDOWS
-            errno_t res = strcpy_s(newBuffer, newCapacity, this->buffer);
-            o_assert(0 == res);
-            #else
-            std::strcpy(newBuffer, this->buffer);
-            #endif
+        // copy over old content, and free old buffer unless it is the local buffer
+        Memory::Copy(this->buffer, newBuffer, this->size + 1);
+        if (this->buffer != this->localBuffer) {
             Memory::Free(this->buffer);
-            this->buffer = 0;
-        }
-        else {
-            newBuffer[0] = 0;
         }
         this->buffer = newBuffer;
         this->capacity = newCapacity;
@@ -142,7 +133,7 @@ StringBuilder::GetString() const {
 //------------------------------------------------------------------------------
 String
 StringBuilder::GetSubString(int startIndex, int endIndex) const {
-    if (this->buffer) {
+    if (this->size > 0) {
         if (EndOfString == endIndex) {
             endIndex = this->size;
         }
@@ -647,7 +638,7 @@ int
 StringBuilder::FindSubString(int startIndex, int endIndex, const char* subStr) const {
     o_assert(0 != subStr);
     o_assert((EndOfString == endIndex) || (endIndex >= startIndex));
-    if (nullptr != this->buffer) {
+    if (this->size > 0) {
         o_assert(startIndex < this->size);
         return findSubString(this->buffer, startIndex, endIndex, subStr);
     }
@@ -745,22 +736,44 @@ StringBuilder::format(int maxLength, bool append, const char* fmt, va_list args)
     if (!append) {
         this->Clear();
     }
-    this->ensureRoom(maxLength);
+
+    // first try to format into the room that's already there (usually the
+    // local buffer), and only grow to the actually required size if that
+    // wasn't enough, this way short formatted strings never hit the heap
+    // even if the caller provides a generous maxLength
+    int room = this->capacity - this->size;
+    if (room > maxLength) {
+        room = maxLength;
+    }
+    va_list argsCopy;
+    va_copy(argsCopy, args);
 #if ORYOL_ANDROID
-    int res = vsnprintf(&(this->buffer[this->size]), maxLength, fmt, args);
+    int res = vsnprintf(&(this->buffer[this->size]), room, fmt, argsCopy);
 #else
-    int res = std::vsnprintf(&(this->buffer[this->size]), maxLength, fmt, args);
+    int res = std::vsnprintf(&(this->buffer[this->size]), room, fmt, argsCopy);
 #endif
+    va_end(argsCopy);
     if ((res < 0) || (res >= (maxLength-1))) {
         // error or string was truncated
         this->buffer[this->size] = 0;
         return false;
     }
-    else {
-        // all ok, need to adjust length
-        this->size += res;
-        return true;
+    if (res >= room) {
+        // didn't fit into existing room, grow to the exact size and format again
+        this->ensureRoom(res);
+#if ORYOL_ANDROID
+        res = vsnprintf(&(this->buffer[this->size]), res + 1, fmt, args);
+#else
+        res = std::vsnprintf(&(this->buffer[this->size]), res + 1, fmt, args);
+#endif
+        if (res < 0) {
+            this->buffer[this->size] = 0;
+            return false;
+        }
     }
+    // all ok, need to adjust length
+    this->size += res;
+    return true;
 }
 
 //------------------------------------------------------------------------------
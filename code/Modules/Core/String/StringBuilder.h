@@ -8,6 +8,13 @@
     Use the StringBuilder methods to build, manipulate and inspect
     string data. Internally a StringBuilder object has a dynamic
     buffer which grows as needed, but never shrinks.
+
+    A StringBuilder starts in stack-buffer mode: the first
+    LocalBufferSize bytes (including the terminating 0) live in
+    the StringBuilder object itself, so building short strings (file
+    paths, URLs, log lines) in a local StringBuilder variable doesn't
+    touch the heap. The buffer only moves to the heap when it
+    needs to grow beyond that.
 */
 #include "Core/Types.h"
 #include "Core/String/String.h"
@@ -33,6 +40,9 @@ public:
     StringBuilder(char delim, std::initializer_list<String> list);
     /// destructor
     ~StringBuilder();
+
+    /// size of the embedded buffer (including the terminating 0)
+    static const int LocalBufferSize = 128;
     
     /// reserve space (numBytes excludes the terminating 0 byte)
     void Reserve(int numBytes);
@@ -156,10 +166,16 @@ private:
     /// internal formatting method
     bool format(int maxLength, bool append, const char* fmt, va_list args);
     
+    /// not copyable
+    StringBuilder(const StringBuilder& rhs) = delete;
+    /// not copy-assignable
+    void operator=(const StringBuilder& rhs) = delete;
+
     static const int minGrowSize = 128;
     char* buffer;
     int capacity;
     int size;
+    char localBuffer[LocalBufferSize];
 };
     
 } // namespace Oryol
@@ -0,0 +1,236 @@
+//------------------------------------------------------------------------------
+//  globalStringAtomTable.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include <cstring>
+#include "globalStringAtomTable.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Assertion.h"
+#include "Core/Threading/ThreadLocalPtr.h"
+#if ORYOL_USE_VLD
+#include "vld.h"
+#endif
+
+namespace Oryol {
+
+namespace {
+    // threadBits[i] is the lookup bit of the i-th thread, threads
+    // beyond the first 64 share the last entry (which is 0)
+    const int MaxTrackedThreads = 64;
+    uint64_t threadBits[MaxTrackedThreads + 1];
+    std::atomic<int> numThreads(0);
+    ORYOL_THREADLOCAL_PTR(uint64_t) curThreadBit = nullptr;
+}
+
+//------------------------------------------------------------------------------
+globalStringAtomTable*
+globalStringAtomTable::Ptr() {
+    // NOTE: the global table is never released, same as the
+    // thread-local string atom tables (creation is thread-safe
+    // because of the function-local static)
+    static globalStringAtomTable* table = []() {
+        #if ORYOL_USE_VLD
+        VLDDisable();
+        #endif
+        globalStringAtomTable* t = new(Memory::Alloc(sizeof(globalStringAtomTable))) globalStringAtomTable();
+        #if ORYOL_USE_VLD
+        VLDEnable();
+        #endif
+        return t;
+    }();
+    return table;
+}
+
+//------------------------------------------------------------------------------
+globalStringAtomTable::globalStringAtomTable() :
+curIndex(nullptr),
+numAtoms(0),
+numBytes(0),
+numAllocatedBytes(0),
+numDuplicateBytesSaved(0) {
+    for (int i = 0; i < MaxTrackedThreads; i++) {
+        threadBits[i] = uint64_t(1) << i;
+    }
+    threadBits[MaxTrackedThreads] = 0;
+    this->curIndex.store(this->allocIndex(InitialIndexSize), std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------
+uint64_t
+globalStringAtomTable::threadBit() {
+    if (!curThreadBit) {
+        int threadIndex = numThreads.fetch_add(1, std::memory_order_relaxed);
+        if (threadIndex >= MaxTrackedThreads) {
+            threadIndex = MaxTrackedThreads;
+        }
+        curThreadBit = &threadBits[threadIndex];
+    }
+    return *curThreadBit;
+}
+
+//------------------------------------------------------------------------------
+uint32_t
+globalStringAtomTable::slotForHash(int32_t hash, uint32_t mask) {
+    // the string hash is well distributed in its low bits already
+    return uint32_t(hash) & mask;
+}
+
+//------------------------------------------------------------------------------
+globalStringAtomTable::index*
+globalStringAtomTable::allocIndex(uint32_t num) {
+    o_assert((num & (num - 1)) == 0);
+    index* idx = Memory::New<index>();
+    idx->mask = num - 1;
+    idx->slots = (std::atomic<const entry*>*) Memory::Alloc(int(num * sizeof(std::atomic<const entry*>)));
+    for (uint32_t i = 0; i < num; i++) {
+        new(&idx->slots[i]) std::atomic<const entry*>(nullptr);
+    }
+    this->indices.Add(idx);
+    this->numAllocatedBytes.fetch_add(int(num * sizeof(std::atomic<const entry*>)), std::memory_order_relaxed);
+    return idx;
+}
+
+//------------------------------------------------------------------------------
+const globalStringAtomTable::entry*
+globalStringAtomTable::find(const index* idx, int32_t hash, const char* str) {
+    uint32_t slot = slotForHash(hash, idx->mask);
+    for (;;) {
+        const entry* e = idx->slots[slot].load(std::memory_order_acquire);
+        if (nullptr == e) {
+            return nullptr;
+        }
+        if ((e->header.hash == hash) && (0 == std::strcmp(e->header.str, str))) {
+            return e;
+        }
+        slot = (slot + 1) & idx->mask;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+globalStringAtomTable::insert(index* idx, const entry* e) {
+    uint32_t slot = slotForHash(e->header.hash, idx->mask);
+    while (nullptr != idx->slots[slot].load(std::memory_order_relaxed)) {
+        slot = (slot + 1) & idx->mask;
+    }
+    idx->slots[slot].store(e, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------
+const globalStringAtomTable::entry*
+globalStringAtomTable::allocEntry(int32_t hash, const char* str) {
+    const int strLen = int(std::strlen(str));
+    const int requiredSize = int(sizeof(entry)) + strLen + 1;
+    o_assert(requiredSize < ChunkSize);
+    if ((nullptr == this->curPointer) || ((this->curPointer + requiredSize) > this->endPointer)) {
+        int8_t* newChunk = (int8_t*) Memory::Alloc(ChunkSize);
+        this->chunks.Add(newChunk);
+        this->curPointer = newChunk;
+        this->endPointer = newChunk + ChunkSize;
+        this->numAllocatedBytes.fetch_add(ChunkSize, std::memory_order_relaxed);
+    }
+    entry* e = (entry*) this->curPointer;
+    char* dst = (char*) (e + 1);
+    std::memcpy(dst, str, strLen + 1);
+    new(&e->header) stringAtomBuffer::Header(this, hash, strLen, dst);
+    new(&e->threadMask) std::atomic<uint64_t>(0);
+    this->curPointer = (int8_t*) Memory::Align(this->curPointer + requiredSize, alignof(entry));
+    this->numBytes.fetch_add(requiredSize, std::memory_order_relaxed);
+    return e;
+}
+
+//------------------------------------------------------------------------------
+void
+globalStringAtomTable::trackLookup(const entry* e) {
+    // a thread-local table would hold a copy of the string for each
+    // thread that looks it up, count these copies as saved (the
+    // shared mask is only written the first time a thread sees the string)
+    const uint64_t bit = threadBit();
+    std::atomic<uint64_t>& mask = const_cast<entry*>(e)->threadMask;
+    if ((0 != bit) && (0 == (mask.load(std::memory_order_relaxed) & bit))) {
+        const uint64_t prevMask = mask.fetch_or(bit, std::memory_order_relaxed);
+        if ((0 != prevMask) && (0 == (prevMask & bit))) {
+            const int size = int(sizeof(stringAtomBuffer::Header)) + e->header.length + 1;
+            this->numDuplicateBytesSaved.fetch_add(size, std::memory_order_relaxed);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+const stringAtomBuffer::Header*
+globalStringAtomTable::Find(int32_t hash, const char* str) const {
+    o_assert_dbg(nullptr != str);
+    const entry* e = find(this->curIndex.load(std::memory_order_acquire), hash, str);
+    return e ? &e->header : nullptr;
+}
+
+//------------------------------------------------------------------------------
+const stringAtomBuffer::Header*
+globalStringAtomTable::FindOrAdd(int32_t hash, const char* str) {
+    o_assert_dbg(nullptr != str);
+
+    // fast path: lock-free lookup
+    const entry* e = find(this->curIndex.load(std::memory_order_acquire), hash, str);
+    if (nullptr == e) {
+        // slow path: check again under the lock, since another thread
+        // might have added the string (or published a new index)
+        #if ORYOL_HAS_THREADS
+        std::lock_guard<std::mutex> guard(this->lock);
+        #endif
+        index* idx = this->curIndex.load(std::memory_order_relaxed);
+        e = find(idx, hash, str);
+        if (nullptr == e) {
+            #if ORYOL_USE_VLD
+            VLDDisable();
+            #endif
+            // keep the load factor at or below 0.5 so probe sequences stay short
+            const int num = this->numAtoms.load(std::memory_order_relaxed) + 1;
+            if (uint32_t(num * 2) > (idx->mask + 1)) {
+                index* newIdx = this->allocIndex((idx->mask + 1) * 2);
+                for (uint32_t i = 0; i <= idx->mask; i++) {
+                    const entry* oldEntry = idx->slots[i].load(std::memory_order_relaxed);
+                    if (oldEntry) {
+                        insert(newIdx, oldEntry);
+                    }
+                }
+                // the old index can't be freed, lock-free readers might still use it
+                this->curIndex.store(newIdx, std::memory_order_release);
+                idx = newIdx;
+            }
+            e = this->allocEntry(hash, str);
+            insert(idx, e);
+            this->numAtoms.store(num, std::memory_order_relaxed);
+            #if ORYOL_USE_VLD
+            VLDEnable();
+            #endif
+        }
+    }
+    this->trackLookup(e);
+    return &e->header;
+}
+
+//------------------------------------------------------------------------------
+int
+globalStringAtomTable::NumAtoms() const {
+    return this->numAtoms.load(std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+int
+globalStringAtomTable::NumBytes() const {
+    return this->numBytes.load(std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+int
+globalStringAtomTable::NumAllocatedBytes() const {
+    return this->numAllocatedBytes.load(std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+int64_t
+globalStringAtomTable::NumDuplicateBytesSaved() const {
+    return this->numDuplicateBytesSaved.load(std::memory_order_relaxed);
+}
+
+} // namespace Oryol
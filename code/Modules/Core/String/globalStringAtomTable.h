@@ -0,0 +1,98 @@
+#pragma once
+//------------------------------------------------------------------------------
+/*
+    private class, do not use
+
+    A process-wide StringAtom table, used instead of the thread-local
+    stringAtomTables when Oryol is compiled with ORYOL_GLOBAL_STRINGATOMS.
+
+    Lookups are lock-free: the index is an open-addressing table of
+    atomic entry pointers which is only ever filled (never erased from),
+    so a reader either sees a fully constructed entry or an empty slot.
+    Adding a new string takes a mutex, re-checks the index, copies the
+    string into a chunk and publishes the entry with a release-store.
+    When the index needs to grow, a new index is built and published,
+    the old index stays alive (readers may still be probing it), a
+    reader which misses in an old index simply retries under the lock.
+
+    Like the thread-local tables, the global table is never destroyed,
+    StringAtom data pointers must stay valid until the process ends.
+*/
+#include "Core/Types.h"
+#include "Core/String/stringAtomBuffer.h"
+#include "Core/Containers/Array.h"
+#include <atomic>
+#if ORYOL_HAS_THREADS
+#include <mutex>
+#endif
+
+namespace Oryol {
+
+class globalStringAtomTable {
+public:
+    /// get the global table (created on demand)
+    static globalStringAtomTable* Ptr();
+
+    /// find an existing string or add a new string, hash must be HashForString(str)
+    const stringAtomBuffer::Header* FindOrAdd(int32_t hash, const char* str);
+    /// find a string without locking, return nullptr if not found
+    const stringAtomBuffer::Header* Find(int32_t hash, const char* str) const;
+
+    /// number of unique strings in the table
+    int NumAtoms() const;
+    /// number of string bytes in the table (including headers and 0-terminators)
+    int NumBytes() const;
+    /// number of bytes allocated for string chunks and index
+    int NumAllocatedBytes() const;
+    /// bytes which thread-local tables would have duplicated in other threads
+    int64_t NumDuplicateBytesSaved() const;
+
+private:
+    /// constructor
+    globalStringAtomTable();
+
+    /// an entry in the chunk buffer, string data follows the entry
+    struct entry {
+        stringAtomBuffer::Header header;
+        /// one bit for each thread which looked up the string
+        std::atomic<uint64_t> threadMask;
+    };
+    /// the open-addressing lookup index
+    struct index {
+        uint32_t mask = 0;
+        std::atomic<const entry*>* slots = nullptr;
+    };
+
+    /// get bit for the calling thread (0 if more than 64 threads)
+    static uint64_t threadBit();
+    /// compute start slot for a hash value
+    static uint32_t slotForHash(int32_t hash, uint32_t mask);
+    /// find entry in index
+    static const entry* find(const index* idx, int32_t hash, const char* str);
+    /// insert entry into index (caller must hold the lock)
+    static void insert(index* idx, const entry* e);
+    /// allocate a new index with num slots
+    index* allocIndex(uint32_t num);
+    /// copy string into chunk buffer, return new entry (caller must hold the lock)
+    const entry* allocEntry(int32_t hash, const char* str);
+    /// record a lookup from the calling thread
+    void trackLookup(const entry* e);
+
+    static const int ChunkSize = (1<<16);
+    static const int InitialIndexSize = 1024;
+
+    std::atomic<index*> curIndex;
+    #if ORYOL_HAS_THREADS
+    std::mutex lock;
+    #endif
+    Array<index*> indices;
+    Array<int8_t*> chunks;
+    int8_t* curPointer = nullptr;
+    int8_t* endPointer = nullptr;
+    std::atomic<int> numAtoms;
+    std::atomic<int> numBytes;
+    std::atomic<int> numAllocatedBytes;
+    std::atomic<int64_t> numDuplicateBytesSaved;
+};
+
+} // namespace Oryol
@@ -68,6 +68,7 @@ stringAtomBuffer::AddString(stringAtomTable* table, int32_t hash, const char* st
 
     // set curPointer to the next aligned position
     this->curPointer = (int8_t*) Memory::Align(this->curPointer + requiredSize, sizeof(Header));
+    this->numBytes += int(requiredSize);
     
     return head;
 }
@@ -19,9 +19,9 @@ public:
         // default constructor
         Header() : table(0), hash(0), length(0), str(0) { };
         /// constructor
-        Header(const stringAtomTable* t, int32_t hsh, int len, const char* s) : table(t), hash(hsh), length(len), str(s) { };
+        Header(const void* t, int32_t hsh, int len, const char* s) : table(t), hash(hsh), length(len), str(s) { };
     
-        const stringAtomTable* table;
+        const void* table;      // the owning stringAtomTable or globalStringAtomTable
         int32_t hash;
         int length;
         const char* str;
@@ -37,6 +37,7 @@ public:
     static const int chunkSize = (1<<14);    // careful with this: each thread has its own stringbuffer!
     Array<int8_t*> chunks;
     int8_t* curPointer = 0;        // this is always aligned to min(sizeof(header), ORYOL_MAX_PLATFORM_ALIGN)
+    int numBytes = 0;              // number of used bytes (headers and strings)
 };
     
 } // namespace Oryol
@@ -10,25 +10,25 @@
 
 namespace Oryol {
 
-ORYOL_THREADLOCAL_PTR(stringAtomTable) stringAtomTable::ptr = nullptr;
+ORYOL_THREADLOCAL_FIXED_PTR(stringAtomTable, StringAtomTableSlot) stringAtomTable::ptr = nullptr;
 
 //------------------------------------------------------------------------------
 stringAtomTable*
-stringAtomTable::threadLocalPtr() {
+stringAtomTable::createThreadLocal() {
     // NOTE: this object can never be released, even if a thread is left
     // since StringAtom object can move to other threads, thus memory
     // leak detectors will complain about these allocations on program
     // exit
-    if (!ptr) {
-        #if ORYOL_USE_VLD
-        VLDDisable();
-        #endif
-        ptr = Memory::New<stringAtomTable>();
-        #if ORYOL_USE_VLD
-        VLDEnable();
-        #endif
-    }
-    return ptr;
+    o_assert_dbg(!ptr);
+    #if ORYOL_USE_VLD
+    VLDDisable();
+    #endif
+    stringAtomTable* table = Memory::New<stringAtomTable>();
+    #if ORYOL_USE_VLD
+    VLDEnable();
+    #endif
+    ptr = table;
+    return table;
 }
 
 //------------------------------------------------------------------------------
@@ -112,18 +112,6 @@ stringAtomTable::Entry::operator==(const Entry& rhs) const {
     }
 }
 
-//------------------------------------------------------------------------------
-bool
-stringAtomTable::Entry::operator<(const Entry& rhs) const {
-        
-    #if ORYOL_DEBUG
-    o_assert(this->header != 0 && rhs.header != 0);
-    o_assert(this->header->hash != 0 && rhs.header->hash != 0);
-    o_assert(this->header->str != 0 && rhs.header->str != 0);
-    #endif
-    return std::strcmp(this->header->str, rhs.header->str) < 0;
-}
-
 } // namespace Oryol
 
 
@@ -7,7 +7,7 @@
 */
 #include "Core/Types.h"
 #include "Core/String/stringAtomBuffer.h"
-#include "Core/Containers/HashSet.h"
+#include "Core/Containers/FlatHashSet.h"
 #include "Core/Threading/ThreadLocalPtr.h"
 
 namespace Oryol {
@@ -16,6 +16,8 @@ class stringAtomTable {
 public:
     /// access to thread-local stringAtomTable (created on demand)
     static stringAtomTable* threadLocalPtr();
+    /// create the thread-local stringAtomTable
+    static stringAtomTable* createThreadLocal();
     /// compute hash value for string
     static int32_t HashForString(const char* str);
     /// find a matching buffer header in the table
@@ -23,7 +25,7 @@ public:
     /// add a string to the atom table
     const stringAtomBuffer::Header* Add(int32_t hash, const char* str);
     
-    static ORYOL_THREADLOCAL_PTR(stringAtomTable) ptr;
+    static ORYOL_THREADLOCAL_FIXED_PTR(stringAtomTable, StringAtomTableSlot) ptr;
 
     /// a bucket entry
     struct Entry {
@@ -33,8 +35,6 @@ public:
         Entry(const stringAtomBuffer::Header* h) : header(h) { };
         /// equality operator
         bool operator==(const Entry& rhs) const;
-        /// less-then operator
-        bool operator<(const Entry& rhs) const;
         
         const stringAtomBuffer::Header* header;
     };
@@ -46,7 +46,19 @@ public:
         };
     };
     stringAtomBuffer buffer;
-    HashSet<Entry, Hasher, 1024> table;
+    FlatHashSet<Entry, Hasher> table;
 };
 
+//------------------------------------------------------------------------------
+inline stringAtomTable*
+stringAtomTable::threadLocalPtr() {
+    // NOTE: this is called for each StringAtom construction, keep
+    // the table creation out of line
+    stringAtomTable* table = ptr;
+    if (nullptr == table) {
+        table = createThreadLocal();
+    }
+    return table;
+}
+
 } // namespace Oryol
@@ -0,0 +1,350 @@
+//------------------------------------------------------------------------------
+//  JobSystem.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "JobSystem.h"
+#include "Core/Core.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Memory/FrameAllocator.h"
+#include "Core/Containers/MPMCQueue.h"
+#include "Core/Threading/ThreadLocalPtr.h"
+#include "Core/Threading/workStealingDeque.h"
+#if ORYOL_HAS_THREADS
+#include <thread>
+#include <condition_variable>
+#endif
+
+namespace Oryol {
+
+using namespace _priv;
+
+namespace {
+    const int DequeCapacity = 1024;
+    const int NumSpinsBeforeSleep = 64;
+
+    struct worker {
+        workStealingDeque<job, DequeCapacity> deque;
+        uint32_t rand = 0x2545F491;
+        #if ORYOL_HAS_THREADS
+        std::thread thread;
+        #endif
+    };
+    struct _state {
+        int numWorkers = 0;
+        Array<worker*> workers;     // numWorkers worker threads, plus the setup thread
+        job* jobPool = nullptr;
+        MPMCQueue<job*> freeJobs{JobSystem::JobPoolSize};
+        MPMCQueue<job*> injectQueue{JobSystem::JobPoolSize};
+        std::atomic<int> numQueued{0};
+        std::atomic<int> numSleeping{0};
+        std::atomic<bool> stop{false};
+        #if ORYOL_HAS_THREADS
+        std::mutex sleepMutex;
+        std::condition_variable sleepCond;
+        #endif
+    };
+    _state* state = nullptr;
+    ORYOL_THREADLOCAL_PTR(worker) curWorker = nullptr;
+
+    //--------------------------------------------------------------------------
+    job*
+    findJob(worker* self) {
+        job* j = nullptr;
+        if (self) {
+            j = self->deque.Pop();
+        }
+        if ((nullptr == j) && !state->injectQueue.Dequeue(j)) {
+            j = nullptr;
+        }
+        if (nullptr == j) {
+            // try to steal from the other deques, start at a random victim
+            const int numDeques = state->workers.Size();
+            uint32_t r = self ? self->rand : uint32_t(numDeques);
+            r ^= r << 13; r ^= r >> 17; r ^= r << 5;
+            if (self) {
+                self->rand = r;
+            }
+            for (int i = 0; (i < numDeques) && (nullptr == j); i++) {
+                worker* victim = state->workers[int((r + i) % numDeques)];
+                if (victim != self) {
+                    j = victim->deque.Steal();
+                }
+            }
+        }
+        if (j) {
+            state->numQueued.fetch_sub(1, std::memory_order_relaxed);
+        }
+        return j;
+    }
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+JobGroup::JobGroup() :
+pending(0),
+finishing(0) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+JobGroup::~JobGroup() {
+    o_assert(this->Done());
+}
+
+//------------------------------------------------------------------------------
+bool
+JobGroup::Done() const {
+    // NOTE: a group is only done when no thread is inside finish()
+    // anymore, so that it can be destroyed right after Wait() returns
+    return (0 == this->pending.load()) && (0 == this->finishing.load());
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::Setup(int numWorkers) {
+    o_assert(nullptr == state);
+    #if ORYOL_HAS_THREADS
+    if (AutoNumWorkers == numWorkers) {
+        const int numCores = int(std::thread::hardware_concurrency());
+        numWorkers = numCores > 1 ? numCores - 1 : 0;
+    }
+    #else
+    numWorkers = 0;
+    #endif
+    o_assert(numWorkers >= 0);
+
+    state = Memory::New<_state>();
+    state->numWorkers = numWorkers;
+    state->jobPool = (job*) Memory::Alloc(JobPoolSize * int(sizeof(job)));
+    for (int i = 0; i < JobPoolSize; i++) {
+        job* j = new(&state->jobPool[i]) job();
+        state->freeJobs.Enqueue(j);
+    }
+
+    // one deque per worker thread, and one for the setup thread (last)
+    state->workers.Reserve(numWorkers + 1);
+    for (int i = 0; i < (numWorkers + 1); i++) {
+        worker* w = Memory::New<worker>();
+        w->rand += uint32_t(i) * 0x9E3779B9;
+        state->workers.Add(w);
+    }
+    curWorker = state->workers.Back();
+    #if ORYOL_HAS_THREADS
+    for (int i = 0; i < numWorkers; i++) {
+        worker* w = state->workers[i];
+        w->thread = std::thread(workerFunc, (void*)w);
+    }
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::Discard() {
+    o_assert(nullptr != state);
+    o_assert(curWorker == state->workers.Back());
+
+    // help running queued jobs, then stop and join the worker threads
+    while (state->numQueued.load() > 0) {
+        job* j = findJob(curWorker);
+        if (j) {
+            execute(j);
+        }
+        #if ORYOL_HAS_THREADS
+        else {
+            std::this_thread::yield();
+        }
+        #endif
+    }
+    #if ORYOL_HAS_THREADS
+    {
+        std::lock_guard<std::mutex> guard(state->sleepMutex);
+        state->stop.store(true);
+    }
+    state->sleepCond.notify_all();
+    for (int i = 0; i < state->numWorkers; i++) {
+        state->workers[i]->thread.join();
+    }
+    #endif
+    // jobs which were queued by running jobs while stopping
+    while (job* j = findJob(curWorker)) {
+        execute(j);
+    }
+
+    for (worker* w : state->workers) {
+        Memory::Delete(w);
+    }
+    Memory::Free(state->jobPool);
+    Memory::Delete(state);
+    state = nullptr;
+    curWorker = nullptr;
+}
+
+//------------------------------------------------------------------------------
+bool
+JobSystem::IsValid() {
+    return nullptr != state;
+}
+
+//------------------------------------------------------------------------------
+int
+JobSystem::NumWorkers() {
+    return state ? state->numWorkers : 0;
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::Wait(JobGroup& group) {
+    while (!group.Done()) {
+        job* j = state ? findJob(curWorker) : nullptr;
+        if (j) {
+            execute(j);
+        }
+        #if ORYOL_HAS_THREADS
+        else {
+            std::this_thread::yield();
+        }
+        #endif
+    }
+}
+
+//------------------------------------------------------------------------------
+job*
+JobSystem::allocJob(JobGroup& group) {
+    if ((nullptr == state) || (0 == state->numWorkers)) {
+        return nullptr;
+    }
+    job* j = nullptr;
+    if (!state->freeJobs.Dequeue(j)) {
+        // job pool exhausted, run inline
+        return nullptr;
+    }
+    j->group = &group;
+    group.pending.fetch_add(1);
+    return j;
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::submit(job* j) {
+    o_assert_dbg(j && j->group);
+
+    // NOTE: numQueued must be incremented before the job becomes visible
+    // and before numSleeping is checked, a worker going to sleep does it
+    // the other way around, so that wakeups can't get lost
+    state->numQueued.fetch_add(1);
+    bool queued = false;
+    if (curWorker) {
+        queued = curWorker->deque.Push(j);
+    }
+    else {
+        queued = state->injectQueue.Enqueue(j);
+    }
+    if (!queued) {
+        state->numQueued.fetch_sub(1);
+        execute(j);
+        return;
+    }
+    #if ORYOL_HAS_THREADS
+    if (state->numSleeping.load() > 0) {
+        std::lock_guard<std::mutex> guard(state->sleepMutex);
+        state->sleepCond.notify_one();
+    }
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::submitAfter(JobGroup& dep, job* j) {
+    {
+        #if ORYOL_HAS_THREADS
+        std::lock_guard<std::mutex> guard(dep.lock);
+        #endif
+        if (dep.pending.load() > 0) {
+            dep.continuations.Add(j);
+            return;
+        }
+    }
+    submit(j);
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::execute(job* j) {
+    JobGroup* group = j->group;
+    j->invoke(j);
+    j->invoke = nullptr;
+    j->group = nullptr;
+    state->freeJobs.Enqueue(j);
+    finish(group);
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::finish(JobGroup* group) {
+    group->finishing.fetch_add(1);
+    if (1 == group->pending.fetch_sub(1)) {
+        // last job of the group, move the continuations out under the
+        // lock (the group might have received new jobs in the meantime)
+        Array<job*> continuations;
+        {
+            #if ORYOL_HAS_THREADS
+            std::lock_guard<std::mutex> guard(group->lock);
+            #endif
+            if (0 == group->pending.load()) {
+                continuations = std::move(group->continuations);
+            }
+        }
+        for (job* j : continuations) {
+            submit(j);
+        }
+    }
+    // NOTE: this is the last access to group, it may be destroyed after this
+    group->finishing.fetch_sub(1, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::workerFunc(void* ptr) {
+    #if ORYOL_HAS_THREADS
+    worker* self = (worker*) ptr;
+    curWorker = self;
+    const bool enterCore = Core::IsValid();
+    if (enterCore) {
+        Core::EnterThread();
+    }
+    // workers never run their PostRunLoop, so the frame allocator
+    // is reset after each job instead
+    FrameAllocator* frameAllocator = FrameAllocator::ThreadLocal();
+    int numSpins = 0;
+    for (;;) {
+        job* j = findJob(self);
+        if (j) {
+            execute(j);
+            if (frameAllocator) {
+                frameAllocator->Reset();
+            }
+            numSpins = 0;
+        }
+        else if (state->stop.load()) {
+            break;
+        }
+        else if (++numSpins < NumSpinsBeforeSleep) {
+            std::this_thread::yield();
+        }
+        else {
+            std::unique_lock<std::mutex> lock(state->sleepMutex);
+            state->numSleeping.fetch_add(1);
+            state->sleepCond.wait(lock, [] {
+                return state->stop.load() || (state->numQueued.load() > 0);
+            });
+            state->numSleeping.fetch_sub(1);
+            numSpins = 0;
+        }
+    }
+    if (enterCore) {
+        Core::LeaveThread();
+    }
+    curWorker = nullptr;
+    #endif
+}
+
+} // namespace Oryol
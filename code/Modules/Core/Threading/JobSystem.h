@@ -0,0 +1,212 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::JobSystem
+    @ingroup Core
+    @brief work-stealing job system for CPU-heavy work
+
+    The JobSystem runs small functions (jobs) on a pool of worker
+    threads (by default one per CPU core, minus the main thread). Each
+    worker, and the thread which called Setup(), has its own
+    work-stealing deque: new jobs are pushed to the deque of the
+    calling thread, idle threads steal jobs from the other deques.
+    Jobs pushed from other threads (e.g. IO threads) go through a
+    shared injection queue.
+
+    Jobs are added to a JobGroup, which counts the jobs that haven't
+    finished yet. Wait() blocks until all jobs of a group are done,
+    and runs jobs itself while waiting. RunAfter() adds a job which
+    only starts when all jobs of another group have finished, this
+    can be used to build simple dependency chains.
+
+    ParallelFor() splits an index range into pieces of 'grain'
+    indices and calls func(first, last) for each piece, with last
+    being exclusive:
+
+    @code
+    JobSystem::ParallelFor(0, numParticles, 1024, [&](int first, int last) {
+        for (int i = first; i < last; i++) {
+            particles[i].Update();
+        }
+    });
+    @endcode
+
+    Jobs must be small callables (lambdas with at most MaxJobSize bytes
+    of captures), they are stored in a pre-allocated job pool, so
+    submitting a job doesn't allocate. If the JobSystem hasn't been
+    setup, has no worker threads, or if the job pool or a deque
+    is full, jobs run immediately on the calling thread.
+
+    Core::Setup() sets up the JobSystem, the number of worker threads
+    is configured with CoreSetup::NumJobWorkers. Worker threads have
+    no frames, their FrameAllocator is reset after each job, so frame
+    memory allocated in a job is only valid until the job returns.
+*/
+#include "Core/Config.h"
+#include "Core/Assertion.h"
+#include "Core/Containers/Array.h"
+#include <atomic>
+#include <utility>
+#include <type_traits>
+#if ORYOL_HAS_THREADS
+#include <mutex>
+#endif
+
+namespace Oryol {
+
+class JobGroup;
+
+namespace _priv {
+/// a pooled job with inline storage for the callable
+struct job {
+    static const int StorageSize = 64;
+    typedef void (*invokeFunc)(job* j);
+    invokeFunc invoke = nullptr;
+    JobGroup* group = nullptr;
+    alignas(16) uint8_t storage[StorageSize];
+};
+} // namespace _priv
+
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::JobGroup
+    @ingroup Core
+    @brief a group of jobs which can be waited on
+
+    @see JobSystem
+*/
+class JobGroup {
+public:
+    /// constructor
+    JobGroup();
+    /// destructor (all jobs must be done)
+    ~JobGroup();
+    /// return true if all jobs in the group are done
+    bool Done() const;
+
+private:
+    friend class JobSystem;
+    /// not copyable
+    JobGroup(const JobGroup& rhs) = delete;
+    /// not copy-assignable
+    void operator=(const JobGroup& rhs) = delete;
+
+    std::atomic<int> pending;   // number of unfinished jobs
+    std::atomic<int> finishing; // threads currently finishing a job of this group
+    #if ORYOL_HAS_THREADS
+    std::mutex lock;
+    #endif
+    Array<_priv::job*> continuations;
+};
+
+class JobSystem {
+public:
+    /// use one worker thread per CPU core, minus one for the main thread
+    static const int AutoNumWorkers = -1;
+    /// max size of a job callable in bytes
+    static const int MaxJobSize = _priv::job::StorageSize;
+    /// number of pre-allocated jobs
+    static const int JobPoolSize = 4096;
+
+    /// setup the job system (called from Core::Setup())
+    static void Setup(int numWorkers=AutoNumWorkers);
+    /// discard the job system, runs remaining jobs and stops the worker threads
+    static void Discard();
+    /// return true if the job system has been setup
+    static bool IsValid();
+    /// get number of worker threads
+    static int NumWorkers();
+
+    /// run a job
+    template<class FUNC> static void Run(JobGroup& group, FUNC&& func);
+    /// run a job after all jobs in another group have finished
+    template<class FUNC> static void RunAfter(JobGroup& dependency, JobGroup& group, FUNC&& func);
+    /// wait until all jobs in the group are done, run other jobs while waiting
+    static void Wait(JobGroup& group);
+    /// call func(first, last) for pieces of 'grain' indices (grain=0: choose automatically)
+    template<class FUNC> static void ParallelFor(int begin, int end, int grain, FUNC&& func);
+
+private:
+    /// get a job from the pool and add it to group, or nullptr if jobs must run inline
+    static _priv::job* allocJob(JobGroup& group);
+    /// push a job to the calling thread's deque (runs inline if deque full)
+    static void submit(_priv::job* j);
+    /// add job to the dependency's continuations, or submit if dependency is done
+    static void submitAfter(JobGroup& dependency, _priv::job* j);
+    /// run a job, return it to the pool, and finish its group
+    static void execute(_priv::job* j);
+    /// decrement a group's pending count, submit continuations when done
+    static void finish(JobGroup* group);
+    /// worker thread function
+    static void workerFunc(void* worker);
+    /// setup a job's callable
+    template<class FUNC> static void initJob(_priv::job* j, FUNC&& func);
+};
+
+//------------------------------------------------------------------------------
+template<class FUNC> void
+JobSystem::initJob(_priv::job* j, FUNC&& func) {
+    typedef typename std::decay<FUNC>::type funcType;
+    static_assert(sizeof(funcType) <= MaxJobSize, "JobSystem: job callable too big (capture less, or capture by reference)");
+    static_assert(alignof(funcType) <= 16, "JobSystem: job callable alignment too big");
+    new(j->storage) funcType(std::forward<FUNC>(func));
+    j->invoke = [](_priv::job* j) {
+        funcType* f = (funcType*) j->storage;
+        (*f)();
+        f->~funcType();
+    };
+}
+
+//------------------------------------------------------------------------------
+template<class FUNC> void
+JobSystem::Run(JobGroup& group, FUNC&& func) {
+    _priv::job* j = allocJob(group);
+    if (nullptr != j) {
+        initJob(j, std::forward<FUNC>(func));
+        submit(j);
+    }
+    else {
+        func();
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class FUNC> void
+JobSystem::RunAfter(JobGroup& dependency, JobGroup& group, FUNC&& func) {
+    _priv::job* j = allocJob(group);
+    if (nullptr != j) {
+        initJob(j, std::forward<FUNC>(func));
+        submitAfter(dependency, j);
+    }
+    else {
+        Wait(dependency);
+        func();
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class FUNC> void
+JobSystem::ParallelFor(int begin, int end, int grain, FUNC&& func) {
+    if (begin >= end) {
+        return;
+    }
+    if (grain <= 0) {
+        // about 4 pieces per thread, so that stealing can balance uneven work
+        const int numPieces = (NumWorkers() + 1) * 4;
+        grain = (end - begin + numPieces - 1) / numPieces;
+    }
+    if (((end - begin) <= grain) || (0 == NumWorkers())) {
+        func(begin, end);
+        return;
+    }
+    JobGroup group;
+    for (int first = begin; first < end; first += grain) {
+        const int last = (end - first) > grain ? first + grain : end;
+        Run(group, [&func, first, last]() {
+            func(first, last);
+        });
+    }
+    Wait(group);
+}
+
+} // namespace Oryol
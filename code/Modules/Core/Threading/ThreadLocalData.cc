@@ -3,53 +3,88 @@
 //------------------------------------------------------------------------------
 #include "Pre.h"
 #include "ThreadLocalData.h"
-#include "Core/Memory/Memory.h"
+#include <cstdlib>
 #include "Core/Assertion.h"
 
 #if ORYOL_THREADLOCAL_PTHREAD
 namespace Oryol {
-    
-pthread_key_t ThreadLocalData::key = 0;
-std::atomic<int> ThreadLocalData::curSlot{0};
-    
+
+pthread_key_t ThreadLocalData::key;
+std::atomic<bool> ThreadLocalData::keyValid{false};
+std::atomic<int> ThreadLocalData::curSlot{ThreadLocalData::NumFixedSlots};
+
+namespace {
+    pthread_once_t keyOnce = PTHREAD_ONCE_INIT;
+}
+
+//------------------------------------------------------------------------------
+void
+ThreadLocalData::createKey() {
+    // NOTE: a pointer table is freed when its thread exits, the
+    // objects the table points to are owned by their users
+    const int res = pthread_key_create(&key, std::free);
+    o_assert(0 == res);
+    keyValid.store(true, std::memory_order_release);
+}
+
 //------------------------------------------------------------------------------
 void
 ThreadLocalData::SetupOnce() {
-    if (0 == key) {
-        pthread_key_create(&key, 0);
-        o_assert_dbg(0 != key);
+    if (!keyValid.load(std::memory_order_acquire)) {
+        pthread_once(&keyOnce, createKey);
     }
 }
 
 //------------------------------------------------------------------------------
 void**
 ThreadLocalData::PointerTable() {
-    o_assert_dbg(0 != key);
-    
+    SetupOnce();
+
     // get thread-local value (null if none assigned yet)
     void** table = (void**) pthread_getspecific(key);
     if (0 == table) {
         // not assigned yet, allocate thread-specific table and
-        // associate with key
-        int tableSize = MaxNumSlots * sizeof(void*);
-        table = (void**) Memory::Alloc(tableSize);
-        Memory::Clear(table, tableSize);
+        // associate with key, NOTE: this must not go through
+        // Memory::Alloc(), since Memory uses thread-locals itself
+        table = (void**) std::calloc(MaxNumSlots, sizeof(void*));
         pthread_setspecific(key, table);
     }
     return table;
 }
 
+//------------------------------------------------------------------------------
+void
+ThreadLocalData::EnterThread() {
+    PointerTable();
+}
+
+//------------------------------------------------------------------------------
+void
+ThreadLocalData::LeaveThread() {
+    if (keyValid.load(std::memory_order_acquire)) {
+        void** table = (void**) pthread_getspecific(key);
+        if (table) {
+            pthread_setspecific(key, nullptr);
+            std::free(table);
+        }
+    }
+}
+
 //------------------------------------------------------------------------------
 int
 ThreadLocalData::Alloc() {
     o_assert_dbg(curSlot < (MaxNumSlots - 1));
     return curSlot++;
 }
-    
+
 //------------------------------------------------------------------------------
 void
 ThreadLocalData::Set(int slotIndex, void* ptr) {
     o_assert_range_dbg(slotIndex, MaxNumSlots);
+    if ((nullptr == ptr) && (nullptr == Get(slotIndex))) {
+        // don't create a table just to store a null pointer
+        return;
+    }
     void** table = PointerTable();
     table[slotIndex] = ptr;
 }
@@ -3,10 +3,22 @@
 /**
     @class Oryol::ThreadLocalData
     @brief manage a thread-local pointer table via pthread keys
-    
+
     ThreadLocalData and ThreadLocalPtr enable thread-local support
     on platforms where the compiler doesn't have a thread-local keyword
-    (only on iOS so far).
+    (only on iOS so far, or when compiled with ORYOL_FORCE_THREADLOCAL_PTHREAD).
+
+    Each thread has a pointer table which is associated with a single
+    pthread key. The first slots of the table are reserved at compile
+    time for Core's hot thread-locals (see FixedSlot), the remaining
+    slots are handed out at runtime by Alloc(). Get() is inline, reading
+    a slot is one pthread_getspecific() call plus an indexed load, and
+    no table is created for reading (all slots are null until written).
+
+    Core::EnterThread() creates the pointer table of a new thread up
+    front, Core::LeaveThread() frees it. Threads which don't go through
+    Core::EnterThread() get their table on the first Set(), and it is
+    freed by the pthread key destructor when the thread exits.
 */
 #include "Core/Types.h"
 #if ORYOL_THREADLOCAL_PTHREAD
@@ -15,25 +27,43 @@
 #include <pthread.h>
 
 namespace Oryol {
-    
+
 class ThreadLocalData {
 public:
-    /// setup once from main-thread
+    /// slots reserved at compile time for Core's hot thread-locals
+    enum FixedSlot {
+        StringAtomTableSlot = 0,
+        MemoryTagSlot,
+        AllocationTrackerSlot,
+        FrameAllocatorSlot,
+
+        NumFixedSlots,
+        InvalidSlot = -1
+    };
+
+    /// setup once, may be called from any thread
     static void SetupOnce();
-    
+    /// create the calling thread's pointer table (called from Core::EnterThread)
+    static void EnterThread();
+    /// free the calling thread's pointer table (called from Core::LeaveThread)
+    static void LeaveThread();
+
     /// allocate a new slot
     static int Alloc();
     /// associate slot index with a pointer
     static void Set(int slotIndex, void* ptr);
     /// get pointer associated with slot
     static void* Get(int slotIndex);
-    
+
 private:
-    /// get pointer to thread-local pointer-table
+    /// get pointer to thread-local pointer-table, create if not exists
     static void** PointerTable();
-    
+    /// create the pthread key
+    static void createKey();
+
     static const int MaxNumSlots = 1024;
     static pthread_key_t key;
+    static std::atomic<bool> keyValid;
     static std::atomic<int> curSlot;
 };
 
@@ -41,9 +71,12 @@ private:
 inline void*
 ThreadLocalData::Get(int slotIndex) {
     o_assert_range_dbg(slotIndex, MaxNumSlots);
-    void** table = PointerTable();
-    return table[slotIndex];
+    if (!keyValid.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    void** table = (void**) pthread_getspecific(key);
+    return table ? table[slotIndex] : nullptr;
 }
-    
+
 } // namespace Oryol
-#endif // ORYOL_COMPILER_HAS_THREADLOCAL
+#endif // ORYOL_THREADLOCAL_PTHREAD
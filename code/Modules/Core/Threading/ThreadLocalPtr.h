@@ -7,6 +7,19 @@
     NOTE: ALWAYS use the ORYOL_THREADLOCAL_PTR macro to declare a thread
     local pointer! Search for ORYOL_THREADLOCAL_PTR for examples how to
     properly use the macro. 
+
+    Core's hot thread-locals use ORYOL_THREADLOCAL_FIXED_PTR instead,
+    which on the pthread code path reads a slot index known at compile
+    time (see ThreadLocalData::FixedSlot), and is identical to
+    ORYOL_THREADLOCAL_PTR everywhere else.
+
+    With native thread-local support on ELF platforms, thread-locals use
+    the initial-exec TLS model, so that an access compiles to a load
+    relative to the thread pointer instead of a __tls_get_addr() call
+    (this requires that Oryol is linked into the executable, not into a
+    shared library which is loaded with dlopen()). This is not the case
+    on Android, where the app is a shared library, so Android uses the
+    default TLS model.
 */
 #include "Core/Config.h"
 #include "ThreadLocalData.h"
@@ -14,23 +27,29 @@
 #if ORYOL_THREADLOCAL_PTHREAD
     // platform only has pthread-keys, not compiler keyword
     #define ORYOL_THREADLOCAL_PTR(T) Oryol::ThreadLocalPtr<T>
+    #define ORYOL_THREADLOCAL_FIXED_PTR(T, SLOT) Oryol::ThreadLocalPtr<T, Oryol::ThreadLocalData::SLOT>
 #elif ORYOL_COMPILER_HAS_THREADLOCAL
     #if ORYOL_WINDOWS && defined(_MSC_VER)
         // on Windows, use __declspec(thread)
         #define ORYOL_THREADLOCAL_PTR(T) __declspec(thread) T*
+    #elif defined(__ELF__) && !ORYOL_ANDROID
+        // on GCC/Clang with ELF executables, use __thread with the initial-exec model
+        #define ORYOL_THREADLOCAL_PTR(T) __thread __attribute__((tls_model("initial-exec"))) T*
     #else
         // on GCC/Clang, use __thread
         #define ORYOL_THREADLOCAL_PTR(T) __thread T*
     #endif
+    #define ORYOL_THREADLOCAL_FIXED_PTR(T, SLOT) ORYOL_THREADLOCAL_PTR(T)
 #else
     // no threading support at all (e.g. emscripten)
     #define ORYOL_THREADLOCAL_PTR(T) T*
+    #define ORYOL_THREADLOCAL_FIXED_PTR(T, SLOT) T*
 #endif
 
 #if ORYOL_THREADLOCAL_PTHREAD
 namespace Oryol {
 
-template<class T> class ThreadLocalPtr {
+template<class T, int SLOT=ThreadLocalData::InvalidSlot> class ThreadLocalPtr {
 public:
     /// constructor
     ThreadLocalPtr();
@@ -46,48 +65,57 @@ public:
     explicit operator bool() const;
     
 private:
+    /// get slot index, a compile-time constant for fixed slots
+    int slot() const;
+
     int slotIndex;
 };
 
 //------------------------------------------------------------------------------
-template<class T>
-ThreadLocalPtr<T>::ThreadLocalPtr() {
+template<class T, int SLOT>
+ThreadLocalPtr<T, SLOT>::ThreadLocalPtr() {
     ThreadLocalData::SetupOnce();
-    this->slotIndex = ThreadLocalData::Alloc();
+    this->slotIndex = (SLOT < 0) ? ThreadLocalData::Alloc() : SLOT;
 }
 
 //------------------------------------------------------------------------------
-template<class T>
-ThreadLocalPtr<T>::ThreadLocalPtr(T* p) {
+template<class T, int SLOT>
+ThreadLocalPtr<T, SLOT>::ThreadLocalPtr(T* p) {
     ThreadLocalData::SetupOnce();
-    this->slotIndex = ThreadLocalData::Alloc();
+    this->slotIndex = (SLOT < 0) ? ThreadLocalData::Alloc() : SLOT;
     ThreadLocalData::Set(this->slotIndex, (void*) p);
 }
 
 //------------------------------------------------------------------------------
-template<class T> void
-ThreadLocalPtr<T>::operator=(T* p) {
-    ThreadLocalData::Set(this->slotIndex, (void*) p);
+template<class T, int SLOT> int
+ThreadLocalPtr<T, SLOT>::slot() const {
+    static_assert(SLOT < ThreadLocalData::NumFixedSlots, "invalid fixed thread-local slot");
+    return (SLOT < 0) ? this->slotIndex : SLOT;
 }
 
 //------------------------------------------------------------------------------
-template<class T>
-ThreadLocalPtr<T>::operator T*() const {
-    return (T*) ThreadLocalData::Get(this->slotIndex);
+template<class T, int SLOT> void
+ThreadLocalPtr<T, SLOT>::operator=(T* p) {
+    ThreadLocalData::Set(this->slot(), (void*) p);
 }
 
 //------------------------------------------------------------------------------
-template<class T> T*
-ThreadLocalPtr<T>::operator->() const {
+template<class T, int SLOT>
+ThreadLocalPtr<T, SLOT>::operator T*() const {
+    return (T*) ThreadLocalData::Get(this->slot());
+}
+
+//------------------------------------------------------------------------------
+template<class T, int SLOT> T*
+ThreadLocalPtr<T, SLOT>::operator->() const {
     return *this;
 }
 
 //------------------------------------------------------------------------------
-template<class T>
-ThreadLocalPtr<T>::operator bool() const {
-    return nullptr != ThreadLocalData::Get(this->slotIndex);
+template<class T, int SLOT>
+ThreadLocalPtr<T, SLOT>::operator bool() const {
+    return nullptr != ThreadLocalData::Get(this->slot());
 }
 
 } // namespace Oryol
 #endif // ORYOL_THREADLOCAL_PTHREAD
-
@@ -0,0 +1,99 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::workStealingDeque
+    @ingroup _priv
+    @brief fixed-capacity Chase-Lev work-stealing deque
+
+    The owner thread pushes and pops pointers at the bottom end
+    (LIFO, which keeps the owner working on cache-warm data), any
+    other thread may steal from the top end (FIFO, which hands out
+    the oldest, usually biggest pieces of work). Push() returns false
+    if the deque is full, Pop() and Steal() return nullptr if the
+    deque is empty (or, for Steal(), if another thread won the race
+    for the last element).
+
+    See "Correct and Efficient Work-Stealing for Weak Memory Models"
+    (Le, Pop, Cohen, Zappa Nardelli, 2013) for the memory orderings.
+*/
+#include "Core/Config.h"
+#include "Core/Assertion.h"
+#include <atomic>
+
+namespace Oryol {
+namespace _priv {
+
+template<class TYPE, int CAPACITY> class workStealingDeque {
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be a power of 2");
+public:
+    /// constructor
+    workStealingDeque() : top(0), bottom(0) {
+        for (int i = 0; i < CAPACITY; i++) {
+            this->items[i].store(nullptr, std::memory_order_relaxed);
+        }
+    };
+
+    /// push at bottom (owner thread only), return false if full
+    bool Push(TYPE* item) {
+        const int64_t b = this->bottom.load(std::memory_order_relaxed);
+        const int64_t t = this->top.load(std::memory_order_acquire);
+        if ((b - t) >= CAPACITY) {
+            return false;
+        }
+        this->items[b & (CAPACITY - 1)].store(item, std::memory_order_relaxed);
+        this->bottom.store(b + 1, std::memory_order_release);
+        return true;
+    };
+    /// pop from bottom (owner thread only), return nullptr if empty
+    TYPE* Pop() {
+        const int64_t b = this->bottom.load(std::memory_order_relaxed) - 1;
+        this->bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = this->top.load(std::memory_order_relaxed);
+        TYPE* item = nullptr;
+        if (t <= b) {
+            item = this->items[b & (CAPACITY - 1)].load(std::memory_order_relaxed);
+            if (t == b) {
+                // last item, race against thieves
+                if (!this->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                    item = nullptr;
+                }
+                this->bottom.store(b + 1, std::memory_order_relaxed);
+            }
+        }
+        else {
+            // was empty
+            this->bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return item;
+    };
+    /// steal from top (any thread), return nullptr if empty or lost the race
+    TYPE* Steal() {
+        int64_t t = this->top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t b = this->bottom.load(std::memory_order_acquire);
+        if (t < b) {
+            TYPE* item = this->items[t & (CAPACITY - 1)].load(std::memory_order_relaxed);
+            if (this->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                return item;
+            }
+        }
+        return nullptr;
+    };
+    /// approximate number of items
+    int Size() const {
+        const int64_t b = this->bottom.load(std::memory_order_relaxed);
+        const int64_t t = this->top.load(std::memory_order_relaxed);
+        return b > t ? int(b - t) : 0;
+    };
+
+private:
+    std::atomic<int64_t> top;
+    uint8_t pad0[ORYOL_CACHE_LINE_SIZE - sizeof(std::atomic<int64_t>)];
+    std::atomic<int64_t> bottom;
+    uint8_t pad1[ORYOL_CACHE_LINE_SIZE - sizeof(std::atomic<int64_t>)];
+    std::atomic<TYPE*> items[CAPACITY];
+};
+
+} // namespace _priv
+} // namespace Oryol
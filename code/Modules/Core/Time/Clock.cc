@@ -3,6 +3,7 @@
 //------------------------------------------------------------------------------
 #include "Pre.h"
 #include "Clock.h"
+#include "Core/Assertion.h"
 #if ORYOL_EMSCRIPTEN
 #include <emscripten/emscripten.h>
 #elif ORYOL_WINDOWS
@@ -10,9 +11,16 @@
 #else
 #include <chrono>
 #endif
+#include <atomic>
 
 namespace Oryol {
 
+namespace {
+    // simulated time in microseconds, Now() is only simulated if the time step is > 0
+    std::atomic<int64_t> simTimeStep(0);
+    std::atomic<int64_t> simTime(0);
+}
+
 #if ORYOL_WINDOWS
 // query perf-freq before any threads can start
 // and capture a start count
@@ -29,6 +37,9 @@ struct _perf {
 //------------------------------------------------------------------------------
 TimePoint
 Clock::Now() {
+    if (simTimeStep.load(std::memory_order_relaxed) > 0) {
+        return TimePoint(simTime.load(std::memory_order_relaxed));
+    }
     #if ORYOL_EMSCRIPTEN
     // get int64 time in microseconds (emscripten_now is ms)
     int64_t t = int64_t(emscripten_get_now() * 1000);
@@ -47,4 +58,80 @@ Clock::Now() {
     return TimePoint(t);
 }
 
-} // namespace Oryol
\ No newline at end of file
+//------------------------------------------------------------------------------
+int64_t
+Clock::NowNanoSeconds() {
+    #if ORYOL_EMSCRIPTEN
+    return int64_t(emscripten_get_now() * 1000000.0);
+    #elif ORYOL_WINDOWS
+    // split into seconds and remainder to avoid overflow
+    LARGE_INTEGER perfCount;
+    QueryPerformanceCounter(&perfCount);
+    const int64_t d = perfCount.QuadPart - perf.start.QuadPart;
+    const int64_t f = perf.freq.QuadPart;
+    return (d / f) * 1000000000 + ((d % f) * 1000000000) / f;
+    #else
+    using namespace std;
+    auto now = chrono::steady_clock::now();
+    return chrono::duration_cast<chrono::nanoseconds>(now.time_since_epoch()).count();
+    #endif
+}
+
+//------------------------------------------------------------------------------
+/**
+    The simulated time starts at the current real time.
+*/
+void
+Clock::SetSimulatedTimeStep(Duration timeStep) {
+    o_assert(timeStep.getRaw() >= 0);
+    if (timeStep.getRaw() > 0) {
+        if (!IsSimulated()) {
+            simTime.store(Now().getRaw(), std::memory_order_relaxed);
+        }
+    }
+    simTimeStep.store(timeStep.getRaw(), std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+bool
+Clock::IsSimulated() {
+    return simTimeStep.load(std::memory_order_relaxed) > 0;
+}
+
+//------------------------------------------------------------------------------
+void
+Clock::AdvanceSimulatedTime() {
+    simTime.fetch_add(simTimeStep.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+double
+Clock::TicksPerSecond() {
+    // thread-safe one-time calibration
+    static const double ticksPerSecond = calibrateTicks();
+    return ticksPerSecond;
+}
+
+//------------------------------------------------------------------------------
+/**
+    Measures the tick rate against NowNanoSeconds() over 10 milliseconds,
+    if the tick source isn't a cycle counter, ticks are nanoseconds.
+*/
+double
+Clock::calibrateTicks() {
+    #if ORYOL_CLOCK_TICKS_RDTSC || ORYOL_CLOCK_TICKS_CNTVCT
+    const int64_t ns0 = NowNanoSeconds();
+    const int64_t ticks0 = Ticks();
+    int64_t ns1, ticks1;
+    do {
+        ns1 = NowNanoSeconds();
+        ticks1 = Ticks();
+    }
+    while ((ns1 - ns0) < 10000000);
+    return (double(ticks1 - ticks0) * 1000000000.0) / double(ns1 - ns0);
+    #else
+    return 1000000000.0;
+    #endif
+}
+
+} // namespace Oryol
\ No newline at end of file
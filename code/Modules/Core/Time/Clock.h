@@ -8,8 +8,40 @@
     The most important method of Clock is Now() which returns the 
     current point in time. The time values returned by Clock have
     no relation to the "wall-clock-time".
+
+    For instrumentation in hot code paths, Ticks() returns a raw
+    timestamp from the cheapest monotonic time source of the platform:
+    the CPU's time stamp counter on x86 (rdtsc, which is constant-rate
+    on all CPUs of the last decade), the virtual counter on ARM64, or
+    CLOCK_MONOTONIC_RAW on other POSIX platforms. Tick differences are
+    converted to nanoseconds with TicksToNanoSeconds(), the tick rate
+    is calibrated against NowNanoSeconds() once (Core::Setup() does
+    this up front, otherwise it happens on first use).
+
+    For deterministic replays (see App's benchmark mode), Now() can be
+    switched to a simulated time which only advances by a fixed time
+    step on each AdvanceSimulatedTime() call. NowNanoSeconds() and
+    Ticks() always return real time, so that performance measurements
+    are not affected.
+
+    @see ScopedTimer
 */
 #include "Core/Time/TimePoint.h"
+#if ORYOL_EMSCRIPTEN
+// no cycle counter
+#elif defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define ORYOL_CLOCK_TICKS_RDTSC (1)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#elif defined(__aarch64__) && !defined(_MSC_VER)
+#define ORYOL_CLOCK_TICKS_CNTVCT (1)
+#elif ORYOL_POSIX
+#define ORYOL_CLOCK_TICKS_MONOTONIC_RAW (1)
+#include <time.h>
+#endif
 
 namespace Oryol {
     
@@ -17,12 +49,60 @@ class Clock {
 public:
     /// get current point in time
     static TimePoint Now();
+    /// get a monotonic timestamp in nanoseconds (for profiling, unrelated to Now())
+    static int64_t NowNanoSeconds();
     /// get duration between Now and another TimePoint
     static Duration Since(const TimePoint& t);
     /// get duration between Now and TimePoint in the past, and set TimePoint to Now
     static Duration LapTime(TimePoint& inOutTimepoint);
+
+    /// switch Now() to simulated time with a fixed time step (0 switches back to real time)
+    static void SetSimulatedTimeStep(Duration timeStep);
+    /// return true if Now() returns simulated time
+    static bool IsSimulated();
+    /// advance the simulated time by one time step (called once per frame by App)
+    static void AdvanceSimulatedTime();
+
+    /// get a low-overhead raw timestamp (only tick differences are meaningful)
+    static int64_t Ticks();
+    /// get number of ticks per second (calibrated on first call)
+    static double TicksPerSecond();
+    /// convert a tick difference to nanoseconds
+    static int64_t TicksToNanoSeconds(int64_t ticks);
+
+private:
+    /// measure the tick rate
+    static double calibrateTicks();
 };
 
+//------------------------------------------------------------------------------
+inline int64_t
+Clock::Ticks() {
+    #if ORYOL_CLOCK_TICKS_RDTSC
+    return int64_t(__rdtsc());
+    #elif ORYOL_CLOCK_TICKS_CNTVCT
+    int64_t t;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(t));
+    return t;
+    #elif ORYOL_CLOCK_TICKS_MONOTONIC_RAW
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+    #else
+    return NowNanoSeconds();
+    #endif
+}
+
+//------------------------------------------------------------------------------
+inline int64_t
+Clock::TicksToNanoSeconds(int64_t ticks) {
+    #if ORYOL_CLOCK_TICKS_RDTSC || ORYOL_CLOCK_TICKS_CNTVCT
+    return int64_t(double(ticks) * (1000000000.0 / TicksPerSecond()));
+    #else
+    return ticks;
+    #endif
+}
+
 //------------------------------------------------------------------------------
 inline Duration
 Clock::Since(const TimePoint& t) {
@@ -38,4 +118,4 @@ Clock::LapTime(TimePoint& inOutTimepoint) {
     return dur;
 }
 
-} // namespace Oryol
\ No newline at end of file
+} // namespace Oryol
\ No newline at end of file
@@ -0,0 +1,313 @@
+//------------------------------------------------------------------------------
+//  FrameStats.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "FrameStats.h"
+#include "Core/Assertion.h"
+#include "Core/Time/Clock.h"
+#include "Core/TraceRecorder.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#if !ORYOL_EMSCRIPTEN
+#include <chrono>
+#include <thread>
+#endif
+
+namespace Oryol {
+
+namespace {
+    // the pacer yields instead of sleeping for the last 2ms before a deadline
+    const int64_t pacerSpinNanoSeconds = 2000000;
+
+    struct _state {
+        const char* phaseNames[FrameStats::MaxPhases] = { "Frame", "Pacer" };
+        int numPhases = 2;
+        int64_t times[FrameStats::MaxFrames][FrameStats::MaxPhases] = { };
+        bool spikes[FrameStats::MaxFrames] = { };
+        int64_t phaseStart[FrameStats::MaxPhases] = { };
+        int64_t frameCount = 0;
+        int64_t frameStart = 0;
+        bool inFrame = false;
+        int64_t frameTimeSum = 0;
+        int64_t numSpikes = 0;
+        float spikeFactor = 2.0f;
+        int targetFrameRate = 0;
+        int64_t pacerDeadline = 0;
+    } state;
+
+    //--------------------------------------------------------------------------
+    inline int
+    curSlot() {
+        return int(state.frameCount % FrameStats::MaxFrames);
+    }
+
+    //--------------------------------------------------------------------------
+    inline int
+    slotFramesAgo(int framesAgo) {
+        o_assert_range_dbg(framesAgo, FrameStats::NumFrames());
+        return int((state.frameCount - 1 - framesAgo) % FrameStats::MaxFrames);
+    }
+
+    //--------------------------------------------------------------------------
+    void
+    sleepUntil(int64_t deadline) {
+        #if !ORYOL_EMSCRIPTEN
+        for (;;) {
+            const int64_t remaining = deadline - Clock::NowNanoSeconds();
+            if (remaining <= 0) {
+                break;
+            }
+            if (remaining > pacerSpinNanoSeconds) {
+                std::this_thread::sleep_for(std::chrono::nanoseconds(remaining - pacerSpinNanoSeconds));
+            }
+            else {
+                std::this_thread::yield();
+            }
+        }
+        #endif
+    }
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+FrameStats::PhaseId
+FrameStats::RegisterPhase(const char* name) {
+    o_assert(nullptr != name);
+    PhaseId id = FindPhase(name);
+    if (InvalidPhaseId == id) {
+        o_assert2(state.numPhases < MaxPhases, "Too many FrameStats phases registered!\n");
+        id = state.numPhases++;
+        state.phaseNames[id] = name;
+    }
+    return id;
+}
+
+//------------------------------------------------------------------------------
+FrameStats::PhaseId
+FrameStats::FindPhase(const char* name) {
+    o_assert(nullptr != name);
+    for (int i = 0; i < state.numPhases; i++) {
+        if (0 == std::strcmp(state.phaseNames[i], name)) {
+            return i;
+        }
+    }
+    return InvalidPhaseId;
+}
+
+//------------------------------------------------------------------------------
+int
+FrameStats::NumPhases() {
+    return state.numPhases;
+}
+
+//------------------------------------------------------------------------------
+const char*
+FrameStats::PhaseName(PhaseId id) {
+    o_assert_range_dbg(id, state.numPhases);
+    return state.phaseNames[id];
+}
+
+//------------------------------------------------------------------------------
+void
+FrameStats::BeginFrame() {
+    o_assert_dbg(!state.inFrame);
+    const int slot = curSlot();
+    if (state.frameCount >= MaxFrames) {
+        // evict the oldest frame from the rolling average
+        state.frameTimeSum -= state.times[slot][FramePhase];
+    }
+    std::memset(state.times[slot], 0, sizeof(state.times[slot]));
+    state.spikes[slot] = false;
+    state.frameStart = Clock::NowNanoSeconds();
+    state.inFrame = true;
+}
+
+//------------------------------------------------------------------------------
+void
+FrameStats::EndFrame() {
+    o_assert_dbg(state.inFrame);
+    const int slot = curSlot();
+    const int64_t now = Clock::NowNanoSeconds();
+    const int64_t frameTime = now - state.frameStart;
+    state.times[slot][FramePhase] = frameTime;
+
+    // spike detection against the rolling average of the previous frames
+    const int numPrevFrames = NumFrames();
+    if ((state.spikeFactor > 0.0f) && (numPrevFrames >= MinSpikeFrames)) {
+        const double avg = double(state.frameTimeSum) / numPrevFrames;
+        if (double(frameTime) > (avg * state.spikeFactor)) {
+            state.spikes[slot] = true;
+            state.numSpikes++;
+            if (TraceRecorder::IsRecording()) {
+                TraceRecorder::Instant("FrameSpike");
+            }
+        }
+    }
+    state.frameTimeSum += frameTime;
+
+    // frame pacing, the deadline is the start of the next frame, if the
+    // frame is late by more than a whole frame, don't try to catch up
+    if (state.targetFrameRate > 0) {
+        const int64_t period = 1000000000 / state.targetFrameRate;
+        int64_t deadline = state.pacerDeadline;
+        if ((0 == deadline) || ((now - deadline) > period)) {
+            deadline = now;
+        }
+        else if (now < deadline) {
+            sleepUntil(deadline);
+            state.times[slot][PacerPhase] = Clock::NowNanoSeconds() - now;
+        }
+        state.pacerDeadline = deadline + period;
+    }
+    state.frameCount++;
+    state.inFrame = false;
+}
+
+//------------------------------------------------------------------------------
+void
+FrameStats::BeginPhase(PhaseId id) {
+    o_assert_range_dbg(id, state.numPhases);
+    state.phaseStart[id] = Clock::NowNanoSeconds();
+}
+
+//------------------------------------------------------------------------------
+void
+FrameStats::EndPhase(PhaseId id) {
+    o_assert_range_dbg(id, state.numPhases);
+    if (state.inFrame) {
+        state.times[curSlot()][id] += Clock::NowNanoSeconds() - state.phaseStart[id];
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+FrameStats::AddPhaseTime(PhaseId id, int64_t nanoSeconds) {
+    o_assert_range_dbg(id, state.numPhases);
+    if (state.inFrame) {
+        state.times[curSlot()][id] += nanoSeconds;
+    }
+}
+
+//------------------------------------------------------------------------------
+int64_t
+FrameStats::FrameCount() {
+    return state.frameCount;
+}
+
+//------------------------------------------------------------------------------
+int
+FrameStats::NumFrames() {
+    return int(std::min(state.frameCount, int64_t(MaxFrames)));
+}
+
+//------------------------------------------------------------------------------
+Duration
+FrameStats::PhaseTime(PhaseId id, int framesAgo) {
+    o_assert_range_dbg(id, state.numPhases);
+    return Duration(state.times[slotFramesAgo(framesAgo)][id] / 1000);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Percentiles use the nearest-rank method.
+*/
+FrameStats::Summary
+FrameStats::Query(PhaseId id, int numFrames) {
+    o_assert_range_dbg(id, state.numPhases);
+    Summary summary;
+    const int num = std::min(numFrames, NumFrames());
+    if (num <= 0) {
+        return summary;
+    }
+    int64_t values[MaxFrames];
+    int64_t sum = 0;
+    for (int i = 0; i < num; i++) {
+        values[i] = state.times[slotFramesAgo(i)][id];
+        sum += values[i];
+    }
+    std::sort(values, values + num);
+    auto percentile = [&values, num](int p) -> Duration {
+        const int rank = (p * num + 99) / 100;
+        return Duration(values[std::max(rank, 1) - 1] / 1000);
+    };
+    summary.NumFrames = num;
+    summary.Min = Duration(values[0] / 1000);
+    summary.Max = Duration(values[num - 1] / 1000);
+    summary.Avg = Duration((sum / num) / 1000);
+    summary.P50 = percentile(50);
+    summary.P95 = percentile(95);
+    summary.P99 = percentile(99);
+    return summary;
+}
+
+//------------------------------------------------------------------------------
+void
+FrameStats::SetSpikeFactor(float factor) {
+    o_assert(factor >= 0.0f);
+    state.spikeFactor = factor;
+}
+
+//------------------------------------------------------------------------------
+int64_t
+FrameStats::NumSpikes() {
+    return state.numSpikes;
+}
+
+//------------------------------------------------------------------------------
+bool
+FrameStats::IsSpike(int framesAgo) {
+    return state.spikes[slotFramesAgo(framesAgo)];
+}
+
+//------------------------------------------------------------------------------
+void
+FrameStats::SetTargetFrameRate(int framesPerSecond) {
+    o_assert(framesPerSecond >= 0);
+    state.targetFrameRate = framesPerSecond;
+    state.pacerDeadline = 0;
+}
+
+//------------------------------------------------------------------------------
+int
+FrameStats::TargetFrameRate() {
+    return state.targetFrameRate;
+}
+
+//------------------------------------------------------------------------------
+bool
+FrameStats::WriteCSV(const char* path) {
+    o_assert(nullptr != path);
+    FILE* fp = std::fopen(path, "w");
+    if (nullptr == fp) {
+        return false;
+    }
+    std::fputs("frame", fp);
+    for (int i = 0; i < state.numPhases; i++) {
+        std::fprintf(fp, ",%s", state.phaseNames[i]);
+    }
+    std::fputs(",spike\n", fp);
+    const int num = NumFrames();
+    for (int framesAgo = num - 1; framesAgo >= 0; framesAgo--) {
+        const int slot = slotFramesAgo(framesAgo);
+        std::fprintf(fp, "%lld", (long long)(state.frameCount - 1 - framesAgo));
+        for (int i = 0; i < state.numPhases; i++) {
+            std::fprintf(fp, ",%.3f", double(state.times[slot][i]) / 1000000.0);
+        }
+        std::fprintf(fp, ",%d\n", state.spikes[slot] ? 1 : 0);
+    }
+    const bool ok = (0 == std::ferror(fp));
+    std::fclose(fp);
+    return ok;
+}
+
+//------------------------------------------------------------------------------
+void
+FrameStats::Reset() {
+    state.frameCount = 0;
+    state.inFrame = false;
+    state.frameTimeSum = 0;
+    state.numSpikes = 0;
+    state.pacerDeadline = 0;
+}
+
+} // namespace Oryol
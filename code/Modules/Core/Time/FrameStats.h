@@ -0,0 +1,140 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::FrameStats
+    @ingroup Core
+    @brief per-frame timing statistics and frame pacing
+
+    FrameStats records the duration of each frame, and of named phases
+    inside a frame, into a ring buffer of the last MaxFrames frames.
+    Rolling statistics (min/max/avg/p50/p95/p99) can be queried for each
+    phase, and the recorded frames can be written to a CSV file for
+    offline analysis.
+
+    The App class calls BeginFrame() and EndFrame() once per frame and
+    records the PreRunLoop, OnFrame and PostRunLoop phases, so that
+    applications only need to register and time their own phases:
+
+    @code
+    static const FrameStats::PhaseId updatePhase = FrameStats::RegisterPhase("Update");
+    {
+        FrameStats::ScopedPhase scope(updatePhase);
+        ...
+    }
+    FrameStats::Summary s = FrameStats::Query(FrameStats::FramePhase);
+    Log::Info("frame: avg=%.3fms p99=%.3fms\n", s.Avg.AsMilliSeconds(), s.P99.AsMilliSeconds());
+    @endcode
+
+    A frame is a spike if its duration is more than SpikeFactor times
+    the rolling average frame duration. Spikes are counted, flagged in the
+    CSV output and recorded as instant events in the TraceRecorder.
+
+    If a target frame rate is set (see CoreSetup::TargetFrameRate),
+    EndFrame() sleeps until the next frame is due. The pacer sleeps
+    with the OS scheduler until shortly before the deadline, and yields
+    for the remaining time to hit the deadline precisely. The time spent
+    in the pacer is recorded as the PacerPhase. The pacer is not active
+    on platforms where the frame loop is driven by the browser or OS
+    (emscripten).
+
+    FrameStats must only be used from the main thread. Timestamps
+    come from Clock::NowNanoSeconds().
+*/
+#include "Core/Types.h"
+#include "Core/Time/Duration.h"
+
+namespace Oryol {
+
+class FrameStats {
+public:
+    /// number of frames in the ring buffer
+    static const int MaxFrames = 512;
+    /// max number of phases (including the built-in phases)
+    static const int MaxPhases = 16;
+    /// min number of recorded frames before spikes are detected
+    static const int MinSpikeFrames = 16;
+
+    /// a phase id
+    typedef int PhaseId;
+    /// an invalid phase id
+    static const PhaseId InvalidPhaseId = -1;
+    /// built-in phase: duration from BeginFrame() to EndFrame()
+    static const PhaseId FramePhase = 0;
+    /// built-in phase: time spent in the frame pacer
+    static const PhaseId PacerPhase = 1;
+
+    /// rolling statistics of a phase
+    struct Summary {
+        /// number of frames the statistics are computed from
+        int NumFrames = 0;
+        Duration Min;
+        Duration Max;
+        Duration Avg;
+        Duration P50;
+        Duration P95;
+        Duration P99;
+    };
+
+    /// register a named phase (returns the existing id if already registered)
+    static PhaseId RegisterPhase(const char* name);
+    /// find a phase by name, return InvalidPhaseId if not registered
+    static PhaseId FindPhase(const char* name);
+    /// get number of registered phases (ids are 0..NumPhases()-1)
+    static int NumPhases();
+    /// get the name of a phase
+    static const char* PhaseName(PhaseId id);
+
+    /// begin a new frame
+    static void BeginFrame();
+    /// end the current frame, runs the pacer if a target frame rate is set
+    static void EndFrame();
+    /// begin a phase in the current frame
+    static void BeginPhase(PhaseId id);
+    /// end a phase, a phase can be entered several times per frame
+    static void EndPhase(PhaseId id);
+    /// add time to a phase in the current frame
+    static void AddPhaseTime(PhaseId id, int64_t nanoSeconds);
+
+    /// get number of completed frames since the last Reset()
+    static int64_t FrameCount();
+    /// get number of completed frames in the ring buffer
+    static int NumFrames();
+    /// get the duration of a phase in a recent frame (0 is the last completed frame)
+    static Duration PhaseTime(PhaseId id, int framesAgo=0);
+    /// compute rolling statistics over the last numFrames completed frames
+    static Summary Query(PhaseId id, int numFrames=MaxFrames);
+
+    /// set the spike factor (default is 2.0, 0.0 disables spike detection)
+    static void SetSpikeFactor(float factor);
+    /// get number of spike frames since the last Reset()
+    static int64_t NumSpikes();
+    /// return true if a recent frame was a spike (0 is the last completed frame)
+    static bool IsSpike(int framesAgo=0);
+
+    /// set the pacer's target frame rate (0 disables the pacer)
+    static void SetTargetFrameRate(int framesPerSecond);
+    /// get the pacer's target frame rate
+    static int TargetFrameRate();
+
+    /// write recorded frames as CSV file (durations in milliseconds), return false on error
+    static bool WriteCSV(const char* path);
+    /// discard recorded frames (registered phases are kept)
+    static void Reset();
+
+    /// helper class for scoped BeginPhase/EndPhase
+    class ScopedPhase {
+    public:
+        /// constructor, calls BeginPhase()
+        ScopedPhase(PhaseId id_) : id(id_) {
+            FrameStats::BeginPhase(id_);
+        };
+        /// destructor, calls EndPhase()
+        ~ScopedPhase() {
+            FrameStats::EndPhase(this->id);
+        };
+    private:
+        PhaseId id;
+    };
+};
+
+} // namespace Oryol
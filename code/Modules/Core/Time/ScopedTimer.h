@@ -0,0 +1,47 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::ScopedTimer
+    @ingroup Core
+    @brief low-overhead scope timer which accumulates into a counter
+
+    A ScopedTimer measures the time between its construction and
+    destruction with Clock::Ticks(), and adds the elapsed nanoseconds
+    to a counter in the Counters registry. The counter should be
+    registered once up front, so that timing a scope only costs two
+    timestamps and an atomic add, and can stay enabled in release builds:
+
+    @code
+    static const Counters::Id cullTime = Counters::Register("Scene_CullNanoSeconds");
+    void cull() {
+        ScopedTimer timer(cullTime);
+        ...
+    }
+    @endcode
+
+    Read (and reset) the accumulated time at a convenient point, e.g.
+    once per frame, with Counters::Get() and Counters::Set().
+*/
+#include "Core/Time/Clock.h"
+#include "Core/Counters.h"
+
+namespace Oryol {
+
+class ScopedTimer {
+public:
+    /// constructor, starts the timer
+    ScopedTimer(Counters::Id counterId) :
+        id(counterId),
+        start(Clock::Ticks()) {
+        // empty
+    };
+    /// destructor, adds the elapsed nanoseconds to the counter
+    ~ScopedTimer() {
+        Counters::Add(this->id, Clock::TicksToNanoSeconds(Clock::Ticks() - this->start));
+    };
+private:
+    Counters::Id id;
+    int64_t start;
+};
+
+} // namespace Oryol
@@ -4,12 +4,24 @@
 #if ORYOL_PROFILING
 #include "Pre.h"
 #include "Trace.h"
+#if ORYOL_USE_TRACERECORDER
+#include <cstdlib>
+#endif
 
 namespace Oryol {
 
 //------------------------------------------------------------------------------
 Trace::Trace() {
-    #if ORYOL_USE_REMOTERY
+    #if ORYOL_USE_TRACERECORDER
+    // start recording right away if a trace file is requested
+    const char* path = std::getenv("ORYOL_TRACE_FILE");
+    if (path && path[0]) {
+        TraceRecorder::SetThreadName("MainThread");
+        TraceRecorder::DumpOnExit(path);
+        // keep the most recent events of a long capture
+        TraceRecorder::Start(TraceRecorder::DefaultEventsPerThread, true);
+    }
+    #elif ORYOL_USE_REMOTERY
     rmt_CreateGlobalInstance(&this->rmt);
     rmt_SetCurrentThreadName("MainThread");
     #elif ORYOL_USE_EMSCTRACE
@@ -19,7 +31,10 @@ Trace::Trace() {
 
 //------------------------------------------------------------------------------
 Trace::~Trace() {
-    #if ORYOL_USE_REMOTERY
+    #if ORYOL_USE_TRACERECORDER
+    // the trace file is written at process exit, so that
+    // events recorded after Core::Discard() are included
+    #elif ORYOL_USE_REMOTERY
     rmt_DestroyGlobalInstance(this->rmt);
     this->rmt = nullptr;
     #elif ORYOL_USE_EMSCTRACE
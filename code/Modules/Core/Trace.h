@@ -6,13 +6,31 @@
     @brief tracing support when ORYOL_PROFILING is enabled
 
     This file implements various macros that hook Oryol into
-    profiling/tracing tools.
+    profiling/tracing tools. With ORYOL_BUILTIN_TRACE (the default),
+    the macros record into the built-in TraceRecorder, otherwise
+    Remotery or emscripten tracing is used.
+
+    - o_trace_begin_frame(), o_trace_end_frame(): mark frame boundaries
+    - o_trace_begin(name), o_trace_end(): begin/end a named scope
+    - o_trace_scoped(name): scope which ends at the end of the C++ block
+    - o_trace_counter(name, value): set a counter value
+    - o_trace_counter_add(name, delta): add to a counter value
+    - o_trace_flow_begin(name, id), o_trace_flow_end(name, id): connect
+      scopes on different threads (e.g. an IO request and its completion)
+
+    Names are identifiers, not strings (e.g. o_trace_scoped(IO_ReadFile)).
+    Counters are registered in the Counters registry (see Core/Counters.h)
+    and can be queried at runtime with any tracing backend, but only
+    the built-in TraceRecorder records counter and flow events.
  */
 #include "Core/Types.h"
-#if ORYOL_LINUX || ORYOL_MACOS || ORYOL_WINDOWS
+#include "Core/Counters.h"
+#if ORYOL_BUILTIN_TRACE
+#define ORYOL_USE_TRACERECORDER (1)
+#include "Core/TraceRecorder.h"
+#elif ORYOL_LINUX || ORYOL_MACOS || ORYOL_WINDOWS
 #define ORYOL_USE_REMOTERY (1)
-#endif
-#if ORYOL_EMSCRIPTEN
+#elif ORYOL_EMSCRIPTEN
 #define ORYOL_USE_EMSCTRACE (1)
 #endif
 
@@ -49,25 +67,49 @@ struct emscScopedTrace {
 };
 #endif
     
+// counter macros, the counter id is looked up once per call site
+#define o_trace_counter(name, value) do { \
+    static const Oryol::Counters::Id counterId##name = Oryol::Counters::Register(#name); \
+    Oryol::Counters::Set(counterId##name, int64_t(value)); \
+} while (0)
+#define o_trace_counter_add(name, delta) do { \
+    static const Oryol::Counters::Id counterId##name = Oryol::Counters::Register(#name); \
+    Oryol::Counters::Add(counterId##name, int64_t(delta)); \
+} while (0)
+
 // trace macros
-#if ORYOL_USE_REMOTERY
+#if ORYOL_USE_TRACERECORDER
+#define o_trace_begin_frame() Oryol::TraceRecorder::Instant("BeginFrame")
+#define o_trace_end_frame() Oryol::TraceRecorder::Instant("EndFrame")
+#define o_trace_begin(name) Oryol::TraceRecorder::Begin(#name)
+#define o_trace_end() Oryol::TraceRecorder::End()
+#define o_trace_scoped(name) Oryol::TraceRecorder::Scope traceScope##name(#name)
+#define o_trace_flow_begin(name, id) Oryol::TraceRecorder::FlowBegin(#name, uint64_t(id))
+#define o_trace_flow_end(name, id) Oryol::TraceRecorder::FlowEnd(#name, uint64_t(id))
+#elif ORYOL_USE_REMOTERY
 #define o_trace_begin_frame() ((void)0)
 #define o_trace_end_frame() ((void)0)
 #define o_trace_begin(name) rmt_BeginCPUSample(name)
 #define o_trace_end() rmt_EndCPUSample()
 #define o_trace_scoped(name) rmt_ScopedCPUSample(name)
+#define o_trace_flow_begin(name, id) ((void)0)
+#define o_trace_flow_end(name, id) ((void)0)
 #elif ORYOL_USE_EMSCTRACE
 #define o_trace_begin_frame() emscripten_trace_record_frame_start()
 #define o_trace_end_frame() emscripten_trace_record_frame_end()
 #define o_trace_begin(name) emscripten_trace_enter_context(#name)
-#define o_trace_end(name) emscripten_trace_exit_context()
+#define o_trace_end() emscripten_trace_exit_context()
 #define o_trace_scoped(name) emscScopedTrace emscScopedTrace##name(#name)
+#define o_trace_flow_begin(name, id) ((void)0)
+#define o_trace_flow_end(name, id) ((void)0)
 #else
 #define o_trace_begin_frame() ((void)0)
 #define o_trace_end_frame() ((void)0)
 #define o_trace_begin(name) ((void)0)
 #define o_trace_end() ((void)0)
 #define o_trace_scoped(name) ((void)0)
+#define o_trace_flow_begin(name, id) ((void)0)
+#define o_trace_flow_end(name, id) ((void)0)
 #endif
 
 } // namespace Oryol
@@ -77,4 +119,8 @@ struct emscScopedTrace {
 #define o_trace_begin(name) ((void)0)
 #define o_trace_end() ((void)0)
 #define o_trace_scoped(name) ((void)0)
+#define o_trace_counter(name, value) ((void)0)
+#define o_trace_counter_add(name, delta) ((void)0)
+#define o_trace_flow_begin(name, id) ((void)0)
+#define o_trace_flow_end(name, id) ((void)0)
 #endif
@@ -0,0 +1,360 @@
+//------------------------------------------------------------------------------
+//  TraceRecorder.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "TraceRecorder.h"
+#include "Core/Assertion.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Time/Clock.h"
+#include "Core/Threading/ThreadLocalPtr.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#if ORYOL_HAS_THREADS
+#include <mutex>
+#endif
+
+namespace Oryol {
+
+namespace {
+    enum eventType : uint8_t {
+        beginEvent,
+        endEvent,
+        instantEvent,
+        counterEvent,
+        flowBeginEvent,
+        flowEndEvent,
+    };
+    struct event {
+        int64_t time;       // nanoseconds
+        const char* name;
+        int64_t value;      // counter value, or flow id
+        eventType type;
+    };
+    // NOTE: thread buffers are never destroyed, since threads
+    // keep a pointer to their buffer
+    struct threadBuffer {
+        int index = 0;
+        char name[TraceRecorder::MaxThreadNameLength + 1] = { };
+        event* events = nullptr;
+        int capacity = 0;
+        std::atomic<int64_t> numWritten{0};     // events[numWritten % capacity] is written next
+        std::atomic<int64_t> numDropped{0};
+    };
+    threadBuffer* buffers[TraceRecorder::MaxThreads];
+    std::atomic<int> numBuffers{0};
+    #if ORYOL_HAS_THREADS
+    std::mutex buffersMutex;
+    #endif
+    ORYOL_THREADLOCAL_PTR(threadBuffer) curBuffer = nullptr;
+
+    std::atomic<bool> recording{false};
+    std::atomic<bool> ringBufferMode{false};
+    std::atomic<int> eventsPerThread{TraceRecorder::DefaultEventsPerThread};
+    std::atomic<int64_t> startTime{0};
+    const char* dumpOnExitPath = nullptr;
+
+    //--------------------------------------------------------------------------
+    threadBuffer*
+    registerThread() {
+        #if ORYOL_HAS_THREADS
+        std::lock_guard<std::mutex> guard(buffersMutex);
+        #endif
+        const int index = numBuffers.load(std::memory_order_relaxed);
+        if (index >= TraceRecorder::MaxThreads) {
+            return nullptr;
+        }
+        threadBuffer* buf = Memory::New<threadBuffer>();
+        buf->index = index;
+        buf->capacity = eventsPerThread.load(std::memory_order_relaxed);
+        buf->events = (event*) Memory::Alloc(buf->capacity * int(sizeof(event)));
+        buffers[index] = buf;
+        numBuffers.store(index + 1, std::memory_order_release);
+        curBuffer = buf;
+        return buf;
+    }
+
+    //--------------------------------------------------------------------------
+    threadBuffer*
+    threadBuf() {
+        return curBuffer ? (threadBuffer*)curBuffer : registerThread();
+    }
+
+    //--------------------------------------------------------------------------
+    inline void
+    record(eventType type, const char* name, int64_t value) {
+        if (!recording.load(std::memory_order_relaxed)) {
+            return;
+        }
+        threadBuffer* buf = threadBuf();
+        if (nullptr == buf) {
+            return;
+        }
+        // only this thread writes numWritten, the release store
+        // publishes the event to a concurrent Dump()
+        const int64_t i = buf->numWritten.load(std::memory_order_relaxed);
+        if ((i >= buf->capacity) && !ringBufferMode.load(std::memory_order_relaxed)) {
+            buf->numDropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        event& e = buf->events[i % buf->capacity];
+        e.time = Clock::NowNanoSeconds();
+        e.name = name;
+        e.value = value;
+        e.type = type;
+        buf->numWritten.store(i + 1, std::memory_order_release);
+    }
+
+    //--------------------------------------------------------------------------
+    void
+    writeString(FILE* fp, const char* str) {
+        std::fputc('"', fp);
+        for (const char* p = str; *p; p++) {
+            if (('"' == *p) || ('\\' == *p)) {
+                std::fputc('\\', fp);
+            }
+            if (uint8_t(*p) >= 0x20) {
+                std::fputc(*p, fp);
+            }
+        }
+        std::fputc('"', fp);
+    }
+
+    //--------------------------------------------------------------------------
+    /// number of events still in a thread buffer
+    int
+    numBufferedEvents(const threadBuffer* buf, int64_t numWritten) {
+        return int((numWritten < buf->capacity) ? numWritten : buf->capacity);
+    }
+
+    //--------------------------------------------------------------------------
+    /// number of dropped and overwritten events of a thread buffer
+    int64_t
+    numLostEvents(const threadBuffer* buf, int64_t numWritten) {
+        return buf->numDropped.load(std::memory_order_relaxed) + (numWritten - numBufferedEvents(buf, numWritten));
+    }
+
+    //--------------------------------------------------------------------------
+    void
+    dumpAtExit() {
+        if (dumpOnExitPath) {
+            TraceRecorder::Stop();
+            TraceRecorder::Dump(dumpOnExitPath);
+        }
+    }
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+void
+TraceRecorder::Start(int numEventsPerThread, bool ringBuffer) {
+    o_assert(numEventsPerThread > 0);
+    eventsPerThread.store(numEventsPerThread, std::memory_order_relaxed);
+    ringBufferMode.store(ringBuffer, std::memory_order_relaxed);
+    if (0 == startTime.load(std::memory_order_relaxed)) {
+        startTime.store(Clock::NowNanoSeconds(), std::memory_order_relaxed);
+    }
+    recording.store(true, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------
+void
+TraceRecorder::Stop() {
+    recording.store(false, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------
+bool
+TraceRecorder::IsRecording() {
+    return recording.load(std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+void
+TraceRecorder::Clear() {
+    const int num = numBuffers.load(std::memory_order_acquire);
+    for (int i = 0; i < num; i++) {
+        buffers[i]->numWritten.store(0, std::memory_order_relaxed);
+        buffers[i]->numDropped.store(0, std::memory_order_relaxed);
+    }
+    startTime.store(recording.load() ? Clock::NowNanoSeconds() : 0, std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+int
+TraceRecorder::NumEvents() {
+    int result = 0;
+    const int num = numBuffers.load(std::memory_order_acquire);
+    for (int i = 0; i < num; i++) {
+        result += numBufferedEvents(buffers[i], buffers[i]->numWritten.load(std::memory_order_relaxed));
+    }
+    return result;
+}
+
+//------------------------------------------------------------------------------
+int64_t
+TraceRecorder::NumDropped() {
+    int64_t result = 0;
+    const int num = numBuffers.load(std::memory_order_acquire);
+    for (int i = 0; i < num; i++) {
+        result += numLostEvents(buffers[i], buffers[i]->numWritten.load(std::memory_order_relaxed));
+    }
+    return result;
+}
+
+//------------------------------------------------------------------------------
+void
+TraceRecorder::DumpOnExit(const char* path) {
+    o_assert(nullptr != path);
+    if (nullptr == dumpOnExitPath) {
+        std::atexit(dumpAtExit);
+    }
+    else {
+        std::free((void*)dumpOnExitPath);
+    }
+    // NOTE: copy with malloc, since the Memory allocators might be gone at exit
+    const size_t len = std::strlen(path) + 1;
+    char* copy = (char*) std::malloc(len);
+    std::memcpy(copy, path, len);
+    dumpOnExitPath = copy;
+}
+
+//------------------------------------------------------------------------------
+/**
+    This can be called while other threads are recording, only the events
+    which have been recorded when Dump() looks at a thread's buffer are
+    written (in ring buffer mode, only call this while not recording, since
+    the oldest events might be overwritten while they are written). Events
+    are written per thread in recording order, so that begin/end pairs
+    match up, end events whose begin event has been overwritten are skipped.
+*/
+bool
+TraceRecorder::Dump(const char* path) {
+    o_assert(nullptr != path);
+    FILE* fp = std::fopen(path, "w");
+    if (nullptr == fp) {
+        return false;
+    }
+    const int64_t t0 = startTime.load(std::memory_order_relaxed);
+    std::fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n", fp);
+    bool first = true;
+    const int num = numBuffers.load(std::memory_order_acquire);
+    for (int bufIndex = 0; bufIndex < num; bufIndex++) {
+        const threadBuffer* buf = buffers[bufIndex];
+        const int64_t numWritten = buf->numWritten.load(std::memory_order_acquire);
+        const int numEvents = numBufferedEvents(buf, numWritten);
+        if (0 == numEvents) {
+            continue;
+        }
+        const int tid = buf->index + 1;
+        std::fprintf(fp, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":", first ? "" : ",\n", tid);
+        if (buf->name[0]) {
+            writeString(fp, buf->name);
+        }
+        else {
+            std::fprintf(fp, "\"Thread %d\"", tid);
+        }
+        std::fputs("}}", fp);
+        first = false;
+        const int64_t firstEvent = numWritten - numEvents;
+        const int64_t numLost = numLostEvents(buf, numWritten);
+        if (numLost > 0) {
+            // make the incomplete trace obvious in the viewer
+            const int64_t t = buf->events[firstEvent % buf->capacity].time - t0;
+            std::fprintf(fp, ",\n{\"pid\":1,\"tid\":%d,\"ts\":%lld.%03d,\"name\":\"TraceRecorder: %lld events dropped (thread buffer full)\",\"ph\":\"i\",\"s\":\"t\"}",
+                tid, (long long)(t / 1000), int(t % 1000), (long long)numLost);
+        }
+        int depth = 0;
+        for (int64_t i = firstEvent; i < numWritten; i++) {
+            const event& e = buf->events[i % buf->capacity];
+            if (endEvent == e.type) {
+                if (0 == depth) {
+                    continue;
+                }
+                depth--;
+            }
+            else if (beginEvent == e.type) {
+                depth++;
+            }
+            const int64_t t = e.time - t0;
+            std::fprintf(fp, ",\n{\"pid\":1,\"tid\":%d,\"ts\":%lld.%03d", tid, (long long)(t / 1000), int(t % 1000));
+            if (e.name) {
+                std::fputs(",\"name\":", fp);
+                writeString(fp, e.name);
+            }
+            switch (e.type) {
+                case beginEvent:
+                    std::fputs(",\"ph\":\"B\"}", fp);
+                    break;
+                case endEvent:
+                    std::fputs(",\"ph\":\"E\"}", fp);
+                    break;
+                case instantEvent:
+                    std::fputs(",\"ph\":\"i\",\"s\":\"t\"}", fp);
+                    break;
+                case counterEvent:
+                    std::fprintf(fp, ",\"ph\":\"C\",\"args\":{\"value\":%lld}}", (long long)e.value);
+                    break;
+                case flowBeginEvent:
+                    std::fprintf(fp, ",\"ph\":\"s\",\"cat\":\"flow\",\"id\":%llu}", (unsigned long long)e.value);
+                    break;
+                case flowEndEvent:
+                    std::fprintf(fp, ",\"ph\":\"f\",\"bp\":\"e\",\"cat\":\"flow\",\"id\":%llu}", (unsigned long long)e.value);
+                    break;
+            }
+        }
+    }
+    std::fputs("\n]}\n", fp);
+    const bool ok = (0 == std::ferror(fp));
+    std::fclose(fp);
+    return ok;
+}
+
+//------------------------------------------------------------------------------
+void
+TraceRecorder::SetThreadName(const char* name) {
+    o_assert(nullptr != name);
+    threadBuffer* buf = threadBuf();
+    if (buf) {
+        std::strncpy(buf->name, name, MaxThreadNameLength);
+        buf->name[MaxThreadNameLength] = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+TraceRecorder::Begin(const char* name) {
+    record(beginEvent, name, 0);
+}
+
+//------------------------------------------------------------------------------
+void
+TraceRecorder::End() {
+    record(endEvent, nullptr, 0);
+}
+
+//------------------------------------------------------------------------------
+void
+TraceRecorder::Instant(const char* name) {
+    record(instantEvent, name, 0);
+}
+
+//------------------------------------------------------------------------------
+void
+TraceRecorder::Counter(const char* name, int64_t value) {
+    record(counterEvent, name, value);
+}
+
+//------------------------------------------------------------------------------
+void
+TraceRecorder::FlowBegin(const char* name, uint64_t id) {
+    record(flowBeginEvent, name, int64_t(id));
+}
+
+//------------------------------------------------------------------------------
+void
+TraceRecorder::FlowEnd(const char* name, uint64_t id) {
+    record(flowEndEvent, name, int64_t(id));
+}
+
+} // namespace Oryol
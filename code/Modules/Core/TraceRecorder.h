@@ -0,0 +1,98 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::TraceRecorder
+    @ingroup Core
+    @brief built-in trace event recorder with Chrome trace output
+
+    The TraceRecorder records begin/end, instant, counter and flow
+    events into per-thread event buffers, and writes them as a Chrome
+    trace JSON file which can be loaded into chrome://tracing or
+    https://ui.perfetto.dev, no external profiler or network connection
+    is needed.
+
+    With ORYOL_PROFILING and ORYOL_BUILTIN_TRACE enabled, the o_trace_*
+    macros in Core/Trace.h map to the TraceRecorder. Setting the
+    environment variable ORYOL_TRACE_FILE to a file path starts
+    recording in Core::Setup(), and writes the file when the process exits.
+    Recording can also be controlled in code:
+
+    @code
+    TraceRecorder::Start();
+    ...
+    TraceRecorder::Stop();
+    TraceRecorder::Dump("trace.json");
+    @endcode
+
+    Each thread writes into its own fixed-size event buffer without
+    locking (only a thread's first event takes a lock to register the
+    buffer). Timestamps come from Clock::NowNanoSeconds(). If a thread's
+    buffer is full, new events are dropped and counted, see NumDropped().
+    In ring buffer mode (used for ORYOL_TRACE_FILE), new events overwrite
+    the oldest events instead, so that the end of a long capture is kept,
+    the overwritten events are also counted as dropped. The number of
+    dropped events of each thread is written into the trace file as a
+    warning instant event.
+    Event names must be static strings (e.g. string literals), since
+    only the pointer is recorded.
+*/
+#include "Core/Types.h"
+
+namespace Oryol {
+
+class TraceRecorder {
+public:
+    /// default number of events per thread buffer
+    static const int DefaultEventsPerThread = 64 * 1024;
+    /// max number of recorded threads
+    static const int MaxThreads = 64;
+    /// max length of a thread name
+    static const int MaxThreadNameLength = 31;
+
+    /// start recording (eventsPerThread is used when a thread records its first event)
+    static void Start(int eventsPerThread=DefaultEventsPerThread, bool ringBuffer=false);
+    /// stop recording
+    static void Stop();
+    /// return true if currently recording
+    static bool IsRecording();
+    /// discard all recorded events (only call while no thread is recording)
+    static void Clear();
+    /// write recorded events as Chrome trace JSON file, return false if file couldn't be written
+    static bool Dump(const char* path);
+    /// dump recorded events to a file when the process exits
+    static void DumpOnExit(const char* path);
+    /// get number of recorded events (which are still in the thread buffers)
+    static int NumEvents();
+    /// get number of dropped or overwritten events (thread buffers full)
+    static int64_t NumDropped();
+
+    /// set the calling thread's name in the trace
+    static void SetThreadName(const char* name);
+    /// begin a named scope on the calling thread
+    static void Begin(const char* name);
+    /// end the current scope on the calling thread
+    static void End();
+    /// record an instant event
+    static void Instant(const char* name);
+    /// record a counter value
+    static void Counter(const char* name, int64_t value);
+    /// start a flow (an arrow between scopes, possibly on other threads)
+    static void FlowBegin(const char* name, uint64_t id);
+    /// end a flow started with FlowBegin()
+    static void FlowEnd(const char* name, uint64_t id);
+
+    /// helper class for scoped begin/end
+    class Scope {
+    public:
+        /// constructor, calls Begin()
+        Scope(const char* name) {
+            TraceRecorder::Begin(name);
+        };
+        /// destructor, calls End()
+        ~Scope() {
+            TraceRecorder::End();
+        };
+    };
+};
+
+} // namespace Oryol
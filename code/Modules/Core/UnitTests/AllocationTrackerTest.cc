@@ -0,0 +1,124 @@
+//------------------------------------------------------------------------------
+//  AllocationTrackerTest.cc
+//  Test allocation tracking (only meaningful with ORYOL_ALLOCATION_TRACKING).
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Memory/AllocationTracker.h"
+#include "Core/Containers/Array.h"
+#include "Core/StackTrace.h"
+
+using namespace Oryol;
+
+//------------------------------------------------------------------------------
+// NOTE: must neither be inlined nor end in a tail-call to Memory::Alloc(),
+// so that all calls share the call-site inside this function
+static ORYOL_NOINLINE void* allocSomething(int numBytes) {
+    void* ptr = Memory::Alloc(numBytes);
+    Memory::Clear(ptr, numBytes);
+    return ptr;
+}
+
+//------------------------------------------------------------------------------
+// two different users of the same container code
+static ORYOL_NOINLINE void growArrayA(Array<int>& array) {
+    array.Reserve(64);
+    array.Add(1);
+}
+static ORYOL_NOINLINE void growArrayB(Array<int>& array) {
+    array.Reserve(64);
+    array.Add(2);
+}
+
+//------------------------------------------------------------------------------
+TEST(AllocationTrackerCheckpointTest) {
+    Array<int> array;
+    array.Reserve(16);
+    AllocationTracker::Checkpoint checkpoint;
+    for (int i = 0; i < 16; i++) {
+        array.Add(i);
+    }
+    CHECK(checkpoint.NumAllocs() == 0);
+    array.Add(16);
+    if (AllocationTracker::IsEnabled()) {
+        CHECK(checkpoint.NumAllocs() == 1);
+        CHECK(checkpoint.AllocBytes() > 0);
+    }
+    else {
+        CHECK(checkpoint.NumAllocs() == 0);
+    }
+}
+
+//------------------------------------------------------------------------------
+TEST(AllocationTrackerSnapshotTest) {
+    AllocationTracker::SetSampleRate(1);
+    AllocationTracker::Snapshot before = AllocationTracker::TakeSnapshot();
+    void* p0 = allocSomething(100);
+    void* p1 = allocSomething(200);
+    void* p2 = Memory::Alloc(300);
+    Memory::Free(p1);
+    AllocationTracker::Snapshot after = AllocationTracker::TakeSnapshot();
+    AllocationTracker::Snapshot diff = AllocationTracker::Diff(before, after);
+    AllocationTracker::Dump(diff);
+    if (AllocationTracker::IsEnabled()) {
+        CHECK(AllocationTracker::SampleRate() == 1);
+        CHECK(diff.Total.NumAllocs == 3);
+        CHECK(diff.Total.NumFrees == 1);
+        CHECK(diff.Total.AllocBytes == 600);
+        CHECK(diff.Total.LiveBytes == 400);
+        // the 2 allocSomething() calls share the Memory::Alloc() caller,
+        // but are separate call-sites if the call stack can be captured
+        void* frames[4];
+        const bool hasCallStack = StackTrace::Capture(frames, 4) > 0;
+        CHECK(diff.CallSites.Size() == (hasCallStack ? 3 : 2));
+        const AllocationTracker::CallSite* allocSite = nullptr;
+        int64_t allocSiteAllocs = 0;
+        for (const auto& site : diff.CallSites) {
+            CHECK(site.Address != nullptr);
+            CHECK(site.Trace != nullptr);
+            if ((site.Stats.AllocBytes == 300) && (site.Stats.LiveBytes == 300)) {
+                // the Memory::Alloc() call in this function
+                CHECK(site.Stats.NumAllocs == 1);
+                CHECK(site.Stats.NumFrees == 0);
+            }
+            else {
+                if (allocSite) {
+                    CHECK(allocSite->Address == site.Address);
+                    CHECK(allocSite->Callers[0] != site.Callers[0]);
+                }
+                allocSite = &site;
+                allocSiteAllocs += site.Stats.NumAllocs;
+                CHECK(site.Stats.PeakBytes >= 100);
+            }
+        }
+        CHECK(allocSiteAllocs == 2);
+    }
+    else {
+        CHECK(diff.Total.NumAllocs == 0);
+        CHECK(diff.CallSites.Empty());
+    }
+    Memory::Free(p0);
+    Memory::Free(p2);
+    AllocationTracker::SetSampleRate(0);
+
+    // frame memory is not tracked
+    AllocationTracker::Checkpoint checkpoint;
+    Memory::Free(Memory::Alloc(64, MemoryTag::Frame));
+    CHECK(checkpoint.NumAllocs() == 0);
+}
+
+//------------------------------------------------------------------------------
+TEST(AllocationTrackerContainerCallSiteTest) {
+    // allocations in container code are told apart by the container user
+    AllocationTracker::Snapshot before = AllocationTracker::TakeSnapshot();
+    Array<int> a, b;
+    growArrayA(a);
+    growArrayB(b);
+    AllocationTracker::Snapshot diff = AllocationTracker::Diff(before, AllocationTracker::TakeSnapshot());
+    void* frames[4];
+    if (AllocationTracker::IsEnabled() && (StackTrace::Capture(frames, 4) > 0)) {
+        CHECK(diff.Total.NumAllocs == 2);
+        CHECK(diff.CallSites.Size() == 2);
+    }
+}
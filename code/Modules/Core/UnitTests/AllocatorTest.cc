@@ -0,0 +1,253 @@
+//------------------------------------------------------------------------------
+//  AllocatorTest.cc
+//  Test pluggable allocator backends and memory tags.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Memory/PoolAllocator.h"
+#include "Core/Memory/ArenaAllocator.h"
+#include "Core/Memory/FrameAllocator.h"
+#include "Core/Containers/Array.h"
+#include "Core/Containers/Buffer.h"
+
+using namespace Oryol;
+
+//------------------------------------------------------------------------------
+TEST(PoolAllocatorTest) {
+    CHECK(PoolAllocator::SizeClass(1) == 0);
+    CHECK(PoolAllocator::SizeClass(32) == 0);
+    CHECK(PoolAllocator::SizeClass(33) == 1);
+    CHECK(PoolAllocator::SizeClass(PoolAllocator::MaxBlockSize) == PoolAllocator::NumSizeClasses - 1);
+    CHECK(PoolAllocator::SizeClass(PoolAllocator::MaxBlockSize + 1) == InvalidIndex);
+
+    PoolAllocator pool("TestPool");
+    void* p0 = pool.Alloc(20);
+    void* p1 = pool.Alloc(20);
+    void* p2 = pool.Alloc(100000);
+    CHECK(p0 && p1 && p2 && (p0 != p1));
+    CHECK((intptr_t(p0) & (ORYOL_MAX_PLATFORM_ALIGN - 1)) == 0);
+    CHECK((intptr_t(p1) & (ORYOL_MAX_PLATFORM_ALIGN - 1)) == 0);
+    AllocatorStats stats = pool.Stats();
+    CHECK(stats.NumLiveAllocs == 3);
+    CHECK(stats.LiveBytes == 100040);
+    CHECK(stats.HighWaterMark == 100040);
+    pool.Free(p2, 100000);
+    pool.Free(p1, 20);
+    stats = pool.Stats();
+    CHECK(stats.NumLiveAllocs == 1);
+    CHECK(stats.LiveBytes == 20);
+    CHECK(stats.HighWaterMark == 100040);
+
+    // freed blocks are recycled
+    void* p3 = pool.Alloc(24);
+    CHECK(p3 == p1);
+
+    // re-alloc inside same size class doesn't move
+    void* p4 = pool.ReAlloc(p3, 24, 30);
+    CHECK(p4 == p3);
+    Memory::Fill(p4, 30, 0xAB);
+    void* p5 = pool.ReAlloc(p4, 30, 200);
+    CHECK(p5 != p4);
+    CHECK(((uint8_t*)p5)[29] == 0xAB);
+    pool.Free(p5, 200);
+    pool.Free(p0, 20);
+    CHECK(pool.Stats().NumLiveAllocs == 0);
+    CHECK(pool.Stats().LiveBytes == 0);
+}
+
+//------------------------------------------------------------------------------
+TEST(ArenaAllocatorTest) {
+    ArenaAllocator arena("TestArena", 1024);
+    void* p0 = arena.Alloc(100);
+    void* p1 = arena.Alloc(100);
+    CHECK(arena.Owns(p0) && arena.Owns(p1));
+    CHECK((intptr_t(p1) & (ORYOL_MAX_PLATFORM_ALIGN - 1)) == 0);
+    CHECK(((uint8_t*)p1 - (uint8_t*)p0) == Memory::RoundUp(100, ORYOL_MAX_PLATFORM_ALIGN));
+
+    // freeing the top allocation reclaims memory
+    arena.Free(p1, 100);
+    void* p2 = arena.Alloc(50);
+    CHECK(p2 == p1);
+
+    // top allocation can grow in place
+    void* p3 = arena.ReAlloc(p2, 50, 500);
+    CHECK(p3 == p2);
+
+    // a big allocation gets its own chunk
+    void* p4 = arena.Alloc(4000);
+    CHECK(arena.Owns(p4));
+    AllocatorStats stats = arena.Stats();
+    CHECK(stats.NumLiveAllocs == 3);
+    CHECK(stats.LiveBytes == 4600);
+    CHECK(stats.HighWaterMark == 4600);
+
+    // freeing everything rewinds the arena
+    arena.Free(p0, 100);
+    arena.Free(p3, 500);
+    arena.Free(p4, 4000);
+    CHECK(arena.Stats().NumLiveAllocs == 0);
+    void* p5 = arena.Alloc(16);
+    CHECK(p5 == p0);
+    arena.Reset();
+    CHECK(arena.Stats().LiveBytes == 0);
+    CHECK(arena.Alloc(16) == p0);
+    int x = 0;
+    CHECK(!arena.Owns(&x));
+}
+
+//------------------------------------------------------------------------------
+TEST(MemoryTagTest) {
+    static PoolAllocator ioPool("IO");
+    static ArenaAllocator gfxArena("Gfx");
+
+    CHECK(Memory::CurrentTag() == MemoryTag::Default);
+    CHECK(nullptr == Memory::GetAllocator(MemoryTag::IO));
+    void* p0 = Memory::Alloc(64);
+    CHECK(Memory::TagOf(p0) == MemoryTag::Default);
+
+    Memory::SetAllocator(MemoryTag::IO, &ioPool);
+    Memory::SetAllocator(MemoryTag::Gfx, &gfxArena);
+    CHECK(Memory::GetAllocator(MemoryTag::IO) == &ioPool);
+    {
+        Memory::ScopedTag tag(MemoryTag::IO);
+        CHECK(Memory::CurrentTag() == MemoryTag::IO);
+        Array<int> array;
+        for (int i = 0; i < 100; i++) {
+            array.Add(i);
+        }
+        CHECK(ioPool.Stats().NumLiveAllocs == 1);
+        {
+            Memory::ScopedTag innerTag(MemoryTag::Gfx);
+            CHECK(Memory::CurrentTag() == MemoryTag::Gfx);
+            void* p1 = Memory::Alloc(32);
+            CHECK(Memory::TagOf(p1) == MemoryTag::Gfx);
+            CHECK(gfxArena.Stats().NumLiveAllocs == 1);
+            Memory::Free(p1);
+            CHECK(gfxArena.Stats().NumLiveAllocs == 0);
+        }
+        CHECK(Memory::CurrentTag() == MemoryTag::IO);
+
+        // explicit tag
+        void* p2 = Memory::Alloc(32, MemoryTag::Gfx);
+        CHECK(Memory::TagOf(p2) == MemoryTag::Gfx);
+        p2 = Memory::ReAlloc(p2, 64);
+        CHECK(Memory::TagOf(p2) == MemoryTag::Gfx);
+        Memory::Free(p2);
+    }
+    CHECK(Memory::CurrentTag() == MemoryTag::Default);
+    CHECK(ioPool.Stats().NumLiveAllocs == 0);
+    CHECK(ioPool.Stats().HighWaterMark > 0);
+
+    // memory allocated before an allocator was changed is still freed correctly
+    Memory::SetAllocator(MemoryTag::IO, nullptr);
+    Memory::SetAllocator(MemoryTag::Gfx, nullptr);
+    Memory::Free(p0);
+}
+
+//------------------------------------------------------------------------------
+TEST(FrameAllocatorTest) {
+    FrameAllocator frameAlloc("TestFrame", 1024);
+    CHECK(frameAlloc.Capacity() == 1024);
+    void* p0 = frameAlloc.Alloc(100);
+    void* p1 = frameAlloc.Alloc(100);
+    CHECK(frameAlloc.Owns(p0) && frameAlloc.Owns(p1));
+    CHECK((intptr_t(p1) & (ORYOL_MAX_PLATFORM_ALIGN - 1)) == 0);
+
+    // last allocation can be reclaimed or grown in place
+    frameAlloc.Free(p1, 100);
+    CHECK(!frameAlloc.Owns(p1));
+    void* p2 = frameAlloc.Alloc(50);
+    CHECK(p2 == p1);
+    CHECK(frameAlloc.ReAlloc(p2, 50, 400) == p2);
+    CHECK(frameAlloc.Stats().LiveBytes == 500);
+    CHECK(frameAlloc.Stats().NumLiveAllocs == 2);
+
+    // exhaust the region, this falls back to malloc
+    void* p3 = frameAlloc.Alloc(2000);
+    CHECK(frameAlloc.Owns(p3));
+    CHECK(frameAlloc.NumOverflowAllocs() == 1);
+    Memory::Fill(p3, 2000, 0xAB);
+
+    // the next reset grows the region to fit the whole frame
+    frameAlloc.Reset();
+    CHECK(frameAlloc.FrameCount() == 1);
+    CHECK(frameAlloc.Capacity() >= 2512);
+    CHECK(frameAlloc.Stats().LiveBytes == 0);
+    CHECK(frameAlloc.Stats().NumLiveAllocs == 0);
+    CHECK(!frameAlloc.Owns(p0));
+
+    // a steady-state frame doesn't overflow
+    for (int frame = 0; frame < 4; frame++) {
+        frameAlloc.Alloc(512);
+        frameAlloc.Alloc(2000);
+        frameAlloc.Reset();
+    }
+    CHECK(frameAlloc.NumOverflowAllocs() == 1);
+    CHECK(frameAlloc.Stats().HighWaterMark == 2512);
+}
+
+//------------------------------------------------------------------------------
+TEST(FrameAllocatorOverflowResetTest) {
+    // with ORYOL_ALLOCATOR_DEBUG on POSIX, the reset before the overflow
+    // creates a protected region of the old capacity, which must be
+    // released with its own size when the region grows
+    FrameAllocator frameAlloc("TestFrame", 4096);
+    frameAlloc.Alloc(100);
+    frameAlloc.Reset();
+    void* p0 = frameAlloc.Alloc(3000);
+    void* p1 = frameAlloc.Alloc(3000);
+    CHECK(frameAlloc.NumOverflowAllocs() == 1);
+    Memory::Fill(p0, 3000, 0xAB);
+    Memory::Fill(p1, 3000, 0xCD);
+    frameAlloc.Reset();
+    CHECK(frameAlloc.Capacity() >= 6000);
+
+    // the grown region is usable, and survives more resets
+    for (int frame = 0; frame < 4; frame++) {
+        void* p = frameAlloc.Alloc(6000);
+        CHECK(frameAlloc.Owns(p));
+        Memory::Fill(p, 6000, uint8_t(frame));
+        frameAlloc.Reset();
+    }
+    CHECK(frameAlloc.NumOverflowAllocs() == 1);
+}
+
+//------------------------------------------------------------------------------
+TEST(FrameMemoryTest) {
+    static FrameAllocator frameAlloc("TestFrame", 4096);
+    CHECK(nullptr == FrameAllocator::ThreadLocal());
+    FrameAllocator::SetThreadLocal(&frameAlloc);
+    {
+        // Array and Buffer in frame memory
+        Array<int> array;
+        array.SetMemoryTag(MemoryTag::Frame);
+        CHECK(array.GetMemoryTag() == MemoryTag::Frame);
+        for (int i = 0; i < 100; i++) {
+            array.Add(i);
+        }
+        CHECK(Memory::TagOf(array.begin()) == MemoryTag::Frame);
+        CHECK(frameAlloc.Owns(array.begin()));
+        Buffer buffer;
+        buffer.SetMemoryTag(MemoryTag::Frame);
+        buffer.Add(256);
+        buffer.Add(256);
+        CHECK(frameAlloc.Owns(buffer.Data()));
+
+        // moving keeps the memory tag, copying doesn't
+        Array<int> moved(std::move(array));
+        CHECK(moved.GetMemoryTag() == MemoryTag::Frame);
+        Array<int> copied(moved);
+        CHECK(copied.GetMemoryTag() == MemoryTag::InvalidMemoryTag);
+        CHECK(!frameAlloc.Owns(copied.begin()));
+        CHECK(copied[99] == 99);
+    }
+    CHECK(frameAlloc.Stats().NumLiveAllocs == 0);
+    frameAlloc.Reset();
+    FrameAllocator::SetThreadLocal(nullptr);
+
+    // without thread-local frame allocator, frame memory comes from malloc
+    void* p = Memory::Alloc(32, MemoryTag::Frame);
+    CHECK(Memory::TagOf(p) == MemoryTag::Frame);
+    Memory::Free(p);
+}
@@ -394,3 +394,30 @@ TEST(ArrayTest) {
     CHECK(array8.GetMaxGrow() == 0);
 }
 
+
+//------------------------------------------------------------------------------
+struct alignas(64) cacheLineItem {
+    int value;
+};
+
+TEST(ArrayAlignmentTest) {
+    // alignof(TYPE) is honored
+    Array<cacheLineItem> items;
+    for (int i = 0; i < 100; i++) {
+        items.Add(cacheLineItem{i});
+        CHECK((intptr_t(&items.Front()) & 63) == 0);
+    }
+    CHECK(items[99].value == 99);
+    Array<cacheLineItem> copy(items);
+    CHECK((intptr_t(&copy.Front()) & 63) == 0);
+
+    // explicit alignment
+    Array<float, 32> floats;
+    for (int i = 0; i < 100; i++) {
+        floats.Add(float(i));
+        CHECK((intptr_t(floats.begin()) & 31) == 0);
+    }
+    floats.Trim();
+    CHECK((intptr_t(floats.begin()) & 31) == 0);
+    CHECK(floats[99] == 99.0f);
+}
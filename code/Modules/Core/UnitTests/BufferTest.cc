@@ -8,6 +8,19 @@
 
 using namespace Oryol;
 
+namespace {
+class wrapOwner : public RefCounted {
+    OryolClassDecl(wrapOwner);
+public:
+    wrapOwner(bool* destroyedFlag) : destroyed(destroyedFlag) { };
+    ~wrapOwner() {
+        *this->destroyed = true;
+    };
+    bool* destroyed;
+    uint8_t bytes[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+};
+} // anonymous namespace
+
 TEST(BufferTest) {
 
     Buffer buf0;
@@ -111,3 +124,74 @@ TEST(BufferTest) {
     CHECK(6 == buf4.Remove(0, 6));
     CHECK(std::strcmp((const char*)buf4.Data(), "wonderful world!") == 0);
 }
+
+//------------------------------------------------------------------------------
+TEST(BufferAlignmentTest) {
+    Buffer buf;
+    CHECK(buf.GetAlignment() == ORYOL_MAX_PLATFORM_ALIGN);
+    buf.SetAlignment(128);
+    CHECK(buf.GetAlignment() == 128);
+    for (int i = 0; i < 16; i++) {
+        uint8_t* ptr = buf.Add(100);
+        ptr[0] = uint8_t(i);
+        CHECK((intptr_t(buf.Data()) & 127) == 0);
+    }
+    CHECK(buf.Data()[1500] == 15);
+    Buffer moved(std::move(buf));
+    CHECK(moved.GetAlignment() == 128);
+}
+
+//------------------------------------------------------------------------------
+TEST(BufferWrapTest) {
+    bool destroyed = false;
+    {
+        Ptr<wrapOwner> owner = wrapOwner::Create(&destroyed);
+        Buffer buf;
+        buf.Wrap(owner, owner->bytes, 8);
+        CHECK(buf.IsWrapped());
+        CHECK(buf.Size() == 8);
+        CHECK(buf.Capacity() == 8);
+        CHECK(buf.Spare() == 0);
+        CHECK(buf.Data() == owner->bytes);
+        CHECK(owner->GetRefCount() == 2);
+
+        // moving keeps the memory wrapped
+        Buffer moved(std::move(buf));
+        CHECK(!buf.IsWrapped());
+        CHECK(moved.IsWrapped());
+        CHECK(owner->GetRefCount() == 2);
+        owner = nullptr;
+        CHECK(!destroyed);
+
+        // adding data copies the content and releases the owner
+        moved.Add((const uint8_t*)"\x09", 1);
+        CHECK(destroyed);
+        CHECK(!moved.IsWrapped());
+        CHECK(moved.Size() == 9);
+        CHECK(moved.Data()[0] == 1);
+        CHECK(moved.Data()[7] == 8);
+        CHECK(moved.Data()[8] == 9);
+    }
+
+    // Clear() and the destructor release the owner
+    destroyed = false;
+    Buffer buf;
+    {
+        Ptr<wrapOwner> owner = wrapOwner::Create(&destroyed);
+        buf.Wrap(owner, owner->bytes, 4);
+    }
+    CHECK(!destroyed);
+    CHECK(buf.Remove(0, 1) == 1);
+    CHECK(buf.Data()[0] == 2);
+    buf.Clear();
+    CHECK(destroyed);
+    CHECK(buf.Empty());
+    CHECK(!buf.IsWrapped());
+    destroyed = false;
+    {
+        Ptr<wrapOwner> owner = wrapOwner::Create(&destroyed);
+        Buffer buf2;
+        buf2.Wrap(owner, owner->bytes, 8);
+    }
+    CHECK(destroyed);
+}
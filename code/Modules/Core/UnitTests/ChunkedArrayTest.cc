@@ -0,0 +1,138 @@
+//------------------------------------------------------------------------------
+//  ChunkedArrayTest.cc
+//  Test ChunkedArray class, and compare sequential and parallel
+//  per-chunk processing.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Containers/ChunkedArray.h"
+#include "Core/String/String.h"
+#include "Core/Log.h"
+#include <chrono>
+#include <cmath>
+
+using namespace Oryol;
+
+//------------------------------------------------------------------------------
+TEST(ChunkedArrayTest) {
+
+    ChunkedArray<int, 4> array;
+    CHECK(array.Size() == 0);
+    CHECK(array.Empty());
+    CHECK(array.Capacity() == 0);
+    CHECK(array.NumChunks() == 0);
+    CHECK(ChunkedArray<int>::ChunkSize == 64);
+
+    // element addresses must stay stable while the array grows
+    int* ptrs[10];
+    for (int i = 0; i < 10; i++) {
+        ptrs[i] = &array.Add(i);
+    }
+    CHECK(array.Size() == 10);
+    CHECK(array.Capacity() == 12);
+    CHECK(array.NumChunks() == 3);
+    for (int i = 0; i < 10; i++) {
+        CHECK(array[i] == i);
+        CHECK(&array[i] == ptrs[i]);
+    }
+    CHECK(array.Front() == 0);
+    CHECK(array.Back() == 9);
+    CHECK(array.Chunk(0).Size() == 4);
+    CHECK(array.Chunk(2).Size() == 2);
+    CHECK(array.Chunk(1)[3] == 7);
+    CHECK(&array.Chunk(1)[0] == ptrs[4]);
+
+    // iteration
+    int sum = 0;
+    for (int val : array) {
+        sum += val;
+    }
+    CHECK(sum == 45);
+    int numChunks = 0;
+    array.ForEachChunk([&numChunks](Slice<int> chunk, int chunkIndex) {
+        CHECK(chunk[0] == chunkIndex * 4);
+        numChunks++;
+    });
+    CHECK(numChunks == 3);
+
+    // pop back
+    CHECK(array.PopBack() == 9);
+    CHECK(array.PopBack() == 8);
+    CHECK(array.Size() == 8);
+    CHECK(array.NumChunks() == 2);
+    CHECK(array.Capacity() == 12);
+    array.Add(10);
+    CHECK(&array.Back() == ptrs[8]);
+
+    // copy and move
+    ChunkedArray<int, 4> array1(array);
+    CHECK(array1.Size() == 9);
+    CHECK(array1[8] == 10);
+    CHECK(&array1[0] != &array[0]);
+    ChunkedArray<int, 4> array2(std::move(array1));
+    CHECK(array1.Empty());
+    CHECK(array2.Size() == 9);
+    array1 = array2;
+    CHECK(array1.Size() == 9);
+    array2 = std::move(array);
+    CHECK(array.Empty());
+    CHECK(&array2[0] == ptrs[0]);
+
+    // clear keeps the chunks
+    array2.Clear();
+    CHECK(array2.Empty());
+    CHECK(array2.Capacity() == 12);
+
+    // reserve
+    ChunkedArray<String, 8> strArray({ "Bla", "Blub" });
+    CHECK(strArray.Size() == 2);
+    strArray.Reserve(20);
+    CHECK(strArray.Capacity() == 24);
+    strArray.Add("Blob");
+    CHECK(strArray[2] == "Blob");
+    const String str = strArray.PopBack();
+    CHECK(str == "Blob");
+}
+
+//------------------------------------------------------------------------------
+TEST(ChunkedArrayParallelTest) {
+
+    struct particle {
+        float pos[3];
+        float vel[3];
+    };
+    const int numParticles = 1000000;
+    ChunkedArray<particle, 4096> particles;
+    particles.Reserve(numParticles);
+    for (int i = 0; i < numParticles; i++) {
+        particles.Add(particle{ { 0.0f, 0.0f, 0.0f }, { 1.0f, float(i & 7), 0.5f } });
+    }
+    auto update = [](Slice<particle> chunk, int /*chunkIndex*/) {
+        for (particle& p : chunk) {
+            for (int i = 0; i < 3; i++) {
+                p.pos[i] += p.vel[i] * 0.1f;
+                p.vel[i] = std::sqrt(p.vel[i] * p.vel[i] + 1.0f);
+            }
+        }
+    };
+
+    // NOTE: this is not a hard performance test, the numbers are only logged
+    typedef std::chrono::high_resolution_clock clock;
+    auto start = clock::now();
+    particles.ForEachChunk(update);
+    const double seqTime = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    JobSystem::Setup();
+    start = clock::now();
+    particles.ParallelForEachChunk(update);
+    const double parTime = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    JobSystem::Discard();
+
+    // every particle must have been updated exactly twice
+    bool allUpdated = true;
+    for (int i = 0; i < numParticles; i++) {
+        allUpdated &= std::fabs(particles[i].pos[0] - (0.1f + std::sqrt(2.0f) * 0.1f)) < 0.0001f;
+    }
+    CHECK(allUpdated);
+    Log::Info("ChunkedArrayParallelTest: %d particles in %d chunks: ForEachChunk %.2fms, ParallelForEachChunk %.2fms\n",
+        numParticles, particles.NumChunks(), seqTime, parTime);
+}
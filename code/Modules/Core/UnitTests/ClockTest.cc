@@ -1,16 +1,22 @@
 //------------------------------------------------------------------------------
 //  ClockTest.cc
+//  Test the Clock, and log the overhead of the different time sources.
 //------------------------------------------------------------------------------
 #include "Pre.h"
 #include "UnitTest++/src/UnitTest++.h"
 #include "Core/Time/Clock.h"
+#include "Core/Time/ScopedTimer.h"
+#include "Core/Counters.h"
 #include "Core/Log.h"
+#include <chrono>
 #include <cmath>
+#include <thread>
 
 using namespace Oryol;
 
 TEST(ClockTest) {
     TimePoint t0 = Clock::Now();
+    const int64_t ns0 = Clock::NowNanoSeconds();
     double a = 0.0, b = 0.0;
     for (int i = 0; i < 1000000; i++) {
         a += std::sin(b) + std::cos(b);
@@ -20,7 +26,86 @@ TEST(ClockTest) {
     Duration d0 = Clock::Since(t0);
     TimePoint t1 = Clock::Now();
     CHECK(t1 > t0);
+    const int64_t ns1 = Clock::NowNanoSeconds();
+    CHECK(ns1 > ns0);
+    CHECK(std::fabs(double(ns1 - ns0) * 0.001 - d0.AsMicroSeconds()) < 10000.0);
     Log::Info("duration (sec): %f\n", d0.AsSeconds());
     Log::Info("duration (ms): %f\n", d0.AsMilliSeconds());
     Log::Info("duration (us): %f\n", d0.AsMicroSeconds());
-}
\ No newline at end of file
+}
+//------------------------------------------------------------------------------
+TEST(ClockTicksTest) {
+    CHECK(Clock::TicksPerSecond() > 0.0);
+    const int64_t ticks0 = Clock::Ticks();
+    const int64_t ns0 = Clock::NowNanoSeconds();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    const int64_t ticks1 = Clock::Ticks();
+    const int64_t ns1 = Clock::NowNanoSeconds();
+    CHECK(ticks1 > ticks0);
+    const int64_t tickNs = Clock::TicksToNanoSeconds(ticks1 - ticks0);
+    CHECK(std::abs(double(tickNs - (ns1 - ns0))) < 0.05 * double(ns1 - ns0));
+
+    // ScopedTimer accumulates into a counter
+    const Counters::Id id = Counters::Register("ClockTest_ScopedTimer");
+    Counters::Set(id, 0);
+    for (int i = 0; i < 2; i++) {
+        ScopedTimer timer(id);
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    CHECK(Counters::Get(id) >= 9000000);
+    CHECK(Counters::Get(id) < 1000000000);
+    Log::Info("ClockTicksTest: %.3f ticks per nanosecond\n", Clock::TicksPerSecond() / 1000000000.0);
+}
+
+//------------------------------------------------------------------------------
+TEST(ClockOverheadBenchmark) {
+    // NOTE: this is not a hard performance test, the numbers are only logged
+    typedef std::chrono::high_resolution_clock clock;
+    const int num = 1000000;
+    // unsigned, the sum only needs to keep the calls alive and may wrap around
+    uint64_t sum = 0;
+
+    auto start = clock::now();
+    for (int i = 0; i < num; i++) {
+        sum += uint64_t(Clock::Now().getRaw());
+    }
+    const double nowNs = std::chrono::duration<double, std::nano>(clock::now() - start).count() / num;
+
+    start = clock::now();
+    for (int i = 0; i < num; i++) {
+        sum += uint64_t(Clock::NowNanoSeconds());
+    }
+    const double nowNanoNs = std::chrono::duration<double, std::nano>(clock::now() - start).count() / num;
+
+    start = clock::now();
+    for (int i = 0; i < num; i++) {
+        sum += uint64_t(Clock::Ticks());
+    }
+    const double ticksNs = std::chrono::duration<double, std::nano>(clock::now() - start).count() / num;
+
+    const Counters::Id id = Counters::Register("ClockTest_Overhead");
+    start = clock::now();
+    for (int i = 0; i < num; i++) {
+        ScopedTimer timer(id);
+    }
+    const double timerNs = std::chrono::duration<double, std::nano>(clock::now() - start).count() / num;
+    CHECK(sum != 0);
+
+    Log::Info("ClockOverheadBenchmark: Now(): %.1fns, NowNanoSeconds(): %.1fns, Ticks(): %.1fns, ScopedTimer: %.1fns\n",
+        nowNs, nowNanoNs, ticksNs, timerNs);
+}
+
+//------------------------------------------------------------------------------
+TEST(ClockSimulatedTimeTest) {
+    CHECK(!Clock::IsSimulated());
+    Clock::SetSimulatedTimeStep(Duration::FromMilliSeconds(10.0));
+    CHECK(Clock::IsSimulated());
+    const TimePoint t0 = Clock::Now();
+    CHECK(Clock::Now() == t0);
+    Clock::AdvanceSimulatedTime();
+    CHECK((Clock::Now() - t0).AsMilliSeconds() == 10.0);
+    Clock::AdvanceSimulatedTime();
+    CHECK((Clock::Now() - t0).AsMilliSeconds() == 20.0);
+    Clock::SetSimulatedTimeStep(Duration());
+    CHECK(!Clock::IsSimulated());
+}
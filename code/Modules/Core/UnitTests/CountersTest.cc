@@ -0,0 +1,87 @@
+//------------------------------------------------------------------------------
+//  CountersTest.cc
+//  Test the Counters registry and the counter trace macros.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Counters.h"
+#include "Core/Trace.h"
+#include "Core/TraceRecorder.h"
+#include <cstring>
+#if ORYOL_HAS_THREADS
+#include <thread>
+#endif
+
+using namespace Oryol;
+
+//------------------------------------------------------------------------------
+TEST(CountersTest) {
+    const int num0 = Counters::NumCounters();
+    CHECK(Counters::InvalidId == Counters::Find("CountersTest_A"));
+
+    const Counters::Id a = Counters::Register("CountersTest_A");
+    const Counters::Id b = Counters::Register("CountersTest_B");
+    CHECK(a != Counters::InvalidId);
+    CHECK(b != a);
+    CHECK(Counters::NumCounters() == num0 + 2);
+    CHECK(0 == std::strcmp(Counters::Name(a), "CountersTest_A"));
+
+    // registering the same name again returns the same counter,
+    // names are compared by content, not by pointer
+    char name[] = "CountersTest_A";
+    CHECK(Counters::Register(name) == a);
+    CHECK(Counters::Find(name) == a);
+    CHECK(Counters::NumCounters() == num0 + 2);
+
+    CHECK(Counters::Get(a) == 0);
+    Counters::Add(a, 10);
+    Counters::Add(a, -3);
+    CHECK(Counters::Get(a) == 7);
+    Counters::Set(b, 1234567890123);
+    CHECK(Counters::Get(b) == 1234567890123);
+    Counters::ResetAll();
+    CHECK(Counters::Get(a) == 0);
+    CHECK(Counters::Get(b) == 0);
+
+    #if ORYOL_HAS_THREADS
+    // concurrent adds from several threads
+    const int numThreads = 4;
+    const int numAdds = 10000;
+    std::thread threads[numThreads];
+    for (auto& thread : threads) {
+        thread = std::thread([a]() {
+            for (int i = 0; i < numAdds; i++) {
+                Counters::Add(a, 1);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    CHECK(Counters::Get(a) == numThreads * numAdds);
+    #endif
+
+    // counter updates are also recorded as trace events
+    TraceRecorder::Clear();
+    TraceRecorder::Start();
+    Counters::Set(b, 5);
+    Counters::Add(b, 1);
+    TraceRecorder::Stop();
+    CHECK(TraceRecorder::NumEvents() == 2);
+    TraceRecorder::Clear();
+
+    // the macros register the counter on first use
+    #if ORYOL_PROFILING
+    for (int i = 0; i < 3; i++) {
+        o_trace_counter_add(CountersTest_Macro, 2);
+    }
+    const Counters::Id m = Counters::Find("CountersTest_Macro");
+    CHECK(m != Counters::InvalidId);
+    CHECK(Counters::Get(m) == 6);
+    o_trace_counter(CountersTest_Macro, 42);
+    CHECK(Counters::Get(m) == 42);
+    #else
+    o_trace_counter_add(CountersTest_Macro, 2);
+    CHECK(Counters::InvalidId == Counters::Find("CountersTest_Macro"));
+    #endif
+}
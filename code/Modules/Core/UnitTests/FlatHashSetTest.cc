@@ -0,0 +1,213 @@
+//------------------------------------------------------------------------------
+//  FlatHashSetTest.cc
+//  Test FlatHashSet functionality, and measure lookup latency over
+//  the number of elements.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Containers/FlatHashSet.h"
+#include "Core/Containers/HashSet.h"
+#include "Core/Log.h"
+#include <chrono>
+
+using namespace Oryol;
+
+namespace {
+
+struct intHasher {
+    int32_t operator()(int val) const {
+        return val;
+    }
+};
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+TEST(FlatHashSetTest) {
+
+    FlatHashSet<int, intHasher> set;
+    CHECK(set.Size() == 0);
+    CHECK(set.Empty());
+    CHECK(set.Capacity() == 0);
+    CHECK(set.GetMaxLoadFactor() == 0.875f);
+    CHECK(!set.Contains(1));
+    CHECK(set.Find(1) == nullptr);
+    for (int i = 0; i < 1000; i++) {
+        set.Add(i * 3);
+    }
+    CHECK(set.Size() == 1000);
+    CHECK(set.Capacity() >= 1000);
+    for (int i = 0; i < 3000; i++) {
+        CHECK(set.Contains(i) == ((i % 3) == 0));
+    }
+    CHECK(*set.Find(300) == 300);
+    CHECK(set.ValueAtIndex(10) == 30);
+    CHECK(!set.AddUnique(3));
+    CHECK(set.AddUnique(1));
+    CHECK(set.Size() == 1001);
+
+    // copy and move
+    FlatHashSet<int, intHasher> set1(set);
+    CHECK(set1.Size() == 1001);
+    CHECK(set1.Contains(1));
+    FlatHashSet<int, intHasher> set2(std::move(set1));
+    CHECK(set1.Empty());
+    CHECK(!set1.Contains(1));
+    CHECK(set2.Contains(2997));
+    set1 = set2;
+    CHECK(set1.Size() == 1001);
+    set2.Clear();
+    CHECK(set2.Empty());
+    CHECK(!set2.Contains(3));
+    CHECK(set1.Contains(3));
+
+    // erase
+    for (int i = 0; i < 3000; i += 6) {
+        set.Erase(i);
+    }
+    set.Erase(-1);
+    CHECK(set.Size() == 501);
+    for (int i = 0; i < 3000; i++) {
+        const bool expected = (1 == i) || (((i % 3) == 0) && ((i % 6) != 0));
+        CHECK(set.Contains(i) == expected);
+    }
+    int num = 0;
+    for (int val : set) {
+        CHECK(set.Contains(val));
+        num++;
+    }
+    CHECK(num == 501);
+
+    // initializer list
+    FlatHashSet<int, intHasher> set3({ 5, 6, 7 });
+    CHECK(set3.Size() == 3);
+    CHECK(set3.Contains(6));
+}
+
+//------------------------------------------------------------------------------
+TEST(FlatHashSetLoadFactorTest) {
+
+    FlatHashSet<int, intHasher> set;
+    set.Reserve(100);
+    CHECK(set.Capacity() >= 100);
+    const int capacity = set.Capacity();
+    for (int i = 0; i < 100; i++) {
+        set.Add(i);
+    }
+    CHECK(set.Capacity() == capacity);
+
+    // lowering the load factor rehashes
+    set.SetMaxLoadFactor(0.5f);
+    CHECK(set.GetMaxLoadFactor() == 0.5f);
+    CHECK(set.Capacity() >= 100);
+    CHECK(set.Capacity() > capacity);
+    for (int i = 0; i < 100; i++) {
+        CHECK(set.Contains(i));
+    }
+    for (int i = 100; i < 10000; i++) {
+        set.Add(i);
+        CHECK(set.Size() <= set.Capacity());
+    }
+    for (int i = 0; i < 10000; i++) {
+        CHECK(set.Contains(i));
+    }
+}
+
+//------------------------------------------------------------------------------
+TEST(FlatHashSetBulkTest) {
+
+    FlatHashSet<int, intHasher> set;
+    set.Add(-1);
+    set.BeginBulk();
+    for (int i = 0; i < 10000; i++) {
+        set.AddBulk(i);
+    }
+    set.EndBulk();
+    CHECK(set.Size() == 10001);
+    CHECK(set.Capacity() >= 10001);
+    for (int i = -1; i < 10000; i++) {
+        CHECK(set.Contains(i));
+    }
+    CHECK(!set.Contains(10000));
+    set.Add(10000);
+    CHECK(set.Contains(10000));
+
+    // duplicates of existing and of other bulk-added values are dropped
+    set.BeginBulk();
+    set.AddBulk(20000);
+    set.AddBulk(5);
+    set.AddBulk(20001);
+    set.AddBulk(20000);
+    set.AddBulk(-1);
+    set.EndBulk();
+    CHECK(set.Size() == 10004);
+    int num20000 = 0;
+    for (int val : set) {
+        if (20000 == val) {
+            num20000++;
+        }
+    }
+    CHECK(num20000 == 1);
+    CHECK(set.Contains(20000));
+    CHECK(set.Contains(20001));
+    for (int i = 0; i < set.Size(); i++) {
+        CHECK(set.FindIndex(set.ValueAtIndex(i)) == i);
+    }
+    set.Erase(5);
+    CHECK(!set.Contains(5));
+    CHECK(set.Size() == 10003);
+}
+
+//------------------------------------------------------------------------------
+TEST(FlatHashSetStressBenchmark) {
+
+    // NOTE: this is not a hard performance test, the lookup latency
+    // at different element counts is only logged for comparison
+    typedef std::chrono::high_resolution_clock clock;
+    const int numLookups = 1000000;
+    const int sizes[] = { 1000, 10000, 100000, 1000000 };
+    for (int size : sizes) {
+        FlatHashSet<int, intHasher> flatSet;
+        auto start = clock::now();
+        flatSet.BeginBulk();
+        for (int i = 0; i < size; i++) {
+            flatSet.AddBulk(i * 7);
+        }
+        flatSet.EndBulk();
+        const double flatInsert = std::chrono::duration<double, std::micro>(clock::now() - start).count();
+        start = clock::now();
+        int found = 0;
+        uint32_t r = 0x12345678;
+        for (int i = 0; i < numLookups; i++) {
+            // half hits, half misses, random order
+            r ^= r << 13; r ^= r >> 17; r ^= r << 5;
+            found += flatSet.Contains(int(r % uint32_t(size * 2)) * 7) ? 1 : 0;
+        }
+        const double flatLookup = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+
+        // the fixed-bucket HashSet degrades with growing element count,
+        // only measure it up to 100k elements (insertion is O(N^2/NUMBUCKETS))
+        double bucketLookup = 0.0;
+        if (size <= 100000) {
+            HashSet<int, intHasher, 1024> bucketSet;
+            for (int i = 0; i < size; i++) {
+                bucketSet.Add(i * 7);
+            }
+            start = clock::now();
+            int bucketFound = 0;
+            r = 0x12345678;
+            for (int i = 0; i < numLookups; i++) {
+                r ^= r << 13; r ^= r >> 17; r ^= r << 5;
+                bucketFound += bucketSet.Contains(int(r % uint32_t(size * 2)) * 7) ? 1 : 0;
+            }
+            bucketLookup = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+            CHECK(bucketFound == found);
+        }
+        Log::Info("FlatHashSetStressBenchmark: %7d elements: bulk insert %9.1fus, FlatHashSet %6.1fns/lookup",
+            size, flatInsert, flatLookup / numLookups);
+        if (size <= 100000) {
+            Log::Info(", HashSet<1024> %6.1fns/lookup", bucketLookup / numLookups);
+        }
+        Log::Info("\n");
+    }
+}
@@ -0,0 +1,134 @@
+//------------------------------------------------------------------------------
+//  FrameStatsTest.cc
+//  Test frame statistics, spike detection, pacing and CSV export.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Time/FrameStats.h"
+#include "Core/Time/Clock.h"
+#include "Core/Log.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+using namespace Oryol;
+
+//------------------------------------------------------------------------------
+TEST(FrameStatsTest) {
+    FrameStats::Reset();
+    FrameStats::SetSpikeFactor(0.0f);
+    CHECK(FrameStats::NumFrames() == 0);
+    CHECK(FrameStats::Query(FrameStats::FramePhase).NumFrames == 0);
+    CHECK(0 == std::strcmp(FrameStats::PhaseName(FrameStats::FramePhase), "Frame"));
+    CHECK(0 == std::strcmp(FrameStats::PhaseName(FrameStats::PacerPhase), "Pacer"));
+
+    const FrameStats::PhaseId phase = FrameStats::RegisterPhase("FrameStatsTest");
+    CHECK(FrameStats::InvalidPhaseId != phase);
+    CHECK(FrameStats::RegisterPhase("FrameStatsTest") == phase);
+    CHECK(FrameStats::FindPhase("FrameStatsTest") == phase);
+    CHECK(FrameStats::FindPhase("Bla") == FrameStats::InvalidPhaseId);
+
+    // 100 frames where the test phase takes 1..100ms
+    for (int i = 1; i <= 100; i++) {
+        FrameStats::BeginFrame();
+        FrameStats::AddPhaseTime(phase, int64_t(i) * 1000000);
+        FrameStats::AddPhaseTime(phase, 0);
+        FrameStats::EndFrame();
+    }
+    CHECK(FrameStats::FrameCount() == 100);
+    CHECK(FrameStats::NumFrames() == 100);
+    CHECK(FrameStats::PhaseTime(phase, 0).AsTicks() == 100000);
+    CHECK(FrameStats::PhaseTime(phase, 99).AsTicks() == 1000);
+    FrameStats::Summary s = FrameStats::Query(phase);
+    CHECK(s.NumFrames == 100);
+    CHECK(s.Min.AsTicks() == 1000);
+    CHECK(s.Max.AsTicks() == 100000);
+    CHECK(s.Avg.AsTicks() == 50500);
+    CHECK(s.P50.AsTicks() == 50000);
+    CHECK(s.P95.AsTicks() == 95000);
+    CHECK(s.P99.AsTicks() == 99000);
+    s = FrameStats::Query(phase, 10);
+    CHECK(s.NumFrames == 10);
+    CHECK(s.Min.AsTicks() == 91000);
+    CHECK(s.P50.AsTicks() == 95000);
+
+    // the ring buffer only keeps the last MaxFrames frames
+    for (int i = 0; i < FrameStats::MaxFrames; i++) {
+        FrameStats::BeginFrame();
+        FrameStats::EndFrame();
+    }
+    CHECK(FrameStats::NumFrames() == FrameStats::MaxFrames);
+    CHECK(FrameStats::Query(phase).Max.AsTicks() == 0);
+
+    // begin/end phase
+    FrameStats::BeginFrame();
+    FrameStats::BeginPhase(phase);
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    FrameStats::EndPhase(phase);
+    FrameStats::EndFrame();
+    CHECK(FrameStats::PhaseTime(phase).AsMilliSeconds() >= 1.9);
+    CHECK(FrameStats::PhaseTime(FrameStats::FramePhase) >= FrameStats::PhaseTime(phase));
+
+    // CSV export
+    const char* path = "oryol_framestats_test.csv";
+    CHECK(FrameStats::WriteCSV(path));
+    FILE* fp = std::fopen(path, "r");
+    CHECK(nullptr != fp);
+    if (fp) {
+        char line[256];
+        CHECK(nullptr != std::fgets(line, sizeof(line), fp));
+        CHECK(0 == std::strncmp(line, "frame,Frame,Pacer,", 18));
+        CHECK(nullptr != std::strstr(line, ",FrameStatsTest"));
+        CHECK(nullptr != std::strstr(line, ",spike\n"));
+        int numLines = 0;
+        while (std::fgets(line, sizeof(line), fp)) {
+            numLines++;
+        }
+        CHECK(numLines == FrameStats::MaxFrames);
+        std::fclose(fp);
+    }
+    std::remove(path);
+}
+
+//------------------------------------------------------------------------------
+TEST(FrameStatsSpikeTest) {
+    FrameStats::Reset();
+    FrameStats::SetSpikeFactor(2.0f);
+    for (int i = 0; i < FrameStats::MinSpikeFrames; i++) {
+        FrameStats::BeginFrame();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        FrameStats::EndFrame();
+    }
+    CHECK(FrameStats::NumSpikes() == 0);
+    FrameStats::BeginFrame();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    FrameStats::EndFrame();
+    CHECK(FrameStats::NumSpikes() == 1);
+    CHECK(FrameStats::IsSpike(0));
+    CHECK(!FrameStats::IsSpike(1));
+}
+
+//------------------------------------------------------------------------------
+TEST(FrameStatsPacerTest) {
+    FrameStats::Reset();
+    FrameStats::SetSpikeFactor(0.0f);
+    FrameStats::SetTargetFrameRate(100);
+    CHECK(FrameStats::TargetFrameRate() == 100);
+    const int numFrames = 11;
+    const int64_t start = Clock::NowNanoSeconds();
+    for (int i = 0; i < numFrames; i++) {
+        FrameStats::BeginFrame();
+        FrameStats::EndFrame();
+    }
+    const double ms = double(Clock::NowNanoSeconds() - start) / 1000000.0;
+    FrameStats::SetTargetFrameRate(0);
+
+    // the first frame starts right away, the remaining frames are paced
+    CHECK(ms >= 99.0);
+    FrameStats::Summary pacer = FrameStats::Query(FrameStats::PacerPhase, numFrames - 1);
+    CHECK(pacer.Min.AsMilliSeconds() > 5.0);
+    Log::Info("FrameStatsPacerTest: %d frames at 100Hz: %.3fms (pacer avg=%.3fms max=%.3fms)\n",
+        numFrames, ms, pacer.Avg.AsMilliSeconds(), pacer.Max.AsMilliSeconds());
+    FrameStats::Reset();
+}
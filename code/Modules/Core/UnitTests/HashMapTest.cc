@@ -0,0 +1,295 @@
+//------------------------------------------------------------------------------
+//  HashMapTest.cc
+//  Test HashMap functionality, and compare lookup performance against
+//  the other associative containers.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Containers/HashMap.h"
+#include "Core/Containers/Map.h"
+#include "Core/Containers/ArrayMap.h"
+#include "Core/Containers/HashSet.h"
+#include "Core/String/String.h"
+#include "Core/Log.h"
+#include <chrono>
+
+using namespace Oryol;
+
+namespace {
+
+struct intHasher {
+    int32_t operator()(int val) const {
+        return val;
+    }
+};
+
+struct stringHasher {
+    int32_t operator()(const char* str) const {
+        uint32_t h = 0;
+        char c;
+        while (0 != (c = *str++)) {
+            h += c;
+            h += (h << 10);
+            h ^= (h >> 6);
+        }
+        h += (h << 3);
+        h ^= (h >> 11);
+        h += (h << 15);
+        return int32_t(h);
+    }
+    int32_t operator()(const String& str) const {
+        return (*this)(str.AsCStr());
+    }
+};
+
+// a small xorshift random number generator, so that the benchmark
+// is reproducible across platforms
+struct xorshift {
+    uint32_t state = 0x12345678;
+    uint32_t operator()() {
+        this->state ^= this->state << 13;
+        this->state ^= this->state >> 17;
+        this->state ^= this->state << 5;
+        return this->state;
+    }
+};
+
+double usecSince(const std::chrono::high_resolution_clock::time_point& start) {
+    return std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+TEST(HashMapTest) {
+
+    HashMap<int, int, intHasher> map;
+    CHECK(map.Size() == 0);
+    CHECK(map.Empty());
+    CHECK(map.Capacity() == 0);
+    CHECK(!map.Contains(1));
+    CHECK(map.FindIndex(1) == InvalidIndex);
+    CHECK(map.Find(1) == nullptr);
+    for (int i = 0; i < 1000; i++) {
+        map.Add(i, i * 2);
+    }
+    CHECK(map.Size() == 1000);
+    CHECK(!map.Empty());
+    CHECK(map.Capacity() >= 1000);
+    for (int i = 0; i < 1000; i++) {
+        CHECK(map.Contains(i));
+        CHECK(map[i] == i * 2);
+        CHECK(*map.Find(i) == i * 2);
+        // insertion order is preserved
+        CHECK(map.KeyAtIndex(i) == i);
+        CHECK(map.ValueAtIndex(i) == i * 2);
+    }
+    CHECK(!map.Contains(1000));
+    CHECK(!map.Contains(-1));
+    CHECK(!map.AddUnique(5, 5));
+    CHECK(map.AddUnique(1000, 2000));
+    CHECK(map[1000] == 2000);
+    map[1000] = 3;
+    CHECK(map[1000] == 3);
+
+    // copy and move
+    HashMap<int, int, intHasher> map1(map);
+    CHECK(map1.Size() == 1001);
+    CHECK(map1[500] == 1000);
+    HashMap<int, int, intHasher> map2(std::move(map1));
+    CHECK(map1.Size() == 0);
+    CHECK(!map1.Contains(500));
+    CHECK(map2.Size() == 1001);
+    CHECK(map2[500] == 1000);
+    map1 = map2;
+    CHECK(map1.Size() == 1001);
+    CHECK(map1[999] == 1998);
+    map1.Clear();
+    CHECK(map1.Empty());
+    CHECK(map1.Capacity() >= 1001);
+    CHECK(!map1.Contains(999));
+    map1.Add(999, 1);
+    CHECK(map1[999] == 1);
+
+    // erase every other element, the remaining elements must still be found
+    for (int i = 0; i < 1001; i += 2) {
+        map.Erase(i);
+    }
+    map.Erase(5000);
+    CHECK(map.Size() == 500);
+    for (int i = 0; i < 1001; i++) {
+        CHECK(map.Contains(i) == ((i & 1) != 0));
+        if (i & 1) {
+            CHECK(map[i] == i * 2);
+        }
+    }
+    int sum = 0;
+    for (const auto& kvp : map) {
+        CHECK(kvp.key & 1);
+        sum++;
+    }
+    CHECK(sum == 500);
+    while (!map.Empty()) {
+        map.EraseIndex(0);
+    }
+    CHECK(!map.Contains(1));
+    map.Add(1, 1);
+    CHECK(map[1] == 1);
+
+    // initializer list and Reserve
+    HashMap<int, int, intHasher> map3({ { 1, 2 }, { 3, 4 }, { 5, 6 } });
+    CHECK(map3.Size() == 3);
+    CHECK(map3[3] == 4);
+    map3.Reserve(100);
+    CHECK(map3.Capacity() >= 103);
+    CHECK(map3[5] == 6);
+}
+
+//------------------------------------------------------------------------------
+TEST(HashMapStringKeyTest) {
+
+    HashMap<String, int, stringHasher> map;
+    map.Add("One", 1);
+    map.Add("Two", 2);
+    map.Add("Three", 3);
+    CHECK(map.Size() == 3);
+
+    // lookup with String and with const char* (no temporary String created)
+    CHECK(map[String("Two")] == 2);
+    CHECK(map["Three"] == 3);
+    CHECK(map.Contains("One"));
+    CHECK(!map.Contains("Four"));
+    CHECK(map.FindIndex("Three") == 2);
+    CHECK(*map.Find("One") == 1);
+    map.Erase("One");
+    CHECK(!map.Contains("One"));
+    CHECK(map["Three"] == 3);
+    CHECK(map.KeyAtIndex(0) == "Three");
+}
+
+//------------------------------------------------------------------------------
+TEST(HashMapCollisionTest) {
+
+    // a degenerate hasher which puts everything into the same slot
+    struct badHasher {
+        int32_t operator()(int) const {
+            return 0;
+        }
+    };
+    HashMap<int, int, badHasher> map;
+    for (int i = 0; i < 100; i++) {
+        map.Add(i, i);
+    }
+    for (int i = 0; i < 100; i += 3) {
+        map.Erase(i);
+    }
+    for (int i = 0; i < 100; i++) {
+        CHECK(map.Contains(i) == ((i % 3) != 0));
+    }
+}
+
+//------------------------------------------------------------------------------
+TEST(HashMapBenchmark) {
+
+    // NOTE: these are not hard performance tests, only logged for comparison
+    typedef std::chrono::high_resolution_clock clock;
+    const int sizes[] = { 1000, 10000, 100000, 1000000 };
+    for (int size : sizes) {
+        // random keys, and a shuffled copy for lookups
+        Array<int> keys;
+        keys.Reserve(size);
+        xorshift rnd;
+        for (int i = 0; i < size; i++) {
+            keys.Add(int(rnd() & 0x7FFFFFFF));
+        }
+        Array<int> lookups(keys);
+        for (int i = size - 1; i > 0; i--) {
+            const int j = int(rnd() % uint32_t(i + 1));
+            int tmp = lookups[i];
+            lookups[i] = lookups[j];
+            lookups[j] = tmp;
+        }
+        const int numLookups = size < 100000 ? 100000 : size;
+
+        // HashMap
+        HashMap<int, int, intHasher> hashMap;
+        auto start = clock::now();
+        for (int i = 0; i < size; i++) {
+            hashMap.AddUnique(keys[i], i);
+        }
+        const double hashMapInsert = usecSince(start);
+        start = clock::now();
+        int found = 0;
+        for (int i = 0; i < numLookups; i++) {
+            found += hashMap.Contains(lookups[i % size]) ? 1 : 0;
+        }
+        const double hashMapLookup = usecSince(start);
+        CHECK(found == numLookups);
+
+        // Map (bulk insert, otherwise insertion is O(N^2))
+        Map<int, int> map;
+        start = clock::now();
+        map.BeginBulk();
+        for (int i = 0; i < size; i++) {
+            map.AddBulk(keys[i], i);
+        }
+        map.EndBulk();
+        const double mapInsert = usecSince(start);
+        start = clock::now();
+        found = 0;
+        for (int i = 0; i < numLookups; i++) {
+            found += map.Contains(lookups[i % size]) ? 1 : 0;
+        }
+        const double mapLookup = usecSince(start);
+        CHECK(found == numLookups);
+
+        // ArrayMap and HashSet only at small sizes, since they insert sorted
+        double arrayMapInsert = 0.0, arrayMapLookup = 0.0;
+        double hashSetInsert = 0.0, hashSetLookup = 0.0;
+        if (size <= 10000) {
+            ArrayMap<int, int> arrayMap;
+            start = clock::now();
+            for (int i = 0; i < size; i++) {
+                if (!arrayMap.Contains(keys[i])) {
+                    arrayMap.Add(keys[i], i);
+                }
+            }
+            arrayMapInsert = usecSince(start);
+            start = clock::now();
+            found = 0;
+            for (int i = 0; i < numLookups; i++) {
+                found += arrayMap.Contains(lookups[i % size]) ? 1 : 0;
+            }
+            arrayMapLookup = usecSince(start);
+            CHECK(found == numLookups);
+
+            HashSet<int, intHasher, 1024> hashSet;
+            start = clock::now();
+            for (int i = 0; i < size; i++) {
+                if (!hashSet.Contains(keys[i])) {
+                    hashSet.Add(keys[i]);
+                }
+            }
+            hashSetInsert = usecSince(start);
+            start = clock::now();
+            found = 0;
+            for (int i = 0; i < numLookups; i++) {
+                found += hashSet.Contains(lookups[i % size]) ? 1 : 0;
+            }
+            hashSetLookup = usecSince(start);
+            CHECK(found == numLookups);
+        }
+
+        Log::Info("HashMapBenchmark: %d elements, %d lookups\n", size, numLookups);
+        Log::Info("  HashMap:  insert %10.1fus, lookup %10.1fus (%.1fns/lookup)\n",
+            hashMapInsert, hashMapLookup, hashMapLookup * 1000.0 / numLookups);
+        Log::Info("  Map:      insert %10.1fus, lookup %10.1fus (%.1fns/lookup)\n",
+            mapInsert, mapLookup, mapLookup * 1000.0 / numLookups);
+        if (size <= 10000) {
+            Log::Info("  ArrayMap: insert %10.1fus, lookup %10.1fus (%.1fns/lookup)\n",
+                arrayMapInsert, arrayMapLookup, arrayMapLookup * 1000.0 / numLookups);
+            Log::Info("  HashSet:  insert %10.1fus, lookup %10.1fus (%.1fns/lookup)\n",
+                hashSetInsert, hashSetLookup, hashSetLookup * 1000.0 / numLookups);
+        }
+    }
+}
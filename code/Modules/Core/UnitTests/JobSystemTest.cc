@@ -0,0 +1,231 @@
+//------------------------------------------------------------------------------
+//  JobSystemTest.cc
+//  Test the JobSystem, and log ParallelFor timings for different
+//  numbers of worker threads.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Threading/JobSystem.h"
+#include "Core/Log.h"
+#include "Core/Core.h"
+#include "Core/Memory/FrameAllocator.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#if ORYOL_HAS_THREADS
+#include <thread>
+#endif
+
+using namespace Oryol;
+
+//------------------------------------------------------------------------------
+TEST(JobSystemTest) {
+
+    // without setup, jobs run inline
+    CHECK(!JobSystem::IsValid());
+    CHECK(JobSystem::NumWorkers() == 0);
+    {
+        JobGroup group;
+        int val = 0;
+        JobSystem::Run(group, [&val]() { val = 1; });
+        CHECK(val == 1);
+        CHECK(group.Done());
+        JobSystem::Wait(group);
+    }
+
+    JobSystem::Setup(3);
+    CHECK(JobSystem::IsValid());
+    #if ORYOL_HAS_THREADS
+    CHECK(JobSystem::NumWorkers() == 3);
+    #endif
+
+    // Run and Wait, more jobs than the job pool and deque sizes
+    {
+        const int numJobs = JobSystem::JobPoolSize * 2;
+        std::atomic<int> counter(0);
+        JobGroup group;
+        for (int i = 0; i < numJobs; i++) {
+            JobSystem::Run(group, [&counter]() {
+                counter.fetch_add(1, std::memory_order_relaxed);
+            });
+        }
+        JobSystem::Wait(group);
+        CHECK(group.Done());
+        CHECK(counter.load() == numJobs);
+    }
+
+    // jobs which spawn jobs
+    {
+        std::atomic<int> counter(0);
+        JobGroup outer;
+        JobGroup inner;
+        for (int i = 0; i < 16; i++) {
+            JobSystem::Run(outer, [&counter, &inner]() {
+                for (int j = 0; j < 16; j++) {
+                    JobSystem::Run(inner, [&counter]() {
+                        counter.fetch_add(1, std::memory_order_relaxed);
+                    });
+                }
+            });
+        }
+        JobSystem::Wait(outer);
+        JobSystem::Wait(inner);
+        CHECK(counter.load() == 256);
+    }
+
+    // RunAfter: the second stage must only start when the first is done
+    {
+        const int num = 256;
+        static int stage0[num] = { };
+        std::atomic<int> numErrors(0);
+        std::atomic<int> sum(0);
+        JobGroup group0;
+        JobGroup group1;
+        for (int i = 0; i < num; i++) {
+            JobSystem::Run(group0, [i]() {
+                stage0[i] = i + 1;
+            });
+        }
+        JobSystem::RunAfter(group0, group1, [&numErrors, &sum]() {
+            int s = 0;
+            for (int i = 0; i < num; i++) {
+                if (stage0[i] != (i + 1)) {
+                    numErrors++;
+                }
+                s += stage0[i];
+            }
+            sum = s;
+        });
+        JobSystem::Wait(group1);
+        CHECK(group0.Done());
+        CHECK(numErrors.load() == 0);
+        CHECK(sum.load() == (num * (num + 1)) / 2);
+
+        // RunAfter on a group which is already done runs right away
+        JobGroup group2;
+        bool ran = false;
+        JobSystem::RunAfter(group0, group2, [&ran]() { ran = true; });
+        JobSystem::Wait(group2);
+        CHECK(ran);
+    }
+
+    // ParallelFor must visit every index exactly once
+    {
+        const int num = 100003;
+        static std::atomic<int> visits[num];
+        for (int grain : { 0, 1, 7, 1000, num, num * 2 }) {
+            for (auto& v : visits) {
+                v.store(0, std::memory_order_relaxed);
+            }
+            JobSystem::ParallelFor(0, num, grain, [](int first, int last) {
+                for (int i = first; i < last; i++) {
+                    visits[i].fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+            bool allOnce = true;
+            for (const auto& v : visits) {
+                allOnce &= (1 == v.load(std::memory_order_relaxed));
+            }
+            CHECK(allOnce);
+        }
+        // empty range
+        bool called = false;
+        JobSystem::ParallelFor(10, 10, 0, [&called](int, int) { called = true; });
+        CHECK(!called);
+    }
+
+    #if ORYOL_HAS_THREADS
+    // jobs submitted from a thread which isn't part of the job system
+    {
+        std::atomic<int> counter(0);
+        std::thread thread([&counter]() {
+            JobGroup group;
+            for (int i = 0; i < 1000; i++) {
+                JobSystem::Run(group, [&counter]() {
+                    counter.fetch_add(1, std::memory_order_relaxed);
+                });
+            }
+            JobSystem::Wait(group);
+        });
+        thread.join();
+        CHECK(counter.load() == 1000);
+    }
+    #endif
+
+    JobSystem::Discard();
+    CHECK(!JobSystem::IsValid());
+}
+
+//------------------------------------------------------------------------------
+#if ORYOL_HAS_THREADS
+TEST(JobSystemFrameMemoryTest) {
+    // job workers don't run a PostRunLoop, their frame allocator
+    // must be reset after each job, otherwise frame memory piles up
+    CoreSetup coreSetup;
+    coreSetup.NumJobWorkers = 2;
+    coreSetup.FrameAllocatorCapacity = 64 * 1024;
+    Core::Setup(coreSetup);
+    std::atomic<int> numWorkerJobs(0);
+    std::atomic<int> numWithoutAllocator(0);
+    std::atomic<int> numOverflows(0);
+    JobGroup group;
+    for (int i = 0; i < 256; i++) {
+        JobSystem::Run(group, [&numWorkerJobs, &numWithoutAllocator, &numOverflows]() {
+            if (Core::IsMainThread()) {
+                return;
+            }
+            numWorkerJobs++;
+            FrameAllocator* frameAllocator = FrameAllocator::ThreadLocal();
+            if (nullptr == frameAllocator) {
+                numWithoutAllocator++;
+                return;
+            }
+            Memory::Alloc(16 * 1024, MemoryTag::Frame);
+            if (frameAllocator->NumOverflowAllocs() > 0) {
+                numOverflows++;
+            }
+        });
+    }
+    // don't run jobs on the main thread while waiting, let the workers steal them
+    while (!group.Done()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    JobSystem::Wait(group);
+    Log::Info("JobSystemFrameMemoryTest: %d of 256 jobs ran on workers\n", numWorkerJobs.load());
+    CHECK(numWithoutAllocator.load() == 0);
+    CHECK(numOverflows.load() == 0);
+    Core::Discard();
+}
+#endif
+
+//------------------------------------------------------------------------------
+TEST(JobSystemScalingTest) {
+
+    // NOTE: this is not a hard performance test, the numbers are only logged
+    const int num = 1 << 20;
+    static float values[num];
+    for (float& v : values) {
+        v = 1.0f;
+    }
+    auto work = [](int first, int last) {
+        for (int i = first; i < last; i++) {
+            float v = values[i];
+            for (int j = 0; j < 16; j++) {
+                v = std::sqrt(v * v + 1.0f);
+            }
+            values[i] = v;
+        }
+    };
+    typedef std::chrono::high_resolution_clock clock;
+    for (int numWorkers : { 0, 1, 2, 4 }) {
+        JobSystem::Setup(numWorkers);
+        auto start = clock::now();
+        JobSystem::ParallelFor(0, num, 0, work);
+        const double time = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+        JobSystem::Discard();
+        Log::Info("JobSystemScalingTest: %d workers: %.2fms\n", numWorkers, time);
+    }
+    // without enough cores, the numbers only show the job system overhead
+    Log::Info("JobSystemScalingTest: %d hardware threads\n", int(std::thread::hardware_concurrency()));
+    CHECK(values[0] > 1.0f);
+}
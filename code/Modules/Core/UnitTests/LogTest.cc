@@ -6,6 +6,11 @@
 #include "UnitTest++/src/UnitTest++.h"
 #include "Core/Log.h"
 #include "Core/Logger.h"
+#include "Core/Containers/Array.h"
+#include <chrono>
+#include <cstring>
+#include <cstdio>
+#include <thread>
 
 using namespace Oryol;
 
@@ -54,4 +59,188 @@ TEST(LogTest) {
     test_log();
 }
 
+//------------------------------------------------------------------------------
+// a logger which remembers the records it received
+class RecordLogger : public Logger {
+    OryolClassDecl(RecordLogger);
+public:
+    struct entry {
+        bool async = false;
+        Log::Level level = Log::Level::InvalidLevel;
+        uint64_t seq = 0;
+        int threadIndex = 0;
+        int msgThread = -1;
+        int msgIndex = -1;
+    };
+    Array<entry> entries;
+
+    virtual void VPrint(Log::Level l, const char* msg, va_list args) override {
+        char buf[256];
+        std::vsnprintf(buf, sizeof(buf), msg, args);
+        entry e;
+        e.level = l;
+        std::sscanf(buf, "msg %d %d", &e.msgThread, &e.msgIndex);
+        this->entries.Add(e);
+    };
+    virtual void PrintRecord(const Log::Record& rec) override {
+        entry e;
+        e.async = true;
+        e.level = rec.LogLevel;
+        e.seq = rec.SequenceNumber;
+        e.threadIndex = rec.ThreadIndex;
+        std::sscanf(rec.Message, "msg %d %d", &e.msgThread, &e.msgIndex);
+        this->entries.Add(e);
+    };
+};
+
+//------------------------------------------------------------------------------
+// a logger which only formats the messages into a buffer
+class BufferLogger : public Logger {
+    OryolClassDecl(BufferLogger);
+public:
+    char buf[256];
+    virtual void VPrint(Log::Level l, const char* msg, va_list args) override {
+        std::vsnprintf(this->buf, sizeof(this->buf), msg, args);
+    };
+    virtual void PrintRecord(const Log::Record& rec) override {
+        std::strncpy(this->buf, rec.Message, sizeof(this->buf) - 1);
+    };
+};
+
+//------------------------------------------------------------------------------
+// temporarily replace the installed loggers
+static Array<Ptr<Logger>> replaceLoggers(const Ptr<Logger>& logger) {
+    Array<Ptr<Logger>> prev;
+    while (Log::GetNumLoggers() > 0) {
+        prev.Add(Log::GetLogger(0));
+        Log::RemoveLogger(prev.Back());
+    }
+    if (logger) {
+        Log::AddLogger(logger);
+    }
+    return prev;
+}
+
+//------------------------------------------------------------------------------
+static void restoreLoggers(const Array<Ptr<Logger>>& prev) {
+    replaceLoggers(Ptr<Logger>());
+    for (const auto& l : prev) {
+        Log::AddLogger(l);
+    }
+}
+
+//------------------------------------------------------------------------------
+TEST(LogAsyncTest) {
+    Ptr<RecordLogger> logger = RecordLogger::Create();
+    Array<Ptr<Logger>> prevLoggers = replaceLoggers(logger);
+
+    CHECK(!Log::IsAsync());
+    Log::SetAsync(true);
+    CHECK(Log::IsAsync());
+
+    // several threads logging at the same time, flush now and then
+    // so that the queues don't overflow
+    const int numThreads = 4;
+    const int numMessages = 1000;
+    const int64_t droppedBefore = Log::NumDropped();
+    Array<std::thread> threads;
+    for (int t = 0; t < numThreads; t++) {
+        threads.Add(std::thread([t]() {
+            for (int i = 0; i < numMessages; i++) {
+                Log::Info("msg %d %d\n", t, i);
+                if ((i % 32) == 31) {
+                    Log::Flush();
+                }
+            }
+        }));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    // an error is written synchronously, after all queued messages
+    Log::Error("msg %d %d\n", numThreads, 0);
+    CHECK(logger->entries.Back().level == Log::Level::Error);
+    CHECK(!logger->entries.Back().async);
 
+    // check that messages arrived in order, without gaps in the sequence numbers
+    int lastIndex[numThreads];
+    for (int t = 0; t < numThreads; t++) {
+        lastIndex[t] = -1;
+    }
+    int numReceived = 0;
+    bool inOrder = true;
+    uint64_t lastSeq = 0;
+    for (const auto& e : logger->entries) {
+        if (e.async && (e.msgThread >= 0) && (e.msgThread < numThreads)) {
+            inOrder &= (0 == numReceived) || (e.seq == (lastSeq + 1));
+            inOrder &= e.msgIndex > lastIndex[e.msgThread];
+            lastSeq = e.seq;
+            lastIndex[e.msgThread] = e.msgIndex;
+            numReceived++;
+        }
+    }
+    CHECK(inOrder);
+    CHECK((numReceived + (Log::NumDropped() - droppedBefore)) == numThreads * numMessages);
+
+    // messages logged right before switching off async mode are not lost
+    for (int i = 0; i < 16; i++) {
+        Log::Info("msg %d %d\n", 0, numMessages + i);
+    }
+    Log::SetAsync(false);
+    CHECK(!Log::IsAsync());
+    CHECK(logger->entries.Back().msgIndex == numMessages + 15);
+
+    restoreLoggers(prevLoggers);
+}
+
+//------------------------------------------------------------------------------
+TEST(LogContentionBenchmark) {
+    // NOTE: this is not a hard performance test, the numbers are only logged
+    // mode 0: sync, mode 1: async with a Flush() after each batch (not timed),
+    // mode 2: async without flushing (will drop messages if the log thread can't keep up)
+    Ptr<BufferLogger> logger = BufferLogger::Create();
+    Array<Ptr<Logger>> prevLoggers = replaceLoggers(logger);
+
+    const int numThreads = 4;
+    const int numBatches = 500;
+    const int batchSize = Log::AsyncQueueSize / 2;
+    const int numMessages = numThreads * numBatches * batchSize;
+    double avgNs[3] = { };
+    int64_t dropped[3] = { };
+    for (int mode = 0; mode < 3; mode++) {
+        Log::SetAsync(mode > 0);
+        const int64_t droppedBefore = Log::NumDropped();
+        std::atomic<int64_t> totalNs(0);
+        Array<std::thread> threads;
+        for (int t = 0; t < numThreads; t++) {
+            threads.Add(std::thread([&totalNs, mode]() {
+                typedef std::chrono::high_resolution_clock clock;
+                int64_t ns = 0;
+                for (int b = 0; b < numBatches; b++) {
+                    const auto start = clock::now();
+                    for (int i = 0; i < batchSize; i++) {
+                        Log::Warn("fileSystemForURL(): no filesystem for URL 'res:%d' found\n", i);
+                    }
+                    ns += std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count();
+                    if (1 == mode) {
+                        Log::Flush();
+                    }
+                }
+                totalNs += ns;
+            }));
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        Log::Flush();
+        avgNs[mode] = double(totalNs.load()) / double(numMessages);
+        dropped[mode] = Log::NumDropped() - droppedBefore;
+    }
+    Log::SetAsync(false);
+    restoreLoggers(prevLoggers);
+    Log::Info("LogContentionBenchmark: %d threads, avg log call: sync %.1fns, async %.1fns (%d dropped), async burst %.1fns (%d dropped) of %d\n",
+        numThreads, avgNs[0], avgNs[1], int(dropped[1]), avgNs[2], int(dropped[2]), numMessages);
+    // with fewer cores than threads there is little lock contention to remove
+    Log::Info("LogContentionBenchmark: %d hardware threads\n", int(std::thread::hardware_concurrency()));
+    CHECK(dropped[0] == 0);
+}
@@ -0,0 +1,154 @@
+//------------------------------------------------------------------------------
+//  MPMCQueueTest.cc
+//  Test MPMCQueue class, and benchmark the lock-free queues against
+//  a mutex-protected Queue under contention.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Containers/MPMCQueue.h"
+#include "Core/Containers/SPSCQueue.h"
+#include "Core/Containers/Queue.h"
+#include "Core/String/String.h"
+#include "Core/Log.h"
+#if ORYOL_HAS_THREADS
+#include <thread>
+#include <mutex>
+#include <chrono>
+#endif
+
+using namespace Oryol;
+
+//------------------------------------------------------------------------------
+TEST(MPMCQueueTest) {
+
+    MPMCQueue<String> queue(5);
+    CHECK(queue.Capacity() == 8);
+    CHECK(queue.Empty());
+    String str;
+    CHECK(!queue.Dequeue(str));
+    for (int i = 0; i < 8; i++) {
+        CHECK(queue.Enqueue(String("Bla")));
+    }
+    CHECK(queue.Size() == 8);
+    CHECK(!queue.Enqueue(String("Blub")));
+    CHECK(queue.Dequeue(str));
+    CHECK(str == "Bla");
+    CHECK(queue.Enqueue("Blub"));
+    for (int i = 0; i < 7; i++) {
+        CHECK(queue.Dequeue(str));
+        CHECK(str == "Bla");
+    }
+    CHECK(queue.Dequeue(str));
+    CHECK(str == "Blub");
+    CHECK(queue.Empty());
+    for (int i = 0; i < 100; i++) {
+        CHECK(queue.Enqueue(String("Wrap")));
+        CHECK(queue.Dequeue(str));
+    }
+    // leave elements in the queue, destructor must clean up
+    queue.Enqueue(str);
+    queue.Enqueue(str);
+    CHECK(queue.Size() == 2);
+}
+
+#if ORYOL_HAS_THREADS
+namespace {
+
+// a mutex-protected Queue as baseline for the benchmark
+struct lockedQueue {
+    bool Enqueue(int val) {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->queue.Enqueue(val);
+        return true;
+    }
+    bool Dequeue(int& val) {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (this->queue.Empty()) {
+            return false;
+        }
+        val = this->queue.Dequeue();
+        return true;
+    }
+    std::mutex mutex;
+    Queue<int> queue;
+};
+
+// push numItems values through a queue with numProducers and numConsumers
+// threads, returns elapsed time in milliseconds, and the sum of dequeued values
+template<class QUEUE> double
+runContention(QUEUE& queue, int numProducers, int numConsumers, int numItems, int64_t& outSum) {
+    std::atomic<int64_t> sum(0);
+    std::atomic<int> numConsumed(0);
+    const int itemsPerProducer = numItems / numProducers;
+    const int total = itemsPerProducer * numProducers;
+    auto start = std::chrono::high_resolution_clock::now();
+    std::thread threads[16];
+    for (int p = 0; p < numProducers; p++) {
+        threads[p] = std::thread([&queue, itemsPerProducer] {
+            for (int i = 1; i <= itemsPerProducer; i++) {
+                while (!queue.Enqueue(i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int c = 0; c < numConsumers; c++) {
+        threads[numProducers + c] = std::thread([&queue, &sum, &numConsumed, total] {
+            int64_t localSum = 0;
+            while (numConsumed.load(std::memory_order_relaxed) < total) {
+                int val;
+                if (queue.Dequeue(val)) {
+                    localSum += val;
+                    numConsumed.fetch_add(1, std::memory_order_relaxed);
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+            sum += localSum;
+        });
+    }
+    for (int i = 0; i < numProducers + numConsumers; i++) {
+        threads[i].join();
+    }
+    outSum = sum;
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+TEST(MPMCQueueContentionBenchmark) {
+
+    // NOTE: this is not a hard performance test, the numbers are only logged
+    const int numItems = 400000;
+    const int configs[][2] = { { 1, 1 }, { 2, 2 }, { 4, 4 } };
+    for (const auto& cfg : configs) {
+        const int numProducers = cfg[0];
+        const int numConsumers = cfg[1];
+        const int64_t perProducer = numItems / numProducers;
+        const int64_t expectedSum = numProducers * (perProducer * (perProducer + 1) / 2);
+
+        int64_t sum = 0;
+        MPMCQueue<int> mpmcQueue(1024);
+        const double mpmcTime = runContention(mpmcQueue, numProducers, numConsumers, numItems, sum);
+        CHECK(sum == expectedSum);
+
+        lockedQueue mutexQueue;
+        const double mutexTime = runContention(mutexQueue, numProducers, numConsumers, numItems, sum);
+        CHECK(sum == expectedSum);
+
+        if (1 == numProducers && 1 == numConsumers) {
+            SPSCQueue<int> spscQueue(1024);
+            const double spscTime = runContention(spscQueue, 1, 1, numItems, sum);
+            CHECK(sum == expectedSum);
+            Log::Info("MPMCQueueContentionBenchmark: %d producers, %d consumers, %d items: MPMCQueue %.2fms, Queue+mutex %.2fms, SPSCQueue %.2fms\n",
+                numProducers, numConsumers, numItems, mpmcTime, mutexTime, spscTime);
+        }
+        else {
+            Log::Info("MPMCQueueContentionBenchmark: %d producers, %d consumers, %d items: MPMCQueue %.2fms, Queue+mutex %.2fms\n",
+                numProducers, numConsumers, numItems, mpmcTime, mutexTime);
+        }
+    }
+}
+#endif
@@ -76,3 +76,24 @@ TEST(Memory) {
 }
 
 
+
+//------------------------------------------------------------------------------
+TEST(MemoryAlignedTest) {
+    for (int alignment = 1; alignment <= 4096; alignment *= 2) {
+        uint8_t* p = (uint8_t*) Memory::AllocAligned(100, alignment);
+        CHECK((intptr_t(p) & (alignment - 1)) == 0);
+        CHECK((intptr_t(p) & (ORYOL_MAX_PLATFORM_ALIGN - 1)) == 0);
+        Memory::Fill(p, 100, 0x11);
+        CHECK(Memory::TagOf(p) == Memory::CurrentTag());
+
+        // re-alloc must keep alignment and content
+        p = (uint8_t*) Memory::ReAlloc(p, 200);
+        CHECK((intptr_t(p) & (alignment - 1)) == 0);
+        CHECK((p[0] == 0x11) && (p[99] == 0x11));
+        Memory::FreeAligned(p);
+    }
+    void* p = Memory::AllocAligned(16, 64, MemoryTag::IO);
+    CHECK((intptr_t(p) & 63) == 0);
+    CHECK(Memory::TagOf(p) == MemoryTag::IO);
+    Memory::Free(p);
+}
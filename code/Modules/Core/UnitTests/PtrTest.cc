@@ -5,6 +5,12 @@
 #include "UnitTest++/src/UnitTest++.h"
 #include "Core/RefCounted.h"
 #include "Core/Ptr.h"
+#include "Core/WeakPtr.h"
+#include "Core/Log.h"
+#include <chrono>
+#if ORYOL_HAS_THREADS
+#include <thread>
+#endif
 
 using namespace Oryol;
 
@@ -17,6 +23,13 @@ class A : public RefCounted {
 class B : public RefCounted {
     OryolClassDecl(B);
 };
+class C : public A {
+    OryolClassDecl(C);
+public:
+    ~C() { numDestroyed++; };
+    static int numDestroyed;
+};
+int C::numDestroyed = 0;
 }
 
 TEST(Ptr) {
@@ -65,3 +78,119 @@ TEST(Ptr) {
     ptr1 = nullptr;
     CHECK(!ptr1.isValid());
 }
+
+//------------------------------------------------------------------------------
+TEST(WeakPtr) {
+    C::numDestroyed = 0;
+    WeakPtr<C> weak;
+    CHECK(weak.expired());
+    CHECK(!weak.lock());
+    {
+        Ptr<C> c = C::Create();
+        weak = c;
+        CHECK(!weak.expired());
+        CHECK(c->GetRefCount() == 1);
+        Ptr<C> c1 = weak.lock();
+        CHECK(c1 == c);
+        CHECK(c->GetRefCount() == 2);
+
+        // copies and moves of weak pointers
+        WeakPtr<C> weak1(weak);
+        WeakPtr<A> weakA = c;
+        WeakPtr<C> weak2(std::move(weak1));
+        CHECK(weak1.expired());
+        CHECK(weak2.lock() == c);
+        CHECK(weakA.lock() == c);
+        CHECK(c->GetRefCount() == 2);
+    }
+    CHECK(C::numDestroyed == 1);
+    CHECK(weak.expired());
+    CHECK(!weak.lock());
+    weak = nullptr;
+    CHECK(weak.expired());
+
+    #if ORYOL_HAS_THREADS
+    // a weak pointer locked from another thread while the object goes away
+    for (int i = 0; i < 100; i++) {
+        Ptr<C> c = C::Create();
+        WeakPtr<C> w = c;
+        std::thread thread([&w]() {
+            for (int j = 0; j < 100; j++) {
+                Ptr<C> locked = w.lock();
+                if (locked) {
+                    locked->Incr();
+                }
+            }
+        });
+        c = nullptr;
+        thread.join();
+        CHECK(w.expired());
+    }
+    CHECK(C::numDestroyed == 101);
+    #endif
+}
+
+//------------------------------------------------------------------------------
+TEST(BorrowedPtr) {
+    Ptr<A> a = A::Create();
+    Borrowed<A> b = a.borrow();
+    CHECK(b.get() == a.get());
+    CHECK(a->GetRefCount() == 1);
+    b->Incr();
+    CHECK(a->i == 1);
+    Borrowed<RefCounted> b1(a);
+    Borrowed<A> b2(b);
+    Borrowed<A> b3(std::move(b2));
+    CHECK(!b2);
+    CHECK(b3.getUnsafe() == a.getUnsafe());
+    CHECK(a->GetRefCount() == 1);
+    Ptr<A> a1 = b3.lock();
+    CHECK(a->GetRefCount() == 2);
+}
+
+//------------------------------------------------------------------------------
+TEST(SingleThreadedRefCount) {
+    C::numDestroyed = 0;
+    Ptr<C> c = C::Create();
+    CHECK(!c->IsSingleThreaded());
+    c->SetSingleThreaded();
+    CHECK(c->IsSingleThreaded());
+    Ptr<C> c1 = c;
+    CHECK(c->GetRefCount() == 2);
+    WeakPtr<C> weak = c;
+    c1 = nullptr;
+    CHECK(weak.lock() == c);
+    c = nullptr;
+    CHECK(C::numDestroyed == 1);
+    CHECK(weak.expired());
+}
+
+//------------------------------------------------------------------------------
+TEST(PtrCopyBenchmark) {
+    // NOTE: this is not a hard performance test, the numbers are only logged
+    typedef std::chrono::high_resolution_clock clock;
+    const int num = 10000000;
+    Ptr<A> a = A::Create();
+    Ptr<A> b = A::Create();
+    b->SetSingleThreaded();
+    auto copyLoop = [num](const Ptr<A>& ptr) {
+        auto start = clock::now();
+        for (int i = 0; i < num; i++) {
+            Ptr<A> copy = ptr;
+            copy->Incr();
+        }
+        return std::chrono::duration<double, std::nano>(clock::now() - start).count() / num;
+    };
+    const double atomicNs = copyLoop(a);
+    const double singleNs = copyLoop(b);
+    auto start = clock::now();
+    for (int i = 0; i < num; i++) {
+        Borrowed<A> borrowed = a.borrow();
+        borrowed->Incr();
+    }
+    const double borrowNs = std::chrono::duration<double, std::nano>(clock::now() - start).count() / num;
+    CHECK(a->GetRefCount() == 1);
+    CHECK(b->GetRefCount() == 1);
+    Log::Info("PtrCopyBenchmark: atomic copy: %.2fns, single-threaded copy: %.2fns, borrow: %.2fns\n",
+        atomicNs, singleNs, borrowNs);
+}
@@ -89,3 +89,14 @@ TEST(QueueTest) {
     CHECK(queue3.GetMaxGrow() == 0);
 }
     
+
+//------------------------------------------------------------------------------
+TEST(QueueAlignmentTest) {
+    Queue<int, 64> queue;
+    for (int i = 0; i < 100; i++) {
+        queue.Enqueue(i);
+    }
+    CHECK((intptr_t(&queue.Front()) & 63) == 0);
+    CHECK(queue.Dequeue() == 0);
+    CHECK(queue.Back() == 99);
+}
@@ -0,0 +1,146 @@
+//------------------------------------------------------------------------------
+//  ReplayTest.cc
+//  Test recording and playback of per-frame replay events.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Replay.h"
+#include "Core/Containers/Array.h"
+#include <cstdio>
+
+using namespace Oryol;
+
+namespace {
+    struct event {
+        int64_t frame;
+        Replay::ChannelId channel;
+        int value;
+    };
+}
+
+//------------------------------------------------------------------------------
+TEST(ReplayTest) {
+    const char* path = "oryol_replay_test.bin";
+    const Replay::ChannelId chnA = Replay::RegisterChannel("ReplayTestA");
+    const Replay::ChannelId chnB = Replay::RegisterChannel("ReplayTestB");
+    CHECK(Replay::InvalidChannelId != chnA);
+    CHECK(Replay::InvalidChannelId != chnB);
+    CHECK(chnA != chnB);
+    CHECK(Replay::RegisterChannel("ReplayTestA") == chnA);
+    CHECK(Replay::FindChannel("ReplayTestB") == chnB);
+    CHECK(Replay::FindChannel("Bla") == Replay::InvalidChannelId);
+    CHECK(!Replay::IsRecording());
+    CHECK(!Replay::IsPlaying());
+
+    // record 3 frames, channel B is only used in the last frame
+    CHECK(Replay::StartRecording(path));
+    CHECK(Replay::IsRecording());
+    for (int frame = 0; frame < 3; frame++) {
+        Replay::BeginFrame();
+        CHECK(Replay::FrameIndex() == frame);
+        int val = frame * 10;
+        Replay::Record(chnA, &val, sizeof(val));
+        val++;
+        Replay::Record(chnA, &val, sizeof(val));
+        if (2 == frame) {
+            val = 100;
+            Replay::Record(chnB, &val, sizeof(val));
+        }
+    }
+    Replay::Stop();
+    CHECK(!Replay::IsRecording());
+
+    // play back, events must arrive in the same frames and order
+    Array<event> events;
+    auto handler = [&events](Replay::ChannelId chn) {
+        return [&events, chn](const uint8_t* data, int size) {
+            CHECK(size == int(sizeof(int)));
+            event e;
+            e.frame = Replay::FrameIndex();
+            e.channel = chn;
+            e.value = *(const int*)data;
+            events.Add(e);
+        };
+    };
+    Replay::SetPlaybackHandler(chnA, handler(chnA));
+    Replay::SetPlaybackHandler(chnB, handler(chnB));
+    CHECK(Replay::StartPlayback(path));
+    CHECK(Replay::IsPlaying());
+    CHECK(!Replay::PlaybackFinished());
+    int numPeeked = 0;
+    auto peek = [&numPeeked](const uint8_t* data, int size) {
+        numPeeked++;
+    };
+    Replay::PeekRecords(chnA, peek);
+    CHECK(numPeeked == 6);
+    Replay::BeginFrame();
+    CHECK(events.Size() == 2);
+    numPeeked = 0;
+    Replay::PeekRecords(chnA, peek);
+    CHECK(numPeeked == 4);
+    numPeeked = 0;
+    Replay::PeekRecords(chnB, peek);
+    CHECK(numPeeked == 1);
+    Replay::BeginFrame();
+    CHECK(events.Size() == 4);
+    Replay::BeginFrame();
+    CHECK(events.Size() == 7);
+    CHECK(Replay::PlaybackFinished());
+    Replay::Stop();
+    CHECK(!Replay::IsPlaying());
+    const event expected[] = {
+        { 0, chnA, 0 }, { 0, chnA, 1 },
+        { 1, chnA, 10 }, { 1, chnA, 11 },
+        { 2, chnA, 20 }, { 2, chnA, 21 }, { 2, chnB, 100 }
+    };
+    if (events.Size() == 7) {
+        for (int i = 0; i < 7; i++) {
+            CHECK(events[i].frame == expected[i].frame);
+            CHECK(events[i].channel == expected[i].channel);
+            CHECK(events[i].value == expected[i].value);
+        }
+    }
+
+    // records of channels without a handler are dropped
+    events.Clear();
+    Replay::ClearPlaybackHandler(chnA);
+    CHECK(Replay::StartPlayback(path));
+    for (int i = 0; i < 3; i++) {
+        Replay::BeginFrame();
+    }
+    Replay::Stop();
+    CHECK(events.Size() == 1);
+    Replay::ClearPlaybackHandler(chnB);
+    std::remove(path);
+}
+
+//------------------------------------------------------------------------------
+TEST(ReplayInvalidFileTest) {
+    const char* path = "oryol_replay_invalid.bin";
+    CHECK(!Replay::StartPlayback("oryol_replay_missing.bin"));
+    FILE* fp = std::fopen(path, "wb");
+    CHECK(nullptr != fp);
+    std::fputs("this is not a replay file", fp);
+    std::fclose(fp);
+    CHECK(!Replay::StartPlayback(path));
+    CHECK(!Replay::IsPlaying());
+
+    // a truncated record is rejected
+    const Replay::ChannelId chn = Replay::RegisterChannel("ReplayTestA");
+    CHECK(Replay::StartRecording(path));
+    Replay::BeginFrame();
+    const int val = 1;
+    Replay::Record(chn, &val, sizeof(val));
+    Replay::Stop();
+    fp = std::fopen(path, "rb");
+    char buf[256];
+    const int size = int(std::fread(buf, 1, sizeof(buf), fp));
+    std::fclose(fp);
+    fp = std::fopen(path, "wb");
+    std::fwrite(buf, size - 1, 1, fp);
+    std::fclose(fp);
+    CHECK(!Replay::StartPlayback(path));
+    CHECK(!Replay::IsPlaying());
+    std::remove(path);
+}
+
@@ -1,10 +1,17 @@
 //------------------------------------------------------------------------------
-//  ArrayMapTest.cc
-//  Test ArrayMap class.
+//  RunLoopTest.cc
+//  Test RunLoop class, and log per-frame dispatch cost.
 //------------------------------------------------------------------------------
 #include "Pre.h"
 #include "UnitTest++/src/UnitTest++.h"
 #include "Core/RunLoop.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Memory/PoolAllocator.h"
+#include "Core/Log.h"
+#include <chrono>
+#if ORYOL_HAS_THREADS
+#include <thread>
+#endif
 
 using namespace Oryol;
 
@@ -13,6 +20,7 @@ TEST(RunLoopTest) {
     int x = 0;
     int y = 0;
     auto id0 = runLoop.Add([&x]() { x++; });
+    CHECK(runLoop.HasCallback(id0));
     runLoop.Run();
     CHECK(x == 1);
     CHECK(y == 0);
@@ -21,6 +29,7 @@ TEST(RunLoopTest) {
     CHECK(x == 2);
     CHECK(y == 2);
     runLoop.Remove(id0);
+    CHECK(!runLoop.HasCallback(id0));
     runLoop.Run();
     CHECK(x == 2);
     CHECK(y == 4);
@@ -28,4 +37,131 @@ TEST(RunLoopTest) {
     runLoop.Run();
     CHECK(x == 2);
     CHECK(y == 4);
+    CHECK(runLoop.NumCallbacks() == 0);
+}
+
+//------------------------------------------------------------------------------
+TEST(RunLoopPriorityTest) {
+    RunLoop runLoop;
+    int order[5] = { };
+    int num = 0;
+    runLoop.Add([&]() { order[num++] = 2; }, 10);
+    runLoop.Add([&]() { order[num++] = 0; }, -5);
+    runLoop.Add([&]() { order[num++] = 3; }, 10);
+    runLoop.Add([&]() { order[num++] = 1; });
+    runLoop.Add([&]() { order[num++] = 4; }, 100);
+    runLoop.Run();
+    CHECK(num == 5);
+    for (int i = 0; i < 5; i++) {
+        CHECK(order[i] == i);
+    }
+}
+
+//------------------------------------------------------------------------------
+TEST(RunLoopDeferredTest) {
+    RunLoop runLoop;
+    int a = 0, b = 0, c = 0;
+    RunLoop::Id idA = RunLoop::InvalidId;
+    RunLoop::Id idB = RunLoop::InvalidId;
+    RunLoop::Id idC = RunLoop::InvalidId;
+
+    // a callback which removes itself and another callback, and adds a new one,
+    // the removed callback must not be called anymore, the new callback
+    // is called starting with the next frame
+    idA = runLoop.Add([&]() {
+        a++;
+        runLoop.Remove(idA);
+        runLoop.Remove(idB);
+        idC = runLoop.Add([&c]() { c++; });
+    });
+    idB = runLoop.Add([&b]() { b++; });
+    runLoop.Run();
+    CHECK(a == 1);
+    CHECK(b == 0);
+    CHECK(c == 0);
+    CHECK(runLoop.NumCallbacks() == 1);
+    runLoop.Run();
+    CHECK(a == 1);
+    CHECK(b == 0);
+    CHECK(c == 1);
+
+    // add and remove before Run()
+    RunLoop::Id idD = runLoop.Add([&b]() { b++; });
+    runLoop.Remove(idD);
+    runLoop.Run();
+    CHECK(b == 0);
+    CHECK(c == 2);
+    runLoop.Remove(idC);
+    CHECK(runLoop.NumCallbacks() == 0);
+}
+
+#if ORYOL_HAS_THREADS
+//------------------------------------------------------------------------------
+TEST(RunLoopThreadTest) {
+    RunLoop runLoop;
+    int val = 0;
+    RunLoop::Id id = RunLoop::InvalidId;
+    std::thread addThread([&runLoop, &val, &id]() {
+        id = runLoop.Add([&val]() { val++; });
+    });
+    addThread.join();
+    CHECK(runLoop.HasCallback(id));
+    runLoop.Run();
+    CHECK(val == 1);
+    std::thread remThread([&runLoop, id]() {
+        runLoop.Remove(id);
+    });
+    remThread.join();
+    runLoop.Run();
+    CHECK(val == 1);
+    CHECK(!runLoop.HasCallback(id));
+    CHECK(runLoop.NumCallbacks() == 0);
+}
+#endif
+
+//------------------------------------------------------------------------------
+TEST(RunLoopBenchmark) {
+    // NOTE: this is not a hard performance test, the numbers are only logged
+    typedef std::chrono::high_resolution_clock clock;
+    static PoolAllocator pool("RunLoopTest");
+    Memory::SetAllocator(MemoryTag::Core, &pool);
+    {
+        Memory::ScopedTag memTag(MemoryTag::Core);
+        for (int numCallbacks : { 10, 100, 1000 }) {
+            const int numFrames = 100000 / numCallbacks;
+            int counter = 0;
+            RunLoop runLoop;
+            RunLoop::Id ids[1000];
+            for (int i = 0; i < numCallbacks; i++) {
+                ids[i] = runLoop.Add([&counter]() { counter++; }, i & 7);
+            }
+            runLoop.Run();
+
+            // steady state, no allocations
+            const int numAllocs = pool.Stats().NumAllocs;
+            auto start = clock::now();
+            for (int i = 0; i < numFrames; i++) {
+                runLoop.Run();
+            }
+            const double frameNs = std::chrono::duration<double, std::nano>(clock::now() - start).count() / numFrames;
+            CHECK(counter == (numFrames + 1) * numCallbacks);
+            CHECK(pool.Stats().NumAllocs == numAllocs);
+
+            // remove and re-add one callback per frame, no allocations either
+            start = clock::now();
+            for (int i = 0; i < numFrames; i++) {
+                const int index = i % numCallbacks;
+                runLoop.Remove(ids[index]);
+                ids[index] = runLoop.Add([&counter]() { counter++; }, index & 7);
+                runLoop.Run();
+            }
+            const double churnNs = std::chrono::duration<double, std::nano>(clock::now() - start).count() / numFrames;
+            CHECK(pool.Stats().NumAllocs == numAllocs);
+            CHECK(runLoop.NumCallbacks() == numCallbacks);
+
+            Log::Info("RunLoopBenchmark: %d callbacks: %.1fns per frame (%.2fns per callback), %.1fns with add/remove\n",
+                numCallbacks, frameNs, frameNs / numCallbacks, churnNs);
+        }
+    }
+    Memory::SetAllocator(MemoryTag::Core, nullptr);
 }
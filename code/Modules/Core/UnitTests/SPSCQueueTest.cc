@@ -0,0 +1,109 @@
+//------------------------------------------------------------------------------
+//  SPSCQueueTest.cc
+//  Test SPSCQueue class.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Containers/SPSCQueue.h"
+#include "Core/String/String.h"
+#if ORYOL_HAS_THREADS
+#include <thread>
+#endif
+
+using namespace Oryol;
+
+namespace {
+
+// a move-only element type
+struct moveOnly {
+    moveOnly() : val(0) { };
+    explicit moveOnly(int v) : val(v) { };
+    moveOnly(moveOnly&& rhs) : val(rhs.val) { rhs.val = 0; };
+    void operator=(moveOnly&& rhs) { this->val = rhs.val; rhs.val = 0; };
+    moveOnly(const moveOnly& rhs) = delete;
+    void operator=(const moveOnly& rhs) = delete;
+    int val;
+};
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+TEST(SPSCQueueTest) {
+
+    SPSCQueue<String> queue(6);
+    CHECK(queue.Capacity() == 8);
+    CHECK(queue.Size() == 0);
+    CHECK(queue.Empty());
+    String str;
+    CHECK(!queue.Dequeue(str));
+    for (int i = 0; i < 8; i++) {
+        CHECK(queue.Enqueue(String("Bla")));
+    }
+    CHECK(queue.Size() == 8);
+    CHECK(!queue.Enqueue(String("Blub")));
+    CHECK(queue.Dequeue(str));
+    CHECK(str == "Bla");
+    CHECK(queue.Enqueue("Blub"));
+    CHECK(queue.Size() == 8);
+    for (int i = 0; i < 7; i++) {
+        CHECK(queue.Dequeue(str));
+        CHECK(str == "Bla");
+    }
+    CHECK(queue.Dequeue(str));
+    CHECK(str == "Blub");
+    CHECK(queue.Empty());
+
+    // wrap around a few times, and leave some elements in the
+    // queue to check that the destructor cleans up
+    for (int i = 0; i < 100; i++) {
+        CHECK(queue.Enqueue(String("Wrap")));
+        CHECK(queue.Dequeue(str));
+    }
+    queue.Enqueue(str);
+    queue.Enqueue(str);
+
+    // move-only elements
+    SPSCQueue<moveOnly> moQueue(4);
+    moveOnly mo(5);
+    CHECK(moQueue.Enqueue(std::move(mo)));
+    CHECK(mo.val == 0);
+    CHECK(moQueue.Enqueue(6));
+    CHECK(moQueue.Dequeue(mo));
+    CHECK(mo.val == 5);
+    CHECK(moQueue.Dequeue(mo));
+    CHECK(mo.val == 6);
+    CHECK(!moQueue.Dequeue(mo));
+}
+
+#if ORYOL_HAS_THREADS
+//------------------------------------------------------------------------------
+TEST(SPSCQueueThreadTest) {
+
+    // push a sequence of numbers through a small queue, the
+    // consumer must see all numbers in the original order
+    const int num = 1000000;
+    SPSCQueue<int> queue(64);
+    std::thread producer([&queue, num] {
+        for (int i = 0; i < num; i++) {
+            while (!queue.Enqueue(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    int expected = 0;
+    bool inOrder = true;
+    while (expected < num) {
+        int val;
+        if (queue.Dequeue(val)) {
+            inOrder &= (val == expected);
+            expected++;
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    CHECK(inOrder);
+    CHECK(queue.Empty());
+}
+#endif
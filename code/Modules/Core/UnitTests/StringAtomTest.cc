@@ -9,6 +9,7 @@
 #include "Core/Core.h"
 
 #include <cstring>
+#include <cstdio>
 #include <thread>
 #include <array>
 
@@ -81,6 +82,112 @@ TEST(StringAtomMultiThreaded) {
     std::thread t1(threadFunc, std::ref(atom0));
     t1.join();
 }
+
+// test that atoms from different threads share the global table
+TEST(StringAtomGlobalTable) {
+
+    StringAtom atom0("GLOBAL_TABLE_TEST");
+    const int numBytes = StringAtom::GetTableStats().NumBytes;
+    StringAtom atom1;
+    const char* otherPtr = nullptr;
+    std::thread t1([&atom1, &otherPtr] {
+        StringAtom a("GLOBAL_TABLE_TEST");
+        otherPtr = a.AsCStr();
+        atom1 = StringAtom("GLOBAL_TABLE_OTHER");
+    });
+    t1.join();
+    CHECK(atom0 == StringAtom(otherPtr));
+    StringAtom atom2(atom1);
+    CHECK(atom2 == "GLOBAL_TABLE_OTHER");
+    #if ORYOL_GLOBAL_STRINGATOMS
+    // same string data, independent of creator thread
+    CHECK(StringAtom::GetTableStats().Global);
+    CHECK(otherPtr == atom0.AsCStr());
+    CHECK(atom2.AsCStr() == atom1.AsCStr());
+    CHECK(atom0 < atom1 || atom1 < atom0);
+    const StringAtom::TableStats stats = StringAtom::GetTableStats();
+    CHECK(stats.NumBytes > numBytes);
+    CHECK(stats.NumDuplicateBytesSaved > 0);
+    #else
+    // each thread has its own copy of the string
+    CHECK(!StringAtom::GetTableStats().Global);
+    CHECK(otherPtr != atom0.AsCStr());
+    CHECK(StringAtom::GetTableStats().NumBytes > numBytes);
+    #endif
+}
+
+// create string atoms from many threads
+TEST(StringAtomThreadedPerformance) {
+
+    const int numThreads = 4;
+    const int numUniqueStrings = 1024;
+    const int numLookups = 250000;
+    static char strings[numUniqueStrings][32];
+    for (int i = 0; i < numUniqueStrings; i++) {
+        snprintf(strings[i], sizeof(strings[i]), "atom_%d", i);
+    }
+    StringAtom::TableStats before = StringAtom::GetTableStats();
+    chrono::time_point<chrono::system_clock> start = chrono::system_clock::now();
+    std::thread threads[numThreads];
+    for (int t = 0; t < numThreads; t++) {
+        threads[t] = std::thread([t] {
+            StringAtom atom;
+            for (int i = 0; i < numLookups; i++) {
+                atom = strings[(i * 7 + t) & (numUniqueStrings - 1)];
+            }
+            CHECK(atom.IsValid());
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    chrono::duration<double> dur = chrono::system_clock::now() - start;
+    StringAtom::TableStats after = StringAtom::GetTableStats();
+    Log::Info("%d threads: %dx StringAtoms created: %f sec (%s table: %d atoms, %d bytes, %lld duplicate bytes saved)\n",
+        numThreads, numThreads * numLookups, dur.count(), after.Global ? "global" : "thread-local",
+        after.NumAtoms, after.NumBytes, (long long)(after.NumDuplicateBytesSaved - before.NumDuplicateBytesSaved));
+}
+
+// StringAtom construction throughput on worker threads which
+// go through Core::EnterThread/LeaveThread like JobSystem workers
+TEST(StringAtomWorkerThreadBenchmark) {
+    const int numUniqueStrings = 64;    // must be 2^N
+    const int numAtoms = 1000000;
+    static char strings[numUniqueStrings][32];
+    for (int i = 0; i < numUniqueStrings; i++) {
+        snprintf(strings[i], sizeof(strings[i]), "worker_%d", i);
+    }
+    for (int numThreads : { 1, 2, 4 }) {
+        std::thread threads[4];
+        double threadSecs[4] = { };
+        for (int t = 0; t < numThreads; t++) {
+            threads[t] = std::thread([t, &threadSecs] {
+                Core::EnterThread();
+                // warm up the thread's table, then measure lookups only
+                StringAtom atom;
+                for (int i = 0; i < numUniqueStrings; i++) {
+                    atom = strings[i];
+                }
+                chrono::time_point<chrono::system_clock> start = chrono::system_clock::now();
+                for (int i = 0; i < numAtoms; i++) {
+                    StringAtom tmp(strings[i & (numUniqueStrings - 1)]);
+                    atom = tmp;
+                }
+                chrono::duration<double> dur = chrono::system_clock::now() - start;
+                threadSecs[t] = dur.count();
+                CHECK(atom.IsValid());
+                Core::LeaveThread();
+            });
+        }
+        double maxSecs = 0.0;
+        for (int t = 0; t < numThreads; t++) {
+            threads[t].join();
+            maxSecs = threadSecs[t] > maxSecs ? threadSecs[t] : maxSecs;
+        }
+        Log::Info("%d worker threads: %.1fns per StringAtom per thread, %.2f million atoms/sec overall\n",
+            numThreads, (maxSecs * 1e9) / numAtoms, (numThreads * numAtoms) / (maxSecs * 1e6));
+    }
+}
 #endif
 
 // test string atom creation performance
@@ -4,6 +4,7 @@
 #include "Pre.h"
 #include "UnitTest++/src/UnitTest++.h"
 #include "Core/String/StringBuilder.h"
+#include "Core/Memory/AllocationTracker.h"
 
 using namespace Oryol;
 
@@ -12,7 +13,7 @@ TEST(StringBuilderTest) {
     StringBuilder builder;
     CHECK(builder.GetString().Empty());
     CHECK(builder.GetSubString(0, EndOfString).Empty());
-    CHECK(builder.Capacity() == 0);
+    CHECK(builder.Capacity() == StringBuilder::LocalBufferSize);
     CHECK(builder.Length() == 0);
     
     builder.Append('x');
@@ -215,3 +216,48 @@ TEST(StringBuilderTest) {
     CHECK(builder.GetString() == "One: 1, Two: 2, Three: 3 Bla: 46");
 }
 
+//------------------------------------------------------------------------------
+TEST(StringBuilderStackBufferTest) {
+
+    // building short strings doesn't allocate
+    AllocationTracker::Checkpoint checkpoint;
+    for (int i = 0; i < 16; i++) {
+        StringBuilder builder;
+        builder.Append("root:");
+        builder.Append("data/");
+        builder.AppendFormat(1024, "tex%d.dds", i);
+        builder.SubstituteFirst("root:", "file:///");
+        CHECK(builder.Capacity() == StringBuilder::LocalBufferSize);
+        CHECK(builder.Contains("file:///data/tex"));
+    }
+    CHECK(checkpoint.NumAllocs() == 0);
+
+    // short formatted strings with a generous maxLength stay in the local buffer
+    AllocationTracker::Checkpoint fmtCheckpoint;
+    for (int i = 0; i < 16; i++) {
+        StringBuilder builder;
+        CHECK(builder.Format(4096, "frame %d: %s", i, "short log line"));
+        CHECK(builder.Capacity() == StringBuilder::LocalBufferSize);
+    }
+    CHECK(fmtCheckpoint.NumAllocs() == 0);
+
+    // a formatted string longer than the local buffer grows to fit
+    StringBuilder longBuilder;
+    CHECK(longBuilder.Format(1024, "%0300d", 7));
+    CHECK(longBuilder.Length() == 300);
+    CHECK(longBuilder.Back() == '7');
+    CHECK(!longBuilder.Format(64, "%0300d", 7));
+
+    // growing beyond the local buffer moves the content to the heap
+    StringBuilder builder;
+    for (int i = 0; i < 100; i++) {
+        builder.Append("0123456789");
+    }
+    CHECK(builder.Length() == 1000);
+    CHECK(builder.Capacity() > 1000);
+    CHECK(builder.GetSubString(990, EndOfString) == "0123456789");
+    builder.Clear();
+    CHECK(builder.GetString().Empty());
+    builder.Set("Bla");
+    CHECK(builder.GetString() == "Bla");
+}
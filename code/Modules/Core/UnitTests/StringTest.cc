@@ -6,6 +6,7 @@
 #include "UnitTest++/src/UnitTest++.h"
 #include "Core/String/String.h"
 #include "Core/String/StringAtom.h"
+#include "Core/Memory/AllocationTracker.h"
 
 #include <cstring>
 
@@ -64,15 +65,32 @@ TEST(StringTest) {
     CHECK(str4 == blob);
     CHECK(str4 == "Blob");
     
-    // copy-assignment
+    // copy-assignment (short strings are copied)
     str0 = str2;
     CHECK(str0 == "Bla");
     CHECK(str0 == str2);
+    CHECK(str0.RefCount() == 1);
+    CHECK(str2.RefCount() == 1);
+    CHECK(str0.AsCStr() != str2.AsCStr());
+    str2.Clear();
+    CHECK(str0 == "Bla");
+    CHECK(str2.Empty());
+    CHECK(str0.RefCount() == 1);
+    CHECK(str2.RefCount() == 0);
+    str0.Clear();
+    CHECK(str0.Empty());
+
+    // copy-assignment (long strings are shared)
+    const char* longStr = "This string is too long for the local buffer";
+    str2 = longStr;
+    str0 = str2;
+    CHECK(str0 == longStr);
+    CHECK(str0 == str2);
     CHECK(str0.RefCount() == 2);
     CHECK(str2.RefCount() == 2);
     CHECK(str0.AsCStr() == str2.AsCStr());  // tests for identical pointers!
     str2.Clear();
-    CHECK(str0 == "Bla");
+    CHECK(str0 == longStr);
     CHECK(str2.Empty());
     CHECK(str0.RefCount() == 1);
     CHECK(str2.RefCount() == 0);
@@ -151,3 +169,55 @@ TEST(StringTest) {
     CHECK(nullString.AsCStr() != nullptr);
     CHECK(nullString.AsCStr()[0] == 0);    
 }
+
+//------------------------------------------------------------------------------
+TEST(StringSmallStringTest) {
+
+    // strings up to MaxLocalLength are stored in the String object
+    const char* maxLocal = "0123456789012345678901X";
+    const char* minHeap = "0123456789012345678901XY";
+    CHECK(String::MaxLocalLength == 23);
+    CHECK(std::strlen(maxLocal) == 23);
+    CHECK(std::strlen(minHeap) == 24);
+    String local0(maxLocal);
+    String heap0(minHeap);
+    CHECK(local0.Length() == 23);
+    CHECK(heap0.Length() == 24);
+    CHECK(local0 == maxLocal);
+    CHECK(heap0 == minHeap);
+    CHECK(local0 < heap0);
+    CHECK(local0.Back() == 'X');
+    CHECK(heap0.Back() == 'Y');
+    String local1(local0);
+    String heap1(heap0);
+    CHECK(local1.RefCount() == 1);
+    CHECK(heap1.RefCount() == 2);
+    CHECK(local1.AsCStr() != local0.AsCStr());
+    CHECK(heap1.AsCStr() == heap0.AsCStr());
+
+    // moving leaves the source empty
+    String local2(std::move(local1));
+    String heap2(std::move(heap1));
+    CHECK(local1.Empty() && heap1.Empty());
+    CHECK(local2 == maxLocal);
+    CHECK(heap2 == minHeap);
+    CHECK(heap2.RefCount() == 2);
+    local2 = std::move(heap2);
+    CHECK(local2 == minHeap);
+    CHECK(heap2.Empty());
+    CHECK(heap0.RefCount() == 2);
+    heap2 = std::move(local0);
+    CHECK(heap2 == maxLocal);
+    CHECK(local0.Empty());
+
+    // short strings never allocate
+    AllocationTracker::Checkpoint checkpoint;
+    for (int i = 0; i < 16; i++) {
+        String str("Bla");
+        String copy(str);
+        String sub(maxLocal, 2, 10);
+        copy = sub;
+        CHECK(copy == "23456789");
+    }
+    CHECK(checkpoint.NumAllocs() == 0);
+}
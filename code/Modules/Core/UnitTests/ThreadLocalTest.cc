@@ -0,0 +1,85 @@
+//------------------------------------------------------------------------------
+//  ThreadLocalTest.cc
+//  Test thread-local pointers, and log the cost of accessing them.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Threading/ThreadLocalPtr.h"
+#include "Core/Core.h"
+#include "Core/Log.h"
+#include <chrono>
+#if ORYOL_HAS_THREADS
+#include <thread>
+#endif
+
+using namespace Oryol;
+
+namespace {
+    ORYOL_THREADLOCAL_PTR(int) threadPtr = nullptr;
+    int* globalPtr = nullptr;
+}
+
+//------------------------------------------------------------------------------
+TEST(ThreadLocalTest) {
+    int a = 1, b = 2;
+    CHECK(nullptr == (int*)threadPtr);
+    threadPtr = &a;
+    CHECK(&a == threadPtr);
+    CHECK(*threadPtr == 1);
+    threadPtr = nullptr;
+    CHECK(!threadPtr);
+
+    #if ORYOL_HAS_THREADS
+    // each thread sees its own value
+    threadPtr = &a;
+    int* otherVal = &a;
+    std::thread thread([&otherVal, &b]() {
+        Core::EnterThread();
+        otherVal = threadPtr;
+        threadPtr = &b;
+        CHECK(&b == threadPtr);
+        threadPtr = nullptr;
+        Core::LeaveThread();
+    });
+    thread.join();
+    CHECK(nullptr == otherVal);
+    CHECK(&a == threadPtr);
+    threadPtr = nullptr;
+    #endif
+
+    #if ORYOL_THREADLOCAL_PTHREAD
+    // fixed slots are not handed out by Alloc()
+    CHECK(ThreadLocalData::Alloc() >= ThreadLocalData::NumFixedSlots);
+    #endif
+}
+
+//------------------------------------------------------------------------------
+TEST(ThreadLocalBenchmark) {
+    // NOTE: this is not a hard performance test, the numbers are only logged
+    typedef std::chrono::high_resolution_clock clock;
+    const int num = 10000000;
+    int val = 0;
+    int64_t sum = 0;
+    threadPtr = &val;
+    auto start = clock::now();
+    for (int i = 0; i < num; i++) {
+        sum += *threadPtr;
+        *threadPtr = i & 1;
+    }
+    const double threadNs = std::chrono::duration<double, std::nano>(clock::now() - start).count() / num;
+    threadPtr = nullptr;
+
+    // baseline: the same through a plain global pointer
+    globalPtr = &val;
+    start = clock::now();
+    for (int i = 0; i < num; i++) {
+        sum += *globalPtr;
+        *globalPtr = i & 1;
+    }
+    const double globalNs = std::chrono::duration<double, std::nano>(clock::now() - start).count() / num;
+    globalPtr = nullptr;
+    CHECK(sum >= 0);
+
+    Log::Info("ThreadLocalBenchmark (%s): thread-local: %.2fns, global: %.2fns per read+write\n",
+        ORYOL_THREADLOCAL_PTHREAD ? "pthread keys" : "native", threadNs, globalNs);
+}
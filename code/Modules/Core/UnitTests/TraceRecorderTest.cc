@@ -0,0 +1,178 @@
+//------------------------------------------------------------------------------
+//  TraceRecorderTest.cc
+//  Test the built-in TraceRecorder and log its per-event overhead.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/TraceRecorder.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Log.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#if ORYOL_HAS_THREADS
+#include <thread>
+#endif
+
+using namespace Oryol;
+
+//------------------------------------------------------------------------------
+static char* readFile(const char* path) {
+    FILE* fp = std::fopen(path, "rb");
+    if (!fp) {
+        return nullptr;
+    }
+    std::fseek(fp, 0, SEEK_END);
+    const int size = int(std::ftell(fp));
+    std::fseek(fp, 0, SEEK_SET);
+    char* buf = (char*) Memory::Alloc(size + 1);
+    buf[std::fread(buf, 1, size, fp)] = 0;
+    std::fclose(fp);
+    return buf;
+}
+
+//------------------------------------------------------------------------------
+static int countSubStr(const char* str, const char* sub) {
+    int count = 0;
+    for (const char* p = std::strstr(str, sub); p; p = std::strstr(p + 1, sub)) {
+        count++;
+    }
+    return count;
+}
+
+//------------------------------------------------------------------------------
+TEST(TraceRecorderTest) {
+    TraceRecorder::Clear();
+    const int numEvents0 = TraceRecorder::NumEvents();
+    CHECK(0 == numEvents0);
+
+    // nothing is recorded while not recording
+    CHECK(!TraceRecorder::IsRecording());
+    TraceRecorder::Begin("NotRecorded");
+    TraceRecorder::End();
+    CHECK(TraceRecorder::NumEvents() == 0);
+
+    TraceRecorder::Start();
+    CHECK(TraceRecorder::IsRecording());
+    TraceRecorder::SetThreadName("TestMainThread");
+    {
+        TraceRecorder::Scope scope("Outer");
+        TraceRecorder::Begin("Inner \"quoted\"");
+        TraceRecorder::Counter("BytesRead", 12345);
+        TraceRecorder::FlowBegin("Request", 77);
+        TraceRecorder::End();
+        TraceRecorder::Instant("Marker");
+    }
+    #if ORYOL_HAS_THREADS
+    std::thread thread([]() {
+        TraceRecorder::SetThreadName("TestWorkerThread");
+        TraceRecorder::Scope scope("Worker");
+        TraceRecorder::FlowEnd("Request", 77);
+    });
+    thread.join();
+    CHECK(TraceRecorder::NumEvents() == 10);
+    #else
+    CHECK(TraceRecorder::NumEvents() == 7);
+    #endif
+    TraceRecorder::Stop();
+    TraceRecorder::Instant("NotRecorded");
+    CHECK(!TraceRecorder::IsRecording());
+    CHECK(TraceRecorder::NumDropped() == 0);
+
+    const char* path = "oryol_trace_test.json";
+    CHECK(TraceRecorder::Dump(path));
+    char* json = readFile(path);
+    CHECK(nullptr != json);
+    if (json) {
+        CHECK(0 == std::strncmp(json, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 38));
+        CHECK(countSubStr(json, "\"ph\":\"B\"") == countSubStr(json, "\"ph\":\"E\""));
+        CHECK(nullptr != std::strstr(json, "\"name\":\"TestMainThread\""));
+        CHECK(nullptr != std::strstr(json, "\"name\":\"Inner \\\"quoted\\\"\""));
+        CHECK(nullptr != std::strstr(json, "\"name\":\"BytesRead\",\"ph\":\"C\",\"args\":{\"value\":12345}"));
+        CHECK(nullptr != std::strstr(json, "\"ph\":\"s\",\"cat\":\"flow\",\"id\":77"));
+        CHECK(nullptr != std::strstr(json, "\"ph\":\"i\""));
+        CHECK(nullptr == std::strstr(json, "NotRecorded"));
+        #if ORYOL_HAS_THREADS
+        CHECK(nullptr != std::strstr(json, "\"name\":\"TestWorkerThread\""));
+        CHECK(nullptr != std::strstr(json, "\"ph\":\"f\",\"bp\":\"e\",\"cat\":\"flow\",\"id\":77"));
+        #endif
+        Memory::Free(json);
+    }
+    std::remove(path);
+
+    TraceRecorder::Clear();
+    CHECK(TraceRecorder::NumEvents() == 0);
+
+    #if ORYOL_HAS_THREADS
+    // a new thread with a small buffer drops events when full
+    TraceRecorder::Start(16);
+    std::thread smallThread([]() {
+        for (int i = 0; i < 20; i++) {
+            TraceRecorder::Counter("Counter", i);
+        }
+    });
+    smallThread.join();
+    TraceRecorder::Stop();
+    CHECK(TraceRecorder::NumEvents() == 16);
+    CHECK(TraceRecorder::NumDropped() == 4);
+    TraceRecorder::Clear();
+
+    // in ring buffer mode, the oldest events are overwritten instead,
+    // and the dropped events are reported in the trace file
+    TraceRecorder::Start(16, true);
+    std::thread ringThread([]() {
+        TraceRecorder::Begin("Overwritten");
+        for (int i = 0; i < 20; i++) {
+            TraceRecorder::Counter("Counter", i);
+        }
+        TraceRecorder::End();
+    });
+    ringThread.join();
+    TraceRecorder::Stop();
+    CHECK(TraceRecorder::NumEvents() == 16);
+    CHECK(TraceRecorder::NumDropped() == 6);
+    CHECK(TraceRecorder::Dump(path));
+    json = readFile(path);
+    CHECK(nullptr != json);
+    if (json) {
+        CHECK(nullptr != std::strstr(json, "TraceRecorder: 6 events dropped"));
+        CHECK(nullptr == std::strstr(json, "Overwritten"));
+        CHECK(nullptr == std::strstr(json, "\"value\":4}"));
+        CHECK(nullptr != std::strstr(json, "\"value\":5}"));
+        CHECK(nullptr != std::strstr(json, "\"value\":19}"));
+        // the end event of the overwritten begin event is skipped
+        CHECK(0 == countSubStr(json, "\"ph\":\"E\""));
+        Memory::Free(json);
+    }
+    std::remove(path);
+    TraceRecorder::Clear();
+    #endif
+}
+
+//------------------------------------------------------------------------------
+TEST(TraceRecorderOverhead) {
+    // NOTE: this is not a hard performance test, the numbers are only logged
+    typedef std::chrono::high_resolution_clock clock;
+    // NOTE: the main thread's buffer has already been created with the default size
+    const int num = TraceRecorder::DefaultEventsPerThread / 4;
+
+    // not recording
+    auto start = clock::now();
+    for (int i = 0; i < num; i++) {
+        TraceRecorder::Scope scope("Scope");
+    }
+    const double idleNs = std::chrono::duration<double, std::nano>(clock::now() - start).count() / (2 * num);
+
+    // recording
+    TraceRecorder::Start();
+    start = clock::now();
+    for (int i = 0; i < num; i++) {
+        TraceRecorder::Scope scope("Scope");
+    }
+    const double recNs = std::chrono::duration<double, std::nano>(clock::now() - start).count() / (2 * num);
+    TraceRecorder::Stop();
+    CHECK(TraceRecorder::NumDropped() == 0);
+    TraceRecorder::Clear();
+
+    Log::Info("TraceRecorderOverhead: %.1fns per event (not recording: %.1fns)\n", recNs, idleNs);
+}
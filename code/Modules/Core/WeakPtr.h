@@ -0,0 +1,132 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::WeakPtr
+    @ingroup Core
+    @brief a weak pointer to a RefCounted object
+
+    A WeakPtr points to a RefCounted object without keeping it alive.
+    To access the object, lock() the WeakPtr, this returns a Ptr
+    which keeps the object alive, or an invalid Ptr if the object
+    has already been destroyed:
+
+    @code
+    WeakPtr<MyClass> weak = myObj;
+    ...
+    if (Ptr<MyClass> obj = weak.lock()) {
+        obj->DoSomething();
+    }
+    @endcode
+
+    WeakPtrs can be locked from any thread, but a single WeakPtr
+    object must not be modified from several threads at once.
+
+    @see RefCounted, Ptr
+*/
+#include "Core/RefCounted.h"
+
+namespace Oryol {
+
+template<class T> class WeakPtr {
+public:
+    /// default constructor
+    WeakPtr() : block(nullptr), obj(nullptr) { };
+    /// nullptr constructor
+    WeakPtr(std::nullptr_t) : block(nullptr), obj(nullptr) { };
+    /// construct from compatible Ptr
+    template<class U> WeakPtr(const Ptr<U>& rhs) : block(nullptr), obj(nullptr) {
+        this->set(static_cast<T*>(rhs.getUnsafe()));
+    };
+    /// copy constructor
+    WeakPtr(const WeakPtr<T>& rhs) : block(rhs.block), obj(rhs.obj) {
+        if (this->block) {
+            this->block->addRef();
+        }
+    };
+    /// move constructor
+    WeakPtr(WeakPtr<T>&& rhs) : block(rhs.block), obj(rhs.obj) {
+        rhs.block = nullptr;
+        rhs.obj = nullptr;
+    };
+    /// destructor
+    ~WeakPtr() {
+        this->invalidate();
+    };
+
+    /// assign from compatible Ptr
+    template<class U> void operator=(const Ptr<U>& rhs) {
+        this->invalidate();
+        this->set(static_cast<T*>(rhs.getUnsafe()));
+    };
+    /// copy-assign
+    void operator=(const WeakPtr<T>& rhs) {
+        if (rhs.block != this->block) {
+            this->invalidate();
+            this->block = rhs.block;
+            this->obj = rhs.obj;
+            if (this->block) {
+                this->block->addRef();
+            }
+        }
+    };
+    /// move-assign
+    void operator=(WeakPtr<T>&& rhs) {
+        if (&rhs != this) {
+            this->invalidate();
+            this->block = rhs.block;
+            this->obj = rhs.obj;
+            rhs.block = nullptr;
+            rhs.obj = nullptr;
+        }
+    };
+    /// assign nullptr (equivalent with invalidate())
+    void operator=(std::nullptr_t) {
+        this->invalidate();
+    };
+
+    /// get a Ptr to the object, invalid if the object has been destroyed
+    Ptr<T> lock() const {
+        Ptr<T> ptr;
+        if (this->block) {
+            this->block->lock();
+            if (this->block->obj && this->obj->tryAddRef()) {
+                ptr = Ptr<T>::adopt(this->obj);
+            }
+            this->block->unlock();
+        }
+        return ptr;
+    };
+    /// return true if the object has been destroyed (or the WeakPtr is empty)
+    bool expired() const {
+        if (this->block) {
+            this->block->lock();
+            const bool res = nullptr == this->block->obj;
+            this->block->unlock();
+            return res;
+        }
+        return true;
+    };
+    /// clear the WeakPtr
+    void invalidate() {
+        if (this->block) {
+            this->block->release();
+            this->block = nullptr;
+            this->obj = nullptr;
+        }
+    };
+
+private:
+    /// point to a new object
+    void set(T* ptr) {
+        if (ptr) {
+            this->block = ptr->weakBlock();
+            this->block->addRef();
+            this->obj = ptr;
+        }
+    };
+
+    _priv::weakRefBlock* block;
+    T* obj;
+};
+
+} // namespace Oryol
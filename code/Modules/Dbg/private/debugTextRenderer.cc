@@ -5,6 +5,8 @@
 #include "debugTextRenderer.h"
 #include "Gfx/Gfx.h"
 #include "DebugShaders.h"
+#include "Core/Trace.h"
+#include "Core/Memory/Memory.h"
 
 #if ORYOL_HAS_THREADS
 #include <mutex>
@@ -113,16 +115,26 @@ debugTextRenderer::drawTextBuffer() {
         Gfx::PopResourceLabel();
     }
     
-    // get the currently accumulated string
-    String str;
+    // get the currently accumulated string, the copy lives in
+    // frame memory, so that this doesn't call malloc each frame
+    int len = 0;
+    char* str = nullptr;
     {
         SCOPED_LOCK;
-        str = this->stringBuilder.GetString();
+        len = this->stringBuilder.Length();
+        if (len > this->maxNumChars) {
+            len = this->maxNumChars;
+        }
+        str = (char*) Memory::Alloc(len + 1, MemoryTag::Frame);
+        Memory::Copy(this->stringBuilder.AsCStr(), str, len);
+        str[len] = 0;
         this->stringBuilder.Clear();
     }
     
     // convert string into vertices
-    this->convertStringToVertices(str);
+    this->convertStringToVertices(str, len);
+    Memory::Free(str);
+    o_trace_counter(Dbg_TextVertices, this->curNumVertices);
 
     // draw the vertices
     if (this->curNumVertices > 0) {
@@ -237,7 +249,7 @@ debugTextRenderer::addVertex(uint8_t x, uint8_t y, uint8_t u, uint8_t v, uint32_
 
 //------------------------------------------------------------------------------
 void
-debugTextRenderer::convertStringToVertices(const String& str) {
+debugTextRenderer::convertStringToVertices(const char* str, int len) {
 
     int cursorX = 0;
     int cursorY = 0;
@@ -245,8 +257,8 @@ debugTextRenderer::convertStringToVertices(const String& str) {
     const int cursorMaxY = this->numRows - 1;
     uint32_t rgba = 0xFF00FFFF;
     
-    const int numChars = str.Length() > this->maxNumChars ? this->maxNumChars : str.Length();
-    const char* ptr = str.AsCStr();
+    const int numChars = len > this->maxNumChars ? this->maxNumChars : len;
+    const char* ptr = str;
     for (int charIndex = 0; charIndex < numChars; charIndex++) {
         unsigned char c = (unsigned char) ptr[charIndex];
         
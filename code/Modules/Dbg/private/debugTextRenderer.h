@@ -44,8 +44,8 @@ public:
     void setupMesh();
     /// setup the text pipeline state object (happens deferred)
     void  setupPipeline();
-    /// convert the provides string object into vertices, and return number of vertices
-    void convertStringToVertices(const String& str);
+    /// convert the provided string into vertices
+    void convertStringToVertices(const char* str, int len);
     /// write one glyph vertex, returns next vertex index
     void addVertex(uint8_t x, uint8_t y, uint8_t u, uint8_t v, uint32_t rgba);
     
@@ -31,6 +31,7 @@ namespace {
 void
 Gfx::Setup(const class GfxSetup& setup) {
     o_assert_dbg(!IsValid());
+    Memory::ScopedTag memTag(MemoryTag::Gfx);
     state = Memory::New<_state>();
     state->gfxSetup = setup;
 
@@ -48,6 +49,7 @@ Gfx::Setup(const class GfxSetup& setup) {
     state->renderer.setup(setup, pointers);
     state->resourceContainer.setup(setup, pointers);
     state->runLoopId = Core::PreRunLoop()->Add([] {
+        Memory::ScopedTag memTag(MemoryTag::Gfx);
         state->displayManager.ProcessSystemEvents();
     });
     state->gfxFrameInfo = GfxFrameInfo();
@@ -274,6 +276,7 @@ Gfx::PopResourceLabel() {
 Id
 Gfx::LoadResource(const Ptr<ResourceLoader>& loader) {
     o_assert_dbg(IsValid());
+    Memory::ScopedTag memTag(MemoryTag::Gfx);
     return state->resourceContainer.Load(loader);
 }
 
@@ -343,8 +346,14 @@ Gfx::CommitFrame() {
     o_trace_scoped(Gfx_CommitFrame);
     o_assert_dbg(IsValid());
     o_assert_dbg(!state->inPass);
+    Memory::ScopedTag memTag(MemoryTag::Gfx);
+    o_trace_counter(Gfx_NumDraw, state->gfxFrameInfo.NumDraw + state->gfxFrameInfo.NumDrawInstanced);
+    o_trace_counter(Gfx_NumApplyDrawState, state->gfxFrameInfo.NumApplyDrawState);
     state->renderer.commitFrame();
-    state->displayManager.Present();
+    {
+        o_trace_scoped(Gfx_Present);
+        state->displayManager.Present();
+    }
     state->resourceContainer.GarbageCollect();
     state->gfxFrameInfo = GfxFrameInfo();
 }
@@ -641,6 +650,7 @@ Gfx::validateShaderSetup(const ShaderSetup& setup) {
 template<> Id
 Gfx::CreateResource(const TextureSetup& setup, const void* data, int size) {
     o_assert_dbg(IsValid());
+    Memory::ScopedTag memTag(MemoryTag::Gfx);
     #if ORYOL_DEBUG
     validateTextureSetup(setup, data, size);
     #endif
@@ -651,6 +661,7 @@ Gfx::CreateResource(const TextureSetup& setup, const void* data, int size) {
 template<> Id
 Gfx::CreateResource(const MeshSetup& setup, const void* data, int size) {
     o_assert_dbg(IsValid());
+    Memory::ScopedTag memTag(MemoryTag::Gfx);
     #if ORYOL_DEBUG
     validateMeshSetup(setup, data, size);
     #endif
@@ -661,6 +672,7 @@ Gfx::CreateResource(const MeshSetup& setup, const void* data, int size) {
 template<> Id
 Gfx::CreateResource(const ShaderSetup& setup, const void* data, int size) {
     o_assert_dbg(IsValid());
+    Memory::ScopedTag memTag(MemoryTag::Gfx);
     #if ORYOL_DEBUG
     validateShaderSetup(setup);
     #endif
@@ -671,6 +683,7 @@ Gfx::CreateResource(const ShaderSetup& setup, const void* data, int size) {
 template<> Id
 Gfx::CreateResource(const PipelineSetup& setup, const void* data, int size) {
     o_assert_dbg(IsValid());
+    Memory::ScopedTag memTag(MemoryTag::Gfx);
     #if ORYOL_DEBUG
     validatePipelineSetup(setup);
     #endif
@@ -681,6 +694,7 @@ Gfx::CreateResource(const PipelineSetup& setup, const void* data, int size) {
 template<> Id
 Gfx::CreateResource(const PassSetup& setup, const void* data, int size) {
     o_assert_dbg(IsValid());
+    Memory::ScopedTag memTag(MemoryTag::Gfx);
     #if ORYOL_DEBUG
     validatePassSetup(setup);
     #endif
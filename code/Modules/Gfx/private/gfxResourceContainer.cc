@@ -5,6 +5,7 @@
 #include "Core/Core.h"
 #include "gfxResourceContainer.h"
 #include "displayMgr.h"
+#include "Core/Trace.h"
 
 namespace Oryol {
 namespace _priv {
@@ -41,6 +42,12 @@ gfxResourceContainer::discard() {
         loader->Cancel();
     }
     this->pendingLoaders.Clear();
+    for (const auto& loader : this->waitingLoaders) {
+        loader->Cancel();
+        loader->SetReadyFunc(ResourceLoader::ReadyFunc());
+    }
+    this->waitingLoaders.Clear();
+    this->readyLoaders.Clear();
     
     ResourceContainerBase::Discard();
 
@@ -269,7 +276,15 @@ gfxResourceContainer::Load(const Ptr<ResourceLoader>& loader) {
         return resId;
     }
     else {
-        this->pendingLoaders.Add(loader);
+        if (loader->IsEventDriven()) {
+            loader->SetReadyFunc([this](const Ptr<ResourceLoader>& readyLoader) {
+                this->readyLoaders.Add(readyLoader);
+            });
+            this->waitingLoaders.Add(loader);
+        }
+        else {
+            this->pendingLoaders.Add(loader);
+        }
         resId = loader->Start();
         return resId;
     }
@@ -381,6 +396,7 @@ gfxResourceContainer::Destroy(const ResourceLabel& label) {
 //------------------------------------------------------------------------------
 void
 gfxResourceContainer::update() {
+    o_trace_scoped(Gfx_ResourceUpdate);
     o_assert_dbg(this->IsValid());
     
     /// call update method on resource pools (this is cheap)
@@ -389,14 +405,31 @@ gfxResourceContainer::update() {
     this->texturePool.Update();
     this->pipelinePool.Update();
 
-    // trigger loaders, and remove from pending array if finished
+    // trigger polled loaders, and remove from pending array if finished
     for (int i = this->pendingLoaders.Size() - 1; i >= 0; i--) {
-        const auto& loader = this->pendingLoaders[i];
-        ResourceState::Code state = loader->Continue();
-        if (ResourceState::Pending != state) {
+        if (this->continueLoader(this->pendingLoaders[i])) {
             this->pendingLoaders.Erase(i);
         }
     }
+
+    // only trigger event-driven loaders which have signalled that
+    // they are ready, this is cheap even with many loaders in flight
+    if (!this->readyLoaders.Empty()) {
+        Array<Ptr<ResourceLoader>> ready(std::move(this->readyLoaders));
+        for (const auto& loader : ready) {
+            if (this->waitingLoaders.Contains(loader) && this->continueLoader(loader)) {
+                loader->SetReadyFunc(ResourceLoader::ReadyFunc());
+                this->waitingLoaders.Erase(loader);
+            }
+        }
+    }
+    o_trace_counter(Gfx_PendingLoaders, this->pendingLoaders.Size() + this->waitingLoaders.Size());
+}
+
+//------------------------------------------------------------------------------
+bool
+gfxResourceContainer::continueLoader(const Ptr<ResourceLoader>& loader) {
+    return ResourceState::Pending != loader->Continue();
 }
 
 //------------------------------------------------------------------------------
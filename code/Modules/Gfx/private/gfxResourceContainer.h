@@ -7,6 +7,7 @@
 */
 #include "Core/RunLoop.h"
 #include "Core/Containers/Array.h"
+#include "Core/Containers/FlatHashSet.h"
 #include "Resource/ResourceLoader.h"
 #include "Resource/ResourceContainerBase.h"
 #include "Resource/ResourceInfo.h"
@@ -65,6 +66,8 @@ public:
 
     /// per-frame update (update resource pools and pending loaders)
     void update();
+    /// continue a loader, return true if the loader has finished
+    bool continueLoader(const Ptr<ResourceLoader>& loader);
     /// destroy a single resource
     void destroyResource(const Id& id);
 
@@ -76,7 +79,14 @@ public:
     class pipelinePool pipelinePool;
     class renderPassPool renderPassPool;
     RunLoop::Id runLoopId = RunLoop::InvalidId;
-    Array<Ptr<ResourceLoader>> pendingLoaders;
+    Array<Ptr<ResourceLoader>> pendingLoaders;      // polled each frame
+    struct loaderHasher {
+        int32_t operator()(const Ptr<ResourceLoader>& loader) const {
+            return int32_t(uintptr_t(loader.get()) >> 4);
+        };
+    };
+    FlatHashSet<Ptr<ResourceLoader>, loaderHasher> waitingLoaders;  // event-driven
+    Array<Ptr<ResourceLoader>> readyLoaders;        // signalled since last update
     Array<Id> destroyQueue;
 };
 
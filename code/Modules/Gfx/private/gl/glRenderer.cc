@@ -10,6 +10,7 @@
 #include "glRenderer.h"
 #include "glTypes.h"
 #include "glCaps.h"
+#include "Core/Trace.h"
 #include "glm/vec4.hpp"
 #include "glm/gtc/type_ptr.hpp"
 
@@ -197,6 +198,10 @@ glRenderer::queryFeature(GfxFeature::Code feat) const {
 void
 glRenderer::commitFrame() {
     o_assert_dbg(this->valid);
+    o_trace_counter(Gfx_StatesApplied, this->numStatesApplied);
+    o_trace_counter(Gfx_StatesSkipped, this->numStatesSkipped);
+    this->numStatesApplied = 0;
+    this->numStatesSkipped = 0;
     this->rpValid = false;
     this->curRenderPass = nullptr;
     this->curPipeline = nullptr;
@@ -408,6 +413,7 @@ glRenderer::endPass() {
 //------------------------------------------------------------------------------
 void
 glRenderer::applyDrawState(pipeline* pip, mesh** meshes, int numMeshes) {
+    o_trace_scoped(glRenderer_ApplyDrawState);
     o_assert_dbg(this->valid);
     o_assert_dbg(pip);
     o_assert_dbg(meshes && (numMeshes > 0));
@@ -491,6 +497,10 @@ glRenderer::applyDrawState(pipeline* pip, mesh** meshes, int numMeshes) {
         if (depthStencilChanged || frontChanged || backChanged) {
             this->depthStencilState = newState;
         }
+        this->numStatesApplied++;
+    }
+    else {
+        this->numStatesSkipped++;
     }
     if (setup.BlendState != this->blendState) {
 
@@ -534,11 +544,19 @@ glRenderer::applyDrawState(pipeline* pip, mesh** meshes, int numMeshes) {
         }
         
         this->blendState = newState;
+        this->numStatesApplied++;
         ORYOL_GL_CHECK_ERROR();
     }
+    else {
+        this->numStatesSkipped++;
+    }
     if (setup.BlendColor != this->blendColor) {
         this->blendColor = setup.BlendColor;
         ::glBlendColor(this->blendColor.x, this->blendColor.y, this->blendColor.z, this->blendColor.w);
+        this->numStatesApplied++;
+    }
+    else {
+        this->numStatesSkipped++;
     }
     if (setup.RasterizerState != this->rasterizerState) {
 
@@ -573,10 +591,20 @@ glRenderer::applyDrawState(pipeline* pip, mesh** meshes, int numMeshes) {
         }
         #endif
         this->rasterizerState = newState;
+        this->numStatesApplied++;
         ORYOL_GL_CHECK_ERROR();
     }
+    else {
+        this->numStatesSkipped++;
+    }
 
     // bind program and uniform buffers
+    if (pip->shd->glProgram != this->program) {
+        this->numStatesApplied++;
+    }
+    else {
+        this->numStatesSkipped++;
+    }
     this->useProgram(pip->shd->glProgram);
 
     // need to store primary mesh with primitive group defs for later draw call
@@ -620,6 +648,10 @@ glRenderer::applyDrawState(pipeline* pip, mesh** meshes, int numMeshes) {
                 ORYOL_GL_CHECK_ERROR();
             }
             curAttr = attr;
+            this->numStatesApplied++;
+        }
+        else {
+            this->numStatesSkipped++;
         }
     }
     #else
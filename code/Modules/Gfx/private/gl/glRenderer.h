@@ -132,6 +132,10 @@ public:
     GLuint vertexBuffer = 0;
     GLuint indexBuffer = 0;
     GLuint program = 0;
+
+    // state cache stats, reset in commitFrame()
+    int numStatesApplied = 0;
+    int numStatesSkipped = 0;
     
     static const int MaxTextureSamplers = 16;
     StaticArray<GLuint, MaxTextureSamplers> samplers;
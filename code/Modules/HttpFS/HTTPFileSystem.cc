@@ -3,16 +3,65 @@
 //------------------------------------------------------------------------------
 #include "Pre.h"
 #include "HTTPFileSystem.h"
+#include "IO/private/ioDiskCache.h"
 
 namespace Oryol {
-    
+
+using namespace _priv;
+
 //------------------------------------------------------------------------------
 void
 HTTPFileSystem::onMsg(const Ptr<IORequest>& ioReq) {
     Ptr<IORead> ioReadRequest = ioReq->DynamicCast<IORead>();
     if (ioReadRequest.isValid()) {
+        #if ORYOL_HAS_THREADS
+        // NOTE: the emscripten loader is asynchronous, and the disk
+        // cache isn't used there (the browser has its own cache)
+        if (ioDiskCache::isValid() &&
+            (0 == ioReadRequest->StartOffset) &&
+            (EndOfFile == ioReadRequest->EndOffset) &&
+            (ioReadRequest->CacheReadEnabled || ioReadRequest->CacheWriteEnabled)) {
+            this->doCachedRequest(ioReadRequest);
+            return;
+        }
+        #endif
         this->loader.doRequest(ioReadRequest);
     }
 }
 
+//------------------------------------------------------------------------------
+void
+HTTPFileSystem::doCachedRequest(const Ptr<IORead>& ioReq) {
+    // the loader runs on a private request, so that the original
+    // request only becomes Handled once the final result is in place,
+    // cancelling the original request aborts the private request
+    Ptr<IORead> loadReq = IORead::Create();
+    loadReq->Url = ioReq->Url;
+    loadReq->CancelSource = ioReq.get();
+    String cachedValidator;
+    Buffer cachedData;
+    if (ioReq->CacheReadEnabled && ioDiskCache::lookup(ioReq->Url.Get(), cachedValidator, cachedData)) {
+        loadReq->CacheValidator = cachedValidator;
+    }
+    this->loader.doRequest(loadReq);
+
+    if ((IOStatus::NotModified == loadReq->Status) && !cachedValidator.Empty()) {
+        ioDiskCache::countHit();
+        ioReq->Status = IOStatus::OK;
+        ioReq->Data = std::move(cachedData);
+        ioReq->CacheValidator = cachedValidator;
+    }
+    else {
+        if ((IOStatus::OK == loadReq->Status) && loadReq->ErrorDesc.Empty() &&
+            ioReq->CacheWriteEnabled && !loadReq->CacheValidator.Empty()) {
+            ioDiskCache::store(ioReq->Url.Get(), loadReq->CacheValidator, loadReq->Data.Data(), loadReq->Data.Size());
+        }
+        ioReq->Status = loadReq->Status;
+        ioReq->Data = std::move(loadReq->Data);
+        ioReq->ErrorDesc = loadReq->ErrorDesc;
+        ioReq->CacheValidator = loadReq->CacheValidator;
+    }
+    ioReq->Handled = true;
+}
+
 } // namespace Oryol
@@ -9,7 +9,11 @@
     @brief implements a simple HTTP-based filesystem
     @see HTTPClient, FileSystem
     
-    @todo: HTTPFileSystem description
+    If the IO module has been setup with a DiskCachePath, complete
+    reads which have CacheReadEnabled or CacheWriteEnabled set go
+    through the disk cache: a cached response is revalidated with
+    the server (If-None-Match / If-Modified-Since), and only used if
+    the server answers with NotModified.
 */
 #include "IO/FileSystemBase.h"
 #include "Core/Creator.h"
@@ -25,6 +29,9 @@ public:
     virtual void onMsg(const Ptr<IORequest>& ioReq) override;
 
 private:
+    /// process a read request through the IO disk cache
+    void doCachedRequest(const Ptr<IORead>& ioReq);
+
     _priv::urlLoader loader;
 };
     
@@ -8,9 +8,59 @@
 #include "Core/RunLoop.h"
 #include "HttpFS/HTTPFileSystem.h"
 #include "IO/IO.h"
+#include "Core/String/StringBuilder.h"
+#include <cstring>
+#if ORYOL_USE_LIBCURL
+#include "HttpFS/private/curl/curlURLLoader.h"
+#endif
+#if ORYOL_POSIX && !ORYOL_EMSCRIPTEN
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#endif
 
 using namespace Oryol;
 
+#if ORYOL_USE_LIBCURL
+//------------------------------------------------------------------------------
+static void feedHeader(const Ptr<IORead>& req, const char* header) {
+    _priv::curlURLLoader::curlHeaderCallback((char*)header, 1, std::strlen(header), req.get());
+}
+
+//------------------------------------------------------------------------------
+TEST(HTTPFileSystemCacheValidatorTest) {
+    using _priv::curlURLLoader;
+
+    // a Last-Modified date on a Wednesday is not an ETag
+    CHECK(curlURLLoader::isETagValidator("\"abc\""));
+    CHECK(curlURLLoader::isETagValidator("W/\"abc\""));
+    CHECK(!curlURLLoader::isETagValidator("Wed, 21 Oct 2015 07:28:00 GMT"));
+    CHECK(!curlURLLoader::isETagValidator(""));
+
+    // a Wednesday date is captured as validator
+    Ptr<IORead> req = IORead::Create();
+    feedHeader(req, "Last-Modified: Wed, 21 Oct 2015 07:28:00 GMT\r\n");
+    CHECK(req->CacheValidator == "Wed, 21 Oct 2015 07:28:00 GMT");
+
+    // an ETag wins over an earlier Last-Modified
+    feedHeader(req, "ETag: W/\"weak-1\"\r\n");
+    CHECK(req->CacheValidator == "W/\"weak-1\"");
+
+    // ...and a later Last-Modified doesn't replace a (weak or strong) ETag
+    feedHeader(req, "Last-Modified: Wed, 21 Oct 2015 07:28:00 GMT\r\n");
+    CHECK(req->CacheValidator == "W/\"weak-1\"");
+    req->CacheValidator.Clear();
+    feedHeader(req, "etag: \"strong-1\"\r\n");
+    feedHeader(req, "Last-Modified: Wed, 21 Oct 2015 07:28:00 GMT\r\n");
+    CHECK(req->CacheValidator == "\"strong-1\"");
+}
+#endif
+
 #if !ORYOL_EMSCRIPTEN && !ORYOL_UNITTESTS_HEADLESS
 TEST(HTTPFileSystemTest) {
     Core::Setup();
@@ -42,3 +92,99 @@ TEST(HTTPFileSystemTest) {
     Core::Discard();
 }
 #endif
+
+#if ORYOL_POSIX && !ORYOL_EMSCRIPTEN && !ORYOL_UNITTESTS_HEADLESS
+namespace {
+
+// a minimal local http server which trickles out a big response body
+// until the client closes the connection
+const int bodySize = 64 * 1024 * 1024;
+std::atomic<int> serverBytesSent{0};
+
+void serveSlowBody(int listenSocket) {
+    int s = accept(listenSocket, nullptr, nullptr);
+    if (s >= 0) {
+        // skip the request header
+        char buf[4096];
+        int headerLen = 0;
+        while (headerLen < int(sizeof(buf) - 1)) {
+            int len = int(recv(s, buf + headerLen, sizeof(buf) - 1 - headerLen, 0));
+            if (len <= 0) {
+                break;
+            }
+            headerLen += len;
+            buf[headerLen] = 0;
+            if (std::strstr(buf, "\r\n\r\n")) {
+                break;
+            }
+        }
+        std::snprintf(buf, sizeof(buf),
+            "HTTP/1.1 200 OK\r\nContent-Length: %d\r\nETag: \"cancel-test\"\r\n\r\n", bodySize);
+        send(s, buf, std::strlen(buf), MSG_NOSIGNAL);
+        std::memset(buf, 'x', sizeof(buf));
+        while (serverBytesSent < bodySize) {
+            if (send(s, buf, sizeof(buf), MSG_NOSIGNAL) <= 0) {
+                break;
+            }
+            serverBytesSent += int(sizeof(buf));
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        close(s);
+    }
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+TEST(HTTPFileSystemCachedCancelTest) {
+    // start the local server
+    int listenSocket = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    CHECK(0 == bind(listenSocket, (sockaddr*)&addr, sizeof(addr)));
+    CHECK(0 == listen(listenSocket, 1));
+    socklen_t addrLen = sizeof(addr);
+    getsockname(listenSocket, (sockaddr*)&addr, &addrLen);
+    std::thread serverThread(serveSlowBody, listenSocket);
+
+    Core::Setup();
+    IOSetup ioSetup;
+    ioSetup.FileSystems.Add("http", HTTPFileSystem::Creator());
+    ioSetup.DiskCachePath = "oryol_http_cancel_test_cache";
+    IO::Setup(ioSetup);
+
+    // put a read which goes through the disk cache, and cancel it
+    // once the transfer is running
+    StringBuilder url;
+    url.Format(128, "http://127.0.0.1:%d/big.bin", int(ntohs(addr.sin_port)));
+    Ptr<IORead> req = IORead::Create();
+    req->Url = url.GetString();
+    req->CacheWriteEnabled = true;
+    IO::Put(req);
+    while (0 == serverBytesSent) {
+        Core::PreRunLoop()->Run();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    req->Cancel();
+
+    // the transfer must be aborted at the next chunk, long before
+    // the whole body has been sent
+    while (!req->Handled) {
+        Core::PreRunLoop()->Run();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK(req->Status == IOStatus::Cancelled);
+    CHECK(req->Data.Empty());
+    serverThread.join();
+    CHECK(serverBytesSent < bodySize);
+    close(listenSocket);
+
+    req = nullptr;
+    IO::Discard();
+    Core::Discard();
+    std::remove("oryol_http_cancel_test_cache");
+}
+#endif
@@ -12,7 +12,7 @@ bool
 baseURLLoader::doRequest(const Ptr<IORead>& ioReq) {
     // process one IO request, implement the actual downloading
     // in a subclass, we only handle the cancelled flag here
-    if (ioReq->Cancelled) {
+    if (ioReq->IsCancelled()) {
         ioReq->Status = IOStatus::Cancelled;
         ioReq->Handled = true;
         return false;
@@ -4,9 +4,12 @@
 #include "Pre.h"
 #include "curlURLLoader.h"
 #include "Core/String/StringConverter.h"
+#include "Core/String/StringBuilder.h"
 #include "Core/Containers/Buffer.h"
 #include "curl/curl.h"
 #include <mutex>
+#include <cstring>
+#include <cctype>
 
 #if LIBCURL_VERSION_NUM != 0x072400
 #error "Not using the right curl version, header search path fuckup?"
@@ -62,6 +65,7 @@ curlURLLoader::setupCurlSession() {
     curl_easy_setopt(this->curlSession, CURLOPT_NOPROGRESS, 1L);
     curl_easy_setopt(this->curlSession, CURLOPT_ERRORBUFFER, this->curlError);
     curl_easy_setopt(this->curlSession, CURLOPT_WRITEFUNCTION, curlWriteDataCallback);
+    curl_easy_setopt(this->curlSession, CURLOPT_HEADERFUNCTION, curlHeaderCallback);
     curl_easy_setopt(this->curlSession, CURLOPT_TCP_KEEPALIVE, 1L);
     curl_easy_setopt(this->curlSession, CURLOPT_TCP_KEEPIDLE, 10L);
     curl_easy_setopt(this->curlSession, CURLOPT_TCP_KEEPINTVL, 10L);
@@ -86,11 +90,12 @@ curlURLLoader::discardCurlSession() {
 //------------------------------------------------------------------------------
 size_t
 curlURLLoader::curlWriteDataCallback(char* ptr, size_t size, size_t nmemb, void* userData) {
-    // userData is expected to point to a Buffer object
+    // userData is expected to point to an IORead object, returning
+    // 0 for a cancelled request aborts the transfer
     int bytesToWrite = (int) (size * nmemb);
-    if (bytesToWrite > 0) {
-        Buffer* buf = (Buffer*) userData;
-        buf->Add((const uint8_t*)ptr, bytesToWrite);
+    IORead* req = (IORead*) userData;
+    if ((bytesToWrite > 0) && !req->IsCancelled()) {
+        req->Data.Add((const uint8_t*)ptr, bytesToWrite);
         return bytesToWrite;
     }
     else {
@@ -98,6 +103,65 @@ curlURLLoader::curlWriteDataCallback(char* ptr, size_t size, size_t nmemb, void*
     }
 }
 
+//------------------------------------------------------------------------------
+/**
+    Match a HTTP header name (case-insensitive), and return the start
+    index of the header value, or -1 if the header doesn't match.
+*/
+static int
+matchHeader(const char* ptr, int len, const char* name) {
+    const int nameLen = int(std::strlen(name));
+    if (len <= nameLen) {
+        return -1;
+    }
+    for (int i = 0; i < nameLen; i++) {
+        if (std::tolower(ptr[i]) != std::tolower(name[i])) {
+            return -1;
+        }
+    }
+    int start = nameLen;
+    while ((start < len) && (' ' == ptr[start])) {
+        start++;
+    }
+    return start;
+}
+
+//------------------------------------------------------------------------------
+bool
+curlURLLoader::isETagValidator(const String& validator) {
+    // NOTE: a Last-Modified date may start with a 'W' too (Wed, ...)
+    if (validator.Empty()) {
+        return false;
+    }
+    const char* str = validator.AsCStr();
+    return ('"' == str[0]) || (0 == std::strncmp(str, "W/\"", 3));
+}
+
+//------------------------------------------------------------------------------
+size_t
+curlURLLoader::curlHeaderCallback(char* ptr, size_t size, size_t nmemb, void* userData) {
+    // userData is expected to point to an IORead object, the ETag or
+    // Last-Modified header is captured as cache validator, an ETag
+    // always wins over Last-Modified
+    const int len = (int) (size * nmemb);
+    IORead* req = (IORead*) userData;
+    int start = matchHeader(ptr, len, "ETag:");
+    const bool isETag = start >= 0;
+    if (!isETag && !isETagValidator(req->CacheValidator)) {
+        start = matchHeader(ptr, len, "Last-Modified:");
+    }
+    if (start >= 0) {
+        int end = len;
+        while ((end > start) && (('\r' == ptr[end-1]) || ('\n' == ptr[end-1]) || (' ' == ptr[end-1]))) {
+            end--;
+        }
+        if (end > start) {
+            req->CacheValidator.Assign(ptr, start, end);
+        }
+    }
+    return len;
+}
+
 //------------------------------------------------------------------------------
 bool
 curlURLLoader::doRequest(const Ptr<IORead>& req) {
@@ -138,10 +202,22 @@ curlURLLoader::doRequestInternal(const Ptr<IORead>& req) {
     requestHeaders = curl_slist_append(requestHeaders, "User-Agent: Mozilla/5.0");
     requestHeaders = curl_slist_append(requestHeaders, "Connection: keep-alive");
     requestHeaders = curl_slist_append(requestHeaders, "Accept-Encoding: gzip, deflate");
+
+    // a conditional request if the IO disk cache has a validator, the
+    // validator is either an ETag (quoted, or W/"..."), or a date
+    const String validator = req->CacheValidator;
+    if (!validator.Empty()) {
+        StringBuilder strBuilder(isETagValidator(validator) ? "If-None-Match: " : "If-Modified-Since: ");
+        strBuilder.Append(validator);
+        requestHeaders = curl_slist_append(requestHeaders, strBuilder.AsCStr());
+    }
     curl_easy_setopt(this->curlSession, CURLOPT_HTTPHEADER, requestHeaders);
 
-    // prepare the HTTPResponse and the response-body stream
-    curl_easy_setopt(this->curlSession, CURLOPT_WRITEDATA, &(req->Data));
+    // prepare the response-body stream, and the header callback
+    // which captures the new cache validator
+    req->CacheValidator.Clear();
+    curl_easy_setopt(this->curlSession, CURLOPT_WRITEDATA, req.get());
+    curl_easy_setopt(this->curlSession, CURLOPT_HEADERDATA, req.get());
 
     // perform the request
     CURLcode performResult = curl_easy_perform(this->curlSession);
@@ -152,7 +228,12 @@ curlURLLoader::doRequestInternal(const Ptr<IORead>& req) {
     req->Status = (IOStatus::Code) curlHttpCode;
 
     // check for error codes
-    if (CURLE_PARTIAL_FILE == performResult) {
+    if (req->IsCancelled()) {
+        // aborted by the write-data callback
+        req->Data.Clear();
+        req->Status = IOStatus::Cancelled;
+    }
+    else if (CURLE_PARTIAL_FILE == performResult) {
         // this seems to happen quite often even though all data has been received,
         // not sure what to do about this, but don't treat it as an error
         Log::Warn("curlURLLoader: CURLE_PARTIAL_FILE received for '%s', httpStatus='%ld'\n", req->Url.AsCStr(), curlHttpCode);
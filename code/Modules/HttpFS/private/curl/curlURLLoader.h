@@ -30,6 +30,8 @@ public:
     static size_t curlWriteDataCallback(char* ptr, size_t size, size_t nmemb, void* userData);
     /// curl header-data callback
     static size_t curlHeaderCallback(char* ptr, size_t size, size_t nmenb, void* userData);
+    /// test if a cache validator is an ETag ("..." or W/"..."), not a Last-Modified date
+    static bool isETagValidator(const String& validator);
 
     void* curlSession;
     char* curlError;
@@ -10,33 +10,78 @@
 #include "IO/private/assignRegistry.h"
 #include "IO/private/schemeRegistry.h"
 #include "IO/private/loadQueue.h"
+#include "IO/private/ioCache.h"
+#include "IO/private/ioDiskCache.h"
 #include "Core/RunLoop.h"
+#include "Core/Trace.h"
+#include "Core/Replay.h"
+#include <cstring>
+#include <utility>
 
 namespace Oryol {
 
 using namespace _priv;
 
 namespace {
+    // a read response which was played back before its request was made
+    struct replayResponse {
+        StringAtom url;
+        IOStatus::Code status = IOStatus::InvalidIOStatus;
+        Buffer data;
+    };
+
     struct _state {
         _priv::assignRegistry assignReg;
         _priv::schemeRegistry schemeReg;
         _priv::ioRouter router;
         RunLoop::Id runLoopId = RunLoop::InvalidId;
         class loadQueue loadQueue;
+        _priv::ioCache cache;
+        bool cacheEnabled = false;
+        bool mapFilesEnabled = false;
+        // handled requests which haven't been dispatched yet
+        Array<Ptr<IORequest>> completed;
+        // requests which are currently dispatched (swapped with completed)
+        Array<Ptr<IORequest>> dispatching;
+        // requests which a filesystem completes asynchronously
+        Array<Ptr<IORequest>> asyncRequests;
+        Replay::ChannelId replayChannel = Replay::InvalidChannelId;
+        // playback: reads waiting for their recorded response
+        Array<Ptr<IORead>> replayPendingReads;
+        Array<replayResponse> replayEarlyResponses;
+        // playback: number of recorded responses per URL not yet claimed by a read
+        Map<StringAtom, int> replayNumResponses;
     };
     _state* state = nullptr;
+
+    // a replay record is the read status, the URL length, the URL and the data
+    struct replayHeader {
+        int32_t status;
+        int32_t urlLength;
+    };
+
+    //--------------------------------------------------------------------------
+    bool
+    parseReplayRecord(const uint8_t* data, int size, replayHeader& outHdr) {
+        if (size < int(sizeof(outHdr))) {
+            return false;
+        }
+        std::memcpy(&outHdr, data, sizeof(outHdr));
+        return (outHdr.urlLength >= 0) && ((int(sizeof(outHdr)) + outHdr.urlLength) <= size);
+    }
 }
 
 //------------------------------------------------------------------------------
 void
 IO::Setup(const IOSetup& setup) {
     o_assert(!IsValid());
+    Memory::ScopedTag memTag(MemoryTag::IO);
 
     state = Memory::New<_state>();
     ioPointers ptrs;
     ptrs.schemeRegistry = &state->schemeReg;
     ptrs.assignRegistry = &state->assignReg;
-    state->router.setup(ptrs);
+    state->router.setup(setup, ptrs);
 
     // setup initial assigns
     for (const auto& assign : setup.Assigns) {
@@ -48,15 +93,50 @@ IO::Setup(const IOSetup& setup) {
         RegisterFileSystem(fs.Key(), fs.Value());
     }
 
+    // setup the read caches
+    state->cache.setup(setup.CacheMaxBytes);
+    state->cacheEnabled = setup.CacheEnabled;
+    state->mapFilesEnabled = setup.MapFilesEnabled;
+    if (!setup.DiskCachePath.Empty()) {
+        ioDiskCache::setup(setup.DiskCachePath);
+    }
+
     state->runLoopId = Core::PreRunLoop()->Add([] { doWork(); });
+
+    // record or play back read responses for deterministic replays
+    state->replayChannel = Replay::RegisterChannel("IO");
+    if (Replay::IsPlaying()) {
+        Replay::SetPlaybackHandler(state->replayChannel, [](const uint8_t* data, int size) {
+            playbackRead(data, size);
+        });
+        // count the recorded responses, so that reads which have
+        // no recorded response don't wait for one forever
+        Replay::PeekRecords(state->replayChannel, [](const uint8_t* data, int size) {
+            replayHeader hdr;
+            if (parseReplayRecord(data, size, hdr)) {
+                const StringAtom url(String((const char*)data + sizeof(hdr), 0, hdr.urlLength));
+                if (state->replayNumResponses.Contains(url)) {
+                    state->replayNumResponses[url]++;
+                }
+                else {
+                    state->replayNumResponses.Add(url, 1);
+                }
+            }
+        });
+    }
 }
 
 //------------------------------------------------------------------------------
 void
 IO::Discard() {
     o_assert(IsValid());
+    Replay::ClearPlaybackHandler(state->replayChannel);
     Core::PreRunLoop()->Remove(state->runLoopId);
     state->router.discard();
+    if (ioDiskCache::isValid()) {
+        ioDiskCache::discard();
+    }
+    state->cache.discard();
     Memory::Delete(state);
     state = nullptr;
 }
@@ -64,10 +144,89 @@ IO::Discard() {
 //------------------------------------------------------------------------------
 void
 IO::doWork() {
+    o_trace_scoped(IO_DoWork);
     o_assert_dbg(IsValid());
     o_assert_dbg(Core::IsMainThread());
-    state->router.doWork();
-    state->loadQueue.update();
+    {
+        Memory::ScopedTag memTag(MemoryTag::IO);
+        state->router.doWork();
+        state->router.takeCompleted(state->completed);
+    }
+    if (!state->asyncRequests.Empty()) {
+        pollAsyncRequests();
+    }
+    if (!state->replayPendingReads.Empty() && (!Replay::IsPlaying() || Replay::PlaybackFinished())) {
+        // the replay is over, reads without a recorded response
+        // go to the filesystems
+        o_warn("IO: %d reads without recorded response, loading from filesystem\n",
+            state->replayPendingReads.Size());
+        for (const auto& ioReq : state->replayPendingReads) {
+            state->router.put(ioReq);
+        }
+        state->replayPendingReads.Clear();
+    }
+    if (!state->completed.Empty()) {
+        dispatchCompleted();
+    }
+    o_trace_counter(IO_LoadQueuePending, state->loadQueue.numPending());
+}
+
+//------------------------------------------------------------------------------
+/**
+    Handle all requests which have completed since the last frame: put
+    read results into the memory cache and the replay recording, and
+    call the completion callbacks. Requests which are completed from
+    inside a callback are dispatched in the next frame.
+*/
+void
+IO::dispatchCompleted() {
+    o_trace_scoped(IO_DispatchCompleted);
+    // swap instead of moving into a local array, so that both
+    // arrays keep their capacity and don't allocate each frame
+    o_assert_dbg(state->dispatching.Empty());
+    std::swap(state->dispatching, state->completed);
+    for (auto& ioReq : state->dispatching) {
+        if (!ioReq->Handled) {
+            // the filesystem will complete the request later
+            state->asyncRequests.Add(std::move(ioReq));
+            continue;
+        }
+        if (ioReq->IsA<IORead>()) {
+            const Ptr<IORead>& ioRead = ioReq.unsafeCast<IORead>();
+            if (Replay::IsRecording()) {
+                recordRead(ioRead);
+            }
+            if (ioRead->CacheWriteEnabled && isCacheable(ioRead)) {
+                writeCache(ioRead);
+            }
+        }
+        if (ioReq->OnCompleted) {
+            // clear the callback before calling it, it may own
+            // references which point back to the request
+            IORequest::CompletedFunc onCompleted(std::move(ioReq->OnCompleted));
+            ioReq->OnCompleted = nullptr;
+            onCompleted(ioReq);
+        }
+    }
+    state->dispatching.Clear();
+}
+
+//------------------------------------------------------------------------------
+/**
+    Some filesystems (e.g. on emscripten) return before the request is
+    handled, those requests need to be polled, but only those.
+*/
+void
+IO::pollAsyncRequests() {
+    for (int i = 0; i < state->asyncRequests.Size(); ) {
+        if (state->asyncRequests[i]->Handled) {
+            state->completed.Add(std::move(state->asyncRequests[i]));
+            state->asyncRequests.EraseSwap(i);
+        }
+        else {
+            i++;
+        }
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -162,10 +321,21 @@ IO::NumPendingLoads() {
 //------------------------------------------------------------------------------
 Ptr<IORead>
 IO::LoadFile(const URL& url) {
+    return LoadFile(url, IORequest::CompletedFunc());
+}
+
+//------------------------------------------------------------------------------
+Ptr<IORead>
+IO::LoadFile(const URL& url, IORequest::CompletedFunc onCompleted) {
     o_assert_dbg(IsValid());
+    Memory::ScopedTag memTag(MemoryTag::IO);
     Ptr<IORead> ioReq = IORead::Create();
     ioReq->Url = url;
-    state->router.put(ioReq);
+    ioReq->CacheReadEnabled = state->cacheEnabled;
+    ioReq->CacheWriteEnabled = state->cacheEnabled;
+    ioReq->MapEnabled = state->mapFilesEnabled;
+    ioReq->OnCompleted = std::move(onCompleted);
+    Put(ioReq);
     return ioReq;
 }
 
@@ -173,10 +343,11 @@ IO::LoadFile(const URL& url) {
 Ptr<IOWrite>
 IO::WriteFile(const URL& url, const Buffer& data) {
     o_assert_dbg(IsValid());
+    Memory::ScopedTag memTag(MemoryTag::IO);
     Ptr<IOWrite> ioReq = IOWrite::Create();
     ioReq->Url = url;
     ioReq->Data.Add(data.Data(), data.Size());
-    state->router.put(ioReq);
+    Put(ioReq);
     return ioReq;
 }
 
@@ -184,7 +355,175 @@ IO::WriteFile(const URL& url, const Buffer& data) {
 void
 IO::Put(const Ptr<IORequest>& ioReq) {
     o_assert_dbg(IsValid());
+    Memory::ScopedTag memTag(MemoryTag::IO);
+    if (ioReq->IsA<IORead>() && Replay::IsPlaying()) {
+        // wait for the recorded response, unless it has already been played back,
+        // each read claims one of the recorded responses of its URL
+        Ptr<IORead> ioRead = ioReq->DynamicCast<IORead>();
+        const StringAtom& url = ioRead->Url.Get();
+        const int numResponses = state->replayNumResponses.Contains(url) ? state->replayNumResponses[url] : 0;
+        if (numResponses > 0) {
+            state->replayNumResponses[url] = numResponses - 1;
+            for (int i = 0; i < state->replayEarlyResponses.Size(); i++) {
+                replayResponse& resp = state->replayEarlyResponses[i];
+                if (resp.url == url) {
+                    ioRead->Status = resp.status;
+                    ioRead->Data = std::move(resp.data);
+                    ioRead->Handled = true;
+                    state->replayEarlyResponses.Erase(i);
+                    state->completed.Add(ioRead);
+                    return;
+                }
+            }
+            state->replayPendingReads.Add(ioRead);
+            return;
+        }
+        // no recorded response left for this URL
+        o_warn("IO: no recorded response for '%s', loading from filesystem\n", url.AsCStr());
+    }
+    if (ioReq->IsA<IORead>()) {
+        const Ptr<IORead>& ioRead = ioReq.unsafeCast<IORead>();
+        if ((ioRead->CacheReadEnabled || ioRead->CacheWriteEnabled) && isCacheable(ioRead)) {
+            // serve the read from the memory cache without going through a filesystem
+            if (ioRead->CacheReadEnabled && state->cache.lookup(ioRead->Url.Get(), ioRead->Data)) {
+                ioRead->Status = IOStatus::OK;
+                ioRead->MemoryCacheHit = true;
+                ioRead->Handled = true;
+                state->completed.Add(ioReq);
+                return;
+            }
+        }
+    }
+    else if (ioReq->IsA<IOWrite>()) {
+        // a write makes the cached content of the URL stale
+        state->cache.remove(ioReq->Url.Get());
+    }
     state->router.put(ioReq);
 }
 
+//------------------------------------------------------------------------------
+bool
+IO::isCacheable(const Ptr<IORead>& ioRead) {
+    // only complete file reads are cached
+    return (0 == ioRead->StartOffset) && (EndOfFile == ioRead->EndOffset);
+}
+
+//------------------------------------------------------------------------------
+/**
+    Put the result of a successful read into the memory cache. This
+    happens when the read is dispatched, before the completion callback
+    hands the data to its owner. A read whose data has already been taken
+    by its owner is not cached, and reads which were served from the
+    cache are skipped. Otherwise the read replaces an existing entry of
+    its URL, so that a read which bypassed the cache refreshes stale data.
+*/
+void
+IO::writeCache(const Ptr<IORead>& ioRead) {
+    if ((IOStatus::OK == ioRead->Status) &&
+        !ioRead->Data.Empty() &&
+        (state->cache.maxBytes > 0) &&
+        !ioRead->MemoryCacheHit) {
+
+        o_trace_scoped(IO_WriteCache);
+        state->cache.insert(ioRead->Url.Get(), ioRead->Data.Data(), ioRead->Data.Size());
+    }
+}
+
+//------------------------------------------------------------------------------
+IOCacheStats
+IO::CacheStats() {
+    o_assert_dbg(IsValid());
+    IOCacheStats stats;
+    stats.Hits = state->cache.numHits;
+    stats.Misses = state->cache.numMisses;
+    stats.Evictions = state->cache.numEvictions;
+    stats.NumEntries = state->cache.numEntries();
+    stats.NumBytes = state->cache.numBytes();
+    stats.MaxBytes = state->cache.maxBytes;
+    if (ioDiskCache::isValid()) {
+        ioDiskCache::getStats(stats);
+    }
+    return stats;
+}
+
+//------------------------------------------------------------------------------
+void
+IO::ResetCacheStats() {
+    o_assert_dbg(IsValid());
+    state->cache.numHits = 0;
+    state->cache.numMisses = 0;
+    state->cache.numEvictions = 0;
+    if (ioDiskCache::isValid()) {
+        ioDiskCache::resetStats();
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+IO::ClearCache() {
+    o_assert_dbg(IsValid());
+    state->cache.clear();
+}
+
+//------------------------------------------------------------------------------
+/**
+    Record the response of a read in the frame it is dispatched,
+    so that it is played back in the same frame.
+*/
+void
+IO::recordRead(const Ptr<IORead>& ioReq) {
+    const StringAtom& url = ioReq->Url.Get();
+    const int size = int(sizeof(replayHeader)) + url.Length() + ioReq->Data.Size();
+    Buffer rec;
+    replayHeader hdr;
+    hdr.status = int32_t(ioReq->Status);
+    hdr.urlLength = url.Length();
+    rec.Reserve(size);
+    rec.Add((const uint8_t*)&hdr, sizeof(hdr));
+    rec.Add((const uint8_t*)url.AsCStr(), url.Length());
+    if (!ioReq->Data.Empty()) {
+        rec.Add(ioReq->Data.Data(), ioReq->Data.Size());
+    }
+    Replay::Record(state->replayChannel, rec.Data(), rec.Size());
+}
+
+//------------------------------------------------------------------------------
+void
+IO::playbackRead(const uint8_t* data, int size) {
+    replayHeader hdr;
+    if (nullptr == state) {
+        return;
+    }
+    if (!parseReplayRecord(data, size, hdr)) {
+        o_warn("IO: invalid replay record\n");
+        return;
+    }
+    const char* urlStart = (const char*) data + sizeof(hdr);
+    const StringAtom url(String(urlStart, 0, hdr.urlLength));
+    const uint8_t* content = data + sizeof(hdr) + hdr.urlLength;
+    const int contentSize = size - int(sizeof(hdr)) - hdr.urlLength;
+
+    // complete the oldest pending read of this URL
+    for (int i = 0; i < state->replayPendingReads.Size(); i++) {
+        const Ptr<IORead>& ioReq = state->replayPendingReads[i];
+        if (ioReq->Url.Get() == url) {
+            ioReq->Status = (IOStatus::Code) hdr.status;
+            if (contentSize > 0) {
+                ioReq->Data.Add(content, contentSize);
+            }
+            ioReq->Handled = true;
+            state->completed.Add(ioReq);
+            state->replayPendingReads.Erase(i);
+            return;
+        }
+    }
+    // the read hasn't been made yet
+    replayResponse& resp = state->replayEarlyResponses.Add();
+    resp.url = url;
+    resp.status = (IOStatus::Code) hdr.status;
+    if (contentSize > 0) {
+        resp.data.Add(content, contentSize);
+    }
+}
+
 } // namespace Oryol
@@ -58,14 +58,35 @@ public:
 
     /// low-level: start async loading of file from URL, return message for polling result
     static Ptr<IORead> LoadFile(const URL& url);
+    /// low-level: start async loading of file from URL, call onCompleted on the main thread when handled
+    static Ptr<IORead> LoadFile(const URL& url, IORequest::CompletedFunc onCompleted);
     /// low-level: start async writing of file via URL, return message for polling result
     static Ptr<IOWrite> WriteFile(const URL& url, const Buffer& data);
     /// low-level: push a generic asynchronous IO request
     static void Put(const Ptr<IORequest>& ioReq);
+
+    /// get the statistics of the read caches
+    static IOCacheStats CacheStats();
+    /// reset the hit/miss/eviction counters of the read caches
+    static void ResetCacheStats();
+    /// remove all entries from the in-memory read cache
+    static void ClearCache();
     
 private:
     /// pump the ioRequestRouter
     static void doWork();
+    /// return true if a read can be served from or stored in the cache
+    static bool isCacheable(const Ptr<IORead>& ioRead);
+    /// dispatch completed requests (cache, replay and completion callbacks)
+    static void dispatchCompleted();
+    /// check requests which are completed asynchronously by their filesystem
+    static void pollAsyncRequests();
+    /// put a handled read into the memory cache
+    static void writeCache(const Ptr<IORead>& ioRead);
+    /// record the response of a handled read into the replay
+    static void recordRead(const Ptr<IORead>& ioRead);
+    /// complete a pending read from a replay record
+    static void playbackRead(const uint8_t* data, int size);
 };
 
 } // namespace Oryol
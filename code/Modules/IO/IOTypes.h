@@ -1,6 +1,7 @@
 #pragma once
 //------------------------------------------------------------------------------
 #include "Core/Types.h"
+#include "Core/Containers/Array.h"
 #include "Core/Containers/Map.h"
 #include "Core/String/StringAtom.h"
 #include "Core/String/String.h"
@@ -23,6 +24,48 @@ public:
     Map<String, String> Assigns;
     /// initial file systems
     Map<StringAtom, std::function<Ptr<FileSystemBase>()>> FileSystems;
+    /// number of IO worker threads for fast filesystems (e.g. local disk)
+    int NumWorkers = 2;
+    /// number of IO worker threads for slow filesystems (0 to share the fast workers)
+    int NumSlowWorkers = 2;
+    /// URL schemes of slow filesystems (e.g. http), handled by the slow workers
+    Array<StringAtom> SlowSchemes{ "http", "https" };
+    /// byte budget of the in-memory read cache (0 disables the cache)
+    int CacheMaxBytes = 16 * 1024 * 1024;
+    /// enable cache reads and writes for IO::LoadFile() and IO::Load()
+    bool CacheEnabled = false;
+    /// directory of the on-disk cache for http: reads (empty disables the disk cache)
+    String DiskCachePath;
+    /// let IO::LoadFile() and IO::Load() memory-map big local files instead of reading them
+    bool MapFilesEnabled = false;
+};
+
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::IOCacheStats
+    @ingroup IO
+    @brief statistics of the IO read caches
+*/
+class IOCacheStats {
+public:
+    /// reads served from the in-memory cache
+    int64_t Hits = 0;
+    /// cacheable reads which were not in the in-memory cache
+    int64_t Misses = 0;
+    /// entries evicted from the in-memory cache to stay within budget
+    int64_t Evictions = 0;
+    /// number of entries in the in-memory cache
+    int NumEntries = 0;
+    /// number of bytes in the in-memory cache
+    int NumBytes = 0;
+    /// byte budget of the in-memory cache
+    int MaxBytes = 0;
+    /// http: reads served from the disk cache after revalidation
+    int64_t DiskHits = 0;
+    /// http: reads which were not in the disk cache
+    int64_t DiskMisses = 0;
+    /// responses written to the disk cache
+    int64_t DiskWrites = 0;
 };
 
 //------------------------------------------------------------------------------
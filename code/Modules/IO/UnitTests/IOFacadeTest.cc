@@ -72,4 +72,67 @@ TEST(IOFacadeTest) {
     IO::Discard();
     Core::Discard();
 }
+
+TEST(IOCompletionTest) {
+    Core::Setup();
+    IO::Setup(IOSetup());
+    IO::RegisterFileSystem("test", TestFileSystem::Creator());
+
+    // completion callback of a low-level request
+    int numCompleted = 0;
+    Ptr<IORead> msg = IO::LoadFile("test://blub.com/blob.txt", [&numCompleted](const Ptr<IORequest>& ioReq) {
+        CHECK(ioReq->Handled);
+        CHECK(ioReq->Status == IOStatus::OK);
+        CHECK(ioReq->Data.Size() == 4);
+        numCompleted++;
+    });
+    CHECK(bool(msg->OnCompleted));
+    while (0 == numCompleted) {
+        Core::PreRunLoop()->Run();
+    }
+    CHECK(!msg->OnCompleted);
+    Core::PreRunLoop()->Run();
+    CHECK(numCompleted == 1);
+
+    // a cancelled request also completes
+    Ptr<IORead> cancelled = IORead::Create();
+    cancelled->Url = "test://blub.com/cancelled.txt";
+    cancelled->Cancelled = true;
+    IOStatus::Code cancelledStatus = IOStatus::InvalidIOStatus;
+    cancelled->OnCompleted = [&cancelledStatus](const Ptr<IORequest>& ioReq) {
+        cancelledStatus = ioReq->Status;
+    };
+    IO::Put(cancelled);
+    while (IOStatus::InvalidIOStatus == cancelledStatus) {
+        Core::PreRunLoop()->Run();
+    }
+    CHECK(cancelledStatus == IOStatus::Cancelled);
+
+    // single and group loads through the load queue
+    int numLoaded = 0;
+    int numGroupLoaded = 0;
+    IO::Load("test://blub.com/single.txt", [&numLoaded](IO::LoadResult res) {
+        CHECK(res.Data.Size() == 4);
+        numLoaded++;
+    });
+    Array<URL> urls({ "test://blub.com/a.txt", "test://blub.com/b.txt", "test://blub.com/c.txt" });
+    IO::LoadGroup(urls, [&numGroupLoaded](Array<IO::LoadResult> results) {
+        CHECK(results.Size() == 3);
+        CHECK(results[0].Url == "test://blub.com/a.txt");
+        CHECK(results[2].Url == "test://blub.com/c.txt");
+        for (const auto& res : results) {
+            CHECK(res.Data.Size() == 4);
+        }
+        numGroupLoaded++;
+    });
+    CHECK(IO::NumPendingLoads() == 2);
+    while (IO::NumPendingLoads() > 0) {
+        Core::PreRunLoop()->Run();
+    }
+    CHECK(numLoaded == 1);
+    CHECK(numGroupLoaded == 1);
+
+    IO::Discard();
+    Core::Discard();
+}
 #endif
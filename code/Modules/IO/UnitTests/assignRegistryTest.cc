@@ -6,6 +6,9 @@
 #include "UnitTest++/src/UnitTest++.h"
 #include "IO/private/assignRegistry.h"
 #include "Core/Ptr.h"
+#include "Core/Log.h"
+#include "Core/Memory/AllocationTracker.h"
+#include "IO/IOTypes.h"
 
 using namespace Oryol;
 using namespace Oryol::_priv;
@@ -33,3 +36,30 @@ TEST(assignRegistryTest) {
     res = reg.ResolveAssigns("blub:");
     CHECK(res == "http://www.flohofwoe.net/blub/");
 }
+
+TEST(assignRegistryAllocTest) {
+
+    // count allocations on the assign- and URL-resolution path, short
+    // strings shouldn't touch the allocator at all (allocations are only
+    // counted with ORYOL_ALLOCATION_TRACKING)
+    assignRegistry reg;
+    reg.SetAssign("res:", "root:data/");
+    reg.SetAssign("root:", "file:///");
+    auto resolve = [&reg] {
+        URL url(reg.ResolveAssigns("res:tex.dds"));
+        String scheme = url.Scheme();
+        String path = url.Path();
+        return url.IsValid() && (scheme == "file") && (path == "data/tex.dds");
+    };
+    // first resolve interns the URL string as StringAtom
+    CHECK(resolve());
+
+    const int num = 100;
+    AllocationTracker::Checkpoint checkpoint;
+    for (int i = 0; i < num; i++) {
+        resolve();
+    }
+    const int64_t numAllocs = checkpoint.NumAllocs();
+    Log::Info("assignRegistryAllocTest: %.2f allocations per URL resolution\n", double(numAllocs) / num);
+    CHECK(0 == numAllocs);
+}
@@ -0,0 +1,226 @@
+//------------------------------------------------------------------------------
+//  ioCacheTest.cc
+//  Test the IO read caches.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "IO/IO.h"
+#include "IO/FileSystemBase.h"
+#include "IO/private/ioCache.h"
+#include "IO/private/ioDiskCache.h"
+#include "Core/Core.h"
+#include "Core/RunLoop.h"
+#include "Core/Creator.h"
+#include <cstdio>
+
+using namespace Oryol;
+using namespace Oryol::_priv;
+
+namespace {
+
+std::atomic<int> numCacheTestReads{0};
+std::atomic<uint8_t> cacheTestLastByte{'D'};
+
+class CacheTestFileSystem : public FileSystemBase {
+    OryolClassDecl(CacheTestFileSystem);
+    OryolClassCreator(CacheTestFileSystem);
+public:
+    virtual void onMsg(const Ptr<IORequest>& msg) override {
+        if (msg->IsA<IORead>()) {
+            numCacheTestReads++;
+            const uint8_t payload[] = {'A', 'B', 'C', cacheTestLastByte};
+            msg->Data.Add(payload, sizeof(payload));
+            msg->Status = IOStatus::OK;
+        }
+        msg->Handled = true;
+    };
+};
+
+Buffer makeData(int size, uint8_t val) {
+    Buffer buf;
+    uint8_t* ptr = buf.Add(size);
+    for (int i = 0; i < size; i++) {
+        ptr[i] = val;
+    }
+    return buf;
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+TEST(ioCacheTest) {
+    ioCache cache;
+    cache.setup(100);
+    const StringAtom a("test://a"), b("test://b"), c("test://c"), d("test://d");
+    Buffer data;
+    CHECK(!cache.lookup(a, data));
+    CHECK(cache.numMisses == 1);
+
+    Buffer d40 = makeData(40, 1);
+    cache.insert(a, d40.Data(), d40.Size());
+    cache.insert(b, d40.Data(), d40.Size());
+    CHECK(cache.numEntries() == 2);
+    CHECK(cache.numBytes() == 80);
+    CHECK(cache.lookup(a, data));
+    CHECK(data.Size() == 40);
+    CHECK(data.Data()[0] == 1);
+    CHECK(cache.numHits == 1);
+
+    // a was used last, so b gets evicted
+    cache.insert(c, d40.Data(), d40.Size());
+    CHECK(cache.numEvictions == 1);
+    CHECK(cache.numEntries() == 2);
+    CHECK(cache.numBytes() == 80);
+    CHECK(cache.contains(a));
+    CHECK(!cache.contains(b));
+    CHECK(cache.contains(c));
+
+    // replacing an entry updates the byte count
+    Buffer d10 = makeData(10, 2);
+    cache.insert(a, d10.Data(), d10.Size());
+    CHECK(cache.numBytes() == 50);
+    CHECK(cache.lookup(a, data));
+    CHECK(data.Size() == 10);
+    CHECK(data.Data()[0] == 2);
+
+    // too big for the whole budget
+    Buffer d200 = makeData(200, 3);
+    cache.insert(d, d200.Data(), d200.Size());
+    CHECK(!cache.contains(d));
+    CHECK(cache.numEntries() == 2);
+
+    // free entries are reused
+    cache.remove(c);
+    CHECK(cache.numBytes() == 10);
+    cache.insert(b, d40.Data(), d40.Size());
+    cache.insert(c, d40.Data(), d40.Size());
+    CHECK(cache.numEntries() == 3);
+    CHECK(cache.numBytes() == 90);
+    cache.clear();
+    CHECK(cache.numEntries() == 0);
+    CHECK(cache.numBytes() == 0);
+    cache.discard();
+}
+
+//------------------------------------------------------------------------------
+TEST(ioDiskCacheTest) {
+    ioDiskCache::setup("oryol_disk_cache_test");
+    CHECK(ioDiskCache::isValid());
+    ioDiskCache::resetStats();
+    const String url("http://www.example.com/data.bin");
+    String validator;
+    Buffer data;
+    ioDiskCache::remove(url);
+    CHECK(!ioDiskCache::lookup(url, validator, data));
+
+    Buffer content = makeData(1000, 7);
+    CHECK(ioDiskCache::store(url, "\"etag-1\"", content.Data(), content.Size()));
+    CHECK(ioDiskCache::lookup(url, validator, data));
+    CHECK(validator == "\"etag-1\"");
+    CHECK(data.Size() == 1000);
+    CHECK(data.Data()[999] == 7);
+    CHECK(!ioDiskCache::lookup("http://www.example.com/other.bin", validator, data));
+
+    IOCacheStats stats;
+    ioDiskCache::getStats(stats);
+    CHECK(stats.DiskMisses == 2);
+    CHECK(stats.DiskWrites == 1);
+    ioDiskCache::remove(url);
+    CHECK(!ioDiskCache::lookup(url, validator, data));
+    ioDiskCache::discard();
+    CHECK(!ioDiskCache::isValid());
+    std::remove("oryol_disk_cache_test");
+}
+
+//------------------------------------------------------------------------------
+#if !ORYOL_EMSCRIPTEN && !ORYOL_UNITTESTS_HEADLESS
+TEST(IOCacheFacadeTest) {
+    Core::Setup();
+    IOSetup ioSetup;
+    ioSetup.CacheEnabled = true;
+    ioSetup.CacheMaxBytes = 1024;
+    IO::Setup(ioSetup);
+    IO::RegisterFileSystem("ctest", CacheTestFileSystem::Creator());
+    numCacheTestReads = 0;
+
+    // the first read goes to the filesystem, the result is
+    // in the cache before the completion callback is called
+    const URL url("ctest://bla.com/blob.txt");
+    bool completed = false;
+    Ptr<IORead> req = IO::LoadFile(url, [&completed](const Ptr<IORequest>& ioReq) {
+        CHECK(IO::CacheStats().NumEntries == 1);
+        completed = true;
+    });
+    while (!completed) {
+        Core::PreRunLoop()->Run();
+    }
+    CHECK(numCacheTestReads == 1);
+    IOCacheStats stats = IO::CacheStats();
+    CHECK(stats.Misses == 1);
+    CHECK(stats.NumEntries == 1);
+    CHECK(stats.NumBytes == 4);
+
+    // the second read is handled right away from the cache
+    req = IO::LoadFile(url);
+    CHECK(req->Handled);
+    CHECK(req->Status == IOStatus::OK);
+    CHECK(req->Data.Size() == 4);
+    CHECK(req->Data.Data()[3] == 'D');
+    CHECK(numCacheTestReads == 1);
+    CHECK(IO::CacheStats().Hits == 1);
+
+    // a read with disabled cache read goes to the filesystem
+    req = IORead::Create();
+    req->Url = url;
+    IO::Put(req);
+    while (!req->Handled) {
+        Core::PreRunLoop()->Run();
+    }
+    CHECK(numCacheTestReads == 2);
+
+    // partial reads are not cached
+    req = IO::LoadFile(url);
+    CHECK(req->Handled);
+    Ptr<IORead> partial = IORead::Create();
+    partial->Url = url;
+    partial->StartOffset = 1;
+    partial->CacheReadEnabled = true;
+    IO::Put(partial);
+    CHECK(!partial->Handled);
+    while (!partial->Handled) {
+        Core::PreRunLoop()->Run();
+    }
+    CHECK(numCacheTestReads == 3);
+
+    // after the file has changed, a read which bypasses the cache
+    // replaces the stale cache entry
+    cacheTestLastByte = 'E';
+    completed = false;
+    req = IORead::Create();
+    req->Url = url;
+    req->CacheWriteEnabled = true;
+    req->OnCompleted = [&completed](const Ptr<IORequest>& ioReq) {
+        completed = true;
+    };
+    IO::Put(req);
+    while (!completed) {
+        Core::PreRunLoop()->Run();
+    }
+    CHECK(numCacheTestReads == 4);
+    req = IO::LoadFile(url);
+    CHECK(req->Handled);
+    CHECK(req->MemoryCacheHit);
+    CHECK(req->Data.Size() == 4);
+    CHECK(req->Data.Data()[3] == 'E');
+    CHECK(IO::CacheStats().NumEntries == 1);
+    cacheTestLastByte = 'D';
+
+    IO::ClearCache();
+    CHECK(IO::CacheStats().NumEntries == 0);
+    IO::ResetCacheStats();
+    CHECK(IO::CacheStats().Hits == 0);
+
+    IO::Discard();
+    Core::Discard();
+}
+#endif
@@ -0,0 +1,204 @@
+//------------------------------------------------------------------------------
+//  ioPriorityTest.cc
+//  Test request priorities and cancellation in the IO workers.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "IO/IO.h"
+#include "IO/FileSystemBase.h"
+#include "Core/Core.h"
+#include "Core/RunLoop.h"
+#include "Core/Creator.h"
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+using namespace Oryol;
+
+#if !ORYOL_EMSCRIPTEN && !ORYOL_UNITTESTS_HEADLESS
+namespace {
+
+const int gateId = 1000;
+const int gate2Id = 1001;
+std::atomic<bool> gateEntered{false};
+std::atomic<bool> gateOpen{false};
+std::atomic<bool> gate2Entered{false};
+std::atomic<bool> gate2Open{false};
+// set to a request which should be completed before the next request is handled
+std::atomic<IORequest*> watchedRequest{nullptr};
+std::atomic<bool> watchedCompletedBefore{false};
+std::mutex orderMutex;
+Array<int> handledOrder;
+
+// the StartOffset is used as request id, the gate requests
+// block the worker until the test has prepared the next step
+class PrioFileSystem : public FileSystemBase {
+    OryolClassDecl(PrioFileSystem);
+    OryolClassCreator(PrioFileSystem);
+public:
+    virtual void onMsg(const Ptr<IORequest>& msg) override {
+        if (gateId == msg->StartOffset) {
+            gateEntered = true;
+            while (!gateOpen) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        else if (gate2Id == msg->StartOffset) {
+            gate2Entered = true;
+            while (!gate2Open) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        else {
+            if (watchedRequest) {
+                watchedCompletedBefore = watchedRequest.load()->Handled.load();
+                watchedRequest = nullptr;
+            }
+            std::lock_guard<std::mutex> lock(orderMutex);
+            handledOrder.Add(msg->StartOffset);
+        }
+        msg->Status = IOStatus::OK;
+        msg->Handled = true;
+    };
+};
+
+void setupIO() {
+    Core::Setup();
+    IOSetup ioSetup;
+    ioSetup.NumWorkers = 1;
+    ioSetup.NumSlowWorkers = 0;
+    ioSetup.FileSystems.Add("prio", PrioFileSystem::Creator());
+    IO::Setup(ioSetup);
+    handledOrder.Clear();
+    gateEntered = false;
+    gateOpen = false;
+    gate2Entered = false;
+    gate2Open = false;
+    watchedRequest = nullptr;
+    watchedCompletedBefore = false;
+}
+
+Ptr<IORead> putRequest(int id, int priority) {
+    Ptr<IORead> req = IORead::Create();
+    req->Url = "prio://test/file.bin";
+    req->StartOffset = id;
+    req->Priority = priority;
+    IO::Put(req);
+    return req;
+}
+
+void closeGate() {
+    putRequest(gateId, 0);
+    while (!gateEntered) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void openGateAndWait(const Array<Ptr<IORead>>& requests) {
+    gateOpen = true;
+    bool allHandled = false;
+    while (!allHandled) {
+        Core::PreRunLoop()->Run();
+        allHandled = true;
+        for (const auto& req : requests) {
+            allHandled &= req->Handled;
+        }
+    }
+}
+
+void discardIO() {
+    IO::Discard();
+    Core::Discard();
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+TEST(ioPriorityTest) {
+    setupIO();
+
+    // while the worker is blocked, requests pile up in its queue
+    closeGate();
+    Array<Ptr<IORead>> requests;
+    requests.Add(putRequest(1, 0));
+    requests.Add(putRequest(2, 0));
+    requests.Add(putRequest(3, 5));
+    requests.Add(putRequest(4, 5));
+    requests.Add(putRequest(5, -5));
+    requests[3]->Cancel();
+    openGateAndWait(requests);
+
+    // higher priority first, same priority in arrival order,
+    // and the cancelled request never reached the filesystem
+    CHECK(handledOrder.Size() == 4);
+    if (handledOrder.Size() == 4) {
+        CHECK(handledOrder[0] == 3);
+        CHECK(handledOrder[1] == 1);
+        CHECK(handledOrder[2] == 2);
+        CHECK(handledOrder[3] == 5);
+    }
+    CHECK(requests[3]->Status == IOStatus::Cancelled);
+    CHECK(requests[0]->Status == IOStatus::OK);
+
+    discardIO();
+}
+
+//------------------------------------------------------------------------------
+TEST(ioPriorityAgingTest) {
+    setupIO();
+
+    // a request one priority level higher overtakes at most
+    // PriorityAging (16) requests which arrived before it
+    closeGate();
+    Array<Ptr<IORead>> requests;
+    const int numLow = 40;
+    for (int i = 0; i < numLow; i++) {
+        requests.Add(putRequest(i, 0));
+    }
+    requests.Add(putRequest(100, 1));
+    openGateAndWait(requests);
+
+    CHECK(handledOrder.Size() == numLow + 1);
+    int pos = InvalidIndex;
+    for (int i = 0; i < handledOrder.Size(); i++) {
+        if (100 == handledOrder[i]) {
+            pos = i;
+        }
+    }
+    CHECK(pos == numLow - 16);
+
+    discardIO();
+}
+
+//------------------------------------------------------------------------------
+TEST(ioPriorityCancelQueuedTest) {
+    setupIO();
+
+    // the second gate is handled first, and blocks the worker
+    // while the other requests are in its priority queue
+    closeGate();
+    Array<Ptr<IORead>> requests;
+    requests.Add(putRequest(gate2Id, 10));
+    requests.Add(putRequest(1, 5));
+    requests.Add(putRequest(2, 0));
+    gateOpen = true;
+    while (!gate2Entered) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // a request cancelled while queued is completed before the
+    // next request is handled, not when it would come up
+    watchedRequest = requests[2].get();
+    requests[2]->Cancel();
+    gate2Open = true;
+    openGateAndWait(requests);
+    CHECK(watchedCompletedBefore);
+    CHECK(requests[2]->Status == IOStatus::Cancelled);
+    CHECK(handledOrder.Size() == 1);
+    if (handledOrder.Size() == 1) {
+        CHECK(handledOrder[0] == 1);
+    }
+
+    discardIO();
+}
+#endif
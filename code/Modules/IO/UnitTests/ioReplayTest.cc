@@ -0,0 +1,99 @@
+//------------------------------------------------------------------------------
+//  ioReplayTest.cc
+//  Test recording and playback of IO read responses.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "IO/IO.h"
+#include "IO/FileSystemBase.h"
+#include "Core/Core.h"
+#include "Core/RunLoop.h"
+#include "Core/Creator.h"
+#include "Core/Replay.h"
+#include <cstdio>
+
+using namespace Oryol;
+
+#if !ORYOL_EMSCRIPTEN && !ORYOL_UNITTESTS_HEADLESS
+namespace {
+
+std::atomic<int> numReplayTestReads{0};
+std::atomic<uint8_t> replayTestByte{'A'};
+
+class ReplayTestFileSystem : public FileSystemBase {
+    OryolClassDecl(ReplayTestFileSystem);
+    OryolClassCreator(ReplayTestFileSystem);
+public:
+    virtual void onMsg(const Ptr<IORequest>& msg) override {
+        if (msg->IsA<IORead>()) {
+            numReplayTestReads++;
+            const uint8_t payload[] = { replayTestByte };
+            msg->Data.Add(payload, sizeof(payload));
+            msg->Status = IOStatus::OK;
+        }
+        msg->Handled = true;
+    };
+};
+
+void setupIO() {
+    IOSetup ioSetup;
+    ioSetup.FileSystems.Add("rtest", ReplayTestFileSystem::Creator());
+    IO::Setup(ioSetup);
+}
+
+// load a file, and run frames until it has been loaded, return the first byte
+uint8_t loadFile(const char* url) {
+    uint8_t result = 0;
+    bool completed = false;
+    IO::LoadFile(url, [&result, &completed](const Ptr<IORequest>& ioReq) {
+        const Ptr<IORead>& ioRead = ioReq.unsafeCast<IORead>();
+        if ((IOStatus::OK == ioRead->Status) && !ioRead->Data.Empty()) {
+            result = ioRead->Data.Data()[0];
+        }
+        completed = true;
+    });
+    for (int i = 0; (i < 100000) && !completed; i++) {
+        Replay::BeginFrame();
+        Core::PreRunLoop()->Run();
+    }
+    CHECK(completed);
+    return result;
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+TEST(ioReplayTest) {
+    const char* path = "oryol_io_replay_test.bin";
+    Core::Setup();
+
+    // record a single read
+    numReplayTestReads = 0;
+    replayTestByte = 'A';
+    CHECK(Replay::StartRecording(path));
+    setupIO();
+    CHECK(loadFile("rtest://bla.com/a.txt") == 'A');
+    CHECK(numReplayTestReads == 1);
+    IO::Discard();
+    Replay::Stop();
+
+    // the recorded read is answered from the replay file, reads
+    // without a recorded response go to the filesystem instead
+    // of waiting forever
+    replayTestByte = 'B';
+    CHECK(Replay::StartPlayback(path));
+    setupIO();
+    CHECK(loadFile("rtest://bla.com/a.txt") == 'A');
+    CHECK(numReplayTestReads == 1);
+    CHECK(loadFile("rtest://bla.com/b.txt") == 'B');
+    CHECK(numReplayTestReads == 2);
+    CHECK(loadFile("rtest://bla.com/a.txt") == 'B');
+    CHECK(numReplayTestReads == 3);
+    IO::Discard();
+    Replay::Stop();
+
+    Core::Discard();
+    replayTestByte = 'A';
+    std::remove(path);
+}
+#endif
@@ -0,0 +1,175 @@
+//------------------------------------------------------------------------------
+//  ioRouterTest.cc
+//  Test IO worker lanes and load-aware dispatch.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "IO/IO.h"
+#include "IO/FileSystemBase.h"
+#include "Core/Core.h"
+#include "Core/RunLoop.h"
+#include "Core/Creator.h"
+#include "Core/Containers/Set.h"
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+using namespace Oryol;
+
+#if !ORYOL_EMSCRIPTEN && !ORYOL_UNITTESTS_HEADLESS
+namespace {
+
+std::mutex threadIdMutex;
+Set<std::thread::id> fastThreadIds;
+Set<std::thread::id> slowThreadIds;
+std::atomic<int> slowRequestMilliSeconds{0};
+
+void recordThreadId(Set<std::thread::id>& threadIds) {
+    std::lock_guard<std::mutex> lock(threadIdMutex);
+    if (!threadIds.Contains(std::this_thread::get_id())) {
+        threadIds.Add(std::this_thread::get_id());
+    }
+}
+
+class FastFileSystem : public FileSystemBase {
+    OryolClassDecl(FastFileSystem);
+    OryolClassCreator(FastFileSystem);
+public:
+    virtual void onMsg(const Ptr<IORequest>& msg) override {
+        recordThreadId(fastThreadIds);
+        msg->Status = IOStatus::OK;
+        msg->Handled = true;
+    };
+};
+
+class SlowFileSystem : public FileSystemBase {
+    OryolClassDecl(SlowFileSystem);
+    OryolClassCreator(SlowFileSystem);
+public:
+    virtual void onMsg(const Ptr<IORequest>& msg) override {
+        recordThreadId(slowThreadIds);
+        std::this_thread::sleep_for(std::chrono::milliseconds(slowRequestMilliSeconds));
+        msg->Status = IOStatus::OK;
+        msg->Handled = true;
+    };
+};
+
+void setupIO(int numWorkers, int numSlowWorkers) {
+    Core::Setup();
+    IOSetup ioSetup;
+    ioSetup.NumWorkers = numWorkers;
+    ioSetup.NumSlowWorkers = numSlowWorkers;
+    ioSetup.SlowSchemes = { "slow" };
+    ioSetup.FileSystems.Add("fast", FastFileSystem::Creator());
+    ioSetup.FileSystems.Add("slow", SlowFileSystem::Creator());
+    IO::Setup(ioSetup);
+    fastThreadIds.Clear();
+    slowThreadIds.Clear();
+}
+
+void discardIO() {
+    IO::Discard();
+    Core::Discard();
+}
+
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+TEST(ioRouterLaneTest) {
+    setupIO(2, 1);
+    slowRequestMilliSeconds = 1;
+    int numCompleted = 0;
+    auto onCompleted = [&numCompleted](const Ptr<IORequest>&) {
+        numCompleted++;
+    };
+    for (int i = 0; i < 64; i++) {
+        IO::LoadFile("fast://bla.com/file.txt", onCompleted);
+        if (0 == (i & 7)) {
+            IO::LoadFile("slow://bla.com/file.txt", onCompleted);
+        }
+    }
+    while (numCompleted < 72) {
+        Core::PreRunLoop()->Run();
+    }
+
+    // the slow filesystem only runs on the one slow worker, and never
+    // on the fast workers
+    CHECK(slowThreadIds.Size() == 1);
+    CHECK(fastThreadIds.Size() >= 1);
+    CHECK(fastThreadIds.Size() <= 2);
+    for (const auto& id : slowThreadIds) {
+        CHECK(!fastThreadIds.Contains(id));
+    }
+    discardIO();
+
+    // without slow workers, all workers are shared
+    setupIO(3, 0);
+    numCompleted = 0;
+    for (int i = 0; i < 16; i++) {
+        IO::LoadFile("slow://bla.com/file.txt", onCompleted);
+    }
+    while (numCompleted < 16) {
+        Core::PreRunLoop()->Run();
+    }
+    CHECK(slowThreadIds.Size() >= 1);
+    CHECK(slowThreadIds.Size() <= 3);
+    discardIO();
+}
+
+//------------------------------------------------------------------------------
+TEST(ioRouterTailLatencyBenchmark) {
+    // NOTE: this is not a hard performance test, the numbers are only logged
+    typedef std::chrono::high_resolution_clock clock;
+    const int numFast = 256;
+    const int numSlow = 16;
+    slowRequestMilliSeconds = 20;
+
+    auto run = [numFast, numSlow](const char* name, int numWorkers, int numSlowWorkers) {
+        setupIO(numWorkers, numSlowWorkers);
+        Array<double> fastLatencies;
+        fastLatencies.Reserve(numFast);
+        Array<double> slowLatencies;
+        slowLatencies.Reserve(numSlow);
+        int numCompleted = 0;
+        const auto start = clock::now();
+        for (int i = 0; i < numFast; i++) {
+            // interleave slow requests with the fast requests
+            if (0 == (i % (numFast / numSlow))) {
+                const auto slowPutTime = clock::now();
+                IO::LoadFile("slow://bla.com/file.txt", [&numCompleted, &slowLatencies, slowPutTime](const Ptr<IORequest>&) {
+                    slowLatencies.Add(std::chrono::duration<double, std::milli>(clock::now() - slowPutTime).count());
+                    numCompleted++;
+                });
+            }
+            const auto putTime = clock::now();
+            IO::LoadFile("fast://bla.com/file.txt", [&numCompleted, &fastLatencies, putTime](const Ptr<IORequest>&) {
+                fastLatencies.Add(std::chrono::duration<double, std::milli>(clock::now() - putTime).count());
+                numCompleted++;
+            });
+        }
+        while (numCompleted < (numFast + numSlow)) {
+            Core::PreRunLoop()->Run();
+        }
+        const double totalMs = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+        CHECK(fastLatencies.Size() == numFast);
+        CHECK(slowLatencies.Size() == numSlow);
+        std::sort(fastLatencies.begin(), fastLatencies.end());
+        std::sort(slowLatencies.begin(), slowLatencies.end());
+        Log::Info("ioRouterTailLatencyBenchmark: %s: fast p50 %.2fms, p99 %.2fms, max %.2fms, slow p50 %.2fms, max %.2fms, total %.2fms\n",
+            name,
+            fastLatencies[numFast / 2],
+            fastLatencies[(numFast * 99) / 100],
+            fastLatencies.Back(),
+            slowLatencies[numSlow / 2],
+            slowLatencies.Back(),
+            totalMs);
+        discardIO();
+    };
+    const IOSetup defaults;
+    run("4 shared workers", 4, 0);
+    run("3 fast + 1 slow workers", 3, 1);
+    run("IOSetup defaults", defaults.NumWorkers, defaults.NumSlowWorkers);
+    slowRequestMilliSeconds = 0;
+}
+#endif
@@ -0,0 +1,175 @@
+//------------------------------------------------------------------------------
+//  ioCache.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "ioCache.h"
+#include "Core/Assertion.h"
+
+namespace Oryol {
+namespace _priv {
+
+//------------------------------------------------------------------------------
+void
+ioCache::setup(int maxBytes_) {
+    o_assert_dbg(maxBytes_ >= 0);
+    this->maxBytes = maxBytes_;
+}
+
+//------------------------------------------------------------------------------
+void
+ioCache::discard() {
+    this->clear();
+    this->maxBytes = 0;
+}
+
+//------------------------------------------------------------------------------
+bool
+ioCache::lookup(const StringAtom& url, Buffer& outData) {
+    const int* entryIndex = this->index.Find(url);
+    if (nullptr == entryIndex) {
+        this->numMisses++;
+        return false;
+    }
+    const int i = *entryIndex;
+    if (i != this->head) {
+        this->unlink(i);
+        this->linkFront(i);
+    }
+    const Buffer& data = this->entries[i].data;
+    outData.Clear();
+    if (!data.Empty()) {
+        outData.Add(data.Data(), data.Size());
+    }
+    this->numHits++;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+bool
+ioCache::contains(const StringAtom& url) const {
+    return this->index.Contains(url);
+}
+
+//------------------------------------------------------------------------------
+void
+ioCache::insert(const StringAtom& url, const uint8_t* data, int size) {
+    o_assert_dbg(url.IsValid());
+    o_assert_dbg((nullptr != data) || (0 == size));
+    this->remove(url);
+    if (size > this->maxBytes) {
+        // doesn't fit at all
+        return;
+    }
+    this->evict(size);
+
+    int i;
+    if (this->freeEntries.Empty()) {
+        i = this->entries.Size();
+        this->entries.Add();
+    }
+    else {
+        i = this->freeEntries.PopBack();
+    }
+    entry& e = this->entries[i];
+    e.url = url;
+    if (size > 0) {
+        e.data.Add(data, size);
+    }
+    this->curBytes += size;
+    this->linkFront(i);
+    this->index.Add(url, i);
+}
+
+//------------------------------------------------------------------------------
+void
+ioCache::remove(const StringAtom& url) {
+    const int* entryIndex = this->index.Find(url);
+    if (entryIndex) {
+        const int i = *entryIndex;
+        this->index.Erase(url);
+        this->unlink(i);
+        this->freeEntry(i);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+ioCache::clear() {
+    this->entries.Clear();
+    this->freeEntries.Clear();
+    this->index.Clear();
+    this->head = InvalidIndex;
+    this->tail = InvalidIndex;
+    this->curBytes = 0;
+}
+
+//------------------------------------------------------------------------------
+int
+ioCache::numEntries() const {
+    return this->index.Size();
+}
+
+//------------------------------------------------------------------------------
+int
+ioCache::numBytes() const {
+    return this->curBytes;
+}
+
+//------------------------------------------------------------------------------
+void
+ioCache::unlink(int i) {
+    entry& e = this->entries[i];
+    if (InvalidIndex != e.prev) {
+        this->entries[e.prev].next = e.next;
+    }
+    else {
+        this->head = e.next;
+    }
+    if (InvalidIndex != e.next) {
+        this->entries[e.next].prev = e.prev;
+    }
+    else {
+        this->tail = e.prev;
+    }
+    e.prev = e.next = InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+void
+ioCache::linkFront(int i) {
+    entry& e = this->entries[i];
+    e.prev = InvalidIndex;
+    e.next = this->head;
+    if (InvalidIndex != this->head) {
+        this->entries[this->head].prev = i;
+    }
+    this->head = i;
+    if (InvalidIndex == this->tail) {
+        this->tail = i;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+ioCache::freeEntry(int i) {
+    entry& e = this->entries[i];
+    this->curBytes -= e.data.Size();
+    e.url.Clear();
+    e.data = Buffer();
+    this->freeEntries.Add(i);
+}
+
+//------------------------------------------------------------------------------
+void
+ioCache::evict(int neededBytes) {
+    while ((InvalidIndex != this->tail) && ((this->curBytes + neededBytes) > this->maxBytes)) {
+        const int i = this->tail;
+        this->index.Erase(this->entries[i].url);
+        this->unlink(i);
+        this->freeEntry(i);
+        this->numEvictions++;
+    }
+}
+
+} // namespace _priv
+} // namespace Oryol
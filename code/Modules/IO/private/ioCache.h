@@ -0,0 +1,81 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::ioCache
+    @ingroup _priv
+    @brief in-memory LRU cache for IORead results
+
+    Keeps the data of complete file reads by URL, up to a byte budget.
+    When the budget is exceeded, the least recently used entries are
+    evicted. Files which are bigger than the whole budget are not cached.
+
+    The entries live in a dense array and are linked into a doubly-linked
+    LRU list by index, a HashMap maps URLs to entry indices. The cache is
+    only accessed from the main thread.
+*/
+#include "Core/Containers/Array.h"
+#include "Core/Containers/Buffer.h"
+#include "Core/Containers/HashMap.h"
+#include "Core/String/StringAtom.h"
+
+namespace Oryol {
+namespace _priv {
+
+class ioCache {
+public:
+    /// setup with a byte budget
+    void setup(int maxBytes);
+    /// discard the cache
+    void discard();
+    /// lookup URL, copy data into outData on hit
+    bool lookup(const StringAtom& url, Buffer& outData);
+    /// test if URL is in the cache (doesn't touch the LRU order or the stats)
+    bool contains(const StringAtom& url) const;
+    /// insert or replace data of an URL
+    void insert(const StringAtom& url, const uint8_t* data, int size);
+    /// remove an URL
+    void remove(const StringAtom& url);
+    /// remove all entries
+    void clear();
+
+    /// number of cached entries
+    int numEntries() const;
+    /// number of cached bytes
+    int numBytes() const;
+
+    int maxBytes = 0;
+    int curBytes = 0;
+    int64_t numHits = 0;
+    int64_t numMisses = 0;
+    int64_t numEvictions = 0;
+
+private:
+    /// unlink an entry from the LRU list
+    void unlink(int index);
+    /// link an entry at the front of the LRU list
+    void linkFront(int index);
+    /// free an entry
+    void freeEntry(int index);
+    /// evict entries from the back until the budget is met
+    void evict(int neededBytes);
+
+    struct hasher {
+        int32_t operator()(const StringAtom& atom) const {
+            return atom.Hash();
+        };
+    };
+    struct entry {
+        StringAtom url;
+        Buffer data;
+        int prev = InvalidIndex;
+        int next = InvalidIndex;
+    };
+    Array<entry> entries;
+    Array<int> freeEntries;
+    HashMap<StringAtom, int, hasher> index;
+    int head = InvalidIndex;     // most recently used
+    int tail = InvalidIndex;     // least recently used
+};
+
+} // namespace _priv
+} // namespace Oryol
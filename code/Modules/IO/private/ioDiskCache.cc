@@ -0,0 +1,204 @@
+//------------------------------------------------------------------------------
+//  ioDiskCache.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "ioDiskCache.h"
+#include "Core/Assertion.h"
+#include "Core/String/StringBuilder.h"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#if ORYOL_WINDOWS
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace Oryol {
+namespace _priv {
+
+namespace {
+    const uint32_t cacheMagic = 0x4349524F;     // 'ORIC'
+
+    struct fileHeader {
+        uint32_t magic;
+        int32_t urlLength;
+        int32_t validatorLength;
+        int32_t dataSize;
+    };
+
+    // NOTE: the path is only written in setup() and discard(), which
+    // must not run while IO requests are in flight
+    String cachePath;
+    std::atomic<bool> valid{false};
+    std::atomic<int64_t> numHits{0};
+    std::atomic<int64_t> numMisses{0};
+    std::atomic<int64_t> numWrites{0};
+    std::atomic<int> tmpCounter{0};
+
+    //--------------------------------------------------------------------------
+    uint64_t
+    hashURL(const String& url) {
+        // 64-bit FNV-1a
+        uint64_t h = 0xcbf29ce484222325ULL;
+        const char* str = url.AsCStr();
+        for (int i = 0; i < url.Length(); i++) {
+            h ^= uint8_t(str[i]);
+            h *= 0x100000001b3ULL;
+        }
+        return h;
+    }
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+void
+ioDiskCache::setup(const String& path) {
+    o_assert(!path.Empty());
+    o_assert(!isValid());
+    #if ORYOL_WINDOWS
+    _mkdir(path.AsCStr());
+    #else
+    mkdir(path.AsCStr(), 0755);
+    #endif
+    cachePath = path;
+    valid = true;
+}
+
+//------------------------------------------------------------------------------
+void
+ioDiskCache::discard() {
+    valid = false;
+    cachePath.Clear();
+}
+
+//------------------------------------------------------------------------------
+bool
+ioDiskCache::isValid() {
+    return valid;
+}
+
+//------------------------------------------------------------------------------
+String
+ioDiskCache::filePath(const String& url) {
+    const uint64_t h = hashURL(url);
+    StringBuilder strBuilder(cachePath);
+    strBuilder.AppendFormat(64, "/%08x%08x.cache", uint32_t(h >> 32), uint32_t(h));
+    return strBuilder.GetString();
+}
+
+//------------------------------------------------------------------------------
+bool
+ioDiskCache::lookup(const String& url, String& outValidator, Buffer& outData) {
+    o_assert_dbg(isValid());
+    bool found = false;
+    FILE* fp = std::fopen(filePath(url).AsCStr(), "rb");
+    if (fp) {
+        fileHeader hdr = { };
+        if ((1 == std::fread(&hdr, sizeof(hdr), 1, fp)) &&
+            (cacheMagic == hdr.magic) &&
+            (hdr.urlLength == url.Length()) &&
+            (hdr.validatorLength > 0) &&
+            (hdr.dataSize >= 0)) {
+
+            Buffer strings;
+            const int stringsSize = hdr.urlLength + hdr.validatorLength;
+            if (1 == std::fread(strings.Add(stringsSize), stringsSize, 1, fp)) {
+                const char* str = (const char*) strings.Data();
+                // check for a hash collision
+                if (0 == std::memcmp(str, url.AsCStr(), hdr.urlLength)) {
+                    outData.Clear();
+                    if ((0 == hdr.dataSize) || (1 == std::fread(outData.Add(hdr.dataSize), hdr.dataSize, 1, fp))) {
+                        outValidator.Assign(str + hdr.urlLength, 0, hdr.validatorLength);
+                        found = true;
+                    }
+                    else {
+                        outData.Clear();
+                    }
+                }
+            }
+        }
+        std::fclose(fp);
+    }
+    if (!found) {
+        numMisses++;
+    }
+    return found;
+}
+
+//------------------------------------------------------------------------------
+bool
+ioDiskCache::store(const String& url, const String& validator, const uint8_t* data, int size) {
+    o_assert_dbg(isValid());
+    o_assert_dbg(!validator.Empty());
+    o_assert_dbg((nullptr != data) || (0 == size));
+    const String path = filePath(url);
+    StringBuilder strBuilder(path);
+    strBuilder.AppendFormat(32, ".%d.tmp", tmpCounter.fetch_add(1));
+    const String tmpPath = strBuilder.GetString();
+
+    FILE* fp = std::fopen(tmpPath.AsCStr(), "wb");
+    if (nullptr == fp) {
+        o_warn("ioDiskCache: failed to write '%s'\n", tmpPath.AsCStr());
+        return false;
+    }
+    fileHeader hdr;
+    hdr.magic = cacheMagic;
+    hdr.urlLength = url.Length();
+    hdr.validatorLength = validator.Length();
+    hdr.dataSize = size;
+    bool ok = 1 == std::fwrite(&hdr, sizeof(hdr), 1, fp);
+    ok &= 1 == std::fwrite(url.AsCStr(), url.Length(), 1, fp);
+    ok &= 1 == std::fwrite(validator.AsCStr(), validator.Length(), 1, fp);
+    if (size > 0) {
+        ok &= 1 == std::fwrite(data, size, 1, fp);
+    }
+    ok &= 0 == std::fclose(fp);
+
+    // replace the old cache file
+    if (ok) {
+        #if ORYOL_WINDOWS
+        std::remove(path.AsCStr());
+        #endif
+        ok = 0 == std::rename(tmpPath.AsCStr(), path.AsCStr());
+    }
+    if (ok) {
+        numWrites++;
+    }
+    else {
+        std::remove(tmpPath.AsCStr());
+    }
+    return ok;
+}
+
+//------------------------------------------------------------------------------
+void
+ioDiskCache::remove(const String& url) {
+    o_assert_dbg(isValid());
+    std::remove(filePath(url).AsCStr());
+}
+
+//------------------------------------------------------------------------------
+void
+ioDiskCache::countHit() {
+    numHits++;
+}
+
+//------------------------------------------------------------------------------
+void
+ioDiskCache::getStats(IOCacheStats& stats) {
+    stats.DiskHits = numHits;
+    stats.DiskMisses = numMisses;
+    stats.DiskWrites = numWrites;
+}
+
+//------------------------------------------------------------------------------
+void
+ioDiskCache::resetStats() {
+    numHits = 0;
+    numMisses = 0;
+    numWrites = 0;
+}
+
+} // namespace _priv
+} // namespace Oryol
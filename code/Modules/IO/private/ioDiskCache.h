@@ -0,0 +1,54 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::_priv::ioDiskCache
+    @ingroup _priv
+    @brief on-disk content cache for http: reads
+
+    Stores the content of HTTP responses in a directory, one file per URL,
+    together with the response's cache validator (the ETag or Last-Modified
+    header). A cached file is never served without revalidation: the
+    HTTP filesystem sends the validator with the request, and only uses
+    the cached content if the server answers with NotModified.
+
+    The cache files are named after a 64-bit hash of the URL and also
+    contain the URL, so hash collisions are detected. A file is written
+    to a temporary file first and then renamed, so that readers never
+    see a partially written file. All functions may be called from
+    any thread.
+*/
+#include "Core/Containers/Buffer.h"
+#include "Core/String/String.h"
+#include "IO/IOTypes.h"
+
+namespace Oryol {
+namespace _priv {
+
+class ioDiskCache {
+public:
+    /// setup the disk cache with a directory (created if it doesn't exist)
+    static void setup(const String& path);
+    /// discard the disk cache (keeps the files)
+    static void discard();
+    /// return true if the disk cache has been setup
+    static bool isValid();
+    /// lookup an URL, return validator and content
+    static bool lookup(const String& url, String& outValidator, Buffer& outData);
+    /// store the content of an URL, return false if the file couldn't be written
+    static bool store(const String& url, const String& validator, const uint8_t* data, int size);
+    /// remove an URL from the cache
+    static void remove(const String& url);
+    /// count a revalidated disk cache hit (content was served from the cache)
+    static void countHit();
+    /// add the disk cache stats to a stats object
+    static void getStats(IOCacheStats& stats);
+    /// reset the disk cache stats
+    static void resetStats();
+
+private:
+    /// get the path of the cache file for an URL
+    static String filePath(const String& url);
+};
+
+} // namespace _priv
+} // namespace Oryol
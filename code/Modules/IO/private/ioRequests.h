@@ -12,6 +12,7 @@
 #include "Core/RefCounted.h"
 #include "Core/Containers/Buffer.h"
 #include "IO/IOTypes.h"
+#include <functional>
 
 namespace Oryol {
 namespace _priv {
@@ -21,12 +22,35 @@ class ioMsg : public RefCounted {
     OryolBaseTypeDecl(ioMsg);
 public:
     ioMsg() : Handled(false), Cancelled(false) { };
+    /// return true if this message or its CancelSource has been cancelled
+    bool IsCancelled() const {
+        return this->Cancelled || ((nullptr != this->CancelSource) && this->CancelSource->Cancelled);
+    };
+    /// cancel the message, unlike setting Cancelled directly, this also
+    /// lets the IO workers complete the message early if it is still queued
+    void Cancel() {
+        this->Cancelled = true;
+        CancelCount()++;
+    };
+    /// optional message which is checked for cancellation in IsCancelled(), this
+    /// lets a filesystem abort a private sub-request when the original request
+    /// is cancelled (the cancel source must outlive this message)
+    const ioMsg* CancelSource = nullptr;
     #if ORYOL_HAS_ATOMIC
     std::atomic<bool> Handled;
     std::atomic<bool> Cancelled;
+    /// process-wide number of Cancel() calls, checked by the IO workers
+    static std::atomic<uint32_t>& CancelCount() {
+        static std::atomic<uint32_t> count(0);
+        return count;
+    };
     #else
     bool Handled;
     bool Cancelled;
+    static uint32_t& CancelCount() {
+        static uint32_t count = 0;
+        return count;
+    };
     #endif
 };
 } // namespace _priv;
@@ -36,12 +60,22 @@ class IORequest : public _priv::ioMsg {
     OryolClassDecl(IORequest);
     OryolTypeDecl(IORequest, _priv::ioMsg);
 public:
+    /// completion callback, called on the main thread
+    typedef std::function<void(const Ptr<IORequest>& ioReq)> CompletedFunc;
+
     URL Url;
     int StartOffset = 0;
     int EndOffset = EndOfFile;
     Buffer Data;
     IOStatus::Code Status = IOStatus::InvalidIOStatus;
     String ErrorDesc;
+    /// requests with a higher priority are handled first by their IO worker,
+    /// must be set before the request is put
+    int Priority = 0;
+    /// optional callback, called once on the main thread after the request
+    /// has been handled, must be set before the request is put (and
+    /// may be cleared on the main thread to ignore the completion)
+    CompletedFunc OnCompleted;
 };
 
 //------------------------------------------------------------------------------
@@ -49,8 +83,18 @@ class IORead : public IORequest {
     OryolClassDecl(IORead);
     OryolTypeDecl(IORead, IORequest);
 public:
+    /// serve the read from the IO caches if possible
     bool CacheReadEnabled = false;
+    /// store the result of the read in the IO caches
     bool CacheWriteEnabled = false;
+    /// set by IO if the read has been served from the in-memory cache
+    bool MemoryCacheHit = false;
+    /// cache validator (ETag or Last-Modified) of a http: response, a
+    /// filesystem may answer with NotModified if this is set before the read
+    String CacheValidator;
+    /// allow the filesystem to memory-map the file, Data then
+    /// wraps the mapped memory instead of holding a copy
+    bool MapEnabled = false;
 };
 
 //------------------------------------------------------------------------------
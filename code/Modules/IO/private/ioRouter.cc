@@ -3,51 +3,121 @@
 //------------------------------------------------------------------------------
 #include "Pre.h"
 #include "ioRouter.h"
+#include "Core/Memory/Memory.h"
+#include <cstring>
 
 namespace Oryol {
 namespace _priv {
 
 //------------------------------------------------------------------------------
 void
-ioRouter::setup(const ioPointers& ptrs) {
-    for (auto& worker : this->workers) {
-        worker.start(ptrs);
+ioRouter::setup(const IOSetup& setup, const ioPointers& ptrs) {
+    o_assert(this->workers.Empty());
+    o_assert((setup.NumWorkers > 0) && (setup.NumSlowWorkers >= 0));
+    #if ORYOL_HAS_THREADS
+    this->numFastWorkers = setup.NumWorkers;
+    this->numSlowWorkers = setup.NumSlowWorkers;
+    #else
+    // without threads, workers are pumped on the main thread,
+    // so more than one doesn't make sense
+    this->numFastWorkers = 1;
+    this->numSlowWorkers = 0;
+    #endif
+    this->slowSchemes = setup.SlowSchemes;
+    const int numWorkers = this->numFastWorkers + this->numSlowWorkers;
+    this->workers.Reserve(numWorkers);
+    for (int i = 0; i < numWorkers; i++) {
+        ioWorker* worker = Memory::New<ioWorker>();
+        worker->start(ptrs);
+        this->workers.Add(worker);
     }
 }
 
 //------------------------------------------------------------------------------
 void
 ioRouter::discard() {
-    for (auto& worker : this->workers) {
-        worker.stop();
+    for (ioWorker* worker : this->workers) {
+        worker->stop();
+        Memory::Delete(worker);
     }
+    this->workers.Clear();
+    this->numFastWorkers = 0;
+    this->numSlowWorkers = 0;
 }
 
 //------------------------------------------------------------------------------
 void
 ioRouter::doWork() {
-    for (auto& worker : this->workers) {
-        worker.doWork();
+    for (ioWorker* worker : this->workers) {
+        worker->doWork();
     }
 }
 
+//------------------------------------------------------------------------------
+void
+ioRouter::takeCompleted(Array<Ptr<IORequest>>& outRequests) {
+    for (ioWorker* worker : this->workers) {
+        worker->takeCompleted(outRequests);
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+ioRouter::isSlowURL(const URL& url) const {
+    // NOTE: compare the scheme in place, URL::Scheme() would allocate
+    const char* str = url.AsCStr();
+    for (const StringAtom& scheme : this->slowSchemes) {
+        const int len = scheme.Length();
+        if ((0 == std::strncmp(str, scheme.AsCStr(), len)) && (':' == str[len])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+ioWorker*
+ioRouter::leastLoadedWorker(int first, int num) {
+    o_assert_dbg(num > 0);
+    // start at a rotating index, so that idle workers are used in turn
+    this->curWorker = (this->curWorker + 1) % num;
+    ioWorker* best = nullptr;
+    int bestLoad = 0;
+    for (int i = 0; i < num; i++) {
+        ioWorker* worker = this->workers[first + ((this->curWorker + i) % num)];
+        const int load = worker->numPending();
+        if ((nullptr == best) || (load < bestLoad)) {
+            best = worker;
+            bestLoad = load;
+            if (0 == load) {
+                break;
+            }
+        }
+    }
+    return best;
+}
+
 //------------------------------------------------------------------------------
 void
 ioRouter::put(const Ptr<ioMsg>& msg) {
     if (msg->IsA<notifyWorkers>()) {
         // notifyWorker messages must be distributed to all workers
-        for (auto& worker : this->workers) {
-            worker.put(msg);
+        for (ioWorker* worker : this->workers) {
+            worker->put(msg);
         }
     }
     else {
-        // for all other messages, use a round-robin dispatch
-        this->curWorker = (this->curWorker + 1) % NumWorkers;
-        this->workers[this->curWorker].put(msg);
+        // for all other messages, use the least loaded worker of the lane
+        o_assert_dbg(msg->IsA<IORequest>());
+        const Ptr<IORequest>& ioReq = msg.unsafeCast<IORequest>();
+        if ((this->numSlowWorkers > 0) && this->isSlowURL(ioReq->Url)) {
+            this->leastLoadedWorker(this->numFastWorkers, this->numSlowWorkers)->put(msg);
+        }
+        else {
+            this->leastLoadedWorker(0, this->numFastWorkers)->put(msg);
+        }
     }
 }
 
 } // namespace _priv
 } // namespace Oryol
-
-
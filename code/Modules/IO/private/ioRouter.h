@@ -4,8 +4,21 @@
     @class Oryol::_priv::ioRouter
     @ingroup IO
     @brief route IO requests to ioWorkers
+
+    The workers are split into two lanes: fast workers for local
+    filesystems, and slow workers for filesystems which may block
+    for a long time (e.g. http), so that slow requests never hold up
+    fast requests. Within a lane, a request goes to the worker with
+    the fewest pending messages (ties are broken round-robin).
+    If the slow lane has no workers, all requests use the fast lane.
+
+    NOTE: the worker message queues are single-consumer, so idle
+    workers can't steal queued requests from busy workers, the
+    load-aware dispatch keeps new requests away from busy workers
+    instead.
 */
-#include "Core/Containers/StaticArray.h"
+#include "Core/Containers/Array.h"
+#include "IO/IOTypes.h"
 #include "IO/private/ioPointers.h"
 #include "IO/private/ioWorker.h"
 
@@ -15,17 +28,26 @@ namespace _priv {
 class ioRouter {
 public:
     /// setup the router
-    void setup(const ioPointers& ptrs);
+    void setup(const IOSetup& setup, const ioPointers& ptrs);
     /// discard the router
     void discard();
     /// route a ioMsg to one or more workers
     void put(const Ptr<ioMsg>& msg);
     /// perform per-frame work
     void doWork();
+    /// move requests which went through a filesystem to the end of outRequests
+    void takeCompleted(Array<Ptr<IORequest>>& outRequests);
+
+    /// return true if an URL is handled by the slow lane
+    bool isSlowURL(const URL& url) const;
+    /// select the least loaded worker in a range of workers
+    ioWorker* leastLoadedWorker(int first, int num);
 
-    static const int NumWorkers = 4;
+    int numFastWorkers = 0;
+    int numSlowWorkers = 0;
     int curWorker = 0;
-    StaticArray<ioWorker, NumWorkers> workers;
+    Array<ioWorker*> workers;       // fast workers first, then slow workers
+    Array<StringAtom> slowSchemes;
 };
 
 } // namespace _priv
@@ -4,13 +4,21 @@
 #include "Pre.h"
 #include "ioWorker.h"
 #include "IO/private/schemeRegistry.h"
+#include "Core/Trace.h"
+#include <algorithm>
+#include <utility>
 
 namespace Oryol {
 namespace _priv {
 
 //------------------------------------------------------------------------------
 ioWorker::ioWorker() :
-threadStopRequested(false) {
+msgQueue(MsgQueueCapacity),
+#if ORYOL_HAS_THREADS
+threadIdle(false),
+#endif
+threadStopRequested(false),
+pendingCount(0) {
     // empty
 }
 
@@ -32,8 +40,13 @@ ioWorker::stop() {
     o_assert(this->threadStartRequested);
     this->threadStopRequested = true;
     #if ORYOL_HAS_THREADS
-        this->transferCondVar.notify_one();
-        this->thread.join();
+    {
+        // take the lock so that the wakeup can't get lost between
+        // the thread checking its wait condition and going to sleep
+        std::lock_guard<std::mutex> lock(this->wakeupMutex);
+        this->wakeupCondVar.notify_one();
+    }
+    this->thread.join();
     #endif
     this->threadStopped = true;
 }
@@ -44,37 +57,106 @@ ioWorker::put(const Ptr<ioMsg>& msg) {
     o_assert(this->isSendThread());
     o_assert(this->threadStartRequested);
     o_assert(!this->threadStopped);
-    this->writeQueue.Enqueue(msg);
+    // keep message order: only bypass the overflow queue if it is empty
+    o_trace_counter_add(IO_QueueDepth, 1);
+    this->pendingCount++;
+    if (!this->overflowQueue.Empty() || !this->msgQueue.Enqueue(msg)) {
+        this->overflowQueue.Enqueue(msg);
+        o_trace_counter_add(IO_OverflowQueueDepth, 1);
+    }
 }
 
 //------------------------------------------------------------------------------
 void
 ioWorker::doWork() {
-    // move messages to transfer queue and wake up thread if work needs to be done
     o_assert(this->isSendThread());
     o_assert(this->threadStartRequested);
     o_assert(!this->threadStopped);
-    if (!this->writeQueue.Empty()) {
-        this->moveWriteToTransferQueue();
-    }
-    o_assert_dbg(this->writeQueue.Empty());
 
     #if ORYOL_HAS_THREADS
-    {
-        std::lock_guard<std::mutex> lock(this->transferMutex);
-        if (!this->transferQueue.Empty()) {
-            this->transferCondVar.notify_one();
+        this->flushOverflowQueue();
+        if (!this->msgQueue.Empty()) {
+            this->wakeup();
         }
-    }
+    #else
+        // if platform has no threads, pump the message queue right here
+        do {
+            this->flushOverflowQueue();
+            this->dequeueMessages();
+            while (this->handleNextRequest()) {
+                // empty
+            }
+        }
+        while (!this->overflowQueue.Empty());
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+ioWorker::addCompleted(const Ptr<IORequest>& ioReq) {
+    o_assert_dbg(this->isWorkerThread());
+    #if ORYOL_HAS_THREADS
+    std::lock_guard<std::mutex> lock(this->completedMutex);
     #endif
+    this->completed.Add(ioReq);
+}
 
-    #if !ORYOL_HAS_THREADS
-        // if platform has no threads, pump the message queue right
-        // FIXME: we could do without all those queue transfers here!
-        this->moveTransferToReadQueue();
-        while (!this->readQueue.Empty()) {
-            this->onMsg(std::move(this->readQueue.Dequeue()));
+//------------------------------------------------------------------------------
+void
+ioWorker::takeCompleted(Array<Ptr<IORequest>>& outRequests) {
+    o_assert_dbg(this->isSendThread());
+    #if ORYOL_HAS_THREADS
+    std::lock_guard<std::mutex> lock(this->completedMutex);
+    #endif
+    if (this->completed.Empty()) {
+        return;
+    }
+    if (outRequests.Empty()) {
+        // fast path: swap the arrays, this leaves the completion
+        // list empty, but keeps the capacity of both arrays, so
+        // that neither side needs to allocate in the next frame
+        std::swap(outRequests, this->completed);
+        return;
+    }
+    // the lock is only held for moving the pointers
+    outRequests.Reserve(this->completed.Size());
+    for (auto& ioReq : this->completed) {
+        outRequests.Add(std::move(ioReq));
+    }
+    this->completed.Clear();
+}
+
+//------------------------------------------------------------------------------
+int
+ioWorker::numPending() const {
+    return this->pendingCount;
+}
+
+//------------------------------------------------------------------------------
+void
+ioWorker::flushOverflowQueue() {
+    o_assert_dbg(this->isSendThread());
+    while (!this->overflowQueue.Empty()) {
+        if (!this->msgQueue.Enqueue(this->overflowQueue.Front())) {
+            // message queue is full, try again next frame
+            break;
         }
+        this->overflowQueue.Dequeue();
+        o_trace_counter_add(IO_OverflowQueueDepth, -1);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+ioWorker::wakeup() {
+    #if ORYOL_HAS_THREADS
+    // the fence pairs with the fence in threadFunc(): either we see that
+    // the thread went idle, or the thread sees the new messages
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (this->threadIdle.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(this->wakeupMutex);
+        this->wakeupCondVar.notify_one();
+    }
     #endif
 }
 
@@ -83,24 +165,35 @@ ioWorker::doWork() {
 void
 ioWorker::threadFunc(ioWorker* self) {
     self->workThreadId = std::this_thread::get_id();
+    Memory::ScopedTag memTag(MemoryTag::IO);
+    #if ORYOL_USE_TRACERECORDER
+    TraceRecorder::SetThreadName("IOWorker");
+    #endif
 
-    // the message processing loop waits for messages to arrive,
-    // moves them from the transfer queue, processes them then goes back to sleep
+    // process messages until the queue runs dry, then go to sleep
+    // until the sender thread wakes us up again
     while (!self->threadStopRequested) {
-
-        // wait for messages to arrive, and if so, transfer to read queue
         {
-            std::unique_lock<std::mutex> lock(self->transferMutex);
-            self->transferCondVar.wait(lock);
-            self->moveTransferToReadQueue();
-            lock.unlock();
-        }
-
-        // now process the messages, this happens without locking
-        while (!self->readQueue.Empty()) {
-            self->onMsg(std::move(self->readQueue.Dequeue()));
+            o_trace_scoped(IO_ProcessMessages);
+            // look for new requests before each request, so that a new
+            // high-priority request doesn't need to wait until the queue
+            // has been drained
+            do {
+                self->dequeueMessages();
+            }
+            while (self->handleNextRequest());
         }
+        std::unique_lock<std::mutex> lock(self->wakeupMutex);
+        self->threadIdle.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        self->wakeupCondVar.wait(lock, [self] {
+            return self->threadStopRequested || !self->msgQueue.Empty();
+        });
+        self->threadIdle.store(false, std::memory_order_relaxed);
     }
+    // the filesystems are owned by the worker thread (see onMsg()),
+    // so they must also be released here
+    self->fileSystems.Clear();
 }
 #endif
 
@@ -125,44 +218,15 @@ ioWorker::isWorkerThread() {
 }
 
 //------------------------------------------------------------------------------
-void
-ioWorker::moveWriteToTransferQueue() {
-    o_assert(this->isSendThread());
-    // if the transfer queue is empty, we can do a very fast complete move
-    {
-        #if ORYOL_HAS_THREADS
-        std::lock_guard<std::mutex> lock(this->transferMutex);
-        #endif
-        if (this->transferQueue.Empty()) {
-            this->transferQueue = std::move(this->writeQueue);
-        }
-        else {
-            // otherwise move messages one by one
-            while (!this->writeQueue.Empty()) {
-                this->transferQueue.Enqueue(this->writeQueue.Dequeue());
-            }
-        }
-    }
-}
-
-//------------------------------------------------------------------------------
-void
-ioWorker::moveTransferToReadQueue() {
-    o_assert(this->isWorkerThread());
-    o_assert(this->readQueue.Empty());
-    this->readQueue = std::move(this->transferQueue);
-}
-
-//------------------------------------------------------------------------------
-Ptr<FileSystemBase>
+Borrowed<FileSystemBase>
 ioWorker::fileSystemForURL(const URL& url) {
     StringAtom scheme = url.Scheme();
     if (this->fileSystems.Contains(scheme)) {
-        return this->fileSystems[scheme];
+        return this->fileSystems[scheme].borrow();
     }
     else {
         o_warn("ioLane::fileSystemForURL: no filesystem registered for URL scheme '%s'!\n", scheme.AsCStr());
-        return Ptr<FileSystemBase>();
+        return nullptr;
     }
 }
 
@@ -179,28 +243,127 @@ ioWorker::checkCancelled(const Ptr<IORequest>& msg) {
     }
 }
 
+//------------------------------------------------------------------------------
+bool
+ioWorker::laterEntry(const queueEntry& a, const queueEntry& b) {
+    // equal keys only happen for different priorities, the
+    // request which arrived later has the higher priority
+    if (a.key != b.key) {
+        return a.key > b.key;
+    }
+    else {
+        return a.seq < b.seq;
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+ioWorker::dequeueMessages() {
+    o_assert_dbg(this->isWorkerThread());
+    bool dequeued = false;
+    Ptr<ioMsg> msg;
+    while (this->msgQueue.Dequeue(msg)) {
+        dequeued = true;
+        if (msg->IsA<IORequest>()) {
+            if (msg->Cancelled) {
+                // never goes into the priority queue
+                this->onMsg(msg);
+            }
+            else {
+                queueEntry entry;
+                entry.seq = this->requestSeq++;
+                entry.key = entry.seq - int64_t(msg.unsafeCast<IORequest>()->Priority) * PriorityAging;
+                entry.msg = std::move(msg);
+                this->requestQueue.Add(std::move(entry));
+                std::push_heap(this->requestQueue.begin(), this->requestQueue.end(), laterEntry);
+            }
+        }
+        else {
+            // a filesystem notification must not overtake queued requests
+            while (this->handleNextRequest()) {
+                // empty
+            }
+            this->onMsg(msg);
+        }
+    }
+    return dequeued;
+}
+
+//------------------------------------------------------------------------------
+bool
+ioWorker::handleNextRequest() {
+    o_assert_dbg(this->isWorkerThread());
+    // cancelled requests may be anywhere in the heap, complete them right
+    // away instead of when they come up, so that they don't count as load,
+    // the heap is only scanned if a request has been cancelled since the
+    // last scan (requests which had their Cancelled flag set directly are
+    // completed when they come up)
+    const uint32_t cancelCount = ioMsg::CancelCount();
+    if (cancelCount != this->lastCancelCount) {
+        this->lastCancelCount = cancelCount;
+        this->pruneCancelled();
+    }
+    if (this->requestQueue.Empty()) {
+        return false;
+    }
+    std::pop_heap(this->requestQueue.begin(), this->requestQueue.end(), laterEntry);
+    Ptr<ioMsg> msg = this->requestQueue.PopBack().msg;
+    this->onMsg(msg);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+void
+ioWorker::pruneCancelled() {
+    o_assert_dbg(this->isWorkerThread());
+    bool pruned = false;
+    for (int i = this->requestQueue.Size() - 1; i >= 0; i--) {
+        if (this->requestQueue[i].msg->Cancelled) {
+            Ptr<ioMsg> msg = std::move(this->requestQueue[i].msg);
+            this->requestQueue.EraseSwapBack(i);
+            this->onMsg(msg);
+            pruned = true;
+        }
+    }
+    if (pruned) {
+        std::make_heap(this->requestQueue.begin(), this->requestQueue.end(), laterEntry);
+    }
+}
+
 //------------------------------------------------------------------------------
 void
 ioWorker::onMsg(const Ptr<ioMsg>& msg) {
+    o_trace_scoped(IO_OnMsg);
     if (msg->IsA<IORequest>()) {
         // find filesystem and forward request, NOTE:
         // the filesystem is responsible to set the
-        // request to 'handled'!
-        Ptr<IORequest> ioReq = msg->DynamicCast<IORequest>();
-        if (!this->checkCancelled(ioReq)) {
+        // request to 'handled'! The request is not copied,
+        // since this would touch its (shared) reference count
+        const Ptr<IORequest>& ioReq = msg.unsafeCast<IORequest>();
+        o_trace_counter_add(IO_NumRequests, 1);
+        if (this->checkCancelled(ioReq)) {
+            this->addCompleted(ioReq);
+        }
+        else {
             auto fs = this->fileSystemForURL(ioReq->Url);
             if (fs) {
                 fs->onMsg(ioReq);
+                this->addCompleted(ioReq);
             }
         }
     }
     else if (msg->IsA<notifyWorkers>()) {
-        // add, remove or replace a filesystem association
-        const StringAtom& urlScheme = msg->DynamicCast<notifyWorkers>()->Scheme;
+        // add, remove or replace a filesystem association, NOTE: atoms
+        // from different string atom tables can't be compared, the
+        // message's scheme (main thread) is used for the scheme registry,
+        // a copy in this thread's table for the local filesystem map
+        const StringAtom& msgScheme = msg->DynamicCast<notifyWorkers>()->Scheme;
+        const StringAtom urlScheme(msgScheme);
         if (msg->IsA<notifyFileSystemAdded>()) {
             o_assert(!this->fileSystems.Contains(urlScheme));
-            auto newFileSystem = this->pointers.schemeRegistry->CreateFileSystem(urlScheme);
-            this->fileSystems.Add(urlScheme, newFileSystem);
+            auto newFileSystem = this->pointers.schemeRegistry->CreateFileSystem(msgScheme);
+            newFileSystem->SetSingleThreaded();
+            this->fileSystems.Add(urlScheme, std::move(newFileSystem));
         }
         else if (msg->IsA<notifyFileSystemRemoved>()) {
             o_assert(this->fileSystems.Contains(urlScheme));
@@ -208,11 +371,14 @@ ioWorker::onMsg(const Ptr<ioMsg>& msg) {
         }
         else if (msg->IsA<notifyFileSystemReplaced>()) {
             o_assert(this->fileSystems.Contains(urlScheme));
-            auto newFileSystem = this->pointers.schemeRegistry->CreateFileSystem(urlScheme);
-            this->fileSystems[urlScheme] = newFileSystem;
+            auto newFileSystem = this->pointers.schemeRegistry->CreateFileSystem(msgScheme);
+            newFileSystem->SetSingleThreaded();
+            this->fileSystems[urlScheme] = std::move(newFileSystem);
         }
         msg->Handled = true;
     }
+    o_trace_counter_add(IO_QueueDepth, -1);
+    this->pendingCount--;
 }
 
 } // namespace _priv
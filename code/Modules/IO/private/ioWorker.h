@@ -5,15 +5,41 @@
     @ingroup IO
     @brief worker thread to forward IO requests to filesystem implementations
     
-    An ioWorker is basically a message queue with a thread behind it. To
-    remove granular locking it is pumped by the runloop. Once per
-    runloop-frame, messages from the main thread will be moved to a
-    'transfer queue', and the worker thread will be signaled. The 
-    worker thread wakes up, moves the messages from the transfer queue
-    to a read-queue, processes them and goes back to sleep.
+    An ioWorker is basically a message queue with a thread behind it.
+    Messages are handed from the main thread to the worker thread
+    through a lock-free SPSCQueue, if the queue is full, messages
+    are kept in a local overflow queue on the main thread until there
+    is room again. The worker is pumped by the runloop: once per
+    runloop-frame the overflow queue is flushed, and the worker thread
+    is woken up if it went to sleep because it ran out of messages. The
+    mutex is only touched for this wake-up, never for handing over
+    messages.
+
+    The worker thread moves the requests from the message queue into
+    a worker-local priority queue, and always handles the request with
+    the highest IORequest::Priority next. To prevent starvation, each
+    request is aged by its arrival order: a request is treated as if
+    it had arrived PriorityAging requests earlier per priority level,
+    so a low-priority request can only be overtaken by a bounded number
+    of later requests. If a request has been cancelled with
+    ioMsg::Cancel() since the last request was handled, cancelled requests
+    are removed from the priority queue before the next request is
+    handled, so that they never reach a filesystem, and don't count as
+    pending work of the worker. Other cancelled requests are completed
+    when they come up.
+    Filesystem notifications are not reordered, all queued requests
+    are handled before a notification.
+
+    Requests which went through a filesystem are put into a completion
+    list, which the main thread takes over once per frame, so that
+    the main thread doesn't need to poll each request in flight. The
+    completion list is protected by its own mutex, which is only held
+    to add one request, or to swap or drain the list.
 */
 #include "Core/Config.h"
+#include "Core/Containers/Array.h"
 #include "Core/Containers/Queue.h"
+#include "Core/Containers/SPSCQueue.h"
 #include "Core/Containers/Map.h"
 #include "Core/String/StringAtom.h"
 #include "IO/private/ioPointers.h"
@@ -39,15 +65,27 @@ public:
     void stop();
     /// put an io message into the internal message queue
     void put(const Ptr<ioMsg>& msg);
-    /// do work on the main thread, this moves queued messages to transfer queue
+    /// do work on the main thread, this flushes the overflow queue and wakes up the thread
     void doWork();
+    /// move requests which went through a filesystem to the end of outRequests (main thread)
+    void takeCompleted(Array<Ptr<IORequest>>& outRequests);
+    /// get number of messages which have been put but not processed yet
+    int numPending() const;
 
     /// lookup filesystem for URL
-    Ptr<FileSystemBase> fileSystemForURL(const URL& url);
+    Borrowed<FileSystemBase> fileSystemForURL(const URL& url);
     /// check for and handle cancelled message
     bool checkCancelled(const Ptr<IORequest>& msg);
     /// called from thread to handle a generic message
     void onMsg(const Ptr<ioMsg>& msg);
+    /// called from thread to move messages into the priority queue, return true if any were dequeued
+    bool dequeueMessages();
+    /// called from thread to prune cancelled requests if needed and handle the highest-priority request, return false if none is queued
+    bool handleNextRequest();
+    /// called from thread to remove and complete cancelled requests in the priority queue
+    void pruneCancelled();
+    /// called from thread to add a request to the completion list
+    void addCompleted(const Ptr<IORequest>& ioReq);
     /// the thread worker func
     #if ORYOL_HAS_THREADS
     static void threadFunc(ioWorker* self);
@@ -56,29 +94,50 @@ public:
     bool isSendThread();
     /// test if we are on the worker-thread
     bool isWorkerThread();
-    /// move messages from the write queue to the transfer queue
-    void moveWriteToTransferQueue();
-    /// move messages from transfer queue to read queue
-    void moveTransferToReadQueue();
+    /// move messages from the overflow queue into the message queue
+    void flushOverflowQueue();
+    /// wake up the worker thread if it is sleeping
+    void wakeup();
+
+    /// capacity of the lock-free message queue
+    static const int MsgQueueCapacity = 256;
+    /// number of requests a request may be overtaken by per priority level
+    static const int PriorityAging = 16;
+
+    /// an entry in the worker-local priority queue
+    struct queueEntry {
+        int64_t key = 0;        // arrival order minus priority bonus, smallest first
+        int64_t seq = 0;        // arrival order
+        Ptr<ioMsg> msg;
+    };
+    /// heap order of the priority queue (std heaps are max-heaps)
+    static bool laterEntry(const queueEntry& a, const queueEntry& b);
 
     ioPointers pointers;
     Map<StringAtom, Ptr<FileSystemBase>> fileSystems;
 
-    Queue<Ptr<ioMsg>> writeQueue;     // written by sender thread
-    Queue<Ptr<ioMsg>> transferQueue;  // written by sender, read by worker thread (locked)
-    Queue<Ptr<ioMsg>> readQueue;      // read by worker thread
+    SPSCQueue<Ptr<ioMsg>> msgQueue;   // written by sender, read by worker thread
+    Queue<Ptr<ioMsg>> overflowQueue;  // only accessed by sender thread
+    Array<Ptr<IORequest>> completed;  // written by worker thread, taken by sender thread
+    Array<queueEntry> requestQueue;   // only accessed by worker thread, a heap
+    int64_t requestSeq = 0;           // only accessed by worker thread
+    uint32_t lastCancelCount = 0;     // only accessed by worker thread
 
     #if ORYOL_HAS_THREADS
     std::thread::id sendThreadId;
     std::thread::id workThreadId;
     std::thread thread;
-    std::mutex transferMutex;
-    std::condition_variable transferCondVar;
+    std::mutex wakeupMutex;
+    std::condition_variable wakeupCondVar;
+    std::mutex completedMutex;
+    std::atomic<bool> threadIdle;
     #endif
     #if ORYOL_HAS_ATOMIC
     std::atomic<bool> threadStopRequested;
+    std::atomic<int> pendingCount;      // incremented by sender, decremented by worker
     #else
     bool threadStopRequested;
+    int pendingCount;
     #endif
     bool threadStartRequested = false;
     bool threadStopped = false;
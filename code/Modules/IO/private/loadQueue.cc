@@ -3,9 +3,8 @@
 //------------------------------------------------------------------------------
 #include "Pre.h"
 #include "loadQueue.h"
-#include "Core/Core.h"
-#include "Core/RunLoop.h"
 #include "IO/IO.h"
+#include "Core/Trace.h"
 
 namespace Oryol {
 
@@ -13,105 +12,99 @@ namespace Oryol {
 void
 loadQueue::add(const URL& url, successFunc onSuccess, failFunc onFail) {
     o_assert_dbg(onSuccess);
-    Ptr<IORead> ioReq = IORead::Create();
-    ioReq->Url = url;
-    IO::Put(ioReq);
-    this->items.Add(item{ ioReq, onSuccess, onFail });
+    this->numPendingItems++;
+    IO::LoadFile(url, [this, onSuccess, onFail](const Ptr<IORequest>& ioReq) {
+        this->onItemCompleted(ioReq, onSuccess, onFail);
+    });
 }
 
 //------------------------------------------------------------------------------
 void
 loadQueue::addGroup(const Array<URL>& urls, groupSuccessFunc onSuccess, failFunc onFail) {
     o_assert_dbg(onSuccess);
-    
+    if (urls.Empty()) {
+        onSuccess(Array<result>());
+        return;
+    }
+
+    // NOTE: completion callbacks are never called from inside
+    // IO::LoadFile(), so it's ok to add the group item after
+    // the requests have been started
+    const int groupId = this->uniqueGroupId++;
     groupItem item;
     item.ioRequests.Reserve(urls.Size());
+    item.numPendingRequests = urls.Size();
+    item.onSuccess = onSuccess;
+    item.onFail = onFail;
     for (const URL& url : urls) {
-        Ptr<IORead> ioReq = IORead::Create();
-        ioReq->Url = url;
-        IO::Put(ioReq);
-        item.ioRequests.Add(ioReq);
-        item.onSuccess = onSuccess;
-        item.onFail = onFail;
+        item.ioRequests.Add(IO::LoadFile(url, [this, groupId](const Ptr<IORequest>& ioReq) {
+            this->onGroupRequestCompleted(groupId, ioReq);
+        }));
     }
-    this->groupItems.Add(item);
+    this->groupItems.Add(KeyValuePair<int, groupItem>(int(groupId), std::move(item)));
 }
 
 //------------------------------------------------------------------------------
 int
 loadQueue::numPending() const {
-    return this->items.Size() + this->groupItems.Size();
+    return this->numPendingItems + this->groupItems.Size();
 }
 
 //------------------------------------------------------------------------------
 void
-loadQueue::update() {
+loadQueue::failed(const Ptr<IORequest>& ioReq, const failFunc& onFail) {
+    if (onFail) {
+        onFail(ioReq->Url, ioReq->Status);
+    }
+    else {
+        // no fail handler was set, just print a warning
+        o_warn("loadQueue:: failed to load file '%s' with '%s'\n",
+            ioReq->Url.AsCStr(), IOStatus::ToString(ioReq->Status));
+    }
+}
 
-    // check single items
-    for (int i = this->items.Size() - 1; i >= 0; --i) {
-        const item& curItem = this->items[i];
-        const auto& ioReq = curItem.ioRequest;
-        if (ioReq->Handled) {
-            // io request has been handled
-            if (IOStatus::OK == ioReq->Status) {
-                // io request was successful
-                curItem.onSuccess(result(ioReq->Url, std::move(ioReq->Data)));
-            }
-            else {
-                // io request failed
-                if (curItem.onFail) {
-                    curItem.onFail(ioReq->Url, ioReq->Status);
-                }
-                else {
-                    // no fail handler was set, just print a warning
-                    o_warn("loadQueue:: failed to load file '%s' with '%s'\n",
-                        ioReq->Url.AsCStr(), IOStatus::ToString(ioReq->Status));
-                }
-            }
-            // remove the handled io request from the queue
-            this->items.Erase(i);
-        }
+//------------------------------------------------------------------------------
+void
+loadQueue::onItemCompleted(const Ptr<IORequest>& ioReq, const successFunc& onSuccess, const failFunc& onFail) {
+    o_trace_scoped(IO_LoadQueueItemCompleted);
+    o_assert_dbg(this->numPendingItems > 0);
+    this->numPendingItems--;
+    if (IOStatus::OK == ioReq->Status) {
+        onSuccess(result(ioReq->Url, std::move(ioReq->Data)));
     }
-    
-    // check group items
-    for (int i = this->groupItems.Size() - 1; i >= 0; --i) {
-        const groupItem& curItem = this->groupItems[i];
-        bool allHandled = true;
-        bool anyFailed = false;
-        for (const auto& ioReq : curItem.ioRequests) {
-            if (ioReq->Handled) {
-                if (IOStatus::OK != ioReq->Status) {
-                    anyFailed = true;
-                    if (curItem.onFail) {
-                        curItem.onFail(ioReq->Url, ioReq->Status);
-                    }
-                    else {
-                        o_warn("loadQueue:: failed to load file '%s' with '%s'\n",
-                            ioReq->Url.AsCStr(), IOStatus::ToString(ioReq->Status));
-                    }
-                }
-            }
-            else {
-                allHandled = false;
-                break;
+    else {
+        failed(ioReq, onFail);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+loadQueue::onGroupRequestCompleted(int groupId, const Ptr<IORequest>& ioReq) {
+    o_trace_scoped(IO_LoadQueueGroupCompleted);
+    o_assert_dbg(this->groupItems.Contains(groupId));
+    groupItem& item = this->groupItems[groupId];
+    if (IOStatus::OK != ioReq->Status) {
+        item.anyFailed = true;
+        failed(ioReq, item.onFail);
+    }
+    o_assert_dbg(item.numPendingRequests > 0);
+    if (0 == --item.numPendingRequests) {
+        // all requests in this group have been handled, if all
+        // were successful, call the success-callback
+        if (!item.anyFailed) {
+            Array<result> results;
+            results.Reserve(item.ioRequests.Size());
+            for (const auto& req : item.ioRequests) {
+                results.Add(req->Url, std::move(req->Data));
             }
+            groupSuccessFunc onSuccess(std::move(item.onSuccess));
+            this->groupItems.Erase(groupId);
+            onSuccess(std::move(results));
         }
-        
-        // if all request in this group have been handled, remove item, and
-        // if all were successful, call the success-callback
-        if (allHandled) {
-            if (!anyFailed) {
-                Array<result> result;
-                result.Reserve(curItem.ioRequests.Size());
-                for (const auto& ioReq : curItem.ioRequests) {
-                    result.Add(ioReq->Url, std::move(ioReq->Data));
-                }
-                curItem.onSuccess(std::move(result));
-            }
-            this->groupItems.Erase(i);
+        else {
+            this->groupItems.Erase(groupId);
         }
     }
 }
 
 } // namespace Oryol
-
@@ -6,11 +6,14 @@
     @brief asynchronously load multiple files, invoke callbacks with result
 
     This is the class behind the IO::Load() and LoadGroup() functions.
+    The load queue doesn't poll its requests, the result callbacks
+    are called from the IO requests' completion callbacks.
 */
 #include "Core/Types.h"
 #include "Core/String/StringAtom.h"
 #include "Core/Containers/Array.h"
 #include "Core/Containers/Buffer.h"
+#include "Core/Containers/Map.h"
 #include "IO/IOTypes.h"
 #include "IO/private/ioRequests.h"
 #include <functional>
@@ -45,23 +48,26 @@ public:
     void add(const URL& url, successFunc onSuccess, failFunc onFail=failFunc());
     /// add a file group request to the queue
     void addGroup(const Array<URL>& urls, groupSuccessFunc onSuccess, failFunc onFail=failFunc());
-    /// update the queue, called per frame from runloop
-    void update();
     /// get number of pending load actions
     int numPending() const;
 
-    struct item {
-        Ptr<IORead> ioRequest;
-        successFunc onSuccess;
-        failFunc onFail;
-    };
-    Array<item> items;
+    /// called when the request of a single item has completed
+    void onItemCompleted(const Ptr<IORequest>& ioReq, const successFunc& onSuccess, const failFunc& onFail);
+    /// called when a request of a group item has completed
+    void onGroupRequestCompleted(int groupId, const Ptr<IORequest>& ioReq);
+    /// call the fail callback, or print a warning
+    static void failed(const Ptr<IORequest>& ioReq, const failFunc& onFail);
+
+    int numPendingItems = 0;
     struct groupItem {
         Array<Ptr<IORead>> ioRequests;
+        int numPendingRequests = 0;
+        bool anyFailed = false;
         groupSuccessFunc onSuccess;
         failFunc onFail;
     };
-    Array<groupItem> groupItems;
+    Map<int, groupItem> groupItems;
+    int uniqueGroupId = 0;
 };
 
 } // namespace Oryol
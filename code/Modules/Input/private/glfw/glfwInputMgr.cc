@@ -6,6 +6,7 @@
 #include "Gfx/private/glfw/glfwDisplayMgr.h"
 #include "Core/Core.h"
 #include "Core/RunLoop.h"
+#include "Core/Replay.h"
 #include "GLFW/glfw3.h"
 
 namespace Oryol {
@@ -299,7 +300,8 @@ glfwInputMgr::updateGamepads() {
 //------------------------------------------------------------------------------
 void
 glfwInputMgr::keyCallback(GLFWwindow* win, int glfwKey, int /*glfwScancode*/, int glfwAction, int /*glfwMods*/) {
-    if (nullptr != self) {
+    // live input is ignored while a Replay is played back
+    if ((nullptr != self) && !Replay::IsPlaying()) {
         Key::Code key = self->mapKey(glfwKey);
         if (Key::InvalidKey != key) {
             if (glfwAction == GLFW_PRESS) {
@@ -318,7 +320,7 @@ glfwInputMgr::keyCallback(GLFWwindow* win, int glfwKey, int /*glfwScancode*/, in
 //------------------------------------------------------------------------------
 void
 glfwInputMgr::charCallback(GLFWwindow* win, unsigned int unicode) {
-    if (nullptr != self) {
+    if ((nullptr != self) && !Replay::IsPlaying()) {
         self->keyboard.onChar((wchar_t)unicode);
     }
 }
@@ -326,7 +328,7 @@ glfwInputMgr::charCallback(GLFWwindow* win, unsigned int unicode) {
 //------------------------------------------------------------------------------
 void
 glfwInputMgr::mouseButtonCallback(GLFWwindow* win, int glfwButton, int glfwAction, int glfwMods) {
-    if (nullptr != self) {
+    if ((nullptr != self) && !Replay::IsPlaying()) {
         MouseButton::Code btn;
         switch (glfwButton) {
             case GLFW_MOUSE_BUTTON_LEFT:    btn = MouseButton::Left; break;
@@ -357,7 +359,7 @@ glfwInputMgr::mouseButtonCallback(GLFWwindow* win, int glfwButton, int glfwActio
 //------------------------------------------------------------------------------
 void
 glfwInputMgr::cursorPosCallback(GLFWwindow* win, double glfwX, double glfwY) {
-    if (nullptr != self) {
+    if ((nullptr != self) && !Replay::IsPlaying()) {
         const glm::vec2 pos((float)glfwX, (float)glfwY);
         self->mouse.onPosMov(pos);
     }
@@ -366,7 +368,7 @@ glfwInputMgr::cursorPosCallback(GLFWwindow* win, double glfwX, double glfwY) {
 //------------------------------------------------------------------------------
 void
 glfwInputMgr::scrollCallback(GLFWwindow* win, double glfwX, double glfwY) {
-    if (nullptr != self) {
+    if ((nullptr != self) && !Replay::IsPlaying()) {
         const glm::vec2 scroll((float)glfwX, (float)glfwY);
         self->mouse.onScroll(scroll);
     }
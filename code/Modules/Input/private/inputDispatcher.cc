@@ -26,11 +26,47 @@ inputDispatcher::unsubscribeEvents(inputDefs::callbackId id) {
 //------------------------------------------------------------------------------
 void
 inputDispatcher::notifyEvent(const InputEvent& ie) {
+    if (Replay::IsRecording() && (Replay::InvalidChannelId != this->replayChannel)) {
+        this->recordEvent(ie);
+    }
     for (const auto& entry : this->inputEventHandlers) {
         entry.Value()(ie);
     }
 }
 
+//------------------------------------------------------------------------------
+void
+inputDispatcher::recordEvent(const InputEvent& ie) {
+    replayInputEvent re = { };
+    re.type = ie.Type;
+    switch (ie.Type) {
+        case InputEvent::KeyDown:
+        case InputEvent::KeyUp:
+        case InputEvent::KeyRepeat:
+            re.code = ie.KeyCode;
+            break;
+        case InputEvent::WChar:
+            re.code = int32_t(ie.WCharCode);
+            break;
+        case InputEvent::MouseButtonDown:
+        case InputEvent::MouseButtonUp:
+            re.code = ie.Button;
+            break;
+        case InputEvent::MouseMove:
+            re.x0 = ie.Position.x; re.y0 = ie.Position.y;
+            re.x1 = ie.Movement.x; re.y1 = ie.Movement.y;
+            break;
+        case InputEvent::MouseScrolling:
+            re.x0 = ie.Scrolling.x; re.y0 = ie.Scrolling.y;
+            break;
+        default:
+            // touch and gesture events are recorded as raw touchEvents
+            // by inputMgrBase, gamepads and sensors are not recorded
+            return;
+    }
+    Replay::Record(this->replayChannel, &re, sizeof(re));
+}
+
 //------------------------------------------------------------------------------
 PointerLockMode::Code
 inputDispatcher::notifyPointerLock(const InputEvent& ie) {
@@ -3,23 +3,37 @@
 /**
     @class Oryol::_priv::inputDispatcher
     @brief dispatch input module events
+
+    While a Replay is recorded, the raw keyboard and mouse events
+    going through notifyEvent() are written to the replay file.
 */
 #include "Input/InputTypes.h"
 #include "Core/Containers/Map.h"
+#include "Core/Replay.h"
 
 namespace Oryol {
 namespace _priv {
 
+/// a keyboard or mouse event as stored in a Replay file
+struct replayInputEvent {
+    int32_t type;       // InputEvent::Type
+    int32_t code;       // key code, wchar or mouse button
+    float x0, y0;       // mouse position or scrolling
+    float x1, y1;       // mouse movement
+};
+
 class inputDispatcher {
 public:
     inputDefs::callbackId subscribeEvents(inputDefs::inputEventCallback handler);
     void unsubscribeEvents(inputDefs::callbackId id);
     void notifyEvent(const InputEvent& event);
     PointerLockMode::Code notifyPointerLock(const InputEvent& event);
+    void recordEvent(const InputEvent& event);
 
     inputDefs::callbackId uniqueIdCounter = 0;
     Map<inputDefs::callbackId, inputDefs::inputEventCallback> inputEventHandlers;
     inputDefs::pointerLockCallback pointerLockHandler;
+    Replay::ChannelId replayChannel = Replay::InvalidChannelId;
 };
 
 } // namespace _priv
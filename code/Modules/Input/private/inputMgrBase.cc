@@ -3,6 +3,8 @@
 //------------------------------------------------------------------------------
 #include "Pre.h"
 #include "inputMgrBase.h"
+#include "Core/Replay.h"
+#include <cstring>
 
 namespace Oryol {
 namespace _priv {
@@ -30,12 +32,29 @@ inputMgrBase::setup(const InputSetup& setup) {
     for (const auto& item : setup.GamepadMappings) {
         this->addGamepadMapping(item.Key(), item.Value());
     }
+    this->dispatcher.replayChannel = Replay::RegisterChannel("InputEvents");
+    this->touchReplayChannel = Replay::RegisterChannel("InputTouch");
+    if (Replay::IsPlaying()) {
+        Replay::SetPlaybackHandler(this->dispatcher.replayChannel, [this](const uint8_t* data, int size) {
+            this->playbackInputEvent(data, size);
+        });
+        Replay::SetPlaybackHandler(this->touchReplayChannel, [this](const uint8_t* data, int size) {
+            touchEvent event;
+            if (int(sizeof(event)) == size) {
+                // NOTE: touchEvent is plain data (TimePoint only wraps an int64)
+                std::memcpy((void*)&event, data, sizeof(event));
+                this->handleTouchEvent(event);
+            }
+        });
+    }
 }
 
 //------------------------------------------------------------------------------
 void
 inputMgrBase::discard() {
     o_assert_dbg(this->isValid());
+    Replay::ClearPlaybackHandler(this->dispatcher.replayChannel);
+    Replay::ClearPlaybackHandler(this->touchReplayChannel);
     this->valid = false;
 }
 
@@ -67,6 +86,19 @@ inputMgrBase::reset() {
 //------------------------------------------------------------------------------
 void
 inputMgrBase::onTouchEvent(const touchEvent& event) {
+    if (Replay::IsPlaying()) {
+        // live touch input is ignored while a replay is played back
+        return;
+    }
+    if (Replay::IsRecording()) {
+        Replay::Record(this->touchReplayChannel, &event, sizeof(event));
+    }
+    this->handleTouchEvent(event);
+}
+
+//------------------------------------------------------------------------------
+void
+inputMgrBase::handleTouchEvent(const touchEvent& event) {
     o_assert_dbg(event.numTouches > 0);
     if (this->touchpad.attached) {
         // track raw touch events
@@ -138,6 +170,44 @@ inputMgrBase::onTouchEvent(const touchEvent& event) {
     }
 }
 
+//------------------------------------------------------------------------------
+void
+inputMgrBase::playbackInputEvent(const uint8_t* data, int size) {
+    replayInputEvent re;
+    if (int(sizeof(re)) != size) {
+        return;
+    }
+    std::memcpy(&re, data, sizeof(re));
+    switch (re.type) {
+        case InputEvent::KeyDown:
+            this->keyboard.onKeyDown((Key::Code) re.code);
+            break;
+        case InputEvent::KeyUp:
+            this->keyboard.onKeyUp((Key::Code) re.code);
+            break;
+        case InputEvent::KeyRepeat:
+            this->keyboard.onKeyRepeat((Key::Code) re.code);
+            break;
+        case InputEvent::WChar:
+            this->keyboard.onChar((wchar_t) re.code);
+            break;
+        case InputEvent::MouseButtonDown:
+            this->mouse.onButtonDown((MouseButton::Code) re.code);
+            break;
+        case InputEvent::MouseButtonUp:
+            this->mouse.onButtonUp((MouseButton::Code) re.code);
+            break;
+        case InputEvent::MouseMove:
+            this->mouse.onPosMov(glm::vec2(re.x0, re.y0), glm::vec2(re.x1, re.y1));
+            break;
+        case InputEvent::MouseScrolling:
+            this->mouse.onScroll(glm::vec2(re.x0, re.y0));
+            break;
+        default:
+            break;
+    }
+}
+
 //------------------------------------------------------------------------------
 void
 inputMgrBase::addGamepadMapping(const StringAtom& id, const GamepadMapping& mapping) {
@@ -25,6 +25,8 @@ public:
     void addGamepadMapping(const StringAtom& id, const GamepadMapping& mapping);
     const GamepadMapping& lookupGamepadMapping(const StringAtom& id) const;
     void onTouchEvent(const touchEvent& event);
+    void handleTouchEvent(const touchEvent& event);
+    void playbackInputEvent(const uint8_t* data, int size);
 
     class keyboardDevice keyboard;
     class mouseDevice mouse;
@@ -42,6 +44,7 @@ public:
     class pinchDetector pinchDetector;
     GamepadMapping defaultGamepadMapping;
     Map<StringAtom, GamepadMapping> gamepadMappings;
+    Replay::ChannelId touchReplayChannel = Replay::InvalidChannelId;
 };
 
 } // namespace _priv
@@ -6,11 +6,28 @@
 #include "Core/String/StringBuilder.h"
 #include "LocalFS/private/fsWrapper.h"
 #include "IO/IO.h"
+#include "Core/Trace.h"
 
 namespace Oryol {
 
 using namespace _priv;
 
+namespace {
+
+/// owner of a memory-mapped file region, unmaps the region when destroyed
+class mappedRegion : public RefCounted {
+    OryolClassDecl(mappedRegion);
+public:
+    mappedRegion(uint8_t* ptr_, int size_) : ptr(ptr_), size(size_) { };
+    ~mappedRegion() {
+        fsWrapper::unmap(this->ptr, this->size);
+    };
+    uint8_t* ptr;
+    int size;
+};
+
+} // anonymous namespace
+
 //------------------------------------------------------------------------------
 void
 LocalFileSystem::init(const StringAtom& scheme_) {
@@ -41,25 +58,61 @@ LocalFileSystem::onMsg(const Ptr<IORequest>& req) {
 //------------------------------------------------------------------------------
 void
 LocalFileSystem::onRead(const Ptr<IORead>& msg) {
+    o_trace_scoped(LocalFS_Read);
     if (msg->Url.HasPath()) {
         fsWrapper::handle h = fsWrapper::openRead(msg->Url.Path().AsCStr());
         if (fsWrapper::invalidHandle != h) {
             const int startOffset = msg->StartOffset;
             const int endOffset = msg->EndOffset;
-            if (startOffset > 0) {
-                fsWrapper::seek(h, startOffset);
-            }
+            const int fileSize = fsWrapper::size(h);
             int size;
             if (endOffset == EndOfFile) {
-                size = fsWrapper::size(h) - startOffset;
+                size = fileSize - startOffset;
             }
             else {
                 size = endOffset - startOffset;
             }
-            if (size > 0) {
+            uint8_t* mapped = nullptr;
+            if (msg->MapEnabled && (size >= MinMapSize) && ((startOffset + size) <= fileSize)) {
+                // NOTE: pages past the end of the file can't be accessed
+                mapped = fsWrapper::map(h, startOffset, size);
+            }
+            if (mapped) {
+                // the mapped pages are only read when the data is accessed
+                msg->Data.Wrap(mappedRegion::Create(mapped, size), mapped, size);
+                o_trace_counter_add(LocalFS_BytesMapped, size);
+                msg->Status = IOStatus::OK;
+            }
+            else if (size > 0) {
+                if (startOffset > 0) {
+                    fsWrapper::seek(h, startOffset);
+                }
+                // read in chunks, so that a cancelled request
+                // doesn't need to wait for a big file to be read
                 uint8_t* ptr = msg->Data.Add(size);
-                int bytesRead = fsWrapper::read(h, ptr, size);
-                if (bytesRead != size) {
+                int bytesRead = 0;
+                bool cancelled = false;
+                while (bytesRead < size) {
+                    if (msg->Cancelled) {
+                        cancelled = true;
+                        break;
+                    }
+                    const int bytesLeft = size - bytesRead;
+                    const int chunkSize = bytesLeft < ReadChunkSize ? bytesLeft : ReadChunkSize;
+                    const int chunkBytesRead = fsWrapper::read(h, ptr + bytesRead, chunkSize);
+                    if (chunkBytesRead > 0) {
+                        bytesRead += chunkBytesRead;
+                    }
+                    if (chunkBytesRead != chunkSize) {
+                        break;
+                    }
+                }
+                o_trace_counter_add(LocalFS_BytesRead, bytesRead);
+                if (cancelled) {
+                    msg->Data.Clear();
+                    msg->Status = IOStatus::Cancelled;
+                }
+                else if (bytesRead != size) {
                     msg->Status = IOStatus::DownloadError;
                     msg->ErrorDesc = "Fewer bytes read then expected";
                 }
@@ -83,11 +136,13 @@ LocalFileSystem::onRead(const Ptr<IORead>& msg) {
 //------------------------------------------------------------------------------
 void
 LocalFileSystem::onWrite(const Ptr<IOWrite>& msg) {
+    o_trace_scoped(LocalFS_Write);
     if (msg->Url.HasPath()) {
         fsWrapper::handle h = fsWrapper::openWrite(msg->Url.Path().AsCStr());
         if (fsWrapper::invalidHandle != h) {
             if (!msg->Data.Empty()) {
                 fsWrapper::write(h, msg->Data.Data(), msg->Data.Size());
+                o_trace_counter_add(LocalFS_BytesWritten, msg->Data.Size());
             }
             fsWrapper::close(h);
             msg->Status = IOStatus::OK;
@@ -7,6 +7,12 @@
     @class Oryol::LocalFileSystem
     @ingroup LocalFS
     @brief FileSystem subclass to access the local host file system
+
+    Reads with IORead::MapEnabled of at least MinMapSize bytes are
+    memory-mapped where the platform supports it: the request's Data
+    wraps the mapped file region, which is unmapped when the last buffer
+    referencing it goes away. The mapping is private (copy-on-write),
+    the file must not be truncated while it is mapped.
 */
 #include "IO/FileSystemBase.h"
 #include "Core/Creator.h"
@@ -22,6 +28,11 @@ public:
     /// called when IO message should be handled
     virtual void onMsg(const Ptr<IORequest>& ioReq) override;
 
+    /// reads are done in chunks of this size, cancelled reads are aborted between chunks
+    static const int ReadChunkSize = 256 * 1024;
+    /// smaller reads are copied even with IORead::MapEnabled
+    static const int MinMapSize = 64 * 1024;
+
 private:
     /// handle IORead msg
     void onRead(const Ptr<IORead>& ioRead);
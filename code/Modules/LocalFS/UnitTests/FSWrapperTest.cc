@@ -61,5 +61,14 @@ TEST(FSWrapperTest) {
     CHECK(fsWrapper::read(hs, buf, sizeof(buf)) == 6);
     readStr.Assign(buf, 0, 6);
     CHECK(readStr == "World\n");
+
+    // map a part of the file which doesn't start at a page boundary
+    uint8_t* mapped = fsWrapper::map(hs, 6, 5);
+    CHECK(mapped != nullptr);
+    if (mapped) {
+        readStr.Assign((const char*)mapped, 0, 5);
+        CHECK(readStr == "World");
+        fsWrapper::unmap(mapped, 5);
+    }
     fsWrapper::close(hs);
 }
@@ -8,6 +8,8 @@
 #include "IO/IO.h"
 #include "LocalFS/LocalFileSystem.h"
 #include "LocalFS/private/fsWrapper.h"
+#include <chrono>
+#include <cstdio>
 #include <thread>
 
 using namespace Oryol;
@@ -191,5 +193,186 @@ TEST(SameExtensionTest) {
     Core::Discard();
 }
 
+TEST(LocalFileSystemChunkedReadTest) {
+    Core::Setup();
+    IOSetup ioSetup;
+    ioSetup.FileSystems.Add("file", LocalFileSystem::Creator());
+    IO::Setup(ioSetup);
+
+    // write a file which spans several read chunks
+    const int size = LocalFileSystem::ReadChunkSize * 3 + 1234;
+    auto write = IOWrite::Create();
+    write->Url = "root:chunked.bin";
+    uint8_t* ptr = write->Data.Add(size);
+    for (int i = 0; i < size; i++) {
+        ptr[i] = uint8_t(i * 7);
+    }
+    IO::Put(write);
+    wait(write);
+    CHECK(write->Status == IOStatus::OK);
+
+    // call the filesystem directly, so that the request
+    // isn't filtered out by the IO worker
+    auto fs = LocalFileSystem::Create();
+    auto read = IORead::Create();
+    read->Url = IO::ResolveAssigns("root:chunked.bin");
+    fs->onMsg(read);
+    CHECK(read->Handled);
+    CHECK(read->Status == IOStatus::OK);
+    CHECK(read->Data.Size() == size);
+    bool match = read->Data.Size() == size;
+    for (int i = 0; match && (i < size); i++) {
+        match = read->Data.Data()[i] == uint8_t(i * 7);
+    }
+    CHECK(match);
+
+    // a cancelled read is aborted at the next chunk boundary
+    read = IORead::Create();
+    read->Url = IO::ResolveAssigns("root:chunked.bin");
+    read->Cancel();
+    fs->onMsg(read);
+    CHECK(read->Handled);
+    CHECK(read->Status == IOStatus::Cancelled);
+    CHECK(read->Data.Empty());
+
+    fs = nullptr;
+    IO::Discard();
+    Core::Discard();
+}
+
+TEST(LocalFileSystemMappedReadTest) {
+    Core::Setup();
+    IOSetup ioSetup;
+    ioSetup.FileSystems.Add("file", LocalFileSystem::Creator());
+    IO::Setup(ioSetup);
+
+    const int size = LocalFileSystem::MinMapSize * 2 + 100;
+    auto write = IOWrite::Create();
+    write->Url = "root:mapped.bin";
+    uint8_t* ptr = write->Data.Add(size);
+    for (int i = 0; i < size; i++) {
+        ptr[i] = uint8_t(i * 3);
+    }
+    IO::Put(write);
+    wait(write);
+    CHECK(write->Status == IOStatus::OK);
+    auto fs = LocalFileSystem::Create();
+
+    // a mapped read from an offset which isn't page-aligned
+    const int startOffset = 1001;
+    auto read = IORead::Create();
+    read->Url = IO::ResolveAssigns("root:mapped.bin");
+    read->StartOffset = startOffset;
+    read->MapEnabled = true;
+    fs->onMsg(read);
+    CHECK(read->Status == IOStatus::OK);
+    CHECK(read->Data.IsWrapped());
+    CHECK(read->Data.Size() == size - startOffset);
+    bool match = read->Data.Size() == size - startOffset;
+    for (int i = 0; match && (i < read->Data.Size()); i++) {
+        match = read->Data.Data()[i] == uint8_t((i + startOffset) * 3);
+    }
+    CHECK(match);
+
+    // the data stays valid after the request is gone,
+    // and writing to it doesn't change the file
+    Buffer data = std::move(read->Data);
+    read = nullptr;
+    data.Data()[0] = 0xFF;
+    CHECK(data.Data()[1] == uint8_t((startOffset + 1) * 3));
+    data.Clear();
+
+    read = IORead::Create();
+    read->Url = IO::ResolveAssigns("root:mapped.bin");
+    read->StartOffset = startOffset;
+    read->EndOffset = startOffset + 1;
+    fs->onMsg(read);
+    CHECK(read->Status == IOStatus::OK);
+    CHECK(read->Data.Size() == 1);
+    CHECK(read->Data.Data()[0] == uint8_t(startOffset * 3));
+
+    // small reads and reads past the end of the file are not mapped
+    read = IORead::Create();
+    read->Url = IO::ResolveAssigns("root:mapped.bin");
+    read->EndOffset = LocalFileSystem::MinMapSize - 1;
+    read->MapEnabled = true;
+    fs->onMsg(read);
+    CHECK(read->Status == IOStatus::OK);
+    CHECK(!read->Data.IsWrapped());
+    read = IORead::Create();
+    read->Url = IO::ResolveAssigns("root:mapped.bin");
+    read->EndOffset = size + 1;
+    read->MapEnabled = true;
+    fs->onMsg(read);
+    CHECK(read->Status == IOStatus::DownloadError);
+    CHECK(!read->Data.IsWrapped());
+
+    fs = nullptr;
+    IO::Discard();
+    Core::Discard();
+}
 
+// NOTE: this is not a hard performance test, the numbers are only logged
+#if !ORYOL_UNITTESTS_HEADLESS
+TEST(LocalFileSystemMappedReadBenchmark) {
+    Core::Setup();
+    IOSetup ioSetup;
+    ioSetup.FileSystems.Add("file", LocalFileSystem::Creator());
+    IO::Setup(ioSetup);
 
+    // write a 16 MByte file in 1 MByte blocks, raise numBlocks
+    // to measure with files of several hundred MBytes
+    const int blockSize = 1024 * 1024;
+    const int numBlocks = 16;
+    const String url = IO::ResolveAssigns("root:map_benchmark.bin");
+    const String path = URL(url).Path();
+    Buffer block;
+    uint64_t* words = (uint64_t*) block.Add(blockSize);
+    for (int i = 0; i < blockSize / 8; i++) {
+        words[i] = uint64_t(i);
+    }
+    _priv::fsWrapper::handle h = _priv::fsWrapper::openWrite(path.AsCStr());
+    CHECK(h != _priv::fsWrapper::invalidHandle);
+    for (int i = 0; i < numBlocks; i++) {
+        _priv::fsWrapper::write(h, block.Data(), blockSize);
+    }
+    _priv::fsWrapper::close(h);
+
+    // read the file and touch all data, as a consumer (e.g. a mesh
+    // loader) would, the first round warms up the page cache
+    auto fs = LocalFileSystem::Create();
+    for (int round = 0; round < 2; round++) {
+        for (int mapEnabled = 0; mapEnabled < 2; mapEnabled++) {
+            auto start = std::chrono::high_resolution_clock::now();
+            auto read = IORead::Create();
+            read->Url = url;
+            read->MapEnabled = 0 != mapEnabled;
+            fs->onMsg(read);
+            auto loaded = std::chrono::high_resolution_clock::now();
+            CHECK(read->Status == IOStatus::OK);
+            CHECK(read->Data.Size() == blockSize * numBlocks);
+            CHECK(read->Data.IsWrapped() == (0 != mapEnabled));
+            uint64_t sum = 0;
+            const uint64_t* ptr = (const uint64_t*) read->Data.Data();
+            const int numWords = read->Data.Size() / 8;
+            for (int i = 0; i < numWords; i++) {
+                sum += ptr[i];
+            }
+            read = nullptr;
+            auto done = std::chrono::high_resolution_clock::now();
+            const uint64_t wordsPerBlock = blockSize / 8;
+            CHECK(sum == numBlocks * (wordsPerBlock * (wordsPerBlock - 1) / 2));
+
+            const double loadMs = std::chrono::duration<double, std::milli>(loaded - start).count();
+            const double totalMs = std::chrono::duration<double, std::milli>(done - start).count();
+            Log::Info("LocalFileSystemMappedReadBenchmark: round %d, %s: read %.2fms, read+touch %.2fms (%.0f MByte/s)\n",
+                round, mapEnabled ? "mapped" : "copied", loadMs, totalMs, numBlocks / (totalMs / 1000.0));
+        }
+    }
+    fs = nullptr;
+    std::remove(path.AsCStr());
+
+    IO::Discard();
+    Core::Discard();
+}
+#endif
@@ -49,6 +49,18 @@ dummyFSWrapper::close(handle f) {
     // empty
 }
 
+//------------------------------------------------------------------------------
+uint8_t*
+dummyFSWrapper::map(handle /*f*/, int /*offset*/, int /*numBytes*/) {
+    return nullptr;
+}
+
+//------------------------------------------------------------------------------
+void
+dummyFSWrapper::unmap(uint8_t* /*ptr*/, int /*numBytes*/) {
+    // empty
+}
+
 //------------------------------------------------------------------------------
 String
 dummyFSWrapper::getExecutableDir() {
@@ -6,10 +6,13 @@
 #include "Core/String/StringBuilder.h"
 #include <stdio.h>
 #include "LocalFS/private/whereami/whereami.h"
+#include <sys/types.h>
+#include <sys/stat.h>
 #if ORYOL_WINDOWS
 #include <direct.h>
 #else
 #include <unistd.h>
+#include <sys/mman.h>
 #endif
 
 namespace Oryol {
@@ -58,12 +61,19 @@ posixFSWrapper::seek(handle h, int offset) {
 int
 posixFSWrapper::size(handle h) {
     o_assert_dbg(invalidHandle != h);
-    FILE* fp = (FILE*) h;
-    long off = ftell(fp);
-    fseek(fp, 0, SEEK_END);
-    long size = ftell(fp);
-    fseek(fp, off, SEEK_SET);
-    return (int) size;
+    // ask the file descriptor instead of seeking to the end and back
+    #if ORYOL_WINDOWS
+    struct _stat64 st;
+    if (0 == _fstat64(_fileno((FILE*)h), &st)) {
+        return (int) st.st_size;
+    }
+    #else
+    struct stat st;
+    if (0 == fstat(fileno((FILE*)h), &st)) {
+        return (int) st.st_size;
+    }
+    #endif
+    return -1;
 }
 
 //------------------------------------------------------------------------------
@@ -73,6 +83,35 @@ posixFSWrapper::close(handle h) {
     fclose((FILE*)h);
 }
 
+//------------------------------------------------------------------------------
+uint8_t*
+posixFSWrapper::map(handle h, int offset, int numBytes) {
+    o_assert_dbg(invalidHandle != h);
+    o_assert_dbg((offset >= 0) && (numBytes > 0));
+    #if ORYOL_WINDOWS
+    return nullptr;
+    #else
+    // the mapping must start at a page boundary
+    const int pageOffset = offset % int(sysconf(_SC_PAGESIZE));
+    void* ptr = mmap(nullptr, numBytes + pageOffset, PROT_READ|PROT_WRITE, MAP_PRIVATE,
+        fileno((FILE*)h), offset - pageOffset);
+    if (MAP_FAILED == ptr) {
+        return nullptr;
+    }
+    return ((uint8_t*)ptr) + pageOffset;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+posixFSWrapper::unmap(uint8_t* ptr, int numBytes) {
+    o_assert_dbg(ptr && (numBytes > 0));
+    #if !ORYOL_WINDOWS
+    const int pageOffset = int(uintptr_t(ptr) % uintptr_t(sysconf(_SC_PAGESIZE)));
+    munmap(ptr - pageOffset, numBytes + pageOffset);
+    #endif
+}
+
 //------------------------------------------------------------------------------
 String
 posixFSWrapper::getExecutableDir() {
@@ -32,6 +32,10 @@ public:
     static int size(handle f);
     /// close file
     static void close(handle f);
+    /// map a part of a file into memory (private copy-on-write pages), return nullptr if not supported
+    static uint8_t* map(handle f, int offset, int numBytes);
+    /// unmap memory returned by map()
+    static void unmap(uint8_t* ptr, int numBytes);
     
     /// get path to own executable
     static String getExecutableDir();
@@ -17,6 +17,7 @@ ResourceContainerBase::~ResourceContainerBase() {
 void
 ResourceContainerBase::Setup(int labelStackCapacity, int registryCapacity) {
     o_assert_dbg(!this->valid);
+    Memory::ScopedTag memTag(MemoryTag::Resource);
     this->labelStack.Reserve(labelStackCapacity);
     this->registry.Setup(registryCapacity);
     this->valid = true;
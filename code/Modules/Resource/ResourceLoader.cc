@@ -31,4 +31,24 @@ ResourceLoader::Cancel() {
     // empty
 }
 
+//------------------------------------------------------------------------------
+bool
+ResourceLoader::IsEventDriven() const {
+    return false;
+}
+
+//------------------------------------------------------------------------------
+void
+ResourceLoader::SetReadyFunc(ReadyFunc func) {
+    this->readyFunc = std::move(func);
+}
+
+//------------------------------------------------------------------------------
+void
+ResourceLoader::signalReady() {
+    if (this->readyFunc) {
+        this->readyFunc(this);
+    }
+}
+
 } // namespace Oryol
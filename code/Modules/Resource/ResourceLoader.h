@@ -4,8 +4,15 @@
     @class Oryol::ResourceLoader
     @ingroup Resource
     @brief base class for resource loaders
+
+    A resource container calls Continue() on a pending loader until the
+    loader is finished. By default this happens once per frame. Loaders
+    which return true from IsEventDriven() instead call signalReady()
+    when Continue() will make progress (e.g. when their IO request
+    has completed), Continue() is then only called after a signal.
 */
 #include "Core/RefCounted.h"
+#include <functional>
 #include "Resource/Id.h"
 #include "Resource/Locator.h"
 #include "Resource/ResourceState.h"
@@ -23,6 +30,19 @@ public:
     virtual ResourceState::Code Continue();
     /// cancel the resource loading process
     virtual void Cancel();
+
+    /// callback to tell the owner that Continue() should be called
+    typedef std::function<void(const Ptr<ResourceLoader>& loader)> ReadyFunc;
+    /// return true if the loader calls signalReady(), instead of being polled
+    virtual bool IsEventDriven() const;
+    /// set the ready callback (called by the resource container before Start())
+    void SetReadyFunc(ReadyFunc func);
+
+protected:
+    /// tell the owner that Continue() should be called
+    void signalReady();
+
+    ReadyFunc readyFunc;
 };
 
 } // namespace Oryol
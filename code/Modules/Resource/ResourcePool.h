@@ -4,10 +4,14 @@
     @class Oryol::ResourcePool
     @ingroup Resource
     @brief generic resource pool
-    @todo ResourcePool description
+
+    The resource slots live in a ChunkedArray, so pointers to resource
+    objects stay valid while the pool grows. The pool starts with
+    the size given to Setup() and grows by SlotChunkSize slots when
+    it runs out of free slots (up to MaxNumPoolResources).
 */
 #include "Core/Containers/Queue.h"
-#include "Core/Containers/Array.h"
+#include "Core/Containers/ChunkedArray.h"
 #include "Resource/Id.h"
 #include "Resource/ResourceInfo.h"
 #include "Resource/ResourcePoolInfo.h"
@@ -18,11 +22,13 @@ template<class RESOURCE> class ResourcePool {
 public:
     /// max number of resources in a pool
     static const int MaxNumPoolResources = (1<<16);
+    /// number of resource slots per chunk (the pool grows by this number)
+    static const int SlotChunkSize = 64;
 
     /// destructor
     ~ResourcePool();
     
-    /// setup the resource pool
+    /// setup the resource pool with initial size
     void Setup(Id::TypeT resourceType, int poolSize);
     /// discard the resource pool
     void Discard();
@@ -70,7 +76,10 @@ public:
     int uniqueCounter = 0;
     Id::TypeT resourceType = 0xFF;
     
-    Array<RESOURCE> slots;
+    /// add new free slots at the end of the pool
+    void grow(int numSlots);
+
+    ChunkedArray<RESOURCE, SlotChunkSize> slots;
     Queue<uint16_t> freeSlots;
 };
     
@@ -85,24 +94,27 @@ template<class RESOURCE> void
 ResourcePool<RESOURCE>::Setup(Id::TypeT resType, int poolSize) {
     o_assert_dbg(!this->isValid);
     o_assert_dbg(Id::InvalidType != resType);
-    o_assert_dbg(poolSize > 0);
+    o_assert_dbg((poolSize > 0) && (poolSize <= MaxNumPoolResources));
     
     this->resourceType = resType;
-    this->slots.SetFixedCapacity(poolSize);
-    this->freeSlots.SetFixedCapacity(poolSize);
     this->LastAllocSlot = 0;
-    
-    // setup empty slots
-    for (int i = 0; i < poolSize; i++) {
+    this->grow(poolSize);
+    this->isValid = true;
+}
+
+//------------------------------------------------------------------------------
+template<class RESOURCE> void
+ResourcePool<RESOURCE>::grow(int numSlots) {
+    Memory::ScopedTag memTag(MemoryTag::Resource);
+    const int firstSlot = this->slots.Size();
+    o_assert((firstSlot + numSlots) <= MaxNumPoolResources);
+    this->slots.Reserve(numSlots);
+    this->freeSlots.Reserve(numSlots);
+    for (int i = firstSlot; i < firstSlot + numSlots; i++) {
+        // setup empty slot and add to the free slots queue
         this->slots.Add();
+        this->freeSlots.Enqueue(uint16_t(i));
     }
-    
-    // setup free slots queue
-    for (uint16_t i = 0; i < poolSize; i++) {
-        this->freeSlots.Enqueue(i);
-    }
-    
-    this->isValid = true;
 }
 
 //------------------------------------------------------------------------------
@@ -135,6 +147,13 @@ template<class RESOURCE> Id
 ResourcePool<RESOURCE>::AllocId() {
     o_assert_dbg(this->isValid);
     o_assert_dbg(Id::InvalidType != this->resourceType);
+    if (this->freeSlots.Empty()) {
+        // grow without moving existing resources
+        const int numSlots = this->slots.Size();
+        o_assert(numSlots < MaxNumPoolResources);
+        const int spare = MaxNumPoolResources - numSlots;
+        this->grow(spare < SlotChunkSize ? spare : SlotChunkSize);
+    }
     Id newId(this->uniqueCounter++, this->freeSlots.Dequeue(), this->resourceType);
     #if ORYOL_DEBUG
         const auto& slot = this->slots[newId.SlotIndex];
@@ -16,6 +16,7 @@ ResourceRegistry::~ResourceRegistry() {
 void
 ResourceRegistry::Setup(int reserveSize) {
     o_assert_dbg(!this->isValid);
+    Memory::ScopedTag memTag(MemoryTag::Resource);
     
     this->isValid = true;
     this->entries.Reserve(reserveSize);
@@ -46,6 +47,7 @@ ResourceRegistry::Add(const Locator& loc, Id id, ResourceLabel label) {
     o_assert_dbg(this->isValid);
     o_assert_dbg(id.IsValid());
     o_assert(!this->idIndexMap.Contains(id));
+    Memory::ScopedTag memTag(MemoryTag::Resource);
     
     this->entries.Add(loc, id, label);
     if (loc.IsShared()) {
@@ -124,20 +126,12 @@ ResourceRegistry::Remove(ResourceLabel label) {
                 this->locatorIndexMap.Erase(loc);
             }
             
-            // fixup the index maps (see elementBuffer)
-            const int swappedIndex = this->entries.Size();
-            if (entryIndex != swappedIndex) {
-                for (auto& elm : this->idIndexMap) {
-                    if (swappedIndex == elm.value) {
-                        elm.value = entryIndex;
-                        break;
-                    }
-                }
-                for (auto& elm : this->locatorIndexMap) {
-                    if (swappedIndex == elm.value) {
-                        elm.value = entryIndex;
-                        break;
-                    }
+            // fixup the index maps for the swapped-in entry
+            if (entryIndex != this->entries.Size()) {
+                const Entry& swapped = this->entries[entryIndex];
+                this->idIndexMap[swapped.id] = entryIndex;
+                if (swapped.locator.IsShared()) {
+                    this->locatorIndexMap[swapped.locator] = entryIndex;
                 }
             }
             
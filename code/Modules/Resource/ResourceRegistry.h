@@ -9,7 +9,7 @@
 #include "Resource/Locator.h"
 #include "Resource/ResourceLabel.h"
 #include "Core/Containers/Array.h"
-#include "Core/Containers/Map.h"
+#include "Core/Containers/HashMap.h"
 
 namespace Oryol {
     
@@ -60,6 +60,18 @@ public:
         ResourceLabel label;
     };
     
+    /// hash functions for the index maps
+    struct locatorHasher {
+        int32_t operator()(const Locator& loc) const {
+            return loc.Location().Hash() ^ int32_t(loc.Signature() * 0x9E3779B1);
+        };
+    };
+    struct idHasher {
+        int32_t operator()(const Id& id) const {
+            return int32_t(id.UniqueStamp ^ (uint32_t(id.SlotIndex) << 16) ^ id.Type);
+        };
+    };
+
     /// find an entry by locator
     const Entry* findEntryByLocator(const Locator& loc) const;
     /// find an entry by id
@@ -67,7 +79,7 @@ public:
     
     bool isValid = false;
     Array<Entry> entries;
-    Map<Locator, int> locatorIndexMap;
-    Map<Id, int> idIndexMap;
+    HashMap<Locator, int, locatorHasher> locatorIndexMap;
+    HashMap<Id, int, idHasher> idIndexMap;
 };
 } // namespace Oryol
@@ -81,3 +81,32 @@ TEST(ResourcePoolTest) {
     resourcePool.Discard();
     CHECK(!resourcePool.IsValid());
 }
+
+TEST(ResourcePoolGrowTest) {
+    const uint16_t myResourceType = 12;
+    myResourcePool resourcePool;
+    resourcePool.Setup(myResourceType, 4);
+    CHECK(resourcePool.GetNumSlots() == 4);
+
+    // allocating beyond the initial size grows the pool, and
+    // doesn't move existing resources
+    Id ids[100];
+    myResource* ptrs[100];
+    for (int i = 0; i < 100; i++) {
+        ids[i] = resourcePool.AllocId();
+        CHECK(ids[i].SlotIndex == i);
+        ptrs[i] = &resourcePool.Assign(ids[i], ResourceState::Valid);
+        ptrs[i]->blub = i;
+    }
+    CHECK(resourcePool.GetNumSlots() == 4 + 2 * myResourcePool::SlotChunkSize);
+    CHECK(resourcePool.GetNumUsedSlots() == 100);
+    for (int i = 0; i < 100; i++) {
+        CHECK(resourcePool.Lookup(ids[i]) == ptrs[i]);
+        CHECK(ptrs[i]->blub == i);
+    }
+    for (int i = 0; i < 100; i++) {
+        resourcePool.Unassign(ids[i]);
+    }
+    CHECK(resourcePool.GetNumUsedSlots() == 0);
+    resourcePool.Discard();
+}
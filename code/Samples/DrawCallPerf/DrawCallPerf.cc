@@ -3,7 +3,7 @@
 //------------------------------------------------------------------------------
 #include "Pre.h"
 #include "Core/Main.h"
-#include "Core/Time/Clock.h"
+#include "Core/Time/FrameStats.h"
 #include "Gfx/Gfx.h"
 #include "Assets/Gfx/ShapeBuilder.h"
 #include "Dbg/Dbg.h"
@@ -34,7 +34,9 @@ public:
     bool updateEnabled = true;
     int frameCount = 0;
     int curNumParticles = 0;
-    TimePoint lastFrameTimePoint;
+    FrameStats::PhaseId updPhase = FrameStats::InvalidPhaseId;
+    FrameStats::PhaseId applyRtPhase = FrameStats::InvalidPhaseId;
+    FrameStats::PhaseId drawPhase = FrameStats::InvalidPhaseId;
     static const int NumParticlesEmittedPerFrame = 100;
     static const int MaxNumParticles = 1024 * 1024;
     struct {
@@ -77,6 +79,11 @@ DrawCallPerfApp::OnInit() {
     this->proj = glm::perspectiveFov(glm::radians(45.0f), fbWidth, fbHeight, 0.01f, 100.0f);
     this->view = glm::lookAt(glm::vec3(0.0f, 2.5f, 0.0f), glm::vec3(0.0f, 0.0f, -10.0f), glm::vec3(0.0f, 1.0f, 0.0f));
     this->model = glm::mat4();
+
+    // register frame statistics phases
+    this->updPhase = FrameStats::RegisterPhase("Update");
+    this->applyRtPhase = FrameStats::RegisterPhase("ApplyRt");
+    this->drawPhase = FrameStats::RegisterPhase("Draw");
     
     return App::OnInit();
 }
@@ -85,23 +92,21 @@ DrawCallPerfApp::OnInit() {
 AppState::Code
 DrawCallPerfApp::OnRunning() {
     
-    Duration updTime, drawTime, applyRtTime;
     this->frameCount++;
     
     // update block
     this->updateCamera();
     if (this->updateEnabled) {
-        TimePoint updStart = Clock::Now();
+        FrameStats::ScopedPhase updScope(this->updPhase);
         this->emitParticles();
         this->updateParticles();
-        updTime = Clock::Since(updStart);
     }
     
     // render block
-    TimePoint applyRtStart = Clock::Now();
+    FrameStats::BeginPhase(this->applyRtPhase);
     Gfx::BeginPass();
-    applyRtTime = Clock::Since(applyRtStart);
-    TimePoint drawStart = Clock::Now();
+    FrameStats::EndPhase(this->applyRtPhase);
+    FrameStats::BeginPhase(this->drawPhase);
     Gfx::ApplyDrawState(this->drawState);
     Gfx::ApplyUniformBlock(this->perFrameParams);
     for (int i = 0; i < this->curNumParticles; i++) {
@@ -109,7 +114,7 @@ DrawCallPerfApp::OnRunning() {
         Gfx::ApplyUniformBlock(this->perParticleParams);
         Gfx::Draw();
     }
-    drawTime = Clock::Since(drawStart);
+    FrameStats::EndPhase(this->drawPhase);
     
     Dbg::DrawTextBuffer();
     Gfx::EndPass();
@@ -120,15 +125,22 @@ DrawCallPerfApp::OnRunning() {
         this->updateEnabled = !this->updateEnabled;
     }
     
-    Duration frameTime = Clock::LapTime(this->lastFrameTimePoint);
-    Dbg::TextColor(1.0f, 1.0f, 0.0f, 1.0f);
-    Dbg::PrintF("\n %d draws\n\r upd=%.3fms\n\r applyRt=%.3fms\n\r draw=%.3fms\n\r frame=%.3fms\n\r"
-                " LMB/tap: toggle particle update",
-                this->curNumParticles,
-                updTime.AsMilliSeconds(),
-                applyRtTime.AsMilliSeconds(),
-                drawTime.AsMilliSeconds(),
-                frameTime.AsMilliSeconds());
+    // show timings of the last frame, and frame time statistics over the last 64 frames
+    if (FrameStats::NumFrames() > 0) {
+        const FrameStats::Summary frameStats = FrameStats::Query(FrameStats::FramePhase, 64);
+        Dbg::TextColor(1.0f, 1.0f, 0.0f, 1.0f);
+        Dbg::PrintF("\n %d draws\n\r upd=%.3fms\n\r applyRt=%.3fms\n\r draw=%.3fms\n\r"
+                    " frame=%.3fms (p50=%.3fms p99=%.3fms, %d spikes)\n\r"
+                    " LMB/tap: toggle particle update",
+                    this->curNumParticles,
+                    FrameStats::PhaseTime(this->updPhase).AsMilliSeconds(),
+                    FrameStats::PhaseTime(this->applyRtPhase).AsMilliSeconds(),
+                    FrameStats::PhaseTime(this->drawPhase).AsMilliSeconds(),
+                    FrameStats::PhaseTime(FrameStats::FramePhase).AsMilliSeconds(),
+                    frameStats.P50.AsMilliSeconds(),
+                    frameStats.P99.AsMilliSeconds(),
+                    int(FrameStats::NumSpikes()));
+    }
     Dbg::TextColor(1.0f, 0.0f, 0.0f, 1.0f);
     Dbg::PrintF("\n\n\r NOTE: this demo will bring down GL fairly quickly!\n");
     
@@ -14,6 +14,9 @@ option(FIPS_UNITTESTS_HEADLESS "If enabled don't run tests which require a displ
 option(ORYOL_SAMPLES "Build Oryol samples" ON)
 set(ORYOL_SAMPLE_URL "http://floooh.github.com/oryol/data/" CACHE STRING "Sample data URL")
 option(ORYOL_DEBUG_SHADERS "Enable/disable debug info for shaders" OFF)
+option(ORYOL_GLOBAL_STRINGATOMS "Use a single process-wide StringAtom table" OFF)
+option(ORYOL_FORCE_THREADLOCAL_PTHREAD "Use pthread keys instead of native thread-locals (POSIX only, for testing)" OFF)
+option(ORYOL_BUILTIN_TRACE "Use the built-in TraceRecorder instead of Remotery for profiling" ON)
 if (FIPS_MACOS OR FIPS_LINUX OR FIPS_ANDROID)
     option(ORYOL_USE_LIBCURL "Use libcurl instead of native APIs" ON)
 else() 
@@ -27,6 +30,9 @@ endif()
 # profiling enabled?
 if (FIPS_PROFILING)
     add_definitions(-DORYOL_PROFILING=1)
+    if (ORYOL_BUILTIN_TRACE)
+        add_definitions(-DORYOL_BUILTIN_TRACE=1)
+    endif()
 endif()
 
 # use Visual Leak Detector?
@@ -173,6 +179,12 @@ endif()
 if (FIPS_ALLOCATOR_DEBUG)
     add_definitions(-DORYOL_ALLOCATOR_DEBUG=1)
 endif()
+if (FIPS_ALLOCATION_TRACKING)
+    add_definitions(-DORYOL_ALLOCATION_TRACKING=1)
+endif()
+if (ORYOL_GLOBAL_STRINGATOMS)
+    add_definitions(-DORYOL_GLOBAL_STRINGATOMS=1)
+endif()
 if (FIPS_UNITTESTS)
     add_definitions(-DORYOL_UNITTESTS=1)
     if (FIPS_UNITTESTS_HEADLESS)
@@ -185,6 +197,9 @@ endif()
 if (FIPS_FORCE_NO_THREADS)
     add_definitions(-DORYOL_FORCE_NO_THREADS=1)
 endif()
+if (ORYOL_FORCE_THREADLOCAL_PTHREAD)
+    add_definitions(-DORYOL_FORCE_THREADLOCAL_PTHREAD=1)
+endif()
 if (FIPS_EMSCRIPTEN)
     add_definitions(-DORYOL_SAMPLE_URL=\"http://localhost/../data/\") # HACK
 else()